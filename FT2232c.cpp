@@ -36,9 +36,9 @@ Revision History:
 
 #include "FtcJtagInternal.h"
 #include "FT2232c.h"
+#include "FtcIoThreadTransport.h"
 
 #include <cstring>
-#include <stdint.h>
 
 BOOLEAN FT2232c::FTC_DeviceInUse(LPSTR lpDeviceName, DWORD dwLocationID)
 {
@@ -194,14 +194,42 @@ FT2232c::FT2232c(void)
   uiNumOpenedDevices = 0;
 
   for (iDeviceCntr = 0; (iDeviceCntr < MAX_NUM_DEVICES); iDeviceCntr++)
+  {
     OpenedDevices[iDeviceCntr].dwProcessId = 0;
 
+    OpenedDevicesTransports[iDeviceCntr].hDevice = 0;
+    OpenedDevicesTransports[iDeviceCntr].pTransport = NULL;
+    OpenedDevicesTransports[iDeviceCntr].dwWaitPolicy = FTC_WAIT_POLICY_HYBRID;
+    OpenedDevicesTransports[iDeviceCntr].dwSpinPeriodMicroSecs = DEFAULT_WAIT_POLICY_SPIN_PERIOD;
+    OpenedDevicesTransports[iDeviceCntr].dwUSBOutTransferSize = DEFAULT_USB_TRANSFER_SIZE;
+    OpenedDevicesTransports[iDeviceCntr].dwUSBTransferChunkSize = FTC_USB_TRANSFER_CHUNK_SIZE_AUTO;
+    OpenedDevicesTransports[iDeviceCntr].dwCommandTimeoutmSec = DEFAULT_COMMAND_TIMEOUT_PERIOD;
+    OpenedDevicesTransports[iDeviceCntr].ulCommandDeadlineMicroSecs = 0;
+    OpenedDevicesTransports[iDeviceCntr].pIoThreadTransport = NULL;
+  }
+
+  dwNextDeviceHandle = 1;
+
   dwNumBytesToSend = 0;
+  dwNumOutputDataReferences = 0;
+  dwNumReferencedBytesToSend = 0;
 }
 
 FT2232c::~FT2232c(void)
 {
+  INT iDeviceCntr = 0;
+
+  for (iDeviceCntr = 0; (iDeviceCntr < MAX_NUM_DEVICES); iDeviceCntr++)
+  {
+    if (OpenedDevicesTransports[iDeviceCntr].pTransport != NULL)
+    {
+      OpenedDevicesTransports[iDeviceCntr].pTransport->Close();
 
+      delete OpenedDevicesTransports[iDeviceCntr].pTransport;
+
+      OpenedDevicesTransports[iDeviceCntr].pTransport = NULL;
+    }
+  }
 }
 
 FTC_STATUS FT2232c::FTC_GetNumDevices(LPDWORD lpdwNumDevices, FT2232CDeviceIndexes *FT2232CIndexes)
@@ -384,9 +412,12 @@ FTC_STATUS FT2232c::FTC_OpenSpecifiedDevice(LPSTR lpDeviceName, DWORD dwLocation
 
           if (Status == FTC_SUCCESS)
           {
-            *pftHandle = (DWORD)reinterpret_cast<intptr_t>(ftHandle);
+            Status = FTC_InsertDeviceTransport(new FtcD2xxTransport(ftHandle), pftHandle);
 
-            FTC_InsertDeviceHandle(lpDeviceName, dwLocationID, *pftHandle);
+            if (Status == FTC_SUCCESS)
+              FTC_InsertDeviceHandle(lpDeviceName, dwLocationID, *pftHandle);
+            else
+              *pftHandle = 0;
           }
         }
       }
@@ -439,7 +470,7 @@ FTC_STATUS FT2232c::FTC_CloseDevice(FTC_HANDLE ftHandle)
 
   if (Status == FTC_SUCCESS)
   {
-    Status = FT_Close((FT_HANDLE)ftHandle);
+    Status = FTC_CloseDeviceTransport(ftHandle);
 
     FTC_RemoveDeviceHandle(ftHandle);
   }
@@ -554,6 +585,219 @@ void FT2232c::FTC_RemoveDeviceHandle(FTC_HANDLE ftHandle)
   }
 }
 
+FTC_STATUS FT2232c::FTC_InsertDeviceTransport(FtcTransport *pTransport, FTC_HANDLE *pftHandle)
+{
+  FTC_STATUS Status = FTC_TOO_MANY_DEVICES;
+  FTC_HANDLE ftHandle = 0;
+  INT iDeviceCntr = 0;
+
+  if (pTransport != NULL)
+  {
+    // Handles are taken from a counter rather than derived from a driver handle or transport pointer, so every
+    // opened device gets a distinct non-zero handle, zero being reserved for the single device case
+    do
+    {
+      ftHandle = dwNextDeviceHandle;
+
+      dwNextDeviceHandle = dwNextDeviceHandle + 1;
+
+      if (dwNextDeviceHandle == 0)
+        dwNextDeviceHandle = 1;
+    }
+    while ((ftHandle == 0) || (FTC_GetDeviceTransportData(ftHandle) != NULL));
+
+    for (iDeviceCntr = 0; ((iDeviceCntr < MAX_NUM_DEVICES) && (Status != FTC_SUCCESS)); iDeviceCntr++)
+    {
+      if (OpenedDevicesTransports[iDeviceCntr].hDevice == 0)
+      {
+        OpenedDevicesTransports[iDeviceCntr].hDevice = ftHandle;
+        OpenedDevicesTransports[iDeviceCntr].pTransport = pTransport;
+        OpenedDevicesTransports[iDeviceCntr].dwWaitPolicy = FTC_WAIT_POLICY_HYBRID;
+        OpenedDevicesTransports[iDeviceCntr].dwSpinPeriodMicroSecs = DEFAULT_WAIT_POLICY_SPIN_PERIOD;
+        OpenedDevicesTransports[iDeviceCntr].dwUSBOutTransferSize = DEFAULT_USB_TRANSFER_SIZE;
+        OpenedDevicesTransports[iDeviceCntr].dwUSBTransferChunkSize = FTC_USB_TRANSFER_CHUNK_SIZE_AUTO;
+        OpenedDevicesTransports[iDeviceCntr].dwCommandTimeoutmSec = DEFAULT_COMMAND_TIMEOUT_PERIOD;
+        OpenedDevicesTransports[iDeviceCntr].ulCommandDeadlineMicroSecs = 0;
+        OpenedDevicesTransports[iDeviceCntr].pIoThreadTransport = NULL;
+
+        Status = FTC_SUCCESS;
+      }
+    }
+
+    // The transport is owned by the device table, so close it if it could not be added to the table
+    if (Status == FTC_SUCCESS)
+      *pftHandle = ftHandle;
+    else
+    {
+      pTransport->Close();
+
+      delete pTransport;
+    }
+  }
+  else
+    Status = FTC_INSUFFICIENT_RESOURCES;
+
+  return Status;
+}
+
+PFTC_DEVICE_TRANSPORT_DATA FT2232c::FTC_GetDeviceTransportData(FTC_HANDLE ftHandle)
+{
+  PFTC_DEVICE_TRANSPORT_DATA pDeviceTransportData = NULL;
+  INT iDeviceCntr = 0;
+
+  if (ftHandle > 0)
+  {
+    for (iDeviceCntr = 0; ((iDeviceCntr < MAX_NUM_DEVICES) && (pDeviceTransportData == NULL)); iDeviceCntr++)
+    {
+      if (OpenedDevicesTransports[iDeviceCntr].hDevice == ftHandle)
+        pDeviceTransportData = &OpenedDevicesTransports[iDeviceCntr];
+    }
+  }
+
+  return pDeviceTransportData;
+}
+
+FtcTransport *FT2232c::FTC_GetDeviceTransport(FTC_HANDLE ftHandle)
+{
+  FtcTransport *pTransport = NULL;
+  PFTC_DEVICE_TRANSPORT_DATA pDeviceTransportData = NULL;
+
+  if ((pDeviceTransportData = FTC_GetDeviceTransportData(ftHandle)) != NULL)
+    pTransport = pDeviceTransportData->pTransport;
+
+  return pTransport;
+}
+
+FTC_STATUS FT2232c::FTC_CloseDeviceTransport(FTC_HANDLE ftHandle)
+{
+  FTC_STATUS Status = FTC_INVALID_HANDLE;
+  INT iDeviceCntr = 0;
+  BOOLEAN bDeviceTransportFound = false;
+
+  if (ftHandle > 0)
+  {
+    for (iDeviceCntr = 0; ((iDeviceCntr < MAX_NUM_DEVICES) && !bDeviceTransportFound); iDeviceCntr++)
+    {
+      if (OpenedDevicesTransports[iDeviceCntr].hDevice == ftHandle)
+      {
+        Status = OpenedDevicesTransports[iDeviceCntr].pTransport->Close();
+
+        delete OpenedDevicesTransports[iDeviceCntr].pTransport;
+
+        OpenedDevicesTransports[iDeviceCntr].hDevice = 0;
+        OpenedDevicesTransports[iDeviceCntr].pTransport = NULL;
+        OpenedDevicesTransports[iDeviceCntr].pIoThreadTransport = NULL;
+
+        bDeviceTransportFound = true;
+      }
+    }
+  }
+
+  return Status;
+}
+
+FTC_STATUS FT2232c::FTC_GetDeviceType(FTC_HANDLE ftHandle, LPDWORD lpdwDeviceType)
+{
+  FTC_STATUS Status = FTC_INVALID_HANDLE;
+  FtcTransport *pTransport = NULL;
+
+  if ((pTransport = FTC_GetDeviceTransport(ftHandle)) != NULL)
+    Status = pTransport->GetDeviceType(lpdwDeviceType);
+
+  return Status;
+}
+
+FTC_STATUS FT2232c::FTC_GetDeviceQueueStatus(FTC_HANDLE ftHandle, LPDWORD lpdwNumBytesDeviceInputBuffer)
+{
+  FTC_STATUS Status = FTC_INVALID_HANDLE;
+  FtcTransport *pTransport = NULL;
+
+  if ((pTransport = FTC_GetDeviceTransport(ftHandle)) != NULL)
+    Status = pTransport->GetQueueStatus(lpdwNumBytesDeviceInputBuffer);
+
+  return Status;
+}
+
+FTC_STATUS FT2232c::FTC_WriteBytesToDevice(FTC_HANDLE ftHandle, LPBYTE pBuffer, DWORD dwNumBytesToWrite, LPDWORD lpdwNumBytesWritten)
+{
+  FTC_STATUS Status = FTC_INVALID_HANDLE;
+  FtcTransport *pTransport = NULL;
+
+  if ((pTransport = FTC_GetDeviceTransport(ftHandle)) != NULL)
+    Status = pTransport->Write(pBuffer, dwNumBytesToWrite, lpdwNumBytesWritten);
+
+  return Status;
+}
+
+FTC_STATUS FT2232c::FTC_WriteOutputBytesToDevice(FTC_HANDLE ftHandle, DWORD dwOutputByteIndex, DWORD dwNumBytesToWrite,
+                                                 LPDWORD lpdwNumBytesWritten)
+{
+  // This function writes part of the bytes to be sent to the device, the dwOutputByteIndex variable specifies the
+  // offset of the first byte to be written. The bytes to be sent are the output buffer bytes with the referenced data
+  // blocks inserted between them, so the part to be written is passed to the transport as a list of segments, which
+  // point into the output buffer and into the data blocks without copying either of them.
+  FTC_STATUS Status = FTC_INVALID_HANDLE;
+  FtcTransport *pTransport = NULL;
+  FTC_WRITE_SEGMENT WriteSegments[((MAX_NUM_OUTPUT_DATA_REFERENCES * 2) + 1)];
+  DWORD dwNumWriteSegments = 0;
+  DWORD dwReferenceCntr = 0;
+  DWORD dwOutputBufferIndex = 0;
+  DWORD dwSegmentByteIndex = 0;
+  DWORD dwSegmentStartIndex = 0;
+  DWORD dwSegmentEndIndex = 0;
+  DWORD dwWriteEndIndex = (dwOutputByteIndex + dwNumBytesToWrite);
+  LPBYTE pSegmentBytes = NULL;
+  DWORD dwNumSegmentBytes = 0;
+
+  if ((pTransport = FTC_GetDeviceTransport(ftHandle)) != NULL)
+  {
+    // Each referenced data block is preceded by the output buffer bytes added ahead of it, and the remaining output
+    // buffer bytes follow the last data block, segments with no bytes in the part to be written are left out
+    for (dwReferenceCntr = 0; (dwReferenceCntr <= (dwNumOutputDataReferences * 2)); dwReferenceCntr++)
+    {
+      if ((dwReferenceCntr % 2) == 0)
+      {
+        pSegmentBytes = &OutputBuffer[dwOutputBufferIndex];
+
+        if (dwReferenceCntr < (dwNumOutputDataReferences * 2))
+          dwNumSegmentBytes = (OutputDataReferences[(dwReferenceCntr / 2)].dwOutputBufferIndex - dwOutputBufferIndex);
+        else
+          dwNumSegmentBytes = (dwNumBytesToSend - dwOutputBufferIndex);
+
+        dwOutputBufferIndex = (dwOutputBufferIndex + dwNumSegmentBytes);
+      }
+      else
+      {
+        pSegmentBytes = OutputDataReferences[(dwReferenceCntr / 2)].pDataBytes;
+        dwNumSegmentBytes = OutputDataReferences[(dwReferenceCntr / 2)].dwNumDataBytes;
+      }
+
+      dwSegmentStartIndex = dwSegmentByteIndex;
+      dwSegmentEndIndex = (dwSegmentByteIndex + dwNumSegmentBytes);
+
+      if (dwSegmentStartIndex < dwOutputByteIndex)
+        dwSegmentStartIndex = dwOutputByteIndex;
+
+      if (dwSegmentEndIndex > dwWriteEndIndex)
+        dwSegmentEndIndex = dwWriteEndIndex;
+
+      if (dwSegmentStartIndex < dwSegmentEndIndex)
+      {
+        WriteSegments[dwNumWriteSegments].pBuffer = &pSegmentBytes[(dwSegmentStartIndex - dwSegmentByteIndex)];
+        WriteSegments[dwNumWriteSegments].dwNumBytes = (dwSegmentEndIndex - dwSegmentStartIndex);
+
+        dwNumWriteSegments = (dwNumWriteSegments + 1);
+      }
+
+      dwSegmentByteIndex = (dwSegmentByteIndex + dwNumSegmentBytes);
+    }
+
+    Status = pTransport->WriteSegments(WriteSegments, dwNumWriteSegments, lpdwNumBytesWritten);
+  }
+
+  return Status;
+}
+
 FTC_STATUS FT2232c::FTC_ResetUSBDevicePurgeUSBInputBuffer(FTC_HANDLE ftHandle)
 {
   FTC_STATUS Status = FTC_SUCCESS;
@@ -561,12 +805,17 @@ FTC_STATUS FT2232c::FTC_ResetUSBDevicePurgeUSBInputBuffer(FTC_HANDLE ftHandle)
   DWORD dwNumBytesRead = 0;
   DWORD dwNumBytesDeviceInputBuffer;
 
-  Status = FT_ResetDevice((FT_HANDLE)ftHandle);
+  FtcTransport *pTransport = NULL;
+
+  if ((pTransport = FTC_GetDeviceTransport(ftHandle)) != NULL)
+    Status = pTransport->ResetDevice();
+  else
+    Status = FTC_INVALID_HANDLE;
 
   if (Status == FTC_SUCCESS)
   {
     // Get the number of bytes in the device input buffer
-    Status = FT_GetQueueStatus((FT_HANDLE)ftHandle, &dwNumBytesDeviceInputBuffer);
+    Status = pTransport->GetQueueStatus(&dwNumBytesDeviceInputBuffer);
 
     if (Status == FTC_SUCCESS)
     {
@@ -580,7 +829,19 @@ FTC_STATUS FT2232c::FTC_ResetUSBDevicePurgeUSBInputBuffer(FTC_HANDLE ftHandle)
 
 FTC_STATUS FT2232c::FTC_SetDeviceUSBBufferSizes(FTC_HANDLE ftHandle, DWORD InputBufferSize, DWORD OutputBufferSize)
 {
-  return FT_SetUSBParameters((FT_HANDLE)ftHandle, InputBufferSize, OutputBufferSize);
+  FTC_STATUS Status = FTC_INVALID_HANDLE;
+  PFTC_DEVICE_TRANSPORT_DATA pDeviceTransportData = NULL;
+
+  if ((pDeviceTransportData = FTC_GetDeviceTransportData(ftHandle)) != NULL)
+  {
+    Status = pDeviceTransportData->pTransport->SetUSBParameters(InputBufferSize, OutputBufferSize);
+
+    // Remember the out transfer size, so writes can be sized to match it
+    if (Status == FTC_SUCCESS)
+      pDeviceTransportData->dwUSBOutTransferSize = OutputBufferSize;
+  }
+
+  return Status;
 }
 
 FTC_STATUS FT2232c::FTC_SetDeviceSpecialCharacters(FTC_HANDLE ftHandle, BOOLEAN bEventEnabled, UCHAR EventCharacter,
@@ -589,42 +850,322 @@ FTC_STATUS FT2232c::FTC_SetDeviceSpecialCharacters(FTC_HANDLE ftHandle, BOOLEAN
  	UCHAR EventCharEnabled = UCHAR(bEventEnabled);
 	UCHAR ErrorCharEnabled = UCHAR(bErrorEnabled);
 
+  FTC_STATUS Status = FTC_INVALID_HANDLE;
+  FtcTransport *pTransport = NULL;
+
   // Set the special characters for the device. disable event and error characters
-  return FT_SetChars((FT_HANDLE)ftHandle, EventCharacter, EventCharEnabled, ErrorCharacter, ErrorCharEnabled);
+  if ((pTransport = FTC_GetDeviceTransport(ftHandle)) != NULL)
+    Status = pTransport->SetChars(EventCharacter, EventCharEnabled, ErrorCharacter, ErrorCharEnabled);
+
+  return Status;
 }
 
 FTC_STATUS FT2232c::FTC_SetReadWriteDeviceTimeouts(FTC_HANDLE ftHandle, DWORD dwReadTimeoutmSec, DWORD dwWriteTimeoutmSec)
 {
+  FTC_STATUS Status = FTC_INVALID_HANDLE;
+  FtcTransport *pTransport = NULL;
+
   // Sets the read and write timeouts in milli-seconds for the device
-  return FT_SetTimeouts((FT_HANDLE)ftHandle, dwReadTimeoutmSec, dwWriteTimeoutmSec);
+  if ((pTransport = FTC_GetDeviceTransport(ftHandle)) != NULL)
+    Status = pTransport->SetTimeouts(dwReadTimeoutmSec, dwWriteTimeoutmSec);
+
+  return Status;
 }
 
 FTC_STATUS FT2232c::FTC_SetDeviceLatencyTimer(FTC_HANDLE ftHandle, BYTE LatencyTimermSec)
 {
+  FTC_STATUS Status = FTC_INVALID_HANDLE;
+  FtcTransport *pTransport = NULL;
+
   // Set the device latency timer to a number of milliseconds
-  return FT_SetLatencyTimer((FT_HANDLE)ftHandle, LatencyTimermSec);
+  if ((pTransport = FTC_GetDeviceTransport(ftHandle)) != NULL)
+    Status = pTransport->SetLatencyTimer(LatencyTimermSec);
+
+  return Status;
 }
 
 FTC_STATUS FT2232c::FTC_GetDeviceLatencyTimer(FTC_HANDLE ftHandle, LPBYTE lpLatencyTimermSec)
 {
-  return FT_GetLatencyTimer((FT_HANDLE)ftHandle, lpLatencyTimermSec);
+  FTC_STATUS Status = FTC_INVALID_HANDLE;
+  FtcTransport *pTransport = NULL;
+
+  if ((pTransport = FTC_GetDeviceTransport(ftHandle)) != NULL)
+    Status = pTransport->GetLatencyTimer(lpLatencyTimermSec);
+
+  return Status;
+}
+
+FTC_STATUS FT2232c::FTC_SetDeviceTransferQueueDepth(FTC_HANDLE ftHandle, DWORD dwNumWriteTransfers, DWORD dwNumReadTransfers)
+{
+  FTC_STATUS Status = FTC_INVALID_HANDLE;
+  FtcTransport *pTransport = NULL;
+
+  if ((pTransport = FTC_GetDeviceTransport(ftHandle)) != NULL)
+  {
+    if ((dwNumWriteTransfers >= MIN_NUM_QUEUED_TRANSFERS) && (dwNumWriteTransfers <= MAX_NUM_QUEUED_TRANSFERS) &&
+        (dwNumReadTransfers >= MIN_NUM_QUEUED_TRANSFERS) && (dwNumReadTransfers <= MAX_NUM_QUEUED_TRANSFERS))
+      Status = pTransport->SetTransferQueueDepth(dwNumWriteTransfers, dwNumReadTransfers);
+    else
+      Status = FTC_INVALID_TRANSFER_QUEUE_DEPTH;
+  }
+
+  return Status;
+}
+
+FTC_STATUS FT2232c::FTC_GetDeviceTransferQueueDepth(FTC_HANDLE ftHandle, LPDWORD lpdwNumWriteTransfers, LPDWORD lpdwNumReadTransfers)
+{
+  FTC_STATUS Status = FTC_INVALID_HANDLE;
+  FtcTransport *pTransport = NULL;
+
+  if ((pTransport = FTC_GetDeviceTransport(ftHandle)) != NULL)
+    Status = pTransport->GetTransferQueueDepth(lpdwNumWriteTransfers, lpdwNumReadTransfers);
+
+  return Status;
+}
+
+FTC_STATUS FT2232c::FTC_SetDeviceWaitPolicy(FTC_HANDLE ftHandle, DWORD dwWaitPolicy, DWORD dwSpinPeriodMicroSecs)
+{
+  FTC_STATUS Status = FTC_SUCCESS;
+  PFTC_DEVICE_TRANSPORT_DATA pDeviceTransportData = NULL;
+
+  if ((pDeviceTransportData = FTC_GetDeviceTransportData(ftHandle)) != NULL)
+  {
+    if ((dwWaitPolicy == FTC_WAIT_POLICY_SPIN) || (dwWaitPolicy == FTC_WAIT_POLICY_BLOCK) || (dwWaitPolicy == FTC_WAIT_POLICY_HYBRID))
+    {
+      if (dwSpinPeriodMicroSecs <= MAX_WAIT_POLICY_SPIN_PERIOD)
+      {
+        pDeviceTransportData->dwWaitPolicy = dwWaitPolicy;
+        pDeviceTransportData->dwSpinPeriodMicroSecs = dwSpinPeriodMicroSecs;
+      }
+      else
+        Status = FTC_INVALID_SPIN_PERIOD;
+    }
+    else
+      Status = FTC_INVALID_WAIT_POLICY;
+  }
+  else
+    Status = FTC_INVALID_HANDLE;
+
+  return Status;
+}
+
+FTC_STATUS FT2232c::FTC_GetDeviceWaitPolicy(FTC_HANDLE ftHandle, LPDWORD lpdwWaitPolicy, LPDWORD lpdwSpinPeriodMicroSecs)
+{
+  FTC_STATUS Status = FTC_SUCCESS;
+  PFTC_DEVICE_TRANSPORT_DATA pDeviceTransportData = NULL;
+
+  if ((pDeviceTransportData = FTC_GetDeviceTransportData(ftHandle)) != NULL)
+  {
+    *lpdwWaitPolicy = pDeviceTransportData->dwWaitPolicy;
+    *lpdwSpinPeriodMicroSecs = pDeviceTransportData->dwSpinPeriodMicroSecs;
+  }
+  else
+    Status = FTC_INVALID_HANDLE;
+
+  return Status;
+}
+
+FTC_STATUS FT2232c::FTC_SetDeviceUSBTransferChunkSize(FTC_HANDLE ftHandle, DWORD dwUSBTransferChunkSize)
+{
+  FTC_STATUS Status = FTC_SUCCESS;
+  PFTC_DEVICE_TRANSPORT_DATA pDeviceTransportData = NULL;
+
+  if ((pDeviceTransportData = FTC_GetDeviceTransportData(ftHandle)) != NULL)
+  {
+    if ((dwUSBTransferChunkSize == FTC_USB_TRANSFER_CHUNK_SIZE_AUTO) ||
+        ((dwUSBTransferChunkSize >= MIN_USB_TRANSFER_CHUNK_SIZE) && (dwUSBTransferChunkSize <= MAX_USB_TRANSFER_CHUNK_SIZE)))
+      pDeviceTransportData->dwUSBTransferChunkSize = dwUSBTransferChunkSize;
+    else
+      Status = FTC_INVALID_USB_TRANSFER_CHUNK_SIZE;
+  }
+  else
+    Status = FTC_INVALID_HANDLE;
+
+  return Status;
+}
+
+FTC_STATUS FT2232c::FTC_GetDeviceUSBTransferChunkSize(FTC_HANDLE ftHandle, LPDWORD lpdwUSBTransferChunkSize)
+{
+  FTC_STATUS Status = FTC_SUCCESS;
+
+  // Returns the chunk size actually used for writes, which is the automatically chosen size when no chunk size is set
+  if (FTC_GetDeviceTransportData(ftHandle) != NULL)
+    *lpdwUSBTransferChunkSize = FTC_GetUSBTransferChunkSize(ftHandle);
+  else
+    Status = FTC_INVALID_HANDLE;
+
+  return Status;
+}
+
+FTC_STATUS FT2232c::FTC_SetDeviceCommandTimeout(FTC_HANDLE ftHandle, DWORD dwCommandTimeoutmSec)
+{
+  FTC_STATUS Status = FTC_SUCCESS;
+  PFTC_DEVICE_TRANSPORT_DATA pDeviceTransportData = NULL;
+
+  if ((pDeviceTransportData = FTC_GetDeviceTransportData(ftHandle)) != NULL)
+  {
+    if ((dwCommandTimeoutmSec >= MIN_COMMAND_TIMEOUT_PERIOD) && (dwCommandTimeoutmSec <= MAX_COMMAND_TIMEOUT_PERIOD))
+      pDeviceTransportData->dwCommandTimeoutmSec = dwCommandTimeoutmSec;
+    else
+      Status = FTC_INVALID_COMMAND_TIMEOUT;
+  }
+  else
+    Status = FTC_INVALID_HANDLE;
+
+  return Status;
+}
+
+FTC_STATUS FT2232c::FTC_GetDeviceCommandTimeout(FTC_HANDLE ftHandle, LPDWORD lpdwCommandTimeoutmSec)
+{
+  FTC_STATUS Status = FTC_SUCCESS;
+  PFTC_DEVICE_TRANSPORT_DATA pDeviceTransportData = NULL;
+
+  if ((pDeviceTransportData = FTC_GetDeviceTransportData(ftHandle)) != NULL)
+    *lpdwCommandTimeoutmSec = pDeviceTransportData->dwCommandTimeoutmSec;
+  else
+    Status = FTC_INVALID_HANDLE;
+
+  return Status;
+}
+
+FTC_STATUS FT2232c::FTC_SetDeviceIOThread(FTC_HANDLE ftHandle, BOOL bIOThreadEnabled)
+{
+  FTC_STATUS Status = FTC_SUCCESS;
+  PFTC_DEVICE_TRANSPORT_DATA pDeviceTransportData = NULL;
+  FtcIoThreadTransport *pIoThreadTransport = NULL;
+
+  if ((pDeviceTransportData = FTC_GetDeviceTransportData(ftHandle)) != NULL)
+  {
+    if (bIOThreadEnabled && (pDeviceTransportData->pIoThreadTransport == NULL))
+    {
+      // The device transport is wrapped by an I/O thread transport, which every later request goes through
+      if ((pIoThreadTransport = new FtcIoThreadTransport(pDeviceTransportData->pTransport)) != NULL)
+      {
+        if ((Status = pIoThreadTransport->Start()) == FTC_SUCCESS)
+        {
+          pDeviceTransportData->pTransport = pIoThreadTransport;
+          pDeviceTransportData->pIoThreadTransport = pIoThreadTransport;
+        }
+        else
+        {
+          pIoThreadTransport->Detach();
+
+          delete pIoThreadTransport;
+        }
+      }
+      else
+        Status = FTC_INSUFFICIENT_RESOURCES;
+    }
+    else if (!bIOThreadEnabled && (pDeviceTransportData->pIoThreadTransport != NULL))
+    {
+      // Waits for the I/O thread to write every batch already submitted before the device transport is used directly
+      pDeviceTransportData->pTransport = pDeviceTransportData->pIoThreadTransport->Detach();
+
+      delete pDeviceTransportData->pIoThreadTransport;
+
+      pDeviceTransportData->pIoThreadTransport = NULL;
+    }
+  }
+  else
+    Status = FTC_INVALID_HANDLE;
+
+  return Status;
+}
+
+FTC_STATUS FT2232c::FTC_GetDeviceIOThread(FTC_HANDLE ftHandle, LPBOOL lpbIOThreadEnabled)
+{
+  FTC_STATUS Status = FTC_SUCCESS;
+  PFTC_DEVICE_TRANSPORT_DATA pDeviceTransportData = NULL;
+
+  if ((pDeviceTransportData = FTC_GetDeviceTransportData(ftHandle)) != NULL)
+    *lpbIOThreadEnabled = (pDeviceTransportData->pIoThreadTransport != NULL);
+  else
+    Status = FTC_INVALID_HANDLE;
+
+  return Status;
+}
+
+BOOL FT2232c::FTC_StartDeviceCommandDeadline(FTC_HANDLE ftHandle)
+{
+  BOOL bDeadlineStarted = FALSE;
+  PFTC_DEVICE_TRANSPORT_DATA pDeviceTransportData = NULL;
+
+  // A function that waits for the device to reply is given the whole command timeout to complete, however many
+  // commands it writes and however many waits it makes. Only the outermost function starts the deadline, TRUE is
+  // returned to it and it must end the deadline before it returns, every wait made in between shares the deadline.
+  if ((pDeviceTransportData = FTC_GetDeviceTransportData(ftHandle)) != NULL)
+  {
+    if (pDeviceTransportData->ulCommandDeadlineMicroSecs == 0)
+    {
+      pDeviceTransportData->ulCommandDeadlineMicroSecs = (FTC_GetMonotonicMicroSecs() + ((ULONGLONG)pDeviceTransportData->dwCommandTimeoutmSec * 1000));
+
+      bDeadlineStarted = TRUE;
+    }
+  }
+
+  return bDeadlineStarted;
+}
+
+void FT2232c::FTC_EndDeviceCommandDeadline(FTC_HANDLE ftHandle)
+{
+  PFTC_DEVICE_TRANSPORT_DATA pDeviceTransportData = NULL;
+
+  if ((pDeviceTransportData = FTC_GetDeviceTransportData(ftHandle)) != NULL)
+    pDeviceTransportData->ulCommandDeadlineMicroSecs = 0;
+}
+
+DWORD FT2232c::FTC_GetUSBTransferChunkSize(FTC_HANDLE ftHandle)
+{
+  DWORD dwUSBTransferChunkSize = DEFAULT_USB_TRANSFER_SIZE;
+  PFTC_DEVICE_TRANSPORT_DATA pDeviceTransportData = NULL;
+
+  if ((pDeviceTransportData = FTC_GetDeviceTransportData(ftHandle)) != NULL)
+  {
+    // By default every write is as large as the out transfer size negotiated with the device, so a write is never
+    // split into more USB transfers than it needs
+    if (pDeviceTransportData->dwUSBTransferChunkSize != FTC_USB_TRANSFER_CHUNK_SIZE_AUTO)
+      dwUSBTransferChunkSize = pDeviceTransportData->dwUSBTransferChunkSize;
+    else
+      dwUSBTransferChunkSize = pDeviceTransportData->dwUSBOutTransferSize;
+
+    if (dwUSBTransferChunkSize > pDeviceTransportData->pTransport->GetMaxWriteTransferSize())
+      dwUSBTransferChunkSize = pDeviceTransportData->pTransport->GetMaxWriteTransferSize();
+
+    if (dwUSBTransferChunkSize < MIN_USB_TRANSFER_CHUNK_SIZE)
+      dwUSBTransferChunkSize = MIN_USB_TRANSFER_CHUNK_SIZE;
+  }
+
+  return dwUSBTransferChunkSize;
 }
 
 FTC_STATUS FT2232c::FTC_ResetMPSSEInterface(FTC_HANDLE ftHandle)
 {
-  return FT_SetBitMode((FT_HANDLE)ftHandle, MPSSE_INTERFACE_MASK, RESET_MPSSE_INTERFACE);
+  FTC_STATUS Status = FTC_INVALID_HANDLE;
+  FtcTransport *pTransport = NULL;
+
+  if ((pTransport = FTC_GetDeviceTransport(ftHandle)) != NULL)
+    Status = pTransport->SetBitMode(MPSSE_INTERFACE_MASK, RESET_MPSSE_INTERFACE);
+
+  return Status;
 }
 
 FTC_STATUS FT2232c::FTC_EnableMPSSEInterface(FTC_HANDLE ftHandle)
 {
-  return FT_SetBitMode((FT_HANDLE)ftHandle, MPSSE_INTERFACE_MASK, ENABLE_MPSSE_INTERFACE);
+  FTC_STATUS Status = FTC_INVALID_HANDLE;
+  FtcTransport *pTransport = NULL;
+
+  if ((pTransport = FTC_GetDeviceTransport(ftHandle)) != NULL)
+    Status = pTransport->SetBitMode(MPSSE_INTERFACE_MASK, ENABLE_MPSSE_INTERFACE);
+
+  return Status;
 }
 
 FTC_STATUS FT2232c::FTC_SendReceiveCommandFromMPSSEInterface(FTC_HANDLE ftHandle, BOOLEAN bSendEchoCommandContinuouslyOnce, BYTE EchoCommand, LPBOOL lpbCommandEchod)
 {
   FTC_STATUS Status = FTC_SUCCESS;
   DWORD dwNumBytesDeviceInputBuffer = 0;
-  SYSTEMTIME StartTime;
+  ULONGLONG ulDeadlineMicroSecs = 0;
+  DWORD dwCommandTimeoutmSec = DEFAULT_COMMAND_TIMEOUT_PERIOD;
   InputByteBuffer InputBuffer;
   DWORD dwNumBytesRead = 0;
   DWORD dwByteCntr = 0;
@@ -639,7 +1180,11 @@ FTC_STATUS FT2232c::FTC_SendReceiveCommandFromMPSSEInterface(FTC_HANDLE ftHandle
     FTC_SendBytesToDevice(ftHandle);
   }
 
-  GetLocalTime(&StartTime);
+  // The echo command may be sent many times, so the whole exchange is timed against its own deadline rather than
+  // the deadline of each command sent
+  FTC_GetDeviceCommandTimeout(ftHandle, &dwCommandTimeoutmSec);
+
+  ulDeadlineMicroSecs = (FTC_GetMonotonicMicroSecs() + ((ULONGLONG)dwCommandTimeoutmSec * 1000));
 
   do
   {
@@ -652,12 +1197,12 @@ FTC_STATUS FT2232c::FTC_SendReceiveCommandFromMPSSEInterface(FTC_HANDLE ftHandle
     }
 
     // Get the number of bytes in the device input buffer
-    Status = FT_GetQueueStatus((FT_HANDLE)ftHandle, &dwNumBytesDeviceInputBuffer);
+    Status = FTC_GetDeviceQueueStatus(ftHandle, &dwNumBytesDeviceInputBuffer);
 
     if (Status == FTC_SUCCESS)
     {
       Sleep(1); // kra - 21/05/08, modified from Sleep(0);
-      if (FTC_Timeout(StartTime, MAX_COMMAND_TIMEOUT_PERIOD))
+      if (FTC_GetMonotonicMicroSecs() >= ulDeadlineMicroSecs)
         Status = FTC_FAILED_TO_COMPLETE_COMMAND;
     }
 
@@ -710,7 +1255,7 @@ FTC_STATUS FT2232c::FTC_SynchronizeMPSSEInterface(FTC_HANDLE ftHandle)
   BOOL bCommandEchod = false;
 
   // Get the number of bytes in the device input buffer
-  Status = FT_GetQueueStatus((FT_HANDLE)ftHandle, &dwNumBytesDeviceInputBuffer);
+  Status = FTC_GetDeviceQueueStatus(ftHandle, &dwNumBytesDeviceInputBuffer);
 
   if (Status == FTC_SUCCESS)
   {
@@ -739,124 +1284,229 @@ FTC_STATUS FT2232c::FTC_SynchronizeMPSSEInterface(FTC_HANDLE ftHandle)
   return Status;
 }
 
-BOOLEAN FT2232c::FTC_Timeout(SYSTEMTIME StartSystemTime, DWORD dwTimeoutmSecs)
+FTC_STATUS FT2232c::FTC_GetNumberBytesFromDeviceInputBuffer(FTC_HANDLE ftHandle, LPDWORD lpdwNumBytesDeviceInputBuffer)
 {
-  BOOLEAN bTimoutExpired = false;
-#ifdef _WIN32
-  FILETIME StartFileTime;
-  ULARGE_INTEGER StartTime;
-  SYSTEMTIME EndSystemTime;
-  FILETIME EndFileTime;
-  ULARGE_INTEGER EndTime;
-  ULONGLONG ulTimeoutmSecs = dwTimeoutmSecs * CONVERT_1MS_TO_100NS; //10000;
+  return FTC_WaitForDeviceInputBytes(ftHandle, 1, lpdwNumBytesDeviceInputBuffer);
+}
 
-  GetLocalTime(&EndSystemTime);
+FTC_STATUS FT2232c::FTC_WaitForDeviceInputBytes(FTC_HANDLE ftHandle, DWORD dwNumBytesExpected, LPDWORD lpdwNumBytesDeviceInputBuffer)
+{
+  FTC_STATUS Status = FTC_SUCCESS;
+  PFTC_DEVICE_TRANSPORT_DATA pDeviceTransportData = NULL;
+  ULONGLONG ulStartMicroSecs = FTC_GetMonotonicMicroSecs();
+  ULONGLONG ulNowMicroSecs = ulStartMicroSecs;
+  BOOLEAN bBlock = false;
+  BOOL bDeadlineStarted = FALSE;
 
-  SystemTimeToFileTime(&StartSystemTime, &StartFileTime);
+  *lpdwNumBytesDeviceInputBuffer = 0;
 
-  StartTime.LowPart = StartFileTime.dwLowDateTime;
-  StartTime.HighPart = StartFileTime.dwHighDateTime;
+  if ((pDeviceTransportData = FTC_GetDeviceTransportData(ftHandle)) != NULL)
+  {
+    // A wait that is not made by a function which has started the command deadline is given the whole command timeout
+    bDeadlineStarted = FTC_StartDeviceCommandDeadline(ftHandle);
 
-  SystemTimeToFileTime(&EndSystemTime, &EndFileTime);
+    do
+    {
+      if (bBlock)
+        // Sleep in the transport until the expected number of bytes has been received or the command deadline passes,
+        // rounding up so the transport does not return just before the deadline
+        Status = pDeviceTransportData->pTransport->WaitForBytes(dwNumBytesExpected,
+                                                                 (DWORD)(((pDeviceTransportData->ulCommandDeadlineMicroSecs - ulNowMicroSecs) + 999) / 1000),
+                                                                 lpdwNumBytesDeviceInputBuffer);
+      else
+        // Get the number of bytes in the device input buffer
+        Status = pDeviceTransportData->pTransport->GetQueueStatus(lpdwNumBytesDeviceInputBuffer);
 
-  EndTime.LowPart = EndFileTime.dwLowDateTime;
-  EndTime.HighPart = EndFileTime.dwHighDateTime;
+      if ((Status == FTC_SUCCESS) && (*lpdwNumBytesDeviceInputBuffer < dwNumBytesExpected))
+      {
+        ulNowMicroSecs = FTC_GetMonotonicMicroSecs();
 
-  if ((EndTime.QuadPart - StartTime.QuadPart) > ulTimeoutmSecs)
-    bTimoutExpired = true;
-#else
-  struct timeval endSystemTime;
-  gettimeofday( &endSystemTime, NULL );
+        if (ulNowMicroSecs >= pDeviceTransportData->ulCommandDeadlineMicroSecs)
+        {
+          // Cancel the transfers queued for a device that has stopped responding and discard whatever it did send, so
+          // the device can be reused as soon as this call returns instead of the stalled transfers timing out first
+          pDeviceTransportData->pTransport->Purge();
 
-  int64_t elapsedTimeUs = (endSystemTime.tv_sec - StartSystemTime.tv_sec) * 1000 * 1000;
-  elapsedTimeUs += (endSystemTime.tv_usec - StartSystemTime.tv_usec);
+          pDeviceTransportData->ulCommandDeadlineMicroSecs = 0;
 
-  bTimoutExpired = elapsedTimeUs > (dwTimeoutmSecs * 1000);
-#endif
+          Status = FTC_FAILED_TO_COMPLETE_COMMAND;
+        }
+        else
+        {
+          switch (pDeviceTransportData->dwWaitPolicy)
+          {
+            case FTC_WAIT_POLICY_BLOCK:
+              bBlock = true;
+            break;
+            case FTC_WAIT_POLICY_HYBRID:
+              // Poll while the bytes are likely to arrive within the spin period, then stop burning the processor
+              if ((ulNowMicroSecs - ulStartMicroSecs) >= pDeviceTransportData->dwSpinPeriodMicroSecs)
+                bBlock = true;
+              else
+                Sleep(0);  // give up timeslice
+            break;
+            default:
+              Sleep(0);  // give up timeslice
+            break;
+          }
+        }
+      }
+    }
+    while ((*lpdwNumBytesDeviceInputBuffer < dwNumBytesExpected) && (Status == FTC_SUCCESS));
+
+    if (bDeadlineStarted)
+      FTC_EndDeviceCommandDeadline(ftHandle);
+  }
+  else
+    Status = FTC_INVALID_HANDLE;
 
-  return bTimoutExpired;
+  return Status;
 }
 
-FTC_STATUS FT2232c::FTC_GetNumberBytesFromDeviceInputBuffer(FTC_HANDLE ftHandle, LPDWORD lpdwNumBytesDeviceInputBuffer)
+FTC_STATUS FT2232c::FTC_PollDeviceInputBytes(FTC_HANDLE ftHandle, DWORD dwNumBytesExpected, LPDWORD lpdwNumBytesDeviceInputBuffer)
 {
+  // This function gets the number of bytes in the device input buffer without waiting for any more. It fails the
+  // same way as FTC_WaitForDeviceInputBytes, once the command deadline has passed without the expected number of
+  // bytes being received, so a caller that polls a device which has stopped responding is not left polling forever.
   FTC_STATUS Status = FTC_SUCCESS;
-  SYSTEMTIME StartTime;
+  PFTC_DEVICE_TRANSPORT_DATA pDeviceTransportData = NULL;
 
-  GetLocalTime(&StartTime);
+  *lpdwNumBytesDeviceInputBuffer = 0;
 
-  do
+  if ((pDeviceTransportData = FTC_GetDeviceTransportData(ftHandle)) != NULL)
   {
-    // Get the number of bytes in the device input buffer
-    Status = FT_GetQueueStatus((FT_HANDLE)ftHandle, lpdwNumBytesDeviceInputBuffer);
+    Status = pDeviceTransportData->pTransport->GetQueueStatus(lpdwNumBytesDeviceInputBuffer);
 
-    if (Status == FTC_SUCCESS)
+    if ((Status == FTC_SUCCESS) && (*lpdwNumBytesDeviceInputBuffer < dwNumBytesExpected) &&
+        (pDeviceTransportData->ulCommandDeadlineMicroSecs != 0) &&
+        (FTC_GetMonotonicMicroSecs() >= pDeviceTransportData->ulCommandDeadlineMicroSecs))
     {
-      Sleep(0);  // give up timeslice
-      if (FTC_Timeout(StartTime, MAX_COMMAND_TIMEOUT_PERIOD))
-        Status = FTC_FAILED_TO_COMPLETE_COMMAND;
+      pDeviceTransportData->pTransport->Purge();
+
+      pDeviceTransportData->ulCommandDeadlineMicroSecs = 0;
+
+      Status = FTC_FAILED_TO_COMPLETE_COMMAND;
     }
   }
-  while ((*lpdwNumBytesDeviceInputBuffer == 0) && (Status == FTC_SUCCESS));
- 
+  else
+    Status = FTC_INVALID_HANDLE;
+
+  return Status;
+}
+
+FTC_STATUS FT2232c::FTC_PurgeDevice(FTC_HANDLE ftHandle)
+{
+  FTC_STATUS Status = FTC_INVALID_HANDLE;
+  PFTC_DEVICE_TRANSPORT_DATA pDeviceTransportData = NULL;
+
+  // Cancels the transfers queued for the device and discards the bytes it has sent, that have not been read yet
+  if ((pDeviceTransportData = FTC_GetDeviceTransportData(ftHandle)) != NULL)
+  {
+    Status = pDeviceTransportData->pTransport->Purge();
+
+    pDeviceTransportData->ulCommandDeadlineMicroSecs = 0;
+  }
+
   return Status;
 }
 
 void FT2232c::FTC_ClearOutputBuffer(void)
 {
   dwNumBytesToSend = 0;
+  dwNumOutputDataReferences = 0;
+  dwNumReferencedBytesToSend = 0;
 }
 
 void FT2232c::FTC_AddByteToOutputBuffer(DWORD dwOutputByte, BOOL bClearOutputBuffer)
 {
   if (bClearOutputBuffer == TRUE)
-    dwNumBytesToSend = 0;
+    FTC_ClearOutputBuffer();
 
   OutputBuffer[dwNumBytesToSend] = (dwOutputByte & '\xFF');
 
   dwNumBytesToSend = dwNumBytesToSend + 1;
 }
 
+void FT2232c::FTC_AddDataBytesToOutputBuffer(LPBYTE pDataBytes, DWORD dwNumDataBytes)
+{
+  PFTC_OUTPUT_DATA_REFERENCE pOutputDataReference = NULL;
+
+  // A large data block is not copied into the output buffer, only a reference to it is kept so that it is written to
+  // the device straight from the caller's buffer, after the output buffer bytes added ahead of it
+  if ((dwNumDataBytes >= MIN_NUM_OUTPUT_DATA_REFERENCE_BYTES) && (dwNumOutputDataReferences < MAX_NUM_OUTPUT_DATA_REFERENCES))
+  {
+    pOutputDataReference = &OutputDataReferences[dwNumOutputDataReferences];
+
+    pOutputDataReference->dwOutputBufferIndex = dwNumBytesToSend;
+    pOutputDataReference->pDataBytes = pDataBytes;
+    pOutputDataReference->dwNumDataBytes = dwNumDataBytes;
+
+    dwNumOutputDataReferences = (dwNumOutputDataReferences + 1);
+    dwNumReferencedBytesToSend = (dwNumReferencedBytesToSend + dwNumDataBytes);
+  }
+  else
+  {
+    memcpy(&OutputBuffer[dwNumBytesToSend], pDataBytes, dwNumDataBytes);
+
+    dwNumBytesToSend = (dwNumBytesToSend + dwNumDataBytes);
+  }
+}
+
+LPBYTE FT2232c::FTC_GetOutputBufferEnd(void)
+{
+  // Returns where the next bytes are to be written in the output buffer, so a command and its parameters or a block
+  // of data bytes can be written in one go. The bytes written are only added to the output buffer by
+  // FTC_CommitOutputBufferBytes, nothing else may be added to the output buffer in between
+  return &OutputBuffer[dwNumBytesToSend];
+}
+
+void FT2232c::FTC_CommitOutputBufferBytes(DWORD dwNumBytes)
+{
+  dwNumBytesToSend = (dwNumBytesToSend + dwNumBytes);
+}
+
 DWORD FT2232c::FTC_GetNumBytesInOutputBuffer(void)
 {
-  return dwNumBytesToSend;
+  // Includes the bytes of the data blocks that are referenced rather than copied
+  return (dwNumBytesToSend + dwNumReferencedBytesToSend);
 }
 
 FTC_STATUS FT2232c::FTC_SendBytesToDevice(FTC_HANDLE ftHandle)
 {
   FTC_STATUS Status = FTC_SUCCESS;
+  DWORD dwUSBTransferChunkSize = FTC_GetUSBTransferChunkSize(ftHandle);
+  DWORD dwTotalNumBytesToSend = FTC_GetNumBytesInOutputBuffer();
   DWORD dwNumDataBytesToSend = 0;
   DWORD dwNumBytesSent = 0;
   DWORD dwTotalNumBytesSent = 0;
 
-  if (dwNumBytesToSend > MAX_NUM_BYTES_USB_WRITE)
+  if (dwTotalNumBytesToSend > dwUSBTransferChunkSize)
   {
     do
     {
-      // 25/08/05 - Can only use 4096 byte block as Windows 2000 Professional does not allow you to alter the USB buffer size
-      // 25/08/05 - Windows 2000 Professional always sets the USB buffer size to 4K ie 4096
-      if ((dwTotalNumBytesSent + MAX_NUM_BYTES_USB_WRITE) <= dwNumBytesToSend)
-        dwNumDataBytesToSend = MAX_NUM_BYTES_USB_WRITE;
+      if ((dwTotalNumBytesSent + dwUSBTransferChunkSize) <= dwTotalNumBytesToSend)
+        dwNumDataBytesToSend = dwUSBTransferChunkSize;
       else
-        dwNumDataBytesToSend = (dwNumBytesToSend - dwTotalNumBytesSent);
+        dwNumDataBytesToSend = (dwTotalNumBytesToSend - dwTotalNumBytesSent);
 
       // This function sends data to a FT2232C dual type device. The dwNumBytesToSend variable specifies the number of
       // bytes in the output buffer to be sent to a FT2232C dual type device. The dwNumBytesSent variable contains
       // the actual number of bytes sent to a FT2232C dual type device.
-      Status = FT_Write((FT_HANDLE)ftHandle, &OutputBuffer[dwTotalNumBytesSent], dwNumDataBytesToSend, &dwNumBytesSent);
+      Status = FTC_WriteOutputBytesToDevice(ftHandle, dwTotalNumBytesSent, dwNumDataBytesToSend, &dwNumBytesSent);
 
       dwTotalNumBytesSent = dwTotalNumBytesSent + dwNumBytesSent;
     }
-    while ((dwTotalNumBytesSent < dwNumBytesToSend) && (Status == FTC_SUCCESS)); 
+    while ((dwTotalNumBytesSent < dwTotalNumBytesToSend) && (Status == FTC_SUCCESS)); 
   }
   else
   {
     // This function sends data to a FT2232C dual type device. The dwNumBytesToSend variable specifies the number of
     // bytes in the output buffer to be sent to a FT2232C dual type device. The dwNumBytesSent variable contains
     // the actual number of bytes sent to a FT2232C dual type device.
-    Status = FT_Write((FT_HANDLE)ftHandle, OutputBuffer, dwNumBytesToSend, &dwNumBytesSent);
+    Status = FTC_WriteOutputBytesToDevice(ftHandle, 0, dwTotalNumBytesToSend, &dwNumBytesSent);
   }
 
-  dwNumBytesToSend = 0;
+  FTC_ClearOutputBuffer();
 
   return Status;
 }
@@ -869,93 +1519,141 @@ FTC_STATUS FT2232c::FTC_ReadBytesFromDevice(FTC_HANDLE ftHandle, PInputByteBuffe
   // number of bytes read from a FT2232C dual type device, which may range from zero to the actual number of bytes
   // requested, depending on how many have been received at the time of the request + the read timeout value.
   // The bytes read from a FT2232C dual type device, will be returned in the input buffer.
-  return FT_Read((FT_HANDLE)ftHandle, InputBuffer, dwNumBytesToRead, lpdwNumBytesRead);
+  FTC_STATUS Status = FTC_INVALID_HANDLE;
+  FtcTransport *pTransport = NULL;
+
+  if ((pTransport = FTC_GetDeviceTransport(ftHandle)) != NULL)
+    Status = pTransport->Read(*InputBuffer, dwNumBytesToRead, lpdwNumBytesRead);
+
+  return Status;
 }
 
-FTC_STATUS FT2232c::FTC_ReadFixedNumBytesFromDevice(FTC_HANDLE ftHandle, PInputByteBuffer InputBuffer,
+FTC_STATUS FT2232c::FTC_ReadFixedNumBytesFromDevice(FTC_HANDLE ftHandle, LPBYTE pInputBuffer,
                                                     DWORD dwNumBytesToRead, LPDWORD lpdwNumDataBytesRead)
 {
-  FTC_STATUS Status = FTC_SUCCESS;
+  // This function reads until the input buffer holds dwNumBytesToRead bytes. The lpdwNumDataBytesRead variable
+  // contains the number of bytes already in the input buffer on entry and the total number of bytes in the input
+  // buffer on return. Each read from the device lands directly at its final offset in the input buffer and never
+  // asks for more bytes than are still outstanding, so the input buffer can be the caller's own data buffer.
+  FTC_STATUS Status = FTC_INVALID_HANDLE;
+  FtcTransport *pTransport = NULL;
   DWORD dwNumBytesDeviceInputBuffer = 0;
-  InputByteBuffer TmpInputByteBuffer;
   DWORD dwNumBytesRead = 0;
-  DWORD dwBytesReadIndex = 0;
+  BOOL bDeadlineStarted = FALSE;
 
-  do
+  if ((pTransport = FTC_GetDeviceTransport(ftHandle)) != NULL)
   {
-    Status = FTC_GetNumberBytesFromDeviceInputBuffer(ftHandle, &dwNumBytesDeviceInputBuffer);
+    Status = FTC_SUCCESS;
+
+    bDeadlineStarted = FTC_StartDeviceCommandDeadline(ftHandle);
 
-    if ((Status == FTC_SUCCESS) && (dwNumBytesDeviceInputBuffer > 0))
+    while ((*lpdwNumDataBytesRead < dwNumBytesToRead) && (Status == FTC_SUCCESS))
     {
-      Status = FTC_ReadBytesFromDevice(ftHandle, &TmpInputByteBuffer, dwNumBytesDeviceInputBuffer, &dwNumBytesRead);
+      Status = FTC_WaitForDeviceInputBytes(ftHandle, (dwNumBytesToRead - *lpdwNumDataBytesRead), &dwNumBytesDeviceInputBuffer);
 
-      if (Status == FTC_SUCCESS)
+      if ((Status == FTC_SUCCESS) && (dwNumBytesDeviceInputBuffer > 0))
       {
-        for (dwBytesReadIndex = 0 ; dwBytesReadIndex < dwNumBytesRead; dwBytesReadIndex++)
-        {
-          (*InputBuffer)[*lpdwNumDataBytesRead] = TmpInputByteBuffer[dwBytesReadIndex];
-          *lpdwNumDataBytesRead = (*lpdwNumDataBytesRead + 1);
-        }
+        if (dwNumBytesDeviceInputBuffer > (dwNumBytesToRead - *lpdwNumDataBytesRead))
+          dwNumBytesDeviceInputBuffer = (dwNumBytesToRead - *lpdwNumDataBytesRead);
+
+        Status = pTransport->Read(&pInputBuffer[*lpdwNumDataBytesRead], dwNumBytesDeviceInputBuffer, &dwNumBytesRead);
+
+        if (Status == FTC_SUCCESS)
+          *lpdwNumDataBytesRead = (*lpdwNumDataBytesRead + dwNumBytesRead);
       }
     }
+
+    if (bDeadlineStarted)
+      FTC_EndDeviceCommandDeadline(ftHandle);
   }
-  while ((*lpdwNumDataBytesRead < dwNumBytesToRead) && (Status == FTC_SUCCESS));
 
   return Status;
 }
 
-FTC_STATUS FT2232c::FTC_SendReadBytesToFromDevice(FTC_HANDLE ftHandle, PInputByteBuffer InputBuffer,
-                                                  DWORD dwNumBytesToRead, LPDWORD lpdwNumBytesRead)
+FTC_STATUS FT2232c::FTC_ReadAvailableBytesFromDevice(FTC_HANDLE ftHandle, LPBYTE pInputBuffer,
+                                                     DWORD dwNumBytesToRead, LPDWORD lpdwNumDataBytesRead)
 {
-  FTC_STATUS Status = FTC_SUCCESS;
-  DWORD dwNumBytesSent = 0;
-  DWORD dwNumControlSendBytes = 0;
-  DWORD dwNumDataBytesRead = 0;
+  // This function reads the bytes that have already been received from the device, up to the number of bytes still
+  // outstanding, without waiting for any more. The lpdwNumDataBytesRead variable is used the same way as by
+  // FTC_ReadFixedNumBytesFromDevice.
+  FTC_STATUS Status = FTC_INVALID_HANDLE;
+  FtcTransport *pTransport = NULL;
+  DWORD dwNumBytesDeviceInputBuffer = 0;
+  DWORD dwNumBytesRead = 0;
 
-  if (dwNumBytesToSend > MAX_NUM_BYTES_USB_WRITE_READ)
+  if ((pTransport = FTC_GetDeviceTransport(ftHandle)) != NULL)
   {
-    // This function sends data to a FT2232C dual type device. The dwNumBytesToSend variable specifies the number of
-    // bytes in the output buffer to be sent to a FT2232C dual type device. The dwNumBytesSent variable contains
-    // the actual number of bytes sent to a FT2232C dual type device.
-    Status = FT_Write((FT_HANDLE)ftHandle, OutputBuffer, MAX_NUM_BYTES_USB_WRITE_READ, &dwNumBytesSent);
+    Status = FTC_SUCCESS;
 
-    if (Status == FTC_SUCCESS)
+    if (*lpdwNumDataBytesRead < dwNumBytesToRead)
     {
-      dwNumControlSendBytes = (dwNumBytesToSend - dwNumBytesToRead);
-
-      Status = FTC_ReadFixedNumBytesFromDevice(ftHandle, InputBuffer, (MAX_NUM_BYTES_USB_WRITE_READ - dwNumControlSendBytes), &dwNumDataBytesRead);
+      Status = pTransport->GetQueueStatus(&dwNumBytesDeviceInputBuffer);
 
-      if (Status == FTC_SUCCESS)
+      if ((Status == FTC_SUCCESS) && (dwNumBytesDeviceInputBuffer > 0))
       {
-        Status = FT_Write((FT_HANDLE)ftHandle, &OutputBuffer[dwNumBytesSent], (dwNumBytesToSend - dwNumBytesSent), &dwNumBytesSent);
+        if (dwNumBytesDeviceInputBuffer > (dwNumBytesToRead - *lpdwNumDataBytesRead))
+          dwNumBytesDeviceInputBuffer = (dwNumBytesToRead - *lpdwNumDataBytesRead);
 
-        if (Status == FTC_SUCCESS)
-        {
-          Status = FTC_ReadFixedNumBytesFromDevice(ftHandle, InputBuffer, (dwNumBytesToRead - dwNumDataBytesRead), &dwNumDataBytesRead);
+        Status = pTransport->Read(&pInputBuffer[*lpdwNumDataBytesRead], dwNumBytesDeviceInputBuffer, &dwNumBytesRead);
 
-          if (Status == FTC_SUCCESS)
-            *lpdwNumBytesRead = dwNumDataBytesRead;
-        }
+        if (Status == FTC_SUCCESS)
+          *lpdwNumDataBytesRead = (*lpdwNumDataBytesRead + dwNumBytesRead);
       }
     }
   }
-  else
+
+  return Status;
+}
+
+FTC_STATUS FT2232c::FTC_SendReadBytesToFromDevice(FTC_HANDLE ftHandle, LPBYTE pInputBuffer,
+                                                  DWORD dwNumBytesToRead, LPDWORD lpdwNumBytesRead)
+{
+  FTC_STATUS Status = FTC_SUCCESS;
+  DWORD dwUSBTransferChunkSize = FTC_GetUSBTransferChunkSize(ftHandle);
+  DWORD dwTotalNumBytesToSend = FTC_GetNumBytesInOutputBuffer();
+  DWORD dwNumDataBytesToSend = 0;
+  DWORD dwNumBytesSent = 0;
+  DWORD dwTotalNumBytesSent = 0;
+  DWORD dwNumDataBytesRead = 0;
+  BOOL bDeadlineStarted = FTC_StartDeviceCommandDeadline(ftHandle);
+
+  // The output buffer is written one chunk after another without waiting for the replies to a chunk before the next
+  // chunk is written, so the device command FIFO never runs dry. Replies that have already arrived are collected
+  // between chunks, so the device is never held up by a full transmit buffer, and the rest are waited for once the
+  // last chunk has been written.
+  while ((dwTotalNumBytesSent < dwTotalNumBytesToSend) && (Status == FTC_SUCCESS))
   {
+    if ((dwTotalNumBytesSent + dwUSBTransferChunkSize) <= dwTotalNumBytesToSend)
+      dwNumDataBytesToSend = dwUSBTransferChunkSize;
+    else
+      dwNumDataBytesToSend = (dwTotalNumBytesToSend - dwTotalNumBytesSent);
+
     // This function sends data to a FT2232C dual type device. The dwNumBytesToSend variable specifies the number of
     // bytes in the output buffer to be sent to a FT2232C dual type device. The dwNumBytesSent variable contains
     // the actual number of bytes sent to a FT2232C dual type device.
-    Status = FT_Write((FT_HANDLE)ftHandle, OutputBuffer, dwNumBytesToSend, &dwNumBytesSent);
+    Status = FTC_WriteOutputBytesToDevice(ftHandle, dwTotalNumBytesSent, dwNumDataBytesToSend, &dwNumBytesSent);
 
     if (Status == FTC_SUCCESS)
     {
-      Status = FTC_ReadFixedNumBytesFromDevice(ftHandle, InputBuffer, dwNumBytesToRead, &dwNumDataBytesRead);
+      dwTotalNumBytesSent = (dwTotalNumBytesSent + dwNumBytesSent);
 
-      if (Status == FTC_SUCCESS)
-        *lpdwNumBytesRead = dwNumDataBytesRead;
+      if (dwTotalNumBytesSent < dwTotalNumBytesToSend)
+        Status = FTC_ReadAvailableBytesFromDevice(ftHandle, pInputBuffer, dwNumBytesToRead, &dwNumDataBytesRead);
     }
   }
 
-  dwNumBytesToSend = 0;
+  if (Status == FTC_SUCCESS)
+  {
+    Status = FTC_ReadFixedNumBytesFromDevice(ftHandle, pInputBuffer, dwNumBytesToRead, &dwNumDataBytesRead);
+
+    if (Status == FTC_SUCCESS)
+      *lpdwNumBytesRead = dwNumDataBytesRead;
+  }
+
+  if (bDeadlineStarted)
+    FTC_EndDeviceCommandDeadline(ftHandle);
+
+  FTC_ClearOutputBuffer();
 
   return Status;
 }
@@ -963,68 +1661,39 @@ FTC_STATUS FT2232c::FTC_SendReadBytesToFromDevice(FTC_HANDLE ftHandle, PInputByt
 FTC_STATUS FT2232c::FTC_SendCommandsSequenceToDevice(FTC_HANDLE ftHandle)
 {
   FTC_STATUS Status = FTC_SUCCESS;
+  DWORD dwUSBTransferChunkSize = FTC_GetUSBTransferChunkSize(ftHandle);
+  DWORD dwTotalNumBytesToSend = FTC_GetNumBytesInOutputBuffer();
   DWORD dwNumDataBytesToSend = 0;
   DWORD dwNumBytesSent = 0;
   DWORD dwTotalNumBytesSent = 0;
 
-  if (dwNumBytesToSend > MAX_NUM_BYTES_USB_WRITE)
+  if (dwTotalNumBytesToSend > dwUSBTransferChunkSize)
   {
     do
     {
-      if ((dwTotalNumBytesSent + MAX_NUM_BYTES_USB_WRITE) <= dwNumBytesToSend)
-        dwNumDataBytesToSend = MAX_NUM_BYTES_USB_WRITE;
+      if ((dwTotalNumBytesSent + dwUSBTransferChunkSize) <= dwTotalNumBytesToSend)
+        dwNumDataBytesToSend = dwUSBTransferChunkSize;
       else
-        dwNumDataBytesToSend = (dwNumBytesToSend - dwTotalNumBytesSent);
+        dwNumDataBytesToSend = (dwTotalNumBytesToSend - dwTotalNumBytesSent);
 
       // This function sends data to a FT2232C dual type device. The dwNumBytesToSend variable specifies the number of
       // bytes in the output buffer to be sent to a FT2232C dual type device. The dwNumBytesSent variable contains
       // the actual number of bytes sent to a FT2232C dual type device.
-      Status = FT_Write((FT_HANDLE)ftHandle, &OutputBuffer[dwTotalNumBytesSent], dwNumDataBytesToSend, &dwNumBytesSent);
+      Status = FTC_WriteOutputBytesToDevice(ftHandle, dwTotalNumBytesSent, dwNumDataBytesToSend, &dwNumBytesSent);
 
       dwTotalNumBytesSent = dwTotalNumBytesSent + dwNumBytesSent;
     }
-    while ((dwTotalNumBytesSent < dwNumBytesToSend) && (Status == FTC_SUCCESS)); 
+    while ((dwTotalNumBytesSent < dwTotalNumBytesToSend) && (Status == FTC_SUCCESS)); 
   }
   else
   {
     // This function sends data to a FT2232C dual type device. The dwNumBytesToSend variable specifies the number of
     // bytes in the output buffer to be sent to a FT2232C dual type device. The dwNumBytesSent variable contains
     // the actual number of bytes sent to a FT2232C dual type device.
-    Status = FT_Write((FT_HANDLE)ftHandle, OutputBuffer, dwNumBytesToSend, &dwNumBytesSent);
+    Status = FTC_WriteOutputBytesToDevice(ftHandle, 0, dwTotalNumBytesToSend, &dwNumBytesSent);
   }
 
-  dwNumBytesToSend = 0;
-  
-  return Status;
-}
-
-FTC_STATUS FT2232c::FTC_ReadCommandsSequenceBytesFromDevice(FTC_HANDLE ftHandle, PInputByteBuffer InputBuffer,
-                                                            DWORD dwNumBytesToRead, LPDWORD lpdwNumBytesRead)
-{
-  FTC_STATUS Status = FTC_SUCCESS;
-  DWORD dwNumDataBytesToRead = 0;
-  DWORD dwNumBytesRead = 0;
-  DWORD dwTotalNumBytesRead = 0;
-
-  if (dwNumBytesToRead > MAX_NUM_BYTES_USB_READ)
-  {
-    do
-    {
-      if ((dwTotalNumBytesRead + MAX_NUM_BYTES_USB_WRITE_READ) <= dwNumBytesToRead)
-        dwNumDataBytesToRead = MAX_NUM_BYTES_USB_WRITE_READ;
-      else
-        dwNumDataBytesToRead = (dwNumBytesToRead - dwTotalNumBytesRead);
-
-      Status = FTC_ReadFixedNumBytesFromDevice(ftHandle, InputBuffer, dwNumDataBytesToRead, &dwNumBytesRead);
-
-      dwTotalNumBytesRead = dwTotalNumBytesRead + dwNumBytesRead;
-    }
-    while ((dwTotalNumBytesRead < dwNumBytesToRead) && (Status == FTC_SUCCESS));
-
-    *lpdwNumBytesRead = dwTotalNumBytesRead;
-  }
-  else
-    Status = FTC_ReadFixedNumBytesFromDevice(ftHandle, InputBuffer, dwNumBytesToRead, lpdwNumBytesRead);
+  FTC_ClearOutputBuffer();
   
   return Status;
 }
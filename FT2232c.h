@@ -30,6 +30,9 @@ Revision History:
 #include "ftcjtag.h"
 #include <ftd2xx.h>
 #include "FtcJtagInternal.h"
+#include "FtcTransport.h"
+
+class FtcIoThreadTransport;
 
 typedef DWORD FTC_HANDLE;
 typedef ULONG FTC_STATUS;
@@ -61,6 +64,18 @@ typedef struct Ft_Device_Data{
   DWORD hDevice;                                    // handle to the opened and initialized FT2232C dual type device
 }FTC_DEVICE_DATA, *PFTC_DEVICE_DATA;
 
+typedef struct Ft_Device_Transport_Data{
+  DWORD hDevice;                                    // handle to an opened device
+  FtcTransport *pTransport;                         // transport backend used to communicate with the opened device
+  DWORD dwWaitPolicy;                               // how to wait for bytes from the device ie spin, block or hybrid
+  DWORD dwSpinPeriodMicroSecs;                      // time spent polling before blocking, hybrid wait policy only
+  DWORD dwUSBOutTransferSize;                       // out transfer size negotiated with the device
+  DWORD dwUSBTransferChunkSize;                     // maximum number of bytes in a single write, zero for automatic
+  DWORD dwCommandTimeoutmSec;                       // time allowed for the device to reply to a command
+  ULONGLONG ulCommandDeadlineMicroSecs;             // monotonic time by which the current command must complete
+  FtcIoThreadTransport *pIoThreadTransport;         // I/O thread wrapped around the device transport, NULL if none
+}FTC_DEVICE_TRANSPORT_DATA, *PFTC_DEVICE_TRANSPORT_DATA;
+
 typedef DWORD FT2232CDeviceIndexes[MAX_NUM_DEVICES];
 
 #define DEVICE_STRING_BUFF_SIZE 64
@@ -81,14 +96,28 @@ typedef OutputByteBuffer *POutputByteBuffer;
 typedef BYTE InputByteBuffer[INPUT_BUFFER_SIZE];
 typedef InputByteBuffer *PInputByteBuffer;
 
-#define CONVERT_1MS_TO_100NS 10000
+#define MAX_NUM_OUTPUT_DATA_REFERENCES 32
+
+// Data blocks smaller than this are copied into the output buffer, as copying a few bytes costs less than writing
+// them as a separate segment
+#define MIN_NUM_OUTPUT_DATA_REFERENCE_BYTES 64
+
+typedef struct Ft_Output_Data_Reference{
+  DWORD  dwOutputBufferIndex;                       // number of output buffer bytes to be sent ahead of the data block
+  LPBYTE pDataBytes;                                // data block, which must not change until the output buffer is sent
+  DWORD  dwNumDataBytes;                            // number of bytes in the data block
+}FTC_OUTPUT_DATA_REFERENCE, *PFTC_OUTPUT_DATA_REFERENCE;
 
-#define MAX_COMMAND_TIMEOUT_PERIOD 5000  // 5 seconds
+#define DEFAULT_COMMAND_TIMEOUT_PERIOD 5000  // 5 seconds
+#define MIN_COMMAND_TIMEOUT_PERIOD 1         // 1 millisecond
+#define MAX_COMMAND_TIMEOUT_PERIOD 3600000   // 1 hour
 
-// 25/08/05 - Windows 2000 Professional always sets the USB buffer size to 4K ie 4096
-#define MAX_NUM_BYTES_USB_WRITE 4096 //32768 // 32KB
-#define MAX_NUM_BYTES_USB_WRITE_READ 4096 //32768 // 32KB
-#define MAX_NUM_BYTES_USB_READ 32768 // 32KB
+#define DEFAULT_WAIT_POLICY_SPIN_PERIOD 100  // 100 microseconds
+#define MAX_WAIT_POLICY_SPIN_PERIOD 1000000  // 1 second
+
+// 25/08/05 - Windows 2000 Professional always sets the USB buffer size to 4K ie 4096, which is also the transfer
+// size used by a device until FTC_SetDeviceUSBBufferSizes negotiates a larger one
+#define DEFAULT_USB_TRANSFER_SIZE 4096
 
 const int MPSSE_INTERFACE_MASK   = '\x00';
 const int RESET_MPSSE_INTERFACE = '\x00';
@@ -111,8 +140,13 @@ class FT2232c
 private:
   UINT uiNumOpenedDevices;
   FTC_DEVICE_DATA OpenedDevices[MAX_NUM_DEVICES];
+  FTC_DEVICE_TRANSPORT_DATA OpenedDevicesTransports[MAX_NUM_DEVICES];
+  DWORD dwNextDeviceHandle;
   OutputByteBuffer OutputBuffer;
   DWORD dwNumBytesToSend;
+  FTC_OUTPUT_DATA_REFERENCE OutputDataReferences[MAX_NUM_OUTPUT_DATA_REFERENCES];
+  DWORD dwNumOutputDataReferences;
+  DWORD dwNumReferencedBytesToSend;
 
   BOOLEAN    FTC_DeviceInUse(LPSTR lpDeviceName, DWORD dwLocationID);
   BOOLEAN    FTC_DeviceOpened(LPSTR lpDeviceName, DWORD dwLocationID, FTC_HANDLE *pftHandle);
@@ -120,6 +154,13 @@ private:
 
   FTC_STATUS FTC_IsDeviceFT2232CType(FT_DEVICE_LIST_INFO_NODE devInfo, LPBOOL lpbFT2232CTypeDevice);
 
+  PFTC_DEVICE_TRANSPORT_DATA FTC_GetDeviceTransportData(FTC_HANDLE ftHandle);
+  DWORD      FTC_GetUSBTransferChunkSize(FTC_HANDLE ftHandle);
+  FTC_STATUS FTC_WriteOutputBytesToDevice(FTC_HANDLE ftHandle, DWORD dwOutputByteIndex, DWORD dwNumBytesToWrite,
+                                          LPDWORD lpdwNumBytesWritten);
+  FTC_STATUS FTC_ReadAvailableBytesFromDevice(FTC_HANDLE ftHandle, LPBYTE pInputBuffer,
+                                              DWORD dwNumBytesToRead, LPDWORD lpdwNumDataBytesRead);
+
 public:
   FT2232c(void);
   ~FT2232c(void);
@@ -138,6 +179,25 @@ protected:
   FTC_STATUS FTC_IsDeviceHandleValid(FTC_HANDLE ftHandle);
   void       FTC_RemoveDeviceHandle(FTC_HANDLE ftHandle);
 
+  FTC_STATUS FTC_InsertDeviceTransport(FtcTransport *pTransport, FTC_HANDLE *pftHandle);
+  FtcTransport *FTC_GetDeviceTransport(FTC_HANDLE ftHandle);
+  FTC_STATUS FTC_CloseDeviceTransport(FTC_HANDLE ftHandle);
+  FTC_STATUS FTC_SetDeviceTransferQueueDepth(FTC_HANDLE ftHandle, DWORD dwNumWriteTransfers, DWORD dwNumReadTransfers);
+  FTC_STATUS FTC_GetDeviceTransferQueueDepth(FTC_HANDLE ftHandle, LPDWORD lpdwNumWriteTransfers, LPDWORD lpdwNumReadTransfers);
+  FTC_STATUS FTC_SetDeviceWaitPolicy(FTC_HANDLE ftHandle, DWORD dwWaitPolicy, DWORD dwSpinPeriodMicroSecs);
+  FTC_STATUS FTC_GetDeviceWaitPolicy(FTC_HANDLE ftHandle, LPDWORD lpdwWaitPolicy, LPDWORD lpdwSpinPeriodMicroSecs);
+  FTC_STATUS FTC_SetDeviceUSBTransferChunkSize(FTC_HANDLE ftHandle, DWORD dwUSBTransferChunkSize);
+  FTC_STATUS FTC_GetDeviceUSBTransferChunkSize(FTC_HANDLE ftHandle, LPDWORD lpdwUSBTransferChunkSize);
+  FTC_STATUS FTC_SetDeviceCommandTimeout(FTC_HANDLE ftHandle, DWORD dwCommandTimeoutmSec);
+  FTC_STATUS FTC_GetDeviceCommandTimeout(FTC_HANDLE ftHandle, LPDWORD lpdwCommandTimeoutmSec);
+  BOOL       FTC_StartDeviceCommandDeadline(FTC_HANDLE ftHandle);
+  void       FTC_EndDeviceCommandDeadline(FTC_HANDLE ftHandle);
+  FTC_STATUS FTC_SetDeviceIOThread(FTC_HANDLE ftHandle, BOOL bIOThreadEnabled);
+  FTC_STATUS FTC_GetDeviceIOThread(FTC_HANDLE ftHandle, LPBOOL lpbIOThreadEnabled);
+  FTC_STATUS FTC_GetDeviceType(FTC_HANDLE ftHandle, LPDWORD lpdwDeviceType);
+  FTC_STATUS FTC_GetDeviceQueueStatus(FTC_HANDLE ftHandle, LPDWORD lpdwNumBytesDeviceInputBuffer);
+  FTC_STATUS FTC_WriteBytesToDevice(FTC_HANDLE ftHandle, LPBYTE pBuffer, DWORD dwNumBytesToWrite, LPDWORD lpdwNumBytesWritten);
+
   FTC_STATUS FTC_ResetUSBDevicePurgeUSBInputBuffer(FTC_HANDLE ftHandle);
   FTC_STATUS FTC_SetDeviceUSBBufferSizes(FTC_HANDLE ftHandle, DWORD InputBufferSize, DWORD OutputBufferSize);
   FTC_STATUS FTC_SetDeviceSpecialCharacters(FTC_HANDLE ftHandle, BOOLEAN bEventEnabled, UCHAR EventCharacter,
@@ -149,23 +209,26 @@ protected:
   FTC_STATUS FTC_EnableMPSSEInterface(FTC_HANDLE ftHandle);
   FTC_STATUS FTC_SendReceiveCommandFromMPSSEInterface(FTC_HANDLE ftHandle, BOOLEAN bSendEchoCommandContinuouslyOnce, BYTE EchoCommand, LPBOOL lpbCommandEchod);
   FTC_STATUS FTC_SynchronizeMPSSEInterface(FTC_HANDLE ftHandle);
-  BOOLEAN    FTC_Timeout(SYSTEMTIME StartSystemTime, DWORD dwTimeoutmSecs);
   FTC_STATUS FTC_GetNumberBytesFromDeviceInputBuffer(FTC_HANDLE ftHandle, LPDWORD lpdwNumBytesDeviceInputBuffer);
+  FTC_STATUS FTC_WaitForDeviceInputBytes(FTC_HANDLE ftHandle, DWORD dwNumBytesExpected, LPDWORD lpdwNumBytesDeviceInputBuffer);
+  FTC_STATUS FTC_PollDeviceInputBytes(FTC_HANDLE ftHandle, DWORD dwNumBytesExpected, LPDWORD lpdwNumBytesDeviceInputBuffer);
+  FTC_STATUS FTC_PurgeDevice(FTC_HANDLE ftHandle);
 
   void       FTC_ClearOutputBuffer(void);
   DWORD      FTC_GetNumBytesInOutputBuffer(void);
   void       FTC_AddByteToOutputBuffer(DWORD dwOutputByte, BOOL bClearOutputBuffer);
+  void       FTC_AddDataBytesToOutputBuffer(LPBYTE pDataBytes, DWORD dwNumDataBytes);
+  LPBYTE     FTC_GetOutputBufferEnd(void);
+  void       FTC_CommitOutputBufferBytes(DWORD dwNumBytes);
   FTC_STATUS FTC_SendBytesToDevice(FTC_HANDLE ftHandle);
   FTC_STATUS FTC_ReadBytesFromDevice(FTC_HANDLE ftHandle, PInputByteBuffer InputBuffer,
                                      DWORD dwNumBytesToRead, LPDWORD lpdwNumBytesRead);
-  FTC_STATUS FTC_ReadFixedNumBytesFromDevice(FTC_HANDLE ftHandle, PInputByteBuffer InputBuffer,
+  FTC_STATUS FTC_ReadFixedNumBytesFromDevice(FTC_HANDLE ftHandle, LPBYTE pInputBuffer,
                                              DWORD dwNumBytesToRead, LPDWORD lpdwNumDataBytesRead);
-  FTC_STATUS FTC_SendReadBytesToFromDevice(FTC_HANDLE ftHandle, PInputByteBuffer InputBuffer,
+  FTC_STATUS FTC_SendReadBytesToFromDevice(FTC_HANDLE ftHandle, LPBYTE pInputBuffer,
                                            DWORD dwNumBytesToRead, LPDWORD lpdwNumBytesRead);
 
   FTC_STATUS FTC_SendCommandsSequenceToDevice(FTC_HANDLE ftHandle);
-  FTC_STATUS FTC_ReadCommandsSequenceBytesFromDevice(FTC_HANDLE ftHandle, PInputByteBuffer InputBuffer,
-                                                     DWORD dwNumBytesToRead, LPDWORD lpdwNumBytesRead);
 };
 
 #endif  /* FT2232c_H */
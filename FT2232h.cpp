@@ -30,6 +30,8 @@ Revision History:
 
 #include "FtcJtagInternal.h"
 #include "FT2232h.h"
+#include "FtcMpsseEmulator.h"
+#include "FtcLibusbTransport.h"
 
 #include <cstring>
 
@@ -278,6 +280,8 @@ FT2232h::FT2232h(void)
     OpenedHiSpeedDevices[iDeviceCntr].dwProcessId = 0;
 
   dwNumBytesToSend = 0;
+
+  dwNextTransportLocationID = 1;
 }
 
 FT2232h::~FT2232h(void)
@@ -427,9 +431,10 @@ FTC_STATUS FT2232h::FTC_OpenSpecifiedHiSpeedDevice(LPSTR lpDeviceName, DWORD dwL
           {
             if ((Status = FT_OpenEx((PVOID)dwLocationID, FT_OPEN_BY_LOCATION, &ftHandle)) == FTC_SUCCESS)
             {
-              *pftHandle = (DWORD)reinterpret_cast<intptr_t>(ftHandle);
-
-              FTC_InsertDeviceHandle(lpDeviceName, dwLocationID, lpChannel, dwDeviceType, *pftHandle);
+              if ((Status = FTC_InsertDeviceTransport(new FtcD2xxTransport(ftHandle), pftHandle)) == FTC_SUCCESS)
+                FTC_InsertDeviceHandle(lpDeviceName, dwLocationID, lpChannel, dwDeviceType, *pftHandle);
+              else
+                *pftHandle = 0;
             }
           }
         }
@@ -451,6 +456,81 @@ FTC_STATUS FT2232h::FTC_OpenSpecifiedHiSpeedDevice(LPSTR lpDeviceName, DWORD dwL
   return Status;
 }
 
+FTC_STATUS FT2232h::FTC_OpenTransportDevice(DWORD dwTransportType, DWORD dwDeviceIndex, FTC_HANDLE *pftHandle)
+{
+  FTC_STATUS Status = FTC_SUCCESS;
+  char szDeviceName[DEVICE_STRING_BUFF_SIZE + 1];
+  char szChannel[CHANNEL_STRING_MIN_BUFF_SIZE + 1];
+  DWORD dwLocationID = 0;
+  DWORD dwDeviceType = 0;
+  FtcTransport *pTransport = NULL;
+
+  switch (dwTransportType)
+  {
+    case FTC_TRANSPORT_D2XX:
+      // The device index is the index of a hi-speed device channel, as returned by JTAG_GetHiSpeedDeviceNameLocIDChannel
+      if ((Status = FTC_GetHiSpeedDeviceNameLocationIDChannel(dwDeviceIndex, szDeviceName, (DEVICE_STRING_BUFF_SIZE + 1), &dwLocationID,
+                                                              szChannel, (CHANNEL_STRING_MIN_BUFF_SIZE + 1), &dwDeviceType)) == FTC_SUCCESS)
+        Status = FTC_OpenSpecifiedHiSpeedDevice(szDeviceName, dwLocationID, szChannel, pftHandle);
+    break;
+    case FTC_TRANSPORT_LIBUSB:
+#ifdef FTCJTAG_LIBUSB
+      strcpy(szDeviceName, LIBUSB_DEVICE_NAME);
+
+      if ((pTransport = new FtcLibusbTransport()) != NULL)
+      {
+        if ((Status = ((FtcLibusbTransport *)pTransport)->Open(dwDeviceIndex)) != FTC_SUCCESS)
+        {
+          delete pTransport;
+
+          pTransport = NULL;
+        }
+      }
+      else
+        Status = FTC_INSUFFICIENT_RESOURCES;
+#else
+      Status = FTC_TRANSPORT_NOT_SUPPORTED;
+#endif
+    break;
+    case FTC_TRANSPORT_MPSSE_EMULATOR:
+      // Every emulator device is a new device, the device index selects whether it is a FT2232H hi-speed device or
+      // a FT2232D dual device
+      strcpy(szDeviceName, EMULATOR_DEVICE_NAME);
+
+      if (dwDeviceIndex > FTC_EMULATOR_DUAL_DEVICE_INDEX)
+        Status = FTC_DEVICE_NOT_FOUND;
+      else if ((pTransport = new FtcMpsseEmulator(((dwDeviceIndex == FTC_EMULATOR_DUAL_DEVICE_INDEX) ? FT_DEVICE_2232C : FT_DEVICE_2232H))) == NULL)
+        Status = FTC_INSUFFICIENT_RESOURCES;
+    break;
+    default:
+      Status = FTC_INVALID_TRANSPORT_TYPE;
+    break;
+  }
+
+  if (pTransport != NULL)
+  {
+    pTransport->GetDeviceType(&dwDeviceType);
+
+    if ((Status = FTC_InsertDeviceTransport(pTransport, pftHandle)) == FTC_SUCCESS)
+    {
+      // There is no location identifier for a device that is not opened through the D2XX driver, so each one is
+      // given the next transport location identifier
+      dwLocationID = dwNextTransportLocationID;
+
+      dwNextTransportLocationID = dwNextTransportLocationID + 1;
+
+      if ((dwDeviceType == FT_DEVICE_2232H) || (dwDeviceType == FT_DEVICE_4232H))
+        FTC_InsertDeviceHandle(szDeviceName, dwLocationID, (LPSTR)CHANNEL_A, dwDeviceType, *pftHandle);
+      else
+        FT2232c::FTC_InsertDeviceHandle(szDeviceName, dwLocationID, *pftHandle);
+    }
+    else
+      *pftHandle = 0;
+  }
+
+  return Status;
+}
+
 FTC_STATUS FT2232h::FTC_GetHiSpeedDeviceType(FTC_HANDLE ftHandle, LPBOOL lpbHiSpeedFT2232HTDeviceType)
 {
   FTC_STATUS Status = FTC_SUCCESS;
@@ -477,7 +557,7 @@ FTC_STATUS FT2232h::FTC_CloseDevice(FTC_HANDLE ftHandle)
 
   if ((Status = FTC_IsHiSpeedDeviceHandleValid(ftHandle)) == FTC_SUCCESS)
   {
-    Status = FT_Close((FT_HANDLE)ftHandle);
+    Status = FTC_CloseDeviceTransport(ftHandle);
 
     FTC_RemoveHiSpeedDeviceHandle(ftHandle);
   }
@@ -662,14 +742,10 @@ FTC_STATUS FT2232h::FTC_IsDeviceHiSpeedType(FTC_HANDLE ftHandle, LPBOOL lpbHiSpe
 {
   FTC_STATUS Status = FTC_SUCCESS;
   DWORD dwDeviceType = 0;
-  DWORD dwDeviceID = 0;
-  SerialNumber szSerialNumber;
-  char szDeviceNameBuffer[DEVICE_STRING_BUFF_SIZE + 1];
-  PVOID pvDummy = NULL;
 
   *lpbHiSpeedDeviceType = FALSE;
 
-  if ((Status = FT_GetDeviceInfo((FT_HANDLE)ftHandle, &dwDeviceType, &dwDeviceID, szSerialNumber, szDeviceNameBuffer, pvDummy)) == FTC_SUCCESS)
+  if ((Status = FTC_GetDeviceType(ftHandle, &dwDeviceType)) == FTC_SUCCESS)
   {
     if ((dwDeviceType == FT_DEVICE_2232H) || (dwDeviceType == FT_DEVICE_4232H))
     {
@@ -684,14 +760,10 @@ FTC_STATUS FT2232h::FTC_IsDeviceHiSpeedFT2232HType(FTC_HANDLE ftHandle, LPBOOL l
 {
   FTC_STATUS Status = FTC_SUCCESS;
   DWORD dwDeviceType = 0;
-  DWORD dwDeviceID = 0;
-  SerialNumber szSerialNumber;
-  char szDeviceNameBuffer[DEVICE_STRING_BUFF_SIZE + 1];
-  PVOID pvDummy = NULL;
 
   *lpbHiSpeedFT2232HTDeviceype = FALSE;
 
-  if ((Status = FT_GetDeviceInfo((FT_HANDLE)ftHandle, &dwDeviceType, &dwDeviceID, szSerialNumber, szDeviceNameBuffer, pvDummy)) == FTC_SUCCESS)
+  if ((Status = FTC_GetDeviceType(ftHandle, &dwDeviceType)) == FTC_SUCCESS)
   {
     if (dwDeviceType == FT_DEVICE_2232H)
     {
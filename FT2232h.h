@@ -97,6 +97,7 @@ private:
   UINT uiNumOpenedHiSpeedDevices;
   FTC_HI_SPEED_DEVICE_DATA OpenedHiSpeedDevices[MAX_NUM_DEVICES];
   DWORD dwNumBytesToSend;
+  DWORD dwNextTransportLocationID;
 
   BOOL FTC_DeviceInUse(LPSTR lpDeviceName, DWORD dwLocationID);
   BOOL FTC_DeviceOpened(LPSTR lpDeviceName, DWORD dwLocationID, FTC_HANDLE *pftHandle);
@@ -114,6 +115,7 @@ protected:
   FTC_STATUS FTC_GetNumHiSpeedDevices(LPDWORD lpdwNumHiSpeedDevices, HiSpeedDeviceIndexes *HiSpeedIndexes);
   FTC_STATUS FTC_GetHiSpeedDeviceNameLocationIDChannel(DWORD dwDeviceIndex, LPSTR lpDeviceName, DWORD dwDeviceNameBufferSize, LPDWORD lpdwLocationID, LPSTR lpChannel, DWORD dwChannelBufferSize, LPDWORD lpdwDeviceType);
   FTC_STATUS FTC_OpenSpecifiedHiSpeedDevice(LPSTR lpDeviceName, DWORD dwLocationID, LPSTR lpChannel, FTC_HANDLE *pftHandle);
+  FTC_STATUS FTC_OpenTransportDevice(DWORD dwTransportType, DWORD dwDeviceIndex, FTC_HANDLE *pftHandle);
   FTC_STATUS FTC_GetHiSpeedDeviceType(FTC_HANDLE ftHandle, LPBOOL lpbHiSpeedFT2232HTDeviceType);
   FTC_STATUS FTC_CloseDevice(FTC_HANDLE ftHandle);
   FTC_STATUS FTC_IsDeviceHandleValid(FTC_HANDLE ftHandle);
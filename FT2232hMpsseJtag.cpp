@@ -33,11 +33,16 @@ Revision History:
 
 #include "FT2232hMpsseJtag.h"
 #include "FtcJtagInternal.h"
+#include "FtcBitKernels.h"
 
 #include <string.h>
 #include <stdio.h>
 #include <stdlib.h>
 
+#ifndef _WIN32
+#include <sys/eventfd.h>
+#endif
+
 FTC_STATUS FT2232hMpsseJtag::CheckWriteDataToExternalDeviceBitsBytesParameters(DWORD dwNumBitsToWrite, DWORD dwNumBytesToWrite)
 {
   FTC_STATUS Status = FTC_SUCCESS;
@@ -84,6 +89,50 @@ void FT2232hMpsseJtag::AddByteToOutputBuffer(DWORD dwOutputByte, BOOL bClearOutp
   }
 }
 
+void FT2232hMpsseJtag::AddDataBytesToOutputBuffer(LPBYTE pDataBytes, DWORD dwNumDataBytes)
+{
+  DWORD dwNumBytesToSend = 0;
+
+  if (iCommandsSequenceDataDeviceIndex == -1)
+    // The data bytes are sent straight from the caller's buffer before the JTAG function returns, so are not copied
+    FTC_AddDataBytesToOutputBuffer(pDataBytes, dwNumDataBytes);
+  else
+  {
+    // A sequence of commands is executed after the caller's buffer may have been reused, so the data bytes are copied
+    dwNumBytesToSend = OpenedDevicesCommandsSequenceData[iCommandsSequenceDataDeviceIndex].dwNumBytesToSend;
+
+    memcpy(&(*OpenedDevicesCommandsSequenceData[iCommandsSequenceDataDeviceIndex].pCommandsSequenceDataOutPutBuffer)[dwNumBytesToSend],
+           pDataBytes, dwNumDataBytes);
+
+    dwNumBytesToSend = (dwNumBytesToSend + dwNumDataBytes);
+
+    OpenedDevicesCommandsSequenceData[iCommandsSequenceDataDeviceIndex].dwNumBytesToSend = dwNumBytesToSend;
+  }
+}
+
+LPBYTE FT2232hMpsseJtag::GetOutputBufferEnd(void)
+{
+  LPBYTE pOutputBufferEnd = NULL;
+
+  // Returns where the next command bytes are to be written, either in the output buffer or in the sequence of commands
+  // being built up for a device, so that a command and its parameters are written in one go instead of byte by byte.
+  // The bytes written are added to the output buffer or sequence of commands by CommitOutputBufferBytes
+  if (iCommandsSequenceDataDeviceIndex == -1)
+    pOutputBufferEnd = FTC_GetOutputBufferEnd();
+  else
+    pOutputBufferEnd = &(*OpenedDevicesCommandsSequenceData[iCommandsSequenceDataDeviceIndex].pCommandsSequenceDataOutPutBuffer)[OpenedDevicesCommandsSequenceData[iCommandsSequenceDataDeviceIndex].dwNumBytesToSend];
+
+  return pOutputBufferEnd;
+}
+
+void FT2232hMpsseJtag::CommitOutputBufferBytes(DWORD dwNumBytes)
+{
+  if (iCommandsSequenceDataDeviceIndex == -1)
+    FTC_CommitOutputBufferBytes(dwNumBytes);
+  else
+    OpenedDevicesCommandsSequenceData[iCommandsSequenceDataDeviceIndex].dwNumBytesToSend += dwNumBytes;
+}
+
 FTC_STATUS FT2232hMpsseJtag::SetTCKTDITMSPinsCloseState(FTC_HANDLE ftHandle, PFTC_CLOSE_FINAL_STATE_PINS pCloseFinalStatePinsData)
 {
   FTC_STATUS Status = FTC_SUCCESS;
@@ -233,21 +282,28 @@ FTC_STATUS FT2232hMpsseJtag::InitDataInOutClockFrequency(FTC_HANDLE ftHandle, DW
 // This procedure sets the JTAG to a new state
 void FT2232hMpsseJtag::SetJTAGToNewState(DWORD dwNewJtagState, DWORD dwNumTmsClocks, BOOL bDoReadOperation)
 {
+  LPBYTE pCommandBytes = NULL;
+
   if ((dwNumTmsClocks >= 1) && (dwNumTmsClocks <= 7))
   {
+    pCommandBytes = GetOutputBufferEnd();
+
     if (bDoReadOperation == TRUE)
-      AddByteToOutputBuffer(CLK_DATA_TMS_READ_CMD, false);
+      pCommandBytes[0] = CLK_DATA_TMS_READ_CMD;
     else
-      AddByteToOutputBuffer(CLK_DATA_TMS_NO_READ_CMD, false);
+      pCommandBytes[0] = CLK_DATA_TMS_NO_READ_CMD;
+
+    pCommandBytes[1] = ((dwNumTmsClocks - 1) & '\xFF');
+    pCommandBytes[2] = (dwNewJtagState & '\xFF');
 
-    AddByteToOutputBuffer(((dwNumTmsClocks - 1) & '\xFF'), false);
-    AddByteToOutputBuffer((dwNewJtagState & '\xFF'), false);
+    CommitOutputBufferBytes(3);
   }
 }
 
 // This function returns the number of TMS clocks to work out the last bit of TDO
 DWORD FT2232hMpsseJtag::MoveJTAGFromOneStateToAnother(JtagStates NewJtagState, DWORD dwLastDataBit, BOOL bDoReadOperation)
 {
+  DWORD dwTmsBits = 0;
   DWORD dwNumTmsClocks = 0;
 
   if (CurrentJtagState == Undefined)
@@ -256,32 +312,23 @@ DWORD FT2232hMpsseJtag::MoveJTAGFromOneStateToAnother(JtagStates NewJtagState, D
     CurrentJtagState = TestLogicReset;
   }
 
-  switch (CurrentJtagState)
+  // Moving to the undefined state does not clock TMS, the TAP controller is reset by the next move instead
+  if (NewJtagState != Undefined)
   {
-    case TestLogicReset:
-      dwNumTmsClocks = TestLogicResetToNewJTAGStateNumTMSClocks[NewJtagState];
-      SetJTAGToNewState((TestLogicResetToNewJTAGState[NewJtagState] | (dwLastDataBit << 7)), dwNumTmsClocks, bDoReadOperation);
-    break;
-    case RunTestIdle:
-      dwNumTmsClocks = RunTestIdleToNewJTAGStateNumTMSClocks[NewJtagState];
-      SetJTAGToNewState((RunTestIdleToNewJTAGState[NewJtagState] | (dwLastDataBit << 7)), dwNumTmsClocks, bDoReadOperation);
-    break;
-    case PauseDataRegister:
-      dwNumTmsClocks = PauseDataRegToNewJTAGStateNumTMSClocks[NewJtagState];
-      SetJTAGToNewState((PauseDataRegToNewJTAGState[NewJtagState] | (dwLastDataBit << 7)), dwNumTmsClocks, bDoReadOperation);
-    break;
-    case PauseInstructionRegister:
-      dwNumTmsClocks = PauseInstructionRegToNewJTAGStateNumTMSClocks[NewJtagState];
-      SetJTAGToNewState((PauseInstructionRegToNewJTAGState[NewJtagState] | (dwLastDataBit << 7)), dwNumTmsClocks, bDoReadOperation);
-    break;
-    case ShiftDataRegister:
-      dwNumTmsClocks = ShiftDataRegToNewJTAGStateNumTMSClocks[NewJtagState];
-      SetJTAGToNewState((ShiftDataRegToNewJTAGState[NewJtagState] | (dwLastDataBit << 7)), dwNumTmsClocks, bDoReadOperation);
-    break;
-    case ShiftInstructionRegister:
-      dwNumTmsClocks = ShiftInstructionRegToNewJTAGStateNumTMSClocks[NewJtagState];
-      SetJTAGToNewState((ShiftInstructionRegToNewJTAGState[NewJtagState] | (dwLastDataBit << 7)), dwNumTmsClocks, bDoReadOperation);
-    break;
+    dwTmsBits = CurrentToNewJTAGState[CurrentJtagState][NewJtagState];
+    dwNumTmsClocks = CurrentToNewJTAGStateNumTMSClocks[CurrentJtagState][NewJtagState];
+
+    if (dwNumTmsClocks > MAX_NUM_TMS_CLOCKS)
+    {
+      // The path is too long for one TMS command, the last data bit is clocked out and TDO is read by the first
+      // TMS command only
+      SetJTAGToNewState(((dwTmsBits & '\x7F') | (dwLastDataBit << 7)), MAX_NUM_TMS_CLOCKS, bDoReadOperation);
+      SetJTAGToNewState((dwTmsBits >> MAX_NUM_TMS_CLOCKS), (dwNumTmsClocks - MAX_NUM_TMS_CLOCKS), false);
+
+      dwNumTmsClocks = MAX_NUM_TMS_CLOCKS;
+    }
+    else
+      SetJTAGToNewState((dwTmsBits | (dwLastDataBit << 7)), dwNumTmsClocks, bDoReadOperation);
   }
 
   CurrentJtagState = NewJtagState;
@@ -308,6 +355,8 @@ FTC_STATUS FT2232hMpsseJtag::ResetTAPContollerExternalDeviceSetToTestIdleMode(FT
   //MoveJTAGFromOneStateToAnother(TestLogicReset, 1, false);JtagStates
   MoveJTAGFromOneStateToAnother(Undefined, 1, false);
 
+  InvalidateInstructionRegisterCache(ftHandle);
+
   MoveJTAGFromOneStateToAnother(RunTestIdle, NO_LAST_DATA_BIT, FALSE);
 
   Status = FTC_SendBytesToDevice(ftHandle);
@@ -520,7 +569,7 @@ FTC_STATUS FT2232hMpsseJtag::GetGeneralPurposeLowerInputOutputPins(FTC_HANDLE ft
   pLowPinsInputData->bPin4LowHighState = FALSE;
 
   // Get the number of bytes in the device input buffer
-  if ((Status = FT_GetQueueStatus((FT_HANDLE)ftHandle, &dwNumBytesDeviceInputBuffer)) == FTC_SUCCESS)
+  if ((Status = FTC_GetDeviceQueueStatus(ftHandle, &dwNumBytesDeviceInputBuffer)) == FTC_SUCCESS)
   {
     if (dwNumBytesDeviceInputBuffer > 0)
       Status = FTC_ReadBytesFromDevice(ftHandle, &InputBuffer, dwNumBytesDeviceInputBuffer, &dwNumBytesRead);
@@ -581,7 +630,7 @@ FTC_STATUS FT2232hMpsseJtag::GetGeneralPurposeInputOutputPins(FTC_HANDLE ftHandl
         if ((bHiSpeedTypeDevice == FALSE) || ((bHiSpeedTypeDevice == TRUE) && (bHiSpeedFT2232HTDeviceype == TRUE)))
         {
           // Get the number of bytes in the device input buffer
-          if ((Status = FT_GetQueueStatus((FT_HANDLE)ftHandle, &dwNumBytesDeviceInputBuffer)) == FTC_SUCCESS)
+          if ((Status = FTC_GetDeviceQueueStatus(ftHandle, &dwNumBytesDeviceInputBuffer)) == FTC_SUCCESS)
           {
             if (dwNumBytesDeviceInputBuffer > 0)
               Status = FTC_ReadBytesFromDevice(ftHandle, &InputBuffer, dwNumBytesDeviceInputBuffer, &dwNumBytesRead);
@@ -674,7 +723,7 @@ FTC_STATUS FT2232hMpsseJtag::GetHiSpeedDeviceGeneralPurposeInputOutputPins(FTC_H
         if (bHiSpeedFT2232HTDeviceype == TRUE)
         {
           // Get the number of bytes in the device input buffer
-          if ((Status = FT_GetQueueStatus((FT_HANDLE)ftHandle, &dwNumBytesDeviceInputBuffer)) == FTC_SUCCESS)
+          if ((Status = FTC_GetDeviceQueueStatus(ftHandle, &dwNumBytesDeviceInputBuffer)) == FTC_SUCCESS)
           {
             if (dwNumBytesDeviceInputBuffer > 0)
               Status = FTC_ReadBytesFromDevice(ftHandle, &InputBuffer, dwNumBytesDeviceInputBuffer, &dwNumBytesRead);
@@ -704,7 +753,7 @@ FTC_STATUS FT2232hMpsseJtag::GetHiSpeedDeviceGeneralPurposeInputOutputPins(FTC_H
   return Status;
 }
 
-void FT2232hMpsseJtag::AddWriteCommandDataToOutPutBuffer(BOOL bInstructionTestData, DWORD dwNumBitsToWrite,
+DWORD FT2232hMpsseJtag::AddWriteCommandDataToOutPutBuffer(BOOL bInstructionTestData, DWORD dwNumBitsToWrite,
                                                          PWriteDataByteBuffer pWriteDataBuffer, DWORD dwNumBytesToWrite,
                                                          DWORD dwTapControllerState)
 {
@@ -714,6 +763,8 @@ void FT2232hMpsseJtag::AddWriteCommandDataToOutPutBuffer(BOOL bInstructionTestDa
   DWORD dwNumRemainingDataBits = 0;
   DWORD dwLastDataBit = 0;
   DWORD dwDataBitIndex = 0;
+  DWORD dwNumTmsClocks = 0;
+  LPBYTE pCommandBytes = NULL;
 
   // adjust for bit count of 1 less than no of bits
   dwModNumBitsToWrite = (dwNumBitsToWrite - 1);
@@ -731,17 +782,16 @@ void FT2232hMpsseJtag::AddWriteCommandDataToOutPutBuffer(BOOL bInstructionTestDa
     dwNumDataBytes = (dwNumDataBytes - 1);
 
     // clk data bytes out on -ve clk LSB
-    AddByteToOutputBuffer(CLK_DATA_BYTES_OUT_ON_NEG_CLK_LSB_FIRST_CMD, false);
-    AddByteToOutputBuffer((dwNumDataBytes & '\xFF'), false);
-    AddByteToOutputBuffer(((dwNumDataBytes / 256) & '\xFF'), false);
+    pCommandBytes = GetOutputBufferEnd();
+    pCommandBytes[0] = CLK_DATA_BYTES_OUT_ON_NEG_CLK_LSB_FIRST_CMD;
+    pCommandBytes[1] = (dwNumDataBytes & '\xFF');
+    pCommandBytes[2] = ((dwNumDataBytes / 256) & '\xFF');
+    CommitOutputBufferBytes(3);
 
     // now add the data bytes to go out
-    do
-    {
-      AddByteToOutputBuffer((*pWriteDataBuffer)[dwDataBufferIndex], false);
-      dwDataBufferIndex = (dwDataBufferIndex + 1);
-    }
-    while (dwDataBufferIndex < (dwNumDataBytes + 1));
+    dwDataBufferIndex = (dwNumDataBytes + 1);
+
+    AddDataBytesToOutputBuffer(*pWriteDataBuffer, dwDataBufferIndex);
   }
 
   dwNumRemainingDataBits = (dwModNumBitsToWrite % 8);
@@ -751,9 +801,11 @@ void FT2232hMpsseJtag::AddWriteCommandDataToOutPutBuffer(BOOL bInstructionTestDa
     dwNumRemainingDataBits = (dwNumRemainingDataBits - 1);
 
     //clk data bits out on -ve clk LSB
-    AddByteToOutputBuffer(CLK_DATA_BITS_OUT_ON_NEG_CLK_LSB_FIRST_CMD, false);
-    AddByteToOutputBuffer((dwNumRemainingDataBits & '\xFF'), false);
-    AddByteToOutputBuffer((*pWriteDataBuffer)[dwDataBufferIndex], false);
+    pCommandBytes = GetOutputBufferEnd();
+    pCommandBytes[0] = CLK_DATA_BITS_OUT_ON_NEG_CLK_LSB_FIRST_CMD;
+    pCommandBytes[1] = (dwNumRemainingDataBits & '\xFF');
+    pCommandBytes[2] = (*pWriteDataBuffer)[dwDataBufferIndex];
+    CommitOutputBufferBytes(3);
   }
 
   // get last bit
@@ -766,21 +818,52 @@ void FT2232hMpsseJtag::AddWriteCommandDataToOutPutBuffer(BOOL bInstructionTestDa
     dwLastDataBit = (dwLastDataBit >> (dwDataBitIndex - 1));
 
   // end it in state passed in, take 1 off the dwTapControllerState variable to correspond with JtagStates enumerated types
-  MoveJTAGFromOneStateToAnother(JtagStates((dwTapControllerState - 1)), dwLastDataBit, false);
+  dwNumTmsClocks = MoveJTAGFromOneStateToAnother(JtagStates((dwTapControllerState - 1)), dwLastDataBit, false);
+
+  return dwNumTmsClocks;
 }
 
 FTC_STATUS FT2232hMpsseJtag::WriteDataToExternalDevice(FTC_HANDLE ftHandle, BOOL bInstructionTestData, DWORD dwNumBitsToWrite,
                                                        PWriteDataByteBuffer pWriteDataBuffer, DWORD dwNumBytesToWrite,
-                                                       DWORD dwTapControllerState)
+                                                       DWORD dwTapControllerState, DWORD dwNumIdleCycles)
 {
   FTC_STATUS Status = FTC_SUCCESS;
+  DWORD dwDeviceIndex = GetCommandsSequenceDataDeviceIndex(ftHandle);
+  DWORD dwNumTmsClocks = 0;
 
   FTC_ClearOutputBuffer();
 
-  AddWriteCommandDataToOutPutBuffer(bInstructionTestData, dwNumBitsToWrite, pWriteDataBuffer,
-                                    dwNumBytesToWrite, dwTapControllerState);
+  if ((bInstructionTestData != FALSE) && IsInstructionRegisterCached(ftHandle, dwNumBitsToWrite, pWriteDataBuffer) &&
+      IsInstructionRegisterKept(ShiftInstructionRegister, JtagStates((dwTapControllerState - 1))) &&
+      IsInstructionRegisterKept(CurrentJtagState, JtagStates((dwTapControllerState - 1))))
+  {
+    // The instruction register already holds the value to be written, so only the move to the end state is clocked.
+    // The scan is only skipped if a real scan would have ended through the update IR state and the move itself does
+    // not load the instruction register
+    dwNumTmsClocks = MoveJTAGFromOneStateToAnother(JtagStates((dwTapControllerState - 1)), NO_LAST_DATA_BIT, false);
 
-  Status = FTC_SendBytesToDevice(ftHandle);
+    AddIdleCyclesToOutputBuffer(ftHandle, dwNumTmsClocks, dwNumIdleCycles);
+
+    if (FTC_GetNumBytesInOutputBuffer() > 0)
+      Status = FTC_SendBytesToDevice(ftHandle);
+
+    if (Status == FTC_SUCCESS)
+      OpenedDevicesCommandsSequenceData[dwDeviceIndex].dwNumInstructionRegisterScansSkipped += 1;
+  }
+  else
+  {
+    dwNumTmsClocks = AddWriteCommandDataToOutPutBuffer(bInstructionTestData, dwNumBitsToWrite, pWriteDataBuffer,
+                                                       dwNumBytesToWrite, dwTapControllerState);
+
+    AddIdleCyclesToOutputBuffer(ftHandle, dwNumTmsClocks, dwNumIdleCycles);
+
+    Status = FTC_SendBytesToDevice(ftHandle);
+
+    if (Status == FTC_SUCCESS)
+      UpdateInstructionRegisterCache(ftHandle, bInstructionTestData, dwNumBitsToWrite, pWriteDataBuffer, dwTapControllerState);
+    else
+      InvalidateInstructionRegisterCache(ftHandle);
+  }
 
   return Status;
 }
@@ -822,44 +905,61 @@ FTC_STATUS FT2232hMpsseJtag::GetDataFromExternalDevice(FTC_HANDLE ftHandle, DWOR
   DWORD dwNumReadDataBytes = 0;
   DWORD dwNumRemainingDataBits = 0;
   DWORD dwNumDataBytesRead = 0;
-  DWORD dwNumBytesDeviceInputBuffer = 0;
-  InputByteBuffer InputBuffer;
-  DWORD dwBytesReadIndex = 0;
-  BYTE LastDataBit = 0;
 
   GetNumDataBytesToRead(dwNumBitsToRead, &dwNumReadDataBytes, &dwNumRemainingDataBits);
 
-  Status = FTC_ReadFixedNumBytesFromDevice(ftHandle, &InputBuffer, dwNumReadDataBytes, &dwNumDataBytesRead);
+  // The data bytes and the TMS read byte are read straight into the caller's buffer, which is large enough to hold
+  // both for the maximum number of bits, and the last data bit is then realigned in place
+  Status = FTC_ReadFixedNumBytesFromDevice(ftHandle, *pReadDataBuffer, dwNumReadDataBytes, &dwNumDataBytesRead);
 
   if (Status == FTC_SUCCESS)
-  {
-    // adjust last 2 bytes
-    if (dwNumRemainingDataBits < 8)
-    {
-      InputBuffer[dwNumReadDataBytes - 2] = (InputBuffer[dwNumReadDataBytes - 2] >> dwNumRemainingDataBits);
-      LastDataBit = (InputBuffer[dwNumReadDataBytes - 1] << (dwNumTmsClocks - 1));
-      LastDataBit = (LastDataBit & '\x80'); // strip the rest
-      InputBuffer[dwNumReadDataBytes - 2] = (InputBuffer[dwNumReadDataBytes - 2] | (LastDataBit >> (dwNumRemainingDataBits - 1)));
+    *lpdwNumBytesReturned = AdjustLastReadDataBytes(*pReadDataBuffer, dwNumReadDataBytes, dwNumRemainingDataBits, dwNumTmsClocks);
+
+  return Status;
+}
 
-      dwNumReadDataBytes = (dwNumReadDataBytes - 1);
+DWORD FT2232hMpsseJtag::AdjustLastReadDataBytes(LPBYTE pReadDataBytes, DWORD dwNumReadDataBytes, DWORD dwNumRemainingDataBits,
+                                                DWORD dwNumTmsClocks)
+{
+  DWORD dwNumDataBits = 0;
 
-      for (dwBytesReadIndex = 0 ; dwBytesReadIndex < dwNumReadDataBytes; dwBytesReadIndex++)
-        (*pReadDataBuffer)[dwBytesReadIndex] = InputBuffer[dwBytesReadIndex];
-    }
-    else // case for 0 bit shift in data + TMS read bit
-    {
-      LastDataBit = (InputBuffer[dwNumReadDataBytes - 1] << (dwNumTmsClocks - 1));
-      LastDataBit = (LastDataBit >> 7); // strip the rest
-      InputBuffer[dwNumReadDataBytes - 1] = LastDataBit;
+  dwNumDataBits = ExtractReadDataBits(pReadDataBytes, 0, pReadDataBytes, dwNumReadDataBytes, dwNumRemainingDataBits, dwNumTmsClocks);
 
-      for (dwBytesReadIndex = 0 ; dwBytesReadIndex < dwNumReadDataBytes; dwBytesReadIndex++)
-        (*pReadDataBuffer)[dwBytesReadIndex] = InputBuffer[dwBytesReadIndex];
-    }
+  return ((dwNumDataBits + (NUMBITSINBYTE - 1)) / NUMBITSINBYTE);
+}
+
+// The bits of the last partial data byte come back in the top bits of the byte and the last data bit comes back in
+// the TMS read byte, so the data bits are moved to dwDestinationBitOffset bits into the destination in three parts
+DWORD FT2232hMpsseJtag::ExtractReadDataBits(LPBYTE pDestination, DWORD dwDestinationBitOffset, LPBYTE pReadDataBytes,
+                                            DWORD dwNumReadDataBytes, DWORD dwNumRemainingDataBits, DWORD dwNumTmsClocks)
+{
+  DWORD dwNumWholeDataBits = 0;
+  DWORD dwNumDataBits = 0;
+  BYTE LastDataBit = 0;
+
+  // the destination may be the read data bytes, so the last data bit is taken before anything is moved
+  LastDataBit = ((pReadDataBytes[(dwNumReadDataBytes - 1)] >> (NUMBITSINBYTE - dwNumTmsClocks)) & '\x01');
+
+  if (dwNumRemainingDataBits < 8)
+  {
+    dwNumWholeDataBits = ((dwNumReadDataBytes - 2) * NUMBITSINBYTE);
+
+    FTC_CopyBits(pDestination, dwDestinationBitOffset, pReadDataBytes, 0, dwNumWholeDataBits);
+    FTC_CopyBits(pDestination, (dwDestinationBitOffset + dwNumWholeDataBits), pReadDataBytes,
+                 (dwNumWholeDataBits + dwNumRemainingDataBits), (NUMBITSINBYTE - dwNumRemainingDataBits));
 
-    *lpdwNumBytesReturned = dwNumReadDataBytes;
+    dwNumDataBits = (dwNumWholeDataBits + (NUMBITSINBYTE - dwNumRemainingDataBits));
   }
+  else // case for 0 bit shift in data + TMS read bit
+  {
+    dwNumDataBits = ((dwNumReadDataBytes - 1) * NUMBITSINBYTE);
 
-  return Status;
+    FTC_CopyBits(pDestination, dwDestinationBitOffset, pReadDataBytes, 0, dwNumDataBits);
+  }
+
+  FTC_CopyBits(pDestination, (dwDestinationBitOffset + dwNumDataBits), &LastDataBit, 0, 1);
+
+  return (dwNumDataBits + 1);
 }
 
 DWORD FT2232hMpsseJtag::AddReadCommandToOutputBuffer(BOOL bInstructionTestData, DWORD dwNumBitsToRead, DWORD dwTapControllerState)
@@ -868,6 +968,7 @@ DWORD FT2232hMpsseJtag::AddReadCommandToOutputBuffer(BOOL bInstructionTestData,
   DWORD dwNumDataBytes = 0;
   DWORD dwNumRemainingDataBits = 0;
   DWORD dwNumTmsClocks = 0;
+  LPBYTE pCommandBytes = NULL;
 
   // adjust for bit count of 1 less than no of bits
   dwModNumBitsToRead = (dwNumBitsToRead - 1);
@@ -885,9 +986,11 @@ DWORD FT2232hMpsseJtag::AddReadCommandToOutputBuffer(BOOL bInstructionTestData,
     dwNumDataBytes = (dwNumDataBytes - 1);
 
     // clk data bytes out on -ve clk LSB
-    AddByteToOutputBuffer(CLK_DATA_BYTES_IN_ON_POS_CLK_LSB_FIRST_CMD, false);
-    AddByteToOutputBuffer((dwNumDataBytes & '\xFF'), false);
-    AddByteToOutputBuffer(((dwNumDataBytes / 256) & '\xFF'), false);
+    pCommandBytes = GetOutputBufferEnd();
+    pCommandBytes[0] = CLK_DATA_BYTES_IN_ON_POS_CLK_LSB_FIRST_CMD;
+    pCommandBytes[1] = (dwNumDataBytes & '\xFF');
+    pCommandBytes[2] = ((dwNumDataBytes / 256) & '\xFF');
+    CommitOutputBufferBytes(3);
   }
 
   // number of remaining bits
@@ -898,8 +1001,10 @@ DWORD FT2232hMpsseJtag::AddReadCommandToOutputBuffer(BOOL bInstructionTestData,
     dwNumRemainingDataBits = (dwNumRemainingDataBits - 1);
 
     //clk data bits out on -ve clk LSB
-    AddByteToOutputBuffer(CLK_DATA_BITS_IN_ON_POS_CLK_LSB_FIRST_CMD, false);
-    AddByteToOutputBuffer((dwNumRemainingDataBits & '\xFF'), false);
+    pCommandBytes = GetOutputBufferEnd();
+    pCommandBytes[0] = CLK_DATA_BITS_IN_ON_POS_CLK_LSB_FIRST_CMD;
+    pCommandBytes[1] = (dwNumRemainingDataBits & '\xFF');
+    CommitOutputBufferBytes(2);
   }
 
   // end it in state passed in, take 1 off the dwTapControllerState variable to correspond with JtagStates enumerated types
@@ -910,7 +1015,7 @@ DWORD FT2232hMpsseJtag::AddReadCommandToOutputBuffer(BOOL bInstructionTestData,
 
 FTC_STATUS FT2232hMpsseJtag::ReadDataFromExternalDevice(FTC_HANDLE ftHandle, BOOL bInstructionTestData, DWORD dwNumBitsToRead,
                                                         PReadDataByteBuffer pReadDataBuffer, LPDWORD lpdwNumBytesReturned,
-                                                        DWORD dwTapControllerState)
+                                                        DWORD dwTapControllerState, DWORD dwNumIdleCycles)
 {
   FTC_STATUS Status = FTC_SUCCESS;
   DWORD dwNumTmsClocks = 0;
@@ -919,6 +1024,9 @@ FTC_STATUS FT2232hMpsseJtag::ReadDataFromExternalDevice(FTC_HANDLE ftHandle, BOO
 
   dwNumTmsClocks = AddReadCommandToOutputBuffer(bInstructionTestData, dwNumBitsToRead, dwTapControllerState);
 
+  // the idle cycles added to the TMS command that ends the scan are read back with the last data bit
+  dwNumTmsClocks = (dwNumTmsClocks + AddIdleCyclesToOutputBuffer(ftHandle, dwNumTmsClocks, dwNumIdleCycles));
+
   AddByteToOutputBuffer(SEND_ANSWER_BACK_IMMEDIATELY_CMD, false);
 
   Status = FTC_SendBytesToDevice(ftHandle);
@@ -926,6 +1034,11 @@ FTC_STATUS FT2232hMpsseJtag::ReadDataFromExternalDevice(FTC_HANDLE ftHandle, BOO
   if (Status == FTC_SUCCESS)
     Status = GetDataFromExternalDevice(ftHandle, dwNumBitsToRead, dwNumTmsClocks, pReadDataBuffer, lpdwNumBytesReturned);
 
+  if (Status == FTC_SUCCESS)
+    UpdateInstructionRegisterCache(ftHandle, bInstructionTestData, dwNumBitsToRead, NULL, dwTapControllerState);
+  else
+    InvalidateInstructionRegisterCache(ftHandle);
+
   return Status;
 }
 
@@ -940,6 +1053,7 @@ DWORD FT2232hMpsseJtag::AddWriteReadCommandDataToOutPutBuffer(BOOL bInstructionT
   DWORD dwLastDataBit = 0;
   DWORD dwDataBitIndex = 0;
   DWORD dwNumTmsClocks = 0;
+  LPBYTE pCommandBytes = NULL;
 
   // adjust for bit count of 1 less than no of bits
   dwModNumBitsToWriteRead = (dwNumBitsToWriteRead - 1);
@@ -957,17 +1071,16 @@ DWORD FT2232hMpsseJtag::AddWriteReadCommandDataToOutPutBuffer(BOOL bInstructionT
     dwNumWriteDataBytes = (dwNumWriteDataBytes - 1);
 
     // clk data bytes out on -ve in +ve clk LSB
-    AddByteToOutputBuffer(CLK_DATA_BYTES_OUT_ON_NEG_CLK_IN_ON_POS_CLK_LSB_FIRST_CMD, false);
-    AddByteToOutputBuffer((dwNumWriteDataBytes & '\xFF'), false);
-    AddByteToOutputBuffer(((dwNumWriteDataBytes / 256) & '\xFF'), false);
+    pCommandBytes = GetOutputBufferEnd();
+    pCommandBytes[0] = CLK_DATA_BYTES_OUT_ON_NEG_CLK_IN_ON_POS_CLK_LSB_FIRST_CMD;
+    pCommandBytes[1] = (dwNumWriteDataBytes & '\xFF');
+    pCommandBytes[2] = ((dwNumWriteDataBytes / 256) & '\xFF');
+    CommitOutputBufferBytes(3);
 
     // now add the data bytes to go out
-    do
-    {
-      AddByteToOutputBuffer((*pWriteDataBuffer)[dwDataBufferIndex], false);
-      dwDataBufferIndex = (dwDataBufferIndex + 1);
-    }
-    while (dwDataBufferIndex < (dwNumWriteDataBytes + 1));
+    dwDataBufferIndex = (dwNumWriteDataBytes + 1);
+
+    AddDataBytesToOutputBuffer(*pWriteDataBuffer, dwDataBufferIndex);
   }
 
   dwNumRemainingDataBits = (dwModNumBitsToWriteRead % 8);
@@ -977,16 +1090,18 @@ DWORD FT2232hMpsseJtag::AddWriteReadCommandDataToOutPutBuffer(BOOL bInstructionT
     dwNumRemainingDataBits = (dwNumRemainingDataBits - 1);
 
     // clk data bits out on -ve in +ve clk LSB
-    AddByteToOutputBuffer(CLK_DATA_BITS_OUT_ON_NEG_CLK_IN_ON_POS_CLK_LSB_FIRST_CMD, false);
-    AddByteToOutputBuffer((dwNumRemainingDataBits & '\xFF'), false);
-    AddByteToOutputBuffer((*pWriteDataBuffer)[dwDataBufferIndex], false);
+    pCommandBytes = GetOutputBufferEnd();
+    pCommandBytes[0] = CLK_DATA_BITS_OUT_ON_NEG_CLK_IN_ON_POS_CLK_LSB_FIRST_CMD;
+    pCommandBytes[1] = (dwNumRemainingDataBits & '\xFF');
+    pCommandBytes[2] = (*pWriteDataBuffer)[dwDataBufferIndex];
+    CommitOutputBufferBytes(3);
   }
 
   // get last bit
   dwLastDataBit = (*pWriteDataBuffer)[dwDataBufferIndex];
   dwDataBitIndex = (dwNumBitsToWriteRead % 8);
 
-  if (dwDataBitIndex == 8)
+  if (dwDataBitIndex == 0)
     dwLastDataBit = (dwLastDataBit >> ((8 - dwDataBitIndex) - 1));
   else
     dwLastDataBit = (dwLastDataBit >> (dwDataBitIndex - 1));
@@ -1000,518 +1115,1068 @@ DWORD FT2232hMpsseJtag::AddWriteReadCommandDataToOutPutBuffer(BOOL bInstructionT
 FTC_STATUS FT2232hMpsseJtag::WriteReadDataToFromExternalDevice(FTC_HANDLE ftHandle, BOOL bInstructionTestData, DWORD dwNumBitsToWriteRead,
                                                                PWriteDataByteBuffer pWriteDataBuffer, DWORD dwNumBytesToWrite,
                                                                PReadDataByteBuffer pReadDataBuffer, LPDWORD lpdwNumBytesReturned,
-                                                               DWORD dwTapControllerState)
+                                                               DWORD dwTapControllerState, DWORD dwNumIdleCycles)
 {
   FTC_STATUS Status = FTC_SUCCESS;
   DWORD dwNumRemainingDataBits = 0;
-  BYTE LastDataBit = 0;
   DWORD dwNumTmsClocks = 0;
   DWORD dwNumReadDataBytes = 0;
-  InputByteBuffer InputBuffer;
   DWORD dwNumDataBytesRead = 0;
-  DWORD dwBytesReadIndex = 0;
 
   FTC_ClearOutputBuffer();
 
   dwNumTmsClocks = AddWriteReadCommandDataToOutPutBuffer(bInstructionTestData, dwNumBitsToWriteRead,
                                                          pWriteDataBuffer, dwNumBytesToWrite, dwTapControllerState);
 
+  // the idle cycles added to the TMS command that ends the scan are read back with the last data bit
+  dwNumTmsClocks = (dwNumTmsClocks + AddIdleCyclesToOutputBuffer(ftHandle, dwNumTmsClocks, dwNumIdleCycles));
+
   AddByteToOutputBuffer(SEND_ANSWER_BACK_IMMEDIATELY_CMD, false);
 
   GetNumDataBytesToRead(dwNumBitsToWriteRead, &dwNumReadDataBytes, &dwNumRemainingDataBits);
 
-  Status = FTC_SendReadBytesToFromDevice(ftHandle, &InputBuffer, dwNumReadDataBytes, &dwNumDataBytesRead);
+  Status = FTC_SendReadBytesToFromDevice(ftHandle, *pReadDataBuffer, dwNumReadDataBytes, &dwNumDataBytesRead);
 
   if (Status == FTC_SUCCESS)
-  {
-    // adjust last 2 bytes
-    if (dwNumRemainingDataBits < 8)
-    {
-      InputBuffer[dwNumReadDataBytes - 2] = (InputBuffer[dwNumReadDataBytes - 2] >> dwNumRemainingDataBits);
-      LastDataBit = (InputBuffer[dwNumReadDataBytes - 1] << (dwNumTmsClocks - 1));
-      LastDataBit = (LastDataBit & '\x80'); // strip the rest
-      InputBuffer[dwNumReadDataBytes - 2] = (InputBuffer[dwNumReadDataBytes - 2] | (LastDataBit >> (dwNumRemainingDataBits - 1)));
+    *lpdwNumBytesReturned = AdjustLastReadDataBytes(*pReadDataBuffer, dwNumReadDataBytes, dwNumRemainingDataBits, dwNumTmsClocks);
+
+  if (Status == FTC_SUCCESS)
+    UpdateInstructionRegisterCache(ftHandle, bInstructionTestData, dwNumBitsToWriteRead, pWriteDataBuffer, dwTapControllerState);
+  else
+    InvalidateInstructionRegisterCache(ftHandle);
 
-      dwNumReadDataBytes = (dwNumReadDataBytes - 1);
+  return Status;
+}
 
-      for (dwBytesReadIndex = 0 ; dwBytesReadIndex < dwNumReadDataBytes; dwBytesReadIndex++)
-        (*pReadDataBuffer)[dwBytesReadIndex] = InputBuffer[dwBytesReadIndex];
+FTC_STATUS FT2232hMpsseJtag::StreamScanDataToFromExternalDevice(FTC_HANDLE ftHandle, BOOL bInstructionTestData, ULONGLONG ulNumBitsToScan,
+                                                                PFTC_SCAN_DATA_SOURCE pDataSource, PFTC_SCAN_DATA_SINK pDataSink,
+                                                                LPVOID pContext, DWORD dwTapControllerState)
+{
+  FTC_STATUS Status = FTC_SUCCESS;
+  JtagStates StartJtagState = CurrentJtagState;
+  ULONGLONG ulNumRemainingDataBytes = 0;
+  DWORD dwNumRemainingDataBits = 0;
+  DWORD dwNumBlockDataBytes = 0;
+  DWORD dwNumReadDataBytes = 0;
+  DWORD dwNumDataBytesRead = 0;
+  DWORD dwNumTmsClocks = 0;
+  DWORD dwLastDataBit = NO_LAST_DATA_BIT;
+  BYTE LastDataByte = 0;
+  BYTE DataBytesCommand = 0;
+  BYTE DataBitsCommand = 0;
+  BOOL bFirstBlockSent = FALSE;
+  BOOL bBlockSent = FALSE;
+  BOOL bLastBlock = FALSE;
+  BOOL bDeadlineStarted = FALSE;
+  LPBYTE pCommandBytes = NULL;
+  LPBYTE pReadDataBytes = NULL;
+
+  // adjust for bit count of 1 less than no of bits, the last bit is clocked with the move out of the shift state
+  ulNumRemainingDataBytes = ((ulNumBitsToScan - 1) / NUMBITSINBYTE);
+  dwNumRemainingDataBits = DWORD((ulNumBitsToScan - 1) % NUMBITSINBYTE);
+
+  if (pDataSource == NULL)
+  {
+    DataBytesCommand = CLK_DATA_BYTES_IN_ON_POS_CLK_LSB_FIRST_CMD;
+    DataBitsCommand = CLK_DATA_BITS_IN_ON_POS_CLK_LSB_FIRST_CMD;
+  }
+  else
+  {
+    if (pDataSink == NULL)
+    {
+      DataBytesCommand = CLK_DATA_BYTES_OUT_ON_NEG_CLK_LSB_FIRST_CMD;
+      DataBitsCommand = CLK_DATA_BITS_OUT_ON_NEG_CLK_LSB_FIRST_CMD;
     }
-    else // case for 0 bit shift in data + TMS read bit
+    else
     {
-      LastDataBit = (InputBuffer[dwNumReadDataBytes - 1] << (dwNumTmsClocks - 1));
-      LastDataBit = (LastDataBit >> 7); // strip the rest
-      InputBuffer[dwNumReadDataBytes - 1] = LastDataBit;
-
-      for (dwBytesReadIndex = 0 ; dwBytesReadIndex < dwNumReadDataBytes; dwBytesReadIndex++)
-        (*pReadDataBuffer)[dwBytesReadIndex] = InputBuffer[dwBytesReadIndex];
+      DataBytesCommand = CLK_DATA_BYTES_OUT_ON_NEG_CLK_IN_ON_POS_CLK_LSB_FIRST_CMD;
+      DataBitsCommand = CLK_DATA_BITS_OUT_ON_NEG_CLK_IN_ON_POS_CLK_LSB_FIRST_CMD;
     }
+  }
 
-    *lpdwNumBytesReturned = dwNumReadDataBytes;
+  // All the blocks share one command deadline
+  bDeadlineStarted = FTC_StartDeviceCommandDeadline(ftHandle);
+
+  // Only one block of data is held at a time, so the memory used does not depend on the number of bits scanned
+  if (pDataSink != NULL)
+  {
+    pReadDataBytes = new BYTE[STREAM_SCAN_READ_BUFFER_SIZE];
+
+    if (pReadDataBytes == NULL)
+      Status = FTC_INSUFFICIENT_RESOURCES;
   }
 
-  return Status;
-}
+  while ((bLastBlock == FALSE) && (Status == FTC_SUCCESS))
+  {
+    if (ulNumRemainingDataBytes > MAX_NUM_BYTE_SHIFT_DATA_BYTES)
+      dwNumBlockDataBytes = MAX_NUM_BYTE_SHIFT_DATA_BYTES;
+    else
+    {
+      dwNumBlockDataBytes = DWORD(ulNumRemainingDataBytes);
+      bLastBlock = TRUE;
+    }
 
-FTC_STATUS FT2232hMpsseJtag::GenerateTCKClockPulses(FTC_HANDLE ftHandle, DWORD dwNumClockPulses)
-{
-  FTC_STATUS Status = FTC_SUCCESS;
-  DWORD dwTotalNumClockPulsesBytes = 0;
-  DWORD dwNumClockPulsesByteBlocks = 0;
-  DWORD dwNumClockPulsesByteBlockCntr = 0;
-  DWORD dwNumClockPulsesBytes = 0;
-  DWORD dwNumRemainingClockPulsesBits = 0;
-  DWORD dwDataBufferIndex = 0;
+    ulNumRemainingDataBytes = (ulNumRemainingDataBytes - dwNumBlockDataBytes);
 
-  MoveJTAGFromOneStateToAnother(RunTestIdle, NO_LAST_DATA_BIT, FALSE);
+    bBlockSent = FALSE;
 
-  dwTotalNumClockPulsesBytes = (dwNumClockPulses / NUMBITSINBYTE);
+    FTC_ClearOutputBuffer();
 
-  if (dwTotalNumClockPulsesBytes > 0)
-  {
-    dwNumClockPulsesByteBlocks = (dwTotalNumClockPulsesBytes / NUM_BYTE_CLOCK_PULSES_BLOCK_SIZE);
+    if (bFirstBlockSent == FALSE)
+    {
+      if (bInstructionTestData == FALSE)
+        MoveJTAGFromOneStateToAnother(ShiftDataRegister, NO_LAST_DATA_BIT, false);
+      else
+        MoveJTAGFromOneStateToAnother(ShiftInstructionRegister, NO_LAST_DATA_BIT, false);
+    }
 
-    do
+    if (dwNumBlockDataBytes > 0)
     {
-      if (dwNumClockPulsesByteBlockCntr < dwNumClockPulsesByteBlocks)
-        dwNumClockPulsesBytes = NUM_BYTE_CLOCK_PULSES_BLOCK_SIZE;
+      pCommandBytes = GetOutputBufferEnd();
+      pCommandBytes[0] = DataBytesCommand;
+      pCommandBytes[1] = ((dwNumBlockDataBytes - 1) & '\xFF');
+      pCommandBytes[2] = (((dwNumBlockDataBytes - 1) / 256) & '\xFF');
+
+      // The data source fills the output buffer straight after the command, so the data bytes are not copied again
+      if (pDataSource != NULL)
+      {
+        Status = pDataSource(pContext, &pCommandBytes[3], dwNumBlockDataBytes);
+
+        CommitOutputBufferBytes((3 + dwNumBlockDataBytes));
+      }
       else
-        dwNumClockPulsesBytes = (dwTotalNumClockPulsesBytes - (dwNumClockPulsesByteBlockCntr * NUM_BYTE_CLOCK_PULSES_BLOCK_SIZE));
+        CommitOutputBufferBytes(3);
+    }
 
-      if (dwNumClockPulsesBytes > 0)
+    if ((bLastBlock == TRUE) && (Status == FTC_SUCCESS))
+    {
+      // The last byte holds the remaining data bits followed by the last data bit
+      if (pDataSource != NULL)
       {
-        // Number of whole bytes
-        dwNumClockPulsesBytes = (dwNumClockPulsesBytes - 1);
+        Status = pDataSource(pContext, &LastDataByte, 1);
 
-        // clk data bytes out on -ve clk LSB
-        AddByteToOutputBuffer(CLK_DATA_BYTES_OUT_ON_NEG_CLK_LSB_FIRST_CMD, false);
-        AddByteToOutputBuffer((dwNumClockPulsesBytes & '\xFF'), false);
-        AddByteToOutputBuffer(((dwNumClockPulsesBytes / 256) & '\xFF'), false);
+        dwLastDataBit = ((LastDataByte >> dwNumRemainingDataBits) & '\x01');
+      }
 
-        DWORD dwDataBufferIndex = 0;
+      if ((dwNumRemainingDataBits > 0) && (Status == FTC_SUCCESS))
+      {
+        pCommandBytes = GetOutputBufferEnd();
+        pCommandBytes[0] = DataBitsCommand;
+        pCommandBytes[1] = ((dwNumRemainingDataBits - 1) & '\xFF');
 
-        // now add the data bytes ie 0 to go out with the clock pulses
-        do
+        if (pDataSource != NULL)
         {
-          AddByteToOutputBuffer(0, false);
-          dwDataBufferIndex = (dwDataBufferIndex + 1);
+          pCommandBytes[2] = LastDataByte;
+          CommitOutputBufferBytes(3);
         }
-        while (dwDataBufferIndex < (dwNumClockPulsesBytes + 1));
+        else
+          CommitOutputBufferBytes(2);
       }
 
-      Status = FTC_SendBytesToDevice(ftHandle);
-
-      dwNumClockPulsesByteBlockCntr = (dwNumClockPulsesByteBlockCntr + 1);
+      // end it in state passed in, take 1 off the dwTapControllerState variable to correspond with JtagStates enumerated types
+      if (Status == FTC_SUCCESS)
+        dwNumTmsClocks = MoveJTAGFromOneStateToAnother(JtagStates((dwTapControllerState - 1)), dwLastDataBit, (pDataSink != NULL));
     }
-    while ((dwNumClockPulsesByteBlockCntr <= dwNumClockPulsesByteBlocks) && (Status == FTC_SUCCESS));
-  }
-
-  if (Status == FTC_SUCCESS)
-  {
-    dwNumRemainingClockPulsesBits = (dwNumClockPulses % NUMBITSINBYTE);
 
-    if (dwNumRemainingClockPulsesBits > 0)
+    if (Status == FTC_SUCCESS)
     {
-      dwNumRemainingClockPulsesBits = (dwNumRemainingClockPulsesBits - 1);
+      if (pDataSink != NULL)
+      {
+        AddByteToOutputBuffer(SEND_ANSWER_BACK_IMMEDIATELY_CMD, false);
 
-      //clk data bits out on -ve clk LSB
-      AddByteToOutputBuffer(CLK_DATA_BITS_OUT_ON_NEG_CLK_LSB_FIRST_CMD, false);
-      AddByteToOutputBuffer((dwNumRemainingClockPulsesBits & '\xFF'), false);
-      AddByteToOutputBuffer('\xFF', false);
+        dwNumReadDataBytes = dwNumBlockDataBytes;
 
-      Status = FTC_SendBytesToDevice(ftHandle);
+        // add the remaining data bits byte and the TMS read byte
+        if (bLastBlock == TRUE)
+        {
+          if (dwNumRemainingDataBits > 0)
+            dwNumReadDataBytes = (dwNumReadDataBytes + 1);
+
+          dwNumReadDataBytes = (dwNumReadDataBytes + 1);
+        }
+
+        Status = FTC_SendReadBytesToFromDevice(ftHandle, pReadDataBytes, dwNumReadDataBytes, &dwNumDataBytesRead);
+
+        if (Status == FTC_SUCCESS)
+        {
+          bFirstBlockSent = TRUE;
+          bBlockSent = TRUE;
+
+          if (bLastBlock == TRUE)
+            dwNumReadDataBytes = AdjustLastReadDataBytes(pReadDataBytes, dwNumReadDataBytes, (NUMBITSINBYTE - dwNumRemainingDataBits),
+                                                         dwNumTmsClocks);
+
+          if (dwNumReadDataBytes > 0)
+            Status = pDataSink(pContext, pReadDataBytes, dwNumReadDataBytes);
+        }
+      }
+      else
+      {
+        Status = FTC_SendBytesToDevice(ftHandle);
+
+        if (Status == FTC_SUCCESS)
+        {
+          bFirstBlockSent = TRUE;
+          bBlockSent = TRUE;
+        }
+      }
+    }
+
+    // Nothing has been clocked if the first block never reached the device, so the TAP controller is still in the
+    // state it was in at the start of the scan. Once part of the scan has been clocked, the TAP controller has only
+    // reached the end state if the last block was sent, otherwise it has been left in the shift state or somewhere on
+    // the way out of it, so the state is not known and the TAP controller is reset by the next move
+    if (Status != FTC_SUCCESS)
+    {
+      if (bFirstBlockSent == FALSE)
+        CurrentJtagState = StartJtagState;
+      else if ((bLastBlock == FALSE) || (bBlockSent == FALSE))
+        CurrentJtagState = Undefined;
     }
   }
 
-  //MoveJTAGFromOneStateToAnother(RunTestIdle, NO_LAST_DATA_BIT, FALSE);
+  FTC_ClearOutputBuffer();
 
-  //Status = FTC_SendBytesToDevice(ftHandle);
+  if (bDeadlineStarted)
+    FTC_EndDeviceCommandDeadline(ftHandle);
+
+  if (pReadDataBytes != NULL)
+    delete [] pReadDataBytes;
+
+  // the data of a streaming scan is not kept, so it is never cached
+  if (Status == FTC_SUCCESS)
+    UpdateInstructionRegisterCache(ftHandle, bInstructionTestData, 0, NULL, dwTapControllerState);
+  else
+    InvalidateInstructionRegisterCache(ftHandle);
 
   return Status;
 }
 
-FTC_STATUS FT2232hMpsseJtag::GenerateClockPulsesHiSpeedDevice(FTC_HANDLE ftHandle, BOOL bPulseClockTimesEightFactor, DWORD dwNumClockPulses, BOOL bControlLowInputOutputPin, BOOL bStopClockPulsesState)
+DWORD FT2232hMpsseJtag::AddCompareScanBlockToOutputBuffer(PWriteDataByteBuffer pWriteDataBuffer, DWORD dwNumDataBytes,
+                                                         DWORD dwBlockIndex, DWORD dwNumBlocks, DWORD dwNumRemainingDataBits,
+                                                         DWORD dwTapControllerState)
 {
-  FTC_STATUS Status = FTC_SUCCESS;
+  DWORD dwDataBytesIndex = (dwBlockIndex * COMPARE_SCAN_BLOCK_NUM_DATA_BYTES);
+  DWORD dwNumBlockDataBytes = (dwNumDataBytes - dwDataBytesIndex);
+  DWORD dwNumTmsClocks = 0;
+  DWORD dwLastDataBit = 0;
+  LPBYTE pCommandBytes = NULL;
 
-  if (!bControlLowInputOutputPin)
+  if (dwNumBlockDataBytes > COMPARE_SCAN_BLOCK_NUM_DATA_BYTES)
+    dwNumBlockDataBytes = COMPARE_SCAN_BLOCK_NUM_DATA_BYTES;
+
+  if (dwNumBlockDataBytes > 0)
   {
-    if (!bPulseClockTimesEightFactor)
-    {
-      // pulses the clock the specified number of times with no data transfer
-      AddByteToOutputBuffer(CLK_FOR_NUM_CLOCKS_NO_DATA_BYTES_CMD, TRUE);
-      AddByteToOutputBuffer((dwNumClockPulses & '\xFF'), FALSE);
-    }
-    else
-    {
-      // pulses the clock eight times the specified number of times with no data transfer
-      AddByteToOutputBuffer(CLK_FOR_TIMES_EIGHT_CLOCKS_NO_DATA_BYTES_CMD, TRUE);
-      AddByteToOutputBuffer((dwNumClockPulses & '\xFF'), FALSE);
-      AddByteToOutputBuffer(((dwNumClockPulses / 256) & '\xFF'), FALSE);
-    }
+    // clk data bytes out on -ve clk LSB, in on +ve clk
+    pCommandBytes = GetOutputBufferEnd();
+    pCommandBytes[0] = CLK_DATA_BYTES_OUT_ON_NEG_CLK_IN_ON_POS_CLK_LSB_FIRST_CMD;
+    pCommandBytes[1] = ((dwNumBlockDataBytes - 1) & '\xFF');
+    pCommandBytes[2] = (((dwNumBlockDataBytes - 1) / 256) & '\xFF');
+    CommitOutputBufferBytes(3);
+
+    AddDataBytesToOutputBuffer(&(*pWriteDataBuffer)[dwDataBytesIndex], dwNumBlockDataBytes);
   }
-  else
+
+  // the last block also clocks the remaining data bits and the last data bit
+  if ((dwBlockIndex + 1) == dwNumBlocks)
   {
-    if (!bStopClockPulsesState)
-    {
-      // pulses the clock eight times the specified number of times or until GPIOL2 goes low with no data transfer
-      AddByteToOutputBuffer(CLK_FOR_TIMES_EIGHT_CLOCKS_GPIOL2_LOW_NO_DATA_BYTES_CMD, TRUE);
-      AddByteToOutputBuffer((dwNumClockPulses & '\xFF'), FALSE);
-      AddByteToOutputBuffer(((dwNumClockPulses / 256) & '\xFF'), FALSE);
-    }
-    else
+    if (dwNumRemainingDataBits > 0)
     {
-      // pulses the clock eight times the specified number of times or until GPIOL2 goes high with no data transfer
-      AddByteToOutputBuffer(CLK_FOR_TIMES_EIGHT_CLOCKS_GPIOL2_HIGH_NO_DATA_BYTES_CMD, TRUE);
-      AddByteToOutputBuffer((dwNumClockPulses & '\xFF'), FALSE);
-      AddByteToOutputBuffer(((dwNumClockPulses / 256) & '\xFF'), FALSE);
+      //clk data bits out on -ve clk LSB, in on +ve clk
+      pCommandBytes = GetOutputBufferEnd();
+      pCommandBytes[0] = CLK_DATA_BITS_OUT_ON_NEG_CLK_IN_ON_POS_CLK_LSB_FIRST_CMD;
+      pCommandBytes[1] = ((dwNumRemainingDataBits - 1) & '\xFF');
+      pCommandBytes[2] = (*pWriteDataBuffer)[dwNumDataBytes];
+      CommitOutputBufferBytes(3);
     }
+
+    dwLastDataBit = (((*pWriteDataBuffer)[dwNumDataBytes] >> dwNumRemainingDataBits) & '\x01');
+
+    // end it in state passed in, take 1 off the dwTapControllerState variable to correspond with JtagStates enumerated types
+    dwNumTmsClocks = MoveJTAGFromOneStateToAnother(JtagStates((dwTapControllerState - 1)), dwLastDataBit, true);
   }
 
-  Status = FTC_SendBytesToDevice(ftHandle);
+  AddByteToOutputBuffer(SEND_ANSWER_BACK_IMMEDIATELY_CMD, false);
 
-  return Status;
+  return dwNumTmsClocks;
 }
 
-void FT2232hMpsseJtag::ProcessReadCommandsSequenceBytes(PInputByteBuffer pInputBuffer, DWORD dwNumBytesRead, PReadCmdSequenceDataByteBuffer pReadCmdSequenceDataBuffer,
-                                                        LPDWORD lpdwNumBytesReturned)
+FTC_STATUS FT2232hMpsseJtag::WriteReadCompareDataToFromExternalDevice(FTC_HANDLE ftHandle, BOOL bInstructionTestData, DWORD dwNumBitsToWriteRead,
+                                                                      PWriteDataByteBuffer pWriteDataBuffer, PWriteDataByteBuffer pExpectedDataBuffer,
+                                                                      PWriteDataByteBuffer pMaskDataBuffer, LPDWORD lpdwMismatchBitOffset,
+                                                                      DWORD dwTapControllerState)
 {
-  DWORD CommandSequenceIndex = 0;
-  PReadCommandsSequenceData pReadCommandsSequenceDataBuffer;
-  DWORD dwNumReadCommandSequences;
-  PReadCommandSequenceData pReadCmdSequenceData;
-  DWORD dwNumBitsToRead = 0;
-  DWORD dwNumTmsClocks = 0;
+  FTC_STATUS Status = FTC_SUCCESS;
+  DWORD dwModNumBits = (dwNumBitsToWriteRead - 1);
+  DWORD dwNumDataBytes = (dwModNumBits / 8);
+  DWORD dwNumRemainingDataBits = (dwModNumBits % 8);
+  DWORD dwNumBlocks = 0;
+  DWORD dwNumBlocksSent = 0;
+  DWORD dwBlockIndex = 0;
+  DWORD dwDataBytesIndex = 0;
   DWORD dwNumReadDataBytes = 0;
-  DWORD dwNumRemainingDataBits = 0;
-  BYTE  LastDataBit = 0;
-  DWORD dwBytesReadIndex = 0;
-  DWORD dwNumReadBytesProcessed = 0;
-  DWORD dwTotalNumBytesRead = 0;
-  DWORD dwNumBytesReturned = 0;
+  DWORD dwNumDataBytesRead = 0;
+  DWORD dwNumTmsClocks = 0;
+  DWORD dwNumBlockBits = 0;
+  DWORD dwMismatchBitOffset = NO_TDO_DATA_MISMATCH;
+  BOOL bDeadlineStarted = FALSE;
+  LPBYTE pReadDataBytes = NULL;
 
-  if (iCommandsSequenceDataDeviceIndex != -1)
+  // The scan is split into blocks of whole data bytes. The next block is always written before the replies to a
+  // block are read and compared, so the device keeps clocking while the host compares, and no block is written after
+  // the block with the first mismatch has been compared.
+  dwNumBlocks = (((dwNumDataBytes + COMPARE_SCAN_BLOCK_NUM_DATA_BYTES) - 1) / COMPARE_SCAN_BLOCK_NUM_DATA_BYTES);
+
+  if (dwNumBlocks == 0)
+    dwNumBlocks = 1;
+
+  pReadDataBytes = new BYTE[(dwNumDataBytes + 2)];
+
+  if (pReadDataBytes != NULL)
   {
-    pReadCommandsSequenceDataBuffer = OpenedDevicesCommandsSequenceData[iCommandsSequenceDataDeviceIndex].pReadCommandsSequenceDataBuffer;
-    dwNumReadCommandSequences = OpenedDevicesCommandsSequenceData[iCommandsSequenceDataDeviceIndex].dwNumReadCommandSequences;
+    // All the blocks share one command deadline
+    bDeadlineStarted = FTC_StartDeviceCommandDeadline(ftHandle);
 
-    for (CommandSequenceIndex = 0; (CommandSequenceIndex < dwNumReadCommandSequences); CommandSequenceIndex++)
-    {
-      pReadCmdSequenceData = (*pReadCommandsSequenceDataBuffer)[CommandSequenceIndex];
-      dwNumBitsToRead = (*pReadCmdSequenceData)[0];
-      dwNumTmsClocks = (*pReadCmdSequenceData)[1];
+    FTC_ClearOutputBuffer();
 
-      GetNumDataBytesToRead(dwNumBitsToRead, &dwNumReadDataBytes, &dwNumRemainingDataBits);
+    if (bInstructionTestData == FALSE)
+      MoveJTAGFromOneStateToAnother(ShiftDataRegister, NO_LAST_DATA_BIT, false);
+    else
+      MoveJTAGFromOneStateToAnother(ShiftInstructionRegister, NO_LAST_DATA_BIT, false);
 
-      dwNumReadBytesProcessed = (dwNumReadBytesProcessed + dwNumReadDataBytes);
+    dwNumTmsClocks = AddCompareScanBlockToOutputBuffer(pWriteDataBuffer, dwNumDataBytes, 0, dwNumBlocks,
+                                                       dwNumRemainingDataBits, dwTapControllerState);
 
-      // adjust last 2 bytes
-      if (dwNumRemainingDataBits < 8)
-      {
-        (*pInputBuffer)[dwNumReadBytesProcessed - 2] = ((*pInputBuffer)[dwNumReadBytesProcessed - 2] >> dwNumRemainingDataBits);
-        LastDataBit = ((*pInputBuffer)[dwNumReadBytesProcessed - 1] << (dwNumTmsClocks - 1));
-        LastDataBit = (LastDataBit & '\x80'); // strip the rest
-        (*pInputBuffer)[dwNumReadBytesProcessed - 2] = ((*pInputBuffer)[dwNumReadBytesProcessed - 2] | (LastDataBit >> (dwNumRemainingDataBits - 1)));
+    if ((Status = FTC_SendBytesToDevice(ftHandle)) == FTC_SUCCESS)
+      dwNumBlocksSent = 1;
 
-        dwNumReadDataBytes = (dwNumReadDataBytes - 1);
+    for (dwBlockIndex = 0; ((dwBlockIndex < dwNumBlocksSent) && (Status == FTC_SUCCESS)); dwBlockIndex++)
+    {
+      if ((dwNumBlocksSent < dwNumBlocks) && (dwMismatchBitOffset == NO_TDO_DATA_MISMATCH))
+      {
+        dwNumTmsClocks = AddCompareScanBlockToOutputBuffer(pWriteDataBuffer, dwNumDataBytes, dwNumBlocksSent, dwNumBlocks,
+                                                           dwNumRemainingDataBits, dwTapControllerState);
 
-        for (dwBytesReadIndex = 0; dwBytesReadIndex < dwNumReadDataBytes; dwBytesReadIndex++)
-          (*pReadCmdSequenceDataBuffer)[(dwBytesReadIndex + dwNumBytesReturned)] = (*pInputBuffer)[(dwBytesReadIndex + dwTotalNumBytesRead)];
+        if ((Status = FTC_SendBytesToDevice(ftHandle)) == FTC_SUCCESS)
+          dwNumBlocksSent = (dwNumBlocksSent + 1);
       }
-      else // case for 0 bit shift in data + TMS read bit
+
+      if (Status == FTC_SUCCESS)
       {
-        LastDataBit = ((*pInputBuffer)[dwNumReadBytesProcessed - 1] << (dwNumTmsClocks - 1));
-        LastDataBit = (LastDataBit >> 7); // strip the rest
-        (*pInputBuffer)[dwNumReadBytesProcessed - 1] = LastDataBit;
+        dwDataBytesIndex = (dwBlockIndex * COMPARE_SCAN_BLOCK_NUM_DATA_BYTES);
 
-        for (dwBytesReadIndex = 0; dwBytesReadIndex < dwNumReadDataBytes; dwBytesReadIndex++)
-          (*pReadCmdSequenceDataBuffer)[(dwBytesReadIndex + dwNumBytesReturned)] = (*pInputBuffer)[(dwBytesReadIndex + dwTotalNumBytesRead)];
-      }
+        dwNumReadDataBytes = (dwNumDataBytes - dwDataBytesIndex);
 
-      dwTotalNumBytesRead = dwNumReadBytesProcessed;
+        if (dwNumReadDataBytes > COMPARE_SCAN_BLOCK_NUM_DATA_BYTES)
+          dwNumReadDataBytes = COMPARE_SCAN_BLOCK_NUM_DATA_BYTES;
 
-      dwNumBytesReturned = (dwNumBytesReturned + dwNumReadDataBytes);
-    }
-  }
+        dwNumBlockBits = (dwNumReadDataBytes * 8);
 
-  *lpdwNumBytesReturned = dwNumBytesReturned;
-}
+        // add the remaining data bits byte and the TMS read byte
+        if ((dwBlockIndex + 1) == dwNumBlocks)
+        {
+          if (dwNumRemainingDataBits > 0)
+            dwNumReadDataBytes = (dwNumReadDataBytes + 1);
 
-DWORD FT2232hMpsseJtag::GetTotalNumCommandsSequenceDataBytesToRead(void)
-{
-  DWORD dwTotalNumBytesToBeRead = 0;
-  DWORD CommandSequenceIndex = 0;
-  PReadCommandsSequenceData pReadCommandsSequenceDataBuffer;
-  DWORD dwNumReadCommandSequences = 0;
-  PReadCommandSequenceData pReadCmdSequenceData;
-  DWORD dwNumBitsToRead = 0;
-  DWORD dwNumDataBytesToRead = 0;
-  DWORD dwNumRemainingDataBits = 0;
+          dwNumReadDataBytes = (dwNumReadDataBytes + 1);
+        }
 
-  if (iCommandsSequenceDataDeviceIndex != -1)
-  {
-    pReadCommandsSequenceDataBuffer = OpenedDevicesCommandsSequenceData[iCommandsSequenceDataDeviceIndex].pReadCommandsSequenceDataBuffer;
-    dwNumReadCommandSequences = OpenedDevicesCommandsSequenceData[iCommandsSequenceDataDeviceIndex].dwNumReadCommandSequences;
+        dwNumDataBytesRead = 0;
+
+        Status = FTC_ReadFixedNumBytesFromDevice(ftHandle, &pReadDataBytes[dwDataBytesIndex], dwNumReadDataBytes, &dwNumDataBytesRead);
+
+        // the replies to the blocks written after a mismatch are only read, so nothing is left behind in the device
+        if ((Status == FTC_SUCCESS) && (dwMismatchBitOffset == NO_TDO_DATA_MISMATCH))
+        {
+          if ((dwBlockIndex + 1) == dwNumBlocks)
+            dwNumBlockBits = ExtractReadDataBits(&pReadDataBytes[dwDataBytesIndex], 0, &pReadDataBytes[dwDataBytesIndex],
+                                                 dwNumReadDataBytes, (NUMBITSINBYTE - dwNumRemainingDataBits), dwNumTmsClocks);
+
+          dwMismatchBitOffset = FTC_FindFirstMismatchBit(&pReadDataBytes[dwDataBytesIndex], &(*pExpectedDataBuffer)[dwDataBytesIndex],
+                                                         ((pMaskDataBuffer != NULL) ? &(*pMaskDataBuffer)[dwDataBytesIndex] : NULL),
+                                                         dwNumBlockBits);
+
+          if (dwMismatchBitOffset != FTC_NO_BIT_MISMATCH)
+            dwMismatchBitOffset = ((dwDataBytesIndex * 8) + dwMismatchBitOffset);
+          else
+            dwMismatchBitOffset = NO_TDO_DATA_MISMATCH;
+        }
+      }
+    }
 
-    for (CommandSequenceIndex = 0; (CommandSequenceIndex < dwNumReadCommandSequences); CommandSequenceIndex++)
+    if (Status == FTC_SUCCESS)
     {
-      pReadCmdSequenceData = (*pReadCommandsSequenceDataBuffer)[CommandSequenceIndex];
-      dwNumBitsToRead = (*pReadCmdSequenceData)[0];
+      // the last block was never written, so the TAP controller is still in the shift state. It is stopped in the
+      // pause state through exit1, as passing through the update state would latch the partly shifted in data
+      if (dwNumBlocksSent < dwNumBlocks)
+      {
+        if (bInstructionTestData == FALSE)
+          MoveJTAGFromOneStateToAnother(PauseDataRegister, NO_LAST_DATA_BIT, false);
+        else
+          MoveJTAGFromOneStateToAnother(PauseInstructionRegister, NO_LAST_DATA_BIT, false);
 
-      GetNumDataBytesToRead(dwNumBitsToRead, &dwNumDataBytesToRead, &dwNumRemainingDataBits);
+        Status = FTC_SendBytesToDevice(ftHandle);
+      }
 
-      dwTotalNumBytesToBeRead = (dwTotalNumBytesToBeRead + dwNumDataBytesToRead);
-    }
-  }
+      if (lpdwMismatchBitOffset != NULL)
+        *lpdwMismatchBitOffset = dwMismatchBitOffset;
 
-  return dwTotalNumBytesToBeRead;
-}
+      if ((Status == FTC_SUCCESS) && (dwMismatchBitOffset != NO_TDO_DATA_MISMATCH))
+        Status = FTC_TDO_DATA_MISMATCH;
+    }
 
-void FT2232hMpsseJtag::CopyReadCommandsSequenceDataBuffer(PReadCommandsSequenceData pDestinationBuffer, PReadCommandsSequenceData pSourceBuffer, DWORD dwSizeReadCommandsSequenceDataBuffer)
-{
-  DWORD CommandSequenceIndex = 0;
-  PReadCommandSequenceData pReadCmdSequenceData;
-  DWORD dwNumBitsToRead = 0;
-  DWORD dwNumTmsClocks = 0;
+    FTC_ClearOutputBuffer();
 
-  for (CommandSequenceIndex = 0; (CommandSequenceIndex < dwSizeReadCommandsSequenceDataBuffer); CommandSequenceIndex++)
-  {
-    pReadCmdSequenceData = (*pSourceBuffer)[CommandSequenceIndex];
-    dwNumBitsToRead = (*pReadCmdSequenceData)[0];
-    dwNumTmsClocks = (*pReadCmdSequenceData)[1];
+    if (bDeadlineStarted)
+      FTC_EndDeviceCommandDeadline(ftHandle);
 
-    pReadCmdSequenceData = (*pDestinationBuffer)[CommandSequenceIndex];
-    (*pReadCmdSequenceData)[0] = dwNumBitsToRead;
-    (*pReadCmdSequenceData)[1] = dwNumTmsClocks;
+    delete [] pReadDataBytes;
   }
+  else
+    Status = FTC_INSUFFICIENT_RESOURCES;
+
+  // a scan with a mismatch may have stopped before all the bits were shifted in
+  if (Status == FTC_SUCCESS)
+    UpdateInstructionRegisterCache(ftHandle, bInstructionTestData, dwNumBitsToWriteRead, pWriteDataBuffer, dwTapControllerState);
+  else
+    InvalidateInstructionRegisterCache(ftHandle);
+
+  return Status;
 }
 
-FTC_STATUS FT2232hMpsseJtag::AddReadCommandSequenceData(DWORD dwNumBitsToRead, DWORD dwNumTmsClocks)
+FTC_STATUS FT2232hMpsseJtag::GenerateTCKClockPulses(FTC_HANDLE ftHandle, DWORD dwNumClockPulses)
 {
   FTC_STATUS Status = FTC_SUCCESS;
-  DWORD dwSizeReadCommandsSequenceDataBuffer;
-  PReadCommandsSequenceData pReadCommandsSequenceDataBuffer;
-  DWORD dwNumReadCommandSequences;
-  PReadCommandsSequenceData pTmpReadCmdsSequenceDataBuffer;
-  PReadCommandSequenceData pReadCmdSequenceData;
+  DWORD dwTotalNumClockPulsesBytes = 0;
+  DWORD dwNumClockPulsesByteBlocks = 0;
+  DWORD dwNumClockPulsesByteBlockCntr = 0;
+  DWORD dwNumClockPulsesBytes = 0;
+  DWORD dwNumRemainingClockPulsesBits = 0;
+  LPBYTE pCommandBytes = NULL;
 
-  if (iCommandsSequenceDataDeviceIndex != -1)
+  MoveJTAGFromOneStateToAnother(RunTestIdle, NO_LAST_DATA_BIT, FALSE);
+
+  dwTotalNumClockPulsesBytes = (dwNumClockPulses / NUMBITSINBYTE);
+
+  if (dwTotalNumClockPulsesBytes > 0)
   {
-    dwSizeReadCommandsSequenceDataBuffer = OpenedDevicesCommandsSequenceData[iCommandsSequenceDataDeviceIndex].dwSizeReadCommandsSequenceDataBuffer;
-    pReadCommandsSequenceDataBuffer = OpenedDevicesCommandsSequenceData[iCommandsSequenceDataDeviceIndex].pReadCommandsSequenceDataBuffer;
-    dwNumReadCommandSequences = OpenedDevicesCommandsSequenceData[iCommandsSequenceDataDeviceIndex].dwNumReadCommandSequences;
+    dwNumClockPulsesByteBlocks = (dwTotalNumClockPulsesBytes / NUM_BYTE_CLOCK_PULSES_BLOCK_SIZE);
 
-    if (dwNumReadCommandSequences > (dwSizeReadCommandsSequenceDataBuffer - 1))
+    do
     {
-      pTmpReadCmdsSequenceDataBuffer = CreateReadCommandsSequenceDataBuffer(dwSizeReadCommandsSequenceDataBuffer);
+      if (dwNumClockPulsesByteBlockCntr < dwNumClockPulsesByteBlocks)
+        dwNumClockPulsesBytes = NUM_BYTE_CLOCK_PULSES_BLOCK_SIZE;
+      else
+        dwNumClockPulsesBytes = (dwTotalNumClockPulsesBytes - (dwNumClockPulsesByteBlockCntr * NUM_BYTE_CLOCK_PULSES_BLOCK_SIZE));
 
-      if (pTmpReadCmdsSequenceDataBuffer != NULL)
+      if (dwNumClockPulsesBytes > 0)
       {
-        // Temporary save the contents of the read commands sequence data buffer
-        CopyReadCommandsSequenceDataBuffer(pTmpReadCmdsSequenceDataBuffer, pReadCommandsSequenceDataBuffer, dwSizeReadCommandsSequenceDataBuffer);
+        // Number of whole bytes
+        dwNumClockPulsesBytes = (dwNumClockPulsesBytes - 1);
 
-        DeleteReadCommandsSequenceDataBuffer(pReadCommandsSequenceDataBuffer, dwSizeReadCommandsSequenceDataBuffer);
+        // clk data bytes out on -ve clk LSB
+        pCommandBytes = GetOutputBufferEnd();
+        pCommandBytes[0] = CLK_DATA_BYTES_OUT_ON_NEG_CLK_LSB_FIRST_CMD;
+        pCommandBytes[1] = (dwNumClockPulsesBytes & '\xFF');
+        pCommandBytes[2] = ((dwNumClockPulsesBytes / 256) & '\xFF');
 
-        // Increase the size of the read commands sequence data buffer
-        pReadCommandsSequenceDataBuffer = CreateReadCommandsSequenceDataBuffer((dwSizeReadCommandsSequenceDataBuffer + COMMAND_SEQUENCE_READ_DATA_BUFFER_SIZE_INCREMENT));
-  
-        if (pReadCommandsSequenceDataBuffer != NULL)
-        {
-          CopyReadCommandsSequenceDataBuffer(pReadCommandsSequenceDataBuffer, pTmpReadCmdsSequenceDataBuffer, dwSizeReadCommandsSequenceDataBuffer);
+        // now add the data bytes ie 0 to go out with the clock pulses
+        memset(&pCommandBytes[3], 0, (dwNumClockPulsesBytes + 1));
 
-          DeleteReadCommandsSequenceDataBuffer(pTmpReadCmdsSequenceDataBuffer, dwSizeReadCommandsSequenceDataBuffer);
+        CommitOutputBufferBytes((3 + dwNumClockPulsesBytes + 1));
+      }
 
-          dwSizeReadCommandsSequenceDataBuffer = (dwSizeReadCommandsSequenceDataBuffer + COMMAND_SEQUENCE_READ_DATA_BUFFER_SIZE_INCREMENT);
+      Status = FTC_SendBytesToDevice(ftHandle);
 
-          OpenedDevicesCommandsSequenceData[iCommandsSequenceDataDeviceIndex].dwSizeReadCommandsSequenceDataBuffer = dwSizeReadCommandsSequenceDataBuffer;
-          OpenedDevicesCommandsSequenceData[iCommandsSequenceDataDeviceIndex].pReadCommandsSequenceDataBuffer = pReadCommandsSequenceDataBuffer;
-        }
-        else
-          Status = FTC_INSUFFICIENT_RESOURCES;
-      }
-      else
-        Status = FTC_INSUFFICIENT_RESOURCES;
+      dwNumClockPulsesByteBlockCntr = (dwNumClockPulsesByteBlockCntr + 1);
     }
+    while ((dwNumClockPulsesByteBlockCntr <= dwNumClockPulsesByteBlocks) && (Status == FTC_SUCCESS));
+  }
 
-    if (Status == FTC_SUCCESS)
-    {
-      if (dwNumReadCommandSequences > 0)
-        pReadCmdSequenceData = (*pReadCommandsSequenceDataBuffer)[(dwNumReadCommandSequences - 1)];
-
-      pReadCmdSequenceData = (*pReadCommandsSequenceDataBuffer)[dwNumReadCommandSequences];
+  if (Status == FTC_SUCCESS)
+  {
+    dwNumRemainingClockPulsesBits = (dwNumClockPulses % NUMBITSINBYTE);
 
-      (*pReadCmdSequenceData)[0] = dwNumBitsToRead;
-      (*pReadCmdSequenceData)[1] = dwNumTmsClocks;
+    if (dwNumRemainingClockPulsesBits > 0)
+    {
+      dwNumRemainingClockPulsesBits = (dwNumRemainingClockPulsesBits - 1);
 
-      dwNumReadCommandSequences = (dwNumReadCommandSequences + 1);
+      //clk data bits out on -ve clk LSB
+      pCommandBytes = GetOutputBufferEnd();
+      pCommandBytes[0] = CLK_DATA_BITS_OUT_ON_NEG_CLK_LSB_FIRST_CMD;
+      pCommandBytes[1] = (dwNumRemainingClockPulsesBits & '\xFF');
+      pCommandBytes[2] = '\xFF';
+      CommitOutputBufferBytes(3);
 
-      OpenedDevicesCommandsSequenceData[iCommandsSequenceDataDeviceIndex].dwNumReadCommandSequences = dwNumReadCommandSequences;
+      Status = FTC_SendBytesToDevice(ftHandle);
     }
   }
 
+  //MoveJTAGFromOneStateToAnother(RunTestIdle, NO_LAST_DATA_BIT, FALSE);
+
+  //Status = FTC_SendBytesToDevice(ftHandle);
+
   return Status;
 }
 
-PReadCommandsSequenceData FT2232hMpsseJtag::CreateReadCommandsSequenceDataBuffer(DWORD dwSizeReadCmdsSequenceDataBuffer)
+FTC_STATUS FT2232hMpsseJtag::GenerateTCKClockOnlyPulses(FTC_HANDLE ftHandle, DWORD dwNumClockPulses)
 {
-  PReadCommandsSequenceData pReadCmdsSequenceDataBuffer;
-  DWORD CommandSequenceIndex = 0;
-  PReadCommandSequenceData pReadCmdSequenceData;
+  // FT2232H and FT4232H hi-speed devices can pulse the clock without clocking any data out, so instead of sending a
+  // data byte for every eight clock pulses, a few clock only commands are sent for any number of clock pulses
+  FTC_STATUS Status = FTC_SUCCESS;
 
-  pReadCmdsSequenceDataBuffer = PReadCommandsSequenceData(new ReadCommandsSequenceData[dwSizeReadCmdsSequenceDataBuffer]);
+  FTC_ClearOutputBuffer();
 
-  if (pReadCmdsSequenceDataBuffer != NULL)
-  {
-    for (CommandSequenceIndex = 0; (CommandSequenceIndex < dwSizeReadCmdsSequenceDataBuffer); CommandSequenceIndex++)
-    {
-      pReadCmdSequenceData = PReadCommandSequenceData(new ReadCommandSequenceData);
+  MoveJTAGFromOneStateToAnother(RunTestIdle, NO_LAST_DATA_BIT, FALSE);
 
-      (*pReadCmdsSequenceDataBuffer)[CommandSequenceIndex] = pReadCmdSequenceData;
-    }
-  }
+  AddClockOnlyPulsesToOutputBuffer(dwNumClockPulses);
 
-  return pReadCmdsSequenceDataBuffer;
+  Status = FTC_SendBytesToDevice(ftHandle);
+
+  return Status;
 }
 
-void FT2232hMpsseJtag::DeleteReadCommandsSequenceDataBuffer(PReadCommandsSequenceData pReadCmdsSequenceDataBuffer, DWORD dwSizeReadCommandsSequenceDataBuffer)
+void FT2232hMpsseJtag::AddClockOnlyPulsesToOutputBuffer(DWORD dwNumClockPulses)
 {
-  DWORD CommandSequenceIndex = 0;
-  PReadCommandSequenceData pReadCmdSequenceData;
+  DWORD dwNumTimesEightClockPulses = 0;
+  DWORD dwNumCmdTimesEightClockPulses = 0;
+  DWORD dwNumRemainingClockPulses = 0;
+  LPBYTE pCommandBytes = NULL;
 
-  for (CommandSequenceIndex = 0; (CommandSequenceIndex < dwSizeReadCommandsSequenceDataBuffer); CommandSequenceIndex++)
+  dwNumTimesEightClockPulses = (dwNumClockPulses / NUMBITSINBYTE);
+
+  while (dwNumTimesEightClockPulses > 0)
   {
-    pReadCmdSequenceData = (*pReadCmdsSequenceDataBuffer)[CommandSequenceIndex];
+    if (dwNumTimesEightClockPulses > MAX_NUM_TIMES_EIGHT_CLOCK_PULSES_CMD)
+      dwNumCmdTimesEightClockPulses = MAX_NUM_TIMES_EIGHT_CLOCK_PULSES_CMD;
+    else
+      dwNumCmdTimesEightClockPulses = dwNumTimesEightClockPulses;
 
-    delete [] pReadCmdSequenceData;
+    // pulses the clock eight times the specified number of times plus one with no data transfer
+    pCommandBytes = GetOutputBufferEnd();
+    pCommandBytes[0] = CLK_FOR_TIMES_EIGHT_CLOCKS_NO_DATA_BYTES_CMD;
+    pCommandBytes[1] = ((dwNumCmdTimesEightClockPulses - 1) & '\xFF');
+    pCommandBytes[2] = (((dwNumCmdTimesEightClockPulses - 1) / 256) & '\xFF');
+    CommitOutputBufferBytes(3);
+
+    dwNumTimesEightClockPulses = (dwNumTimesEightClockPulses - dwNumCmdTimesEightClockPulses);
   }
 
-  delete [] pReadCmdsSequenceDataBuffer;
+  dwNumRemainingClockPulses = (dwNumClockPulses % NUMBITSINBYTE);
+
+  if (dwNumRemainingClockPulses > 0)
+  {
+    // pulses the clock the specified number of times plus one with no data transfer
+    pCommandBytes = GetOutputBufferEnd();
+    pCommandBytes[0] = CLK_FOR_NUM_CLOCKS_NO_DATA_BYTES_CMD;
+    pCommandBytes[1] = ((dwNumRemainingClockPulses - 1) & '\xFF');
+    CommitOutputBufferBytes(2);
+  }
 }
 
-FTC_STATUS FT2232hMpsseJtag::CreateDeviceCommandsSequenceDataBuffers(FTC_HANDLE ftHandle)
+FTC_STATUS FT2232hMpsseJtag::CheckIdleCyclesParameters(DWORD dwNumIdleCycles, DWORD dwTapControllerState)
 {
   FTC_STATUS Status = FTC_SUCCESS;
-  DWORD dwDeviceIndex = 0;
-  bool bDeviceDataBuffersCreated = false;
-
-  for (dwDeviceIndex = 0; ((dwDeviceIndex < MAX_NUM_DEVICES) && !bDeviceDataBuffersCreated); dwDeviceIndex++)
-  {
-    if (OpenedDevicesCommandsSequenceData[dwDeviceIndex].hDevice == 0)
-    {
-      bDeviceDataBuffersCreated = true;
-
-      OpenedDevicesCommandsSequenceData[dwDeviceIndex].pCommandsSequenceDataOutPutBuffer = POutputByteBuffer(new OutputByteBuffer);
 
-      if (OpenedDevicesCommandsSequenceData[dwDeviceIndex].pCommandsSequenceDataOutPutBuffer != NULL)
-      {
-        OpenedDevicesCommandsSequenceData[dwDeviceIndex].pReadCommandsSequenceDataBuffer = CreateReadCommandsSequenceDataBuffer(INIT_COMMAND_SEQUENCE_READ_DATA_BUFFER_SIZE);
+  if (dwNumIdleCycles > MAX_NUM_IDLE_CYCLES)
+    Status = FTC_INVALID_NUMBER_IDLE_CYCLES;
+  else if ((dwNumIdleCycles > 0) && (dwTapControllerState != RUN_TEST_IDLE_STATE))
+    Status = FTC_INVALID_TAP_CONTROLLER_STATE;
 
-        if (OpenedDevicesCommandsSequenceData[dwDeviceIndex].pReadCommandsSequenceDataBuffer != NULL)
-        {
-          OpenedDevicesCommandsSequenceData[dwDeviceIndex].hDevice = ftHandle;
-          OpenedDevicesCommandsSequenceData[dwDeviceIndex].dwNumBytesToSend = 0;
-          OpenedDevicesCommandsSequenceData[dwDeviceIndex].dwSizeReadCommandsSequenceDataBuffer = INIT_COMMAND_SEQUENCE_READ_DATA_BUFFER_SIZE;
-          OpenedDevicesCommandsSequenceData[dwDeviceIndex].dwNumReadCommandSequences = 0;
-        }
-        else
-        {
-          delete [] OpenedDevicesCommandsSequenceData[dwDeviceIndex].pCommandsSequenceDataOutPutBuffer;
+  return Status;
+}
 
-          Status = FTC_INSUFFICIENT_RESOURCES;
-        }
-      }
-      else
-        Status = FTC_INSUFFICIENT_RESOURCES;
-    }
-  }
+DWORD FT2232hMpsseJtag::GetNumIdleCyclesCommandBytes(DWORD dwNumIdleCycles)
+{
+  DWORD dwNumIdleCyclesCommandBytes = 0;
 
-  if ((Status == FTC_SUCCESS) && (bDeviceDataBuffersCreated == true))
-    dwNumOpenedDevices = dwNumOpenedDevices + 1;
+  // Worst case, ie a FT2232D dual device clocking a data byte out for every eight idle cycles
+  if (dwNumIdleCycles > 0)
+    dwNumIdleCyclesCommandBytes = (NUM_IDLE_CYCLES_COMMAND_BYTES + (dwNumIdleCycles / NUMBITSINBYTE));
 
-  return Status;
+  return dwNumIdleCyclesCommandBytes;
 }
 
-void FT2232hMpsseJtag::ClearDeviceCommandSequenceData(FTC_HANDLE ftHandle)
+// Clocks the TAP controller in the Run-Test/Idle state it has just been moved to. dwNumTmsClocks is the number of
+// clocks of the TMS command that made the move, which is the last command in the output buffer. As many idle cycles
+// as will fit are added to that TMS command and the number added is returned, the rest are clocked by clock commands
+DWORD FT2232hMpsseJtag::AddIdleCyclesToOutputBuffer(FTC_HANDLE ftHandle, DWORD dwNumTmsClocks, DWORD dwNumIdleCycles)
 {
-  DWORD dwDeviceIndex = 0;
-  BOOLEAN bDeviceHandleFound = false;
+  DWORD dwNumMergedIdleCycles = 0;
+  DWORD dwNumIdleCycleBytes = 0;
+  DWORD dwNumRemainingIdleCycles = 0;
+  LPBYTE pCommandBytes = NULL;
 
-  if (ftHandle != 0)
+  // A move of more than MAX_NUM_TMS_CLOCKS clocks is split over two TMS commands, so is never added to
+  if ((dwNumIdleCycles > 0) && (dwNumTmsClocks > 0) && (dwNumTmsClocks < MAX_NUM_TMS_CLOCKS))
   {
-    for (dwDeviceIndex = 0; ((dwDeviceIndex < MAX_NUM_DEVICES) && !bDeviceHandleFound); dwDeviceIndex++)
-    {
-      if (OpenedDevicesCommandsSequenceData[dwDeviceIndex].hDevice == ftHandle)
-      {
-        bDeviceHandleFound = true;
+    dwNumMergedIdleCycles = (MAX_NUM_TMS_CLOCKS - dwNumTmsClocks);
 
-        OpenedDevicesCommandsSequenceData[dwDeviceIndex].dwNumBytesToSend = 0;
-        OpenedDevicesCommandsSequenceData[dwDeviceIndex].dwNumReadCommandSequences = 0;
-      }
-    }
+    if (dwNumMergedIdleCycles > dwNumIdleCycles)
+      dwNumMergedIdleCycles = dwNumIdleCycles;
+
+    // The TMS bits above the move are already 0, which keeps the TAP controller in the Run-Test/Idle state
+    pCommandBytes = (GetOutputBufferEnd() - 3);
+    pCommandBytes[1] = (((dwNumTmsClocks + dwNumMergedIdleCycles) - 1) & '\xFF');
+
+    dwNumIdleCycles = (dwNumIdleCycles - dwNumMergedIdleCycles);
   }
-  else
+
+  if (dwNumIdleCycles > 0)
   {
-    // This code is executed if there is only one device connected to the system, this code is here just in case
-    // that a device was unplugged from the system, while the system was still running
-    for (dwDeviceIndex = 0; ((dwDeviceIndex < MAX_NUM_DEVICES) && !bDeviceHandleFound); dwDeviceIndex++)
+    // Only FT2232D dual devices have to clock data bytes out to pulse the clock
+    if (FTC_IsHiSpeedDeviceHandleValid(ftHandle) == FTC_SUCCESS)
+      AddClockOnlyPulsesToOutputBuffer(dwNumIdleCycles);
+    else
     {
-      if (OpenedDevicesCommandsSequenceData[dwDeviceIndex].hDevice != 0)
+      dwNumIdleCycleBytes = (dwNumIdleCycles / NUMBITSINBYTE);
+
+      if (dwNumIdleCycleBytes > 0)
       {
-        bDeviceHandleFound = true;
+        // clk data bytes out on -ve clk LSB
+        pCommandBytes = GetOutputBufferEnd();
+        pCommandBytes[0] = CLK_DATA_BYTES_OUT_ON_NEG_CLK_LSB_FIRST_CMD;
+        pCommandBytes[1] = ((dwNumIdleCycleBytes - 1) & '\xFF');
+        pCommandBytes[2] = (((dwNumIdleCycleBytes - 1) / 256) & '\xFF');
 
-        OpenedDevicesCommandsSequenceData[dwDeviceIndex].dwNumBytesToSend = 0;
-        OpenedDevicesCommandsSequenceData[dwDeviceIndex].dwNumReadCommandSequences = 0;
+        memset(&pCommandBytes[3], 0, dwNumIdleCycleBytes);
+
+        CommitOutputBufferBytes((3 + dwNumIdleCycleBytes));
       }
-    }
-  }
-}
 
-DWORD FT2232hMpsseJtag::GetNumBytesInCommandsSequenceDataBuffer(void)
-{
-  DWORD dwNumBytesToSend = 0;
+      dwNumRemainingIdleCycles = (dwNumIdleCycles % NUMBITSINBYTE);
 
-  if (iCommandsSequenceDataDeviceIndex != -1)
-    // Get the number commands to be executed in sequence ie write, read and write/read
-    dwNumBytesToSend = OpenedDevicesCommandsSequenceData[iCommandsSequenceDataDeviceIndex].dwNumBytesToSend;
+      if (dwNumRemainingIdleCycles > 0)
+      {
+        //clk data bits out on -ve clk LSB
+        pCommandBytes = GetOutputBufferEnd();
+        pCommandBytes[0] = CLK_DATA_BITS_OUT_ON_NEG_CLK_LSB_FIRST_CMD;
+        pCommandBytes[1] = ((dwNumRemainingIdleCycles - 1) & '\xFF');
+        pCommandBytes[2] = '\x00';
+        CommitOutputBufferBytes(3);
+      }
+    }
+  }
 
-  return dwNumBytesToSend;
+  return dwNumMergedIdleCycles;
 }
 
-DWORD FT2232hMpsseJtag::GetCommandsSequenceDataDeviceIndex(FTC_HANDLE ftHandle)
+FTC_STATUS FT2232hMpsseJtag::GenerateClockPulsesHiSpeedDevice(FTC_HANDLE ftHandle, BOOL bPulseClockTimesEightFactor, DWORD dwNumClockPulses, BOOL bControlLowInputOutputPin, BOOL bStopClockPulsesState)
 {
-  DWORD dwDeviceIndex = 0;
-  BOOLEAN bDeviceHandleFound = false;
-  INT iCmdsSequenceDataDeviceIndex = 0;
+  FTC_STATUS Status = FTC_SUCCESS;
 
-  if (ftHandle != 0)
+  if (!bControlLowInputOutputPin)
   {
-    for (dwDeviceIndex = 0; ((dwDeviceIndex < MAX_NUM_DEVICES) && !bDeviceHandleFound); dwDeviceIndex++)
+    if (!bPulseClockTimesEightFactor)
     {
-      if (OpenedDevicesCommandsSequenceData[dwDeviceIndex].hDevice == ftHandle)
-      {
-        bDeviceHandleFound = true;
-
-        iCmdsSequenceDataDeviceIndex = dwDeviceIndex;
-      }
+      // pulses the clock the specified number of times with no data transfer
+      AddByteToOutputBuffer(CLK_FOR_NUM_CLOCKS_NO_DATA_BYTES_CMD, TRUE);
+      AddByteToOutputBuffer((dwNumClockPulses & '\xFF'), FALSE);
+    }
+    else
+    {
+      // pulses the clock eight times the specified number of times with no data transfer
+      AddByteToOutputBuffer(CLK_FOR_TIMES_EIGHT_CLOCKS_NO_DATA_BYTES_CMD, TRUE);
+      AddByteToOutputBuffer((dwNumClockPulses & '\xFF'), FALSE);
+      AddByteToOutputBuffer(((dwNumClockPulses / 256) & '\xFF'), FALSE);
     }
   }
   else
   {
-    // This code is executed if there is only one device connected to the system, this code is here just in case
-    // that a device was unplugged from the system, while the system was still running
-    for (dwDeviceIndex = 0; ((dwDeviceIndex < MAX_NUM_DEVICES) && !bDeviceHandleFound); dwDeviceIndex++)
+    if (!bStopClockPulsesState)
     {
-      if (OpenedDevicesCommandsSequenceData[dwDeviceIndex].hDevice != 0)
-      {
-        bDeviceHandleFound = true;
-
-        iCmdsSequenceDataDeviceIndex = dwDeviceIndex;
-      }
+      // pulses the clock eight times the specified number of times or until GPIOL2 goes low with no data transfer
+      AddByteToOutputBuffer(CLK_FOR_TIMES_EIGHT_CLOCKS_GPIOL2_LOW_NO_DATA_BYTES_CMD, TRUE);
+      AddByteToOutputBuffer((dwNumClockPulses & '\xFF'), FALSE);
+      AddByteToOutputBuffer(((dwNumClockPulses / 256) & '\xFF'), FALSE);
     }
-  }
-
-  return iCmdsSequenceDataDeviceIndex;
-}
+    else
+    {
+      // pulses the clock eight times the specified number of times or until GPIOL2 goes high with no data transfer
+      AddByteToOutputBuffer(CLK_FOR_TIMES_EIGHT_CLOCKS_GPIOL2_HIGH_NO_DATA_BYTES_CMD, TRUE);
+      AddByteToOutputBuffer((dwNumClockPulses & '\xFF'), FALSE);
+      AddByteToOutputBuffer(((dwNumClockPulses / 256) & '\xFF'), FALSE);
+    }
+  }
+
+  Status = FTC_SendBytesToDevice(ftHandle);
+
+  return Status;
+}
+
+void FT2232hMpsseJtag::ProcessReadCommandsSequenceBytes(PFTC_READ_CMD_SEQUENCE_DATA pReadCmdSequenceData, DWORD dwNumReadCommandSequences,
+                                                        PInputByteBuffer pInputBuffer, DWORD dwNumBytesRead,
+                                                        PReadCmdSequenceDataByteBuffer pReadCmdSequenceDataBuffer, LPDWORD lpdwNumBytesReturned)
+{
+  DWORD CommandSequenceIndex = 0;
+  DWORD dwNumRemainingDataBits = 0;
+  DWORD dwNumBytesReturned = 0;
+
+  for (CommandSequenceIndex = 0; (CommandSequenceIndex < dwNumReadCommandSequences); CommandSequenceIndex++, pReadCmdSequenceData++)
+  {
+    // adjust for SHR of incoming byte
+    dwNumRemainingDataBits = (NUMBITSINBYTE - ((pReadCmdSequenceData->dwNumBitsToRead - 1) % NUMBITSINBYTE));
+
+    // the data of every read command starts on a byte boundary in the caller's buffer
+    ExtractReadDataBits(*pReadCmdSequenceDataBuffer, (pReadCmdSequenceData->dwReturnedDataByteOffset * NUMBITSINBYTE),
+                        &(*pInputBuffer)[pReadCmdSequenceData->dwReadDataByteOffset], pReadCmdSequenceData->dwNumReadDataBytes,
+                        dwNumRemainingDataBits, pReadCmdSequenceData->dwNumTmsClocks);
+  }
+
+  if (dwNumReadCommandSequences > 0)
+  {
+    // pReadCmdSequenceData is one past the last read command
+    pReadCmdSequenceData = (pReadCmdSequenceData - 1);
+
+    dwNumBytesReturned = (pReadCmdSequenceData->dwReturnedDataByteOffset + ((pReadCmdSequenceData->dwNumBitsToRead + (NUMBITSINBYTE - 1)) / NUMBITSINBYTE));
+  }
+
+  *lpdwNumBytesReturned = dwNumBytesReturned;
+}
+
+DWORD FT2232hMpsseJtag::GetTotalNumCommandsSequenceDataBytesToRead(void)
+{
+  DWORD dwTotalNumBytesToBeRead = 0;
+  DWORD dwNumReadCommandSequences = 0;
+  PFTC_READ_CMD_SEQUENCE_DATA pReadCmdSequenceData = NULL;
+
+  if (iCommandsSequenceDataDeviceIndex != -1)
+  {
+    dwNumReadCommandSequences = OpenedDevicesCommandsSequenceData[iCommandsSequenceDataDeviceIndex].dwNumReadCommandSequences;
+
+    // The bytes of the last read command end where the bytes of all the read commands end
+    if (dwNumReadCommandSequences > 0)
+    {
+      pReadCmdSequenceData = &OpenedDevicesCommandsSequenceData[iCommandsSequenceDataDeviceIndex].pReadCommandsSequenceDataBuffer[(dwNumReadCommandSequences - 1)];
+
+      dwTotalNumBytesToBeRead = (pReadCmdSequenceData->dwReadDataByteOffset + pReadCmdSequenceData->dwNumReadDataBytes);
+    }
+  }
+
+  return dwTotalNumBytesToBeRead;
+}
+
+FTC_STATUS FT2232hMpsseJtag::AddReadCommandSequenceData(DWORD dwNumBitsToRead, DWORD dwNumTmsClocks)
+{
+  FTC_STATUS Status = FTC_SUCCESS;
+  PFTC_DEVICE_CMD_SEQUENCE_DATA pCmdSequenceData = NULL;
+  PFTC_READ_CMD_SEQUENCE_DATA pReadCommandsSequenceDataBuffer = NULL;
+  PFTC_READ_CMD_SEQUENCE_DATA pReadCmdSequenceData = NULL;
+  PFTC_READ_CMD_SEQUENCE_DATA pPreviousReadCmdSequenceData = NULL;
+  DWORD dwSizeReadCommandsSequenceDataBuffer = 0;
+  DWORD dwNumRemainingDataBits = 0;
+
+  if (iCommandsSequenceDataDeviceIndex != -1)
+  {
+    pCmdSequenceData = &OpenedDevicesCommandsSequenceData[iCommandsSequenceDataDeviceIndex];
+
+    if (pCmdSequenceData->dwNumReadCommandSequences == pCmdSequenceData->dwSizeReadCommandsSequenceDataBuffer)
+    {
+      // The buffer is doubled in size, so adding a read command takes the same time however many have been added
+      dwSizeReadCommandsSequenceDataBuffer = (pCmdSequenceData->dwSizeReadCommandsSequenceDataBuffer * 2);
+
+      pReadCommandsSequenceDataBuffer = CreateReadCommandsSequenceDataBuffer(dwSizeReadCommandsSequenceDataBuffer);
+
+      if (pReadCommandsSequenceDataBuffer != NULL)
+      {
+        memcpy(pReadCommandsSequenceDataBuffer, pCmdSequenceData->pReadCommandsSequenceDataBuffer,
+               (pCmdSequenceData->dwNumReadCommandSequences * sizeof(FTC_READ_CMD_SEQUENCE_DATA)));
+
+        DeleteReadCommandsSequenceDataBuffer(pCmdSequenceData->pReadCommandsSequenceDataBuffer);
+
+        pCmdSequenceData->pReadCommandsSequenceDataBuffer = pReadCommandsSequenceDataBuffer;
+        pCmdSequenceData->dwSizeReadCommandsSequenceDataBuffer = dwSizeReadCommandsSequenceDataBuffer;
+      }
+      else
+        Status = FTC_INSUFFICIENT_RESOURCES;
+    }
+
+    if (Status == FTC_SUCCESS)
+    {
+      pReadCmdSequenceData = &pCmdSequenceData->pReadCommandsSequenceDataBuffer[pCmdSequenceData->dwNumReadCommandSequences];
+
+      pReadCmdSequenceData->dwNumBitsToRead = dwNumBitsToRead;
+      pReadCmdSequenceData->dwNumTmsClocks = dwNumTmsClocks;
+
+      GetNumDataBytesToRead(dwNumBitsToRead, &pReadCmdSequenceData->dwNumReadDataBytes, &dwNumRemainingDataBits);
+
+      // The bytes of a read command follow on from the bytes of the read command before it
+      if (pCmdSequenceData->dwNumReadCommandSequences > 0)
+      {
+        pPreviousReadCmdSequenceData = (pReadCmdSequenceData - 1);
+
+        pReadCmdSequenceData->dwReadDataByteOffset = (pPreviousReadCmdSequenceData->dwReadDataByteOffset + pPreviousReadCmdSequenceData->dwNumReadDataBytes);
+        pReadCmdSequenceData->dwReturnedDataByteOffset = (pPreviousReadCmdSequenceData->dwReturnedDataByteOffset +
+                                                          ((pPreviousReadCmdSequenceData->dwNumBitsToRead + (NUMBITSINBYTE - 1)) / NUMBITSINBYTE));
+      }
+      else
+      {
+        pReadCmdSequenceData->dwReadDataByteOffset = 0;
+        pReadCmdSequenceData->dwReturnedDataByteOffset = 0;
+      }
+
+      pCmdSequenceData->dwNumReadCommandSequences = (pCmdSequenceData->dwNumReadCommandSequences + 1);
+    }
+  }
+
+  return Status;
+}
+
+PFTC_READ_CMD_SEQUENCE_DATA FT2232hMpsseJtag::CreateReadCommandsSequenceDataBuffer(DWORD dwSizeReadCmdsSequenceDataBuffer)
+{
+  PFTC_READ_CMD_SEQUENCE_DATA pReadCmdsSequenceDataBuffer = NULL;
+
+  pReadCmdsSequenceDataBuffer = new FTC_READ_CMD_SEQUENCE_DATA[dwSizeReadCmdsSequenceDataBuffer];
+
+  return pReadCmdsSequenceDataBuffer;
+}
+
+void FT2232hMpsseJtag::DeleteReadCommandsSequenceDataBuffer(PFTC_READ_CMD_SEQUENCE_DATA pReadCmdsSequenceDataBuffer)
+{
+  delete [] pReadCmdsSequenceDataBuffer;
+}
+
+FTC_STATUS FT2232hMpsseJtag::CreateDeviceCommandsSequenceDataBuffers(FTC_HANDLE ftHandle)
+{
+  FTC_STATUS Status = FTC_SUCCESS;
+  DWORD dwDeviceIndex = 0;
+  bool bDeviceDataBuffersCreated = false;
+
+  for (dwDeviceIndex = 0; ((dwDeviceIndex < MAX_NUM_DEVICES) && !bDeviceDataBuffersCreated); dwDeviceIndex++)
+  {
+    if (OpenedDevicesCommandsSequenceData[dwDeviceIndex].hDevice == 0)
+    {
+      bDeviceDataBuffersCreated = true;
+
+      OpenedDevicesCommandsSequenceData[dwDeviceIndex].pCommandsSequenceDataOutPutBuffer = POutputByteBuffer(new OutputByteBuffer);
+
+      if (OpenedDevicesCommandsSequenceData[dwDeviceIndex].pCommandsSequenceDataOutPutBuffer != NULL)
+      {
+        OpenedDevicesCommandsSequenceData[dwDeviceIndex].pReadCommandsSequenceDataBuffer = CreateReadCommandsSequenceDataBuffer(INIT_COMMAND_SEQUENCE_READ_DATA_BUFFER_SIZE);
+        OpenedDevicesCommandsSequenceData[dwDeviceIndex].pSubmittedReadCommandsSequenceDataBuffer = CreateReadCommandsSequenceDataBuffer(INIT_COMMAND_SEQUENCE_READ_DATA_BUFFER_SIZE);
+
+        if ((OpenedDevicesCommandsSequenceData[dwDeviceIndex].pReadCommandsSequenceDataBuffer != NULL) &&
+            (OpenedDevicesCommandsSequenceData[dwDeviceIndex].pSubmittedReadCommandsSequenceDataBuffer != NULL))
+        {
+          OpenedDevicesCommandsSequenceData[dwDeviceIndex].hDevice = ftHandle;
+          OpenedDevicesCommandsSequenceData[dwDeviceIndex].dwNumBytesToSend = 0;
+          OpenedDevicesCommandsSequenceData[dwDeviceIndex].dwSizeReadCommandsSequenceDataBuffer = INIT_COMMAND_SEQUENCE_READ_DATA_BUFFER_SIZE;
+          OpenedDevicesCommandsSequenceData[dwDeviceIndex].dwNumReadCommandSequences = 0;
+          OpenedDevicesCommandsSequenceData[dwDeviceIndex].bCommandSequenceSubmitted = false;
+          OpenedDevicesCommandsSequenceData[dwDeviceIndex].dwNumSubmittedReadBytes = 0;
+          OpenedDevicesCommandsSequenceData[dwDeviceIndex].dwSizeSubmittedReadCommandsSequenceDataBuffer = INIT_COMMAND_SEQUENCE_READ_DATA_BUFFER_SIZE;
+          OpenedDevicesCommandsSequenceData[dwDeviceIndex].dwNumSubmittedReadCommandSequences = 0;
+          OpenedDevicesCommandsSequenceData[dwDeviceIndex].dwSubmittedCommandSequenceTicket = 0;
+          OpenedDevicesCommandsSequenceData[dwDeviceIndex].dwNextCommandSequenceTicket = 1;
+          OpenedDevicesCommandsSequenceData[dwDeviceIndex].CompletionStatus = FTC_SUCCESS;
+          OpenedDevicesCommandsSequenceData[dwDeviceIndex].iCompletionFd = -1;
+          OpenedDevicesCommandsSequenceData[dwDeviceIndex].bCompletionSignalled = false;
+          OpenedDevicesCommandsSequenceData[dwDeviceIndex].bCompletionWatched = false;
+          OpenedDevicesCommandsSequenceData[dwDeviceIndex].bOptimizerEnabled = false;
+          OpenedDevicesCommandsSequenceData[dwDeviceIndex].dwNumOptimizerBytesSaved = 0;
+          OpenedDevicesCommandsSequenceData[dwDeviceIndex].bInstructionRegisterCacheEnabled = true;
+          OpenedDevicesCommandsSequenceData[dwDeviceIndex].bInstructionRegisterCacheValid = false;
+          OpenedDevicesCommandsSequenceData[dwDeviceIndex].dwNumInstructionRegisterScansSkipped = 0;
+          OpenedDevicesCommandsSequenceData[dwDeviceIndex].bStreamingEnabled = false;
+          OpenedDevicesCommandsSequenceData[dwDeviceIndex].pStreamingDataSink = NULL;
+          OpenedDevicesCommandsSequenceData[dwDeviceIndex].pStreamingContext = NULL;
+          OpenedDevicesCommandsSequenceData[dwDeviceIndex].pStreamingInputBuffer = NULL;
+          OpenedDevicesCommandsSequenceData[dwDeviceIndex].pStreamingReadDataBuffer = NULL;
+          OpenedDevicesCommandsSequenceData[dwDeviceIndex].pReplayInputBuffer = NULL;
+          OpenedDevicesCommandsSequenceData[dwDeviceIndex].dwNumStreamedReadBytes = 0;
+          OpenedDevicesCommandsSequenceData[dwDeviceIndex].StartJtagState = Undefined;
+        }
+        else
+        {
+          delete [] OpenedDevicesCommandsSequenceData[dwDeviceIndex].pCommandsSequenceDataOutPutBuffer;
+
+          DeleteReadCommandsSequenceDataBuffer(OpenedDevicesCommandsSequenceData[dwDeviceIndex].pReadCommandsSequenceDataBuffer);
+          DeleteReadCommandsSequenceDataBuffer(OpenedDevicesCommandsSequenceData[dwDeviceIndex].pSubmittedReadCommandsSequenceDataBuffer);
+
+          Status = FTC_INSUFFICIENT_RESOURCES;
+        }
+      }
+      else
+        Status = FTC_INSUFFICIENT_RESOURCES;
+    }
+  }
+
+  if ((Status == FTC_SUCCESS) && (bDeviceDataBuffersCreated == true))
+    dwNumOpenedDevices = dwNumOpenedDevices + 1;
+
+  return Status;
+}
+
+void FT2232hMpsseJtag::ClearDeviceCommandSequenceData(FTC_HANDLE ftHandle)
+{
+  DWORD dwDeviceIndex = 0;
+  BOOLEAN bDeviceHandleFound = false;
+
+  if (ftHandle != 0)
+  {
+    for (dwDeviceIndex = 0; ((dwDeviceIndex < MAX_NUM_DEVICES) && !bDeviceHandleFound); dwDeviceIndex++)
+    {
+      if (OpenedDevicesCommandsSequenceData[dwDeviceIndex].hDevice == ftHandle)
+      {
+        bDeviceHandleFound = true;
+
+        // Only the sequence being built is cleared, a submitted command sequence is still completed by reaping it
+        OpenedDevicesCommandsSequenceData[dwDeviceIndex].dwNumBytesToSend = 0;
+        OpenedDevicesCommandsSequenceData[dwDeviceIndex].dwNumReadCommandSequences = 0;
+        OpenedDevicesCommandsSequenceData[dwDeviceIndex].dwNumStreamedReadBytes = 0;
+        OpenedDevicesCommandsSequenceData[dwDeviceIndex].StartJtagState = Undefined;
+      }
+    }
+  }
+  else
+  {
+    // This code is executed if there is only one device connected to the system, this code is here just in case
+    // that a device was unplugged from the system, while the system was still running
+    for (dwDeviceIndex = 0; ((dwDeviceIndex < MAX_NUM_DEVICES) && !bDeviceHandleFound); dwDeviceIndex++)
+    {
+      if (OpenedDevicesCommandsSequenceData[dwDeviceIndex].hDevice != 0)
+      {
+        bDeviceHandleFound = true;
+
+        // Only the sequence being built is cleared, a submitted command sequence is still completed by reaping it
+        OpenedDevicesCommandsSequenceData[dwDeviceIndex].dwNumBytesToSend = 0;
+        OpenedDevicesCommandsSequenceData[dwDeviceIndex].dwNumReadCommandSequences = 0;
+        OpenedDevicesCommandsSequenceData[dwDeviceIndex].dwNumStreamedReadBytes = 0;
+        OpenedDevicesCommandsSequenceData[dwDeviceIndex].StartJtagState = Undefined;
+      }
+    }
+  }
+}
+
+DWORD FT2232hMpsseJtag::GetNumBytesInCommandsSequenceDataBuffer(void)
+{
+  DWORD dwNumBytesToSend = 0;
+
+  if (iCommandsSequenceDataDeviceIndex != -1)
+    // Get the number commands to be executed in sequence ie write, read and write/read
+    dwNumBytesToSend = OpenedDevicesCommandsSequenceData[iCommandsSequenceDataDeviceIndex].dwNumBytesToSend;
+
+  return dwNumBytesToSend;
+}
+
+BOOL FT2232hMpsseJtag::IsInstructionRegisterCached(FTC_HANDLE ftHandle, DWORD dwNumBitsToWrite, PWriteDataByteBuffer pWriteDataBuffer)
+{
+  PFTC_DEVICE_CMD_SEQUENCE_DATA pCmdSequenceData = &OpenedDevicesCommandsSequenceData[GetCommandsSequenceDataDeviceIndex(ftHandle)];
+  BOOL bInstructionRegisterCached = false;
+
+  if (pCmdSequenceData->bInstructionRegisterCacheEnabled && pCmdSequenceData->bInstructionRegisterCacheValid &&
+      (pCmdSequenceData->dwNumInstructionRegisterBits == dwNumBitsToWrite))
+    bInstructionRegisterCached = (FTC_FindFirstMismatchBit(*pWriteDataBuffer, pCmdSequenceData->InstructionRegisterBytes, NULL,
+                                                           dwNumBitsToWrite) == FTC_NO_BIT_MISMATCH);
+
+  return bInstructionRegisterCached;
+}
+
+// Walks the TMS path from the start state to the new state and returns true if, at the new state, the instruction
+// register holds the value it held before the path was clocked or the value shifted in if the path starts in the shift
+// IR state. The path must go through the update IR state if it starts in the IR column and must not go through the
+// test logic reset or capture IR states. The select IR state is not accepted as the new state, every path out of it
+// goes through one of those two states.
+BOOL FT2232hMpsseJtag::IsInstructionRegisterKept(JtagStates StartJtagState, JtagStates NewJtagState)
+{
+  DWORD dwJtagState = StartJtagState;
+  DWORD dwTmsBits = 0;
+  DWORD dwNumTmsClocks = 0;
+  DWORD dwTmsClockIndex = 0;
+  BOOL bInstructionRegisterUpdated = false;
+  BOOL bInstructionRegisterLoaded = false;
+
+  if ((StartJtagState != Undefined) && (NewJtagState != Undefined) && (NewJtagState != SelectInstructionRegisterScan))
+  {
+    bInstructionRegisterUpdated = ((StartJtagState != TestLogicReset) && (StartJtagState != SelectInstructionRegisterScan) &&
+                                   (StartJtagState != CaptureInstructionRegister) && (StartJtagState != ShiftInstructionRegister) &&
+                                   (StartJtagState != Exit1InstructionRegister) && (StartJtagState != PauseInstructionRegister) &&
+                                   (StartJtagState != Exit2InstructionRegister));
+
+    dwTmsBits = CurrentToNewJTAGState[StartJtagState][NewJtagState];
+    dwNumTmsClocks = CurrentToNewJTAGStateNumTMSClocks[StartJtagState][NewJtagState];
+
+    for (dwTmsClockIndex = 0; (dwTmsClockIndex < dwNumTmsClocks); dwTmsClockIndex++)
+    {
+      dwJtagState = NextJTAGState[dwJtagState][((dwTmsBits >> dwTmsClockIndex) & 1)];
+
+      if (dwJtagState == UpdateInstructionRegister)
+        bInstructionRegisterUpdated = true;
+      else if ((dwJtagState == TestLogicReset) || (dwJtagState == CaptureInstructionRegister))
+        bInstructionRegisterLoaded = true;
+    }
+  }
+
+  return (bInstructionRegisterUpdated && !bInstructionRegisterLoaded);
+}
+
+// Called once a scan has been clocked, pWriteDataBuffer is NULL if the bits shifted in are not known. The instruction
+// register is only cached if the scan ended through the update IR state, any other end state invalidates the cache.
+void FT2232hMpsseJtag::UpdateInstructionRegisterCache(FTC_HANDLE ftHandle, BOOL bInstructionTestData, DWORD dwNumBits,
+                                                      PWriteDataByteBuffer pWriteDataBuffer, DWORD dwTapControllerState)
+{
+  PFTC_DEVICE_CMD_SEQUENCE_DATA pCmdSequenceData = &OpenedDevicesCommandsSequenceData[GetCommandsSequenceDataDeviceIndex(ftHandle)];
+
+  if (bInstructionTestData == FALSE)
+  {
+    if (!IsInstructionRegisterKept(ShiftDataRegister, JtagStates((dwTapControllerState - 1))))
+      pCmdSequenceData->bInstructionRegisterCacheValid = false;
+  }
+  else
+  {
+    if ((pWriteDataBuffer != NULL) && (dwNumBits <= MAX_NUM_CACHED_INSTRUCTION_REGISTER_BITS) &&
+        IsInstructionRegisterKept(ShiftInstructionRegister, JtagStates((dwTapControllerState - 1))))
+    {
+      FTC_CopyBits(pCmdSequenceData->InstructionRegisterBytes, 0, *pWriteDataBuffer, 0, dwNumBits);
+
+      pCmdSequenceData->dwNumInstructionRegisterBits = dwNumBits;
+      pCmdSequenceData->bInstructionRegisterCacheValid = true;
+    }
+    else
+      pCmdSequenceData->bInstructionRegisterCacheValid = false;
+  }
+}
+
+void FT2232hMpsseJtag::InvalidateInstructionRegisterCache(FTC_HANDLE ftHandle)
+{
+  OpenedDevicesCommandsSequenceData[GetCommandsSequenceDataDeviceIndex(ftHandle)].bInstructionRegisterCacheValid = false;
+}
+
+DWORD FT2232hMpsseJtag::GetCommandsSequenceDataDeviceIndex(FTC_HANDLE ftHandle)
+{
+  DWORD dwDeviceIndex = 0;
+  BOOLEAN bDeviceHandleFound = false;
+  INT iCmdsSequenceDataDeviceIndex = 0;
+
+  if (ftHandle != 0)
+  {
+    for (dwDeviceIndex = 0; ((dwDeviceIndex < MAX_NUM_DEVICES) && !bDeviceHandleFound); dwDeviceIndex++)
+    {
+      if (OpenedDevicesCommandsSequenceData[dwDeviceIndex].hDevice == ftHandle)
+      {
+        bDeviceHandleFound = true;
+
+        iCmdsSequenceDataDeviceIndex = dwDeviceIndex;
+      }
+    }
+  }
+  else
+  {
+    // This code is executed if there is only one device connected to the system, this code is here just in case
+    // that a device was unplugged from the system, while the system was still running
+    for (dwDeviceIndex = 0; ((dwDeviceIndex < MAX_NUM_DEVICES) && !bDeviceHandleFound); dwDeviceIndex++)
+    {
+      if (OpenedDevicesCommandsSequenceData[dwDeviceIndex].hDevice != 0)
+      {
+        bDeviceHandleFound = true;
+
+        iCmdsSequenceDataDeviceIndex = dwDeviceIndex;
+      }
+    }
+  }
+
+  return iCmdsSequenceDataDeviceIndex;
+}
 
 void FT2232hMpsseJtag::DeleteDeviceCommandsSequenceDataBuffers(FTC_HANDLE ftHandle)
 {
@@ -1530,9 +2195,20 @@ void FT2232hMpsseJtag::DeleteDeviceCommandsSequenceDataBuffers(FTC_HANDLE ftHand
       pCmdsSequenceDataOutPutBuffer = OpenedDevicesCommandsSequenceData[dwDeviceIndex].pCommandsSequenceDataOutPutBuffer;
       delete [] pCmdsSequenceDataOutPutBuffer;
       OpenedDevicesCommandsSequenceData[dwDeviceIndex].pCommandsSequenceDataOutPutBuffer = NULL;
-      DeleteReadCommandsSequenceDataBuffer(OpenedDevicesCommandsSequenceData[dwDeviceIndex].pReadCommandsSequenceDataBuffer,
-                                           OpenedDevicesCommandsSequenceData[dwDeviceIndex].dwSizeReadCommandsSequenceDataBuffer);
+      DeleteReadCommandsSequenceDataBuffer(OpenedDevicesCommandsSequenceData[dwDeviceIndex].pReadCommandsSequenceDataBuffer);
       OpenedDevicesCommandsSequenceData[dwDeviceIndex].pReadCommandsSequenceDataBuffer = NULL;
+      DeleteReadCommandsSequenceDataBuffer(OpenedDevicesCommandsSequenceData[dwDeviceIndex].pSubmittedReadCommandsSequenceDataBuffer);
+      OpenedDevicesCommandsSequenceData[dwDeviceIndex].pSubmittedReadCommandsSequenceDataBuffer = NULL;
+      DeleteStreamingCommandsSequenceBuffers(dwDeviceIndex);
+      if (OpenedDevicesCommandsSequenceData[dwDeviceIndex].pReplayInputBuffer != NULL)
+        delete [] OpenedDevicesCommandsSequenceData[dwDeviceIndex].pReplayInputBuffer;
+      OpenedDevicesCommandsSequenceData[dwDeviceIndex].pReplayInputBuffer = NULL;
+      OpenedDevicesCommandsSequenceData[dwDeviceIndex].bCommandSequenceSubmitted = false;
+#ifndef _WIN32
+      if (OpenedDevicesCommandsSequenceData[dwDeviceIndex].iCompletionFd != -1)
+        close(OpenedDevicesCommandsSequenceData[dwDeviceIndex].iCompletionFd);
+#endif
+      OpenedDevicesCommandsSequenceData[dwDeviceIndex].iCompletionFd = -1;
     }
   }
 
@@ -1540,237 +2216,2165 @@ void FT2232hMpsseJtag::DeleteDeviceCommandsSequenceDataBuffers(FTC_HANDLE ftHand
     dwNumOpenedDevices = dwNumOpenedDevices - 1;
 }
 
-FTC_STATUS FT2232hMpsseJtag::AddDeviceWriteCommand(FTC_HANDLE ftHandle, BOOL bInstructionTestData, DWORD dwNumBitsToWrite,
-                                                   PWriteDataByteBuffer pWriteDataBuffer, DWORD dwNumBytesToWrite,
-                                                   DWORD dwTapControllerState)
+DWORD FT2232hMpsseJtag::GetMPSSECommandLength(LPBYTE pCommandBytes, DWORD dwNumCommandBytes)
 {
-  FTC_STATUS Status = FTC_SUCCESS;
+  // Returns the number of bytes in the MPSSE command at the start of the command bytes, including any data bytes to
+  // be written, or 0 if the command is not one generated by this library or is incomplete
+  DWORD dwCommandLength = 0;
+
+  switch (pCommandBytes[0])
+  {
+    case CLK_DATA_BYTES_OUT_ON_NEG_CLK_LSB_FIRST_CMD:
+    case CLK_DATA_BYTES_OUT_ON_NEG_CLK_IN_ON_POS_CLK_LSB_FIRST_CMD:
+      if (dwNumCommandBytes >= 3)
+        dwCommandLength = (3 + ((pCommandBytes[1] | (pCommandBytes[2] << 8)) + 1));
+    break;
+    case CLK_DATA_BYTES_IN_ON_POS_CLK_LSB_FIRST_CMD:
+    case CLK_DATA_BITS_OUT_ON_NEG_CLK_LSB_FIRST_CMD:
+    case CLK_DATA_BITS_OUT_ON_NEG_CLK_IN_ON_POS_CLK_LSB_FIRST_CMD:
+    case CLK_DATA_TMS_NO_READ_CMD:
+    case CLK_DATA_TMS_READ_CMD:
+    case SET_LOW_BYTE_DATA_BITS_CMD:
+    case SET_HIGH_BYTE_DATA_BITS_CMD:
+    case SET_CLOCK_FREQUENCY_CMD:
+    case CLK_FOR_TIMES_EIGHT_CLOCKS_NO_DATA_BYTES_CMD:
+    case CLK_FOR_TIMES_EIGHT_CLOCKS_GPIOL2_HIGH_NO_DATA_BYTES_CMD:
+    case CLK_FOR_TIMES_EIGHT_CLOCKS_GPIOL2_LOW_NO_DATA_BYTES_CMD:
+      dwCommandLength = 3;
+    break;
+    case CLK_DATA_BITS_IN_ON_POS_CLK_LSB_FIRST_CMD:
+    case CLK_FOR_NUM_CLOCKS_NO_DATA_BYTES_CMD:
+      dwCommandLength = 2;
+    break;
+    case GET_LOW_BYTE_DATA_BITS_CMD:
+    case GET_HIGH_BYTE_DATA_BITS_CMD:
+    case SEND_ANSWER_BACK_IMMEDIATELY_CMD:
+      dwCommandLength = 1;
+    break;
+  }
+
+  if (dwCommandLength > dwNumCommandBytes)
+    dwCommandLength = 0;
+
+  return dwCommandLength;
+}
+
+DWORD FT2232hMpsseJtag::WriteTMSCommand(LPBYTE pCommandBytes, DWORD dwNumTmsClocks, DWORD dwTmsBits, DWORD dwTdiBit)
+{
+  pCommandBytes[0] = CLK_DATA_TMS_NO_READ_CMD;
+  pCommandBytes[1] = ((dwNumTmsClocks - 1) & '\xFF');
+  pCommandBytes[2] = ((dwTmsBits | (dwTdiBit << 7)) & '\xFF');
+
+  return 3;
+}
+
+DWORD FT2232hMpsseJtag::OptimizeCommandsSequence(LPBYTE pCommandBytes, DWORD dwNumCommandBytes)
+{
+  // This function rewrites a sequence of commands in place and returns the number of bytes left in it. Consecutive TMS
+  // commands, that do not read TDO, are fused into as few TMS commands as possible, TMS high clocks given once the TAP
+  // controller is already in the test logic reset state are dropped and adjacent byte shift commands of the same type
+  // are merged into one. The bytes clocked in from the device are unchanged, so is the state of every JTAG signal. The
+  // optimizer stops at the first command it does not know, the rest of the sequence is left as it is.
+  DWORD dwReadIndex = 0;
+  DWORD dwWriteIndex = 0;
+  DWORD dwCommandLength = 0;
+  DWORD dwTmsClockIndex = 0;
+  DWORD dwNumTmsClocks = 0;
+  DWORD dwTmsBit = 0;
+  DWORD dwTdiBit = 0;
+  DWORD dwNumTmsHighClocks = 0;
+  DWORD dwNumFusedTmsClocks = 0;
+  DWORD dwFusedTmsBits = 0;
+  DWORD dwFusedTdiBit = 0;
+  DWORD dwNumShiftBytes = 0;
+  DWORD dwNumMergedShiftBytes = 0;
+  DWORD dwByteShiftIndex = 0;
+  BOOL bByteShiftWritten = false;
+  BOOL bKnownCommand = true;
+
+  while (dwReadIndex < dwNumCommandBytes)
+  {
+    dwCommandLength = GetMPSSECommandLength(&pCommandBytes[dwReadIndex], (dwNumCommandBytes - dwReadIndex));
+
+    if (dwCommandLength == 0)
+    {
+      // Copy the rest of the sequence as it is
+      bKnownCommand = false;
+
+      dwCommandLength = (dwNumCommandBytes - dwReadIndex);
+    }
+
+    if (bKnownCommand && (pCommandBytes[dwReadIndex] == CLK_DATA_TMS_NO_READ_CMD))
+    {
+      dwNumTmsClocks = (pCommandBytes[dwReadIndex + 1] + 1);
+
+      if (dwNumTmsClocks > MAX_NUM_TMS_CLOCKS)
+        dwNumTmsClocks = MAX_NUM_TMS_CLOCKS;
+
+      // Bit 7 is held on TDI while the TMS bits are clocked out, only the first clock can shift it into a register
+      dwTdiBit = ((pCommandBytes[dwReadIndex + 2] >> 7) & 1);
+
+      for (dwTmsClockIndex = 0; (dwTmsClockIndex < dwNumTmsClocks); dwTmsClockIndex++)
+      {
+        dwTmsBit = ((pCommandBytes[dwReadIndex + 2] >> dwTmsClockIndex) & 1);
+
+        if ((dwTmsBit == 0) || (dwNumTmsHighClocks < NUM_TMS_CLOCKS_TO_TEST_LOGIC_RESET))
+        {
+          if (dwTmsBit == 1)
+            dwNumTmsHighClocks = (dwNumTmsHighClocks + 1);
+          else
+            dwNumTmsHighClocks = 0;
+
+          if ((dwNumFusedTmsClocks == MAX_NUM_TMS_CLOCKS) || ((dwNumFusedTmsClocks > 0) && (dwFusedTdiBit != dwTdiBit)))
+          {
+            dwWriteIndex = (dwWriteIndex + WriteTMSCommand(&pCommandBytes[dwWriteIndex], dwNumFusedTmsClocks, dwFusedTmsBits, dwFusedTdiBit));
+
+            dwNumFusedTmsClocks = 0;
+            dwFusedTmsBits = 0;
+          }
+
+          if (dwNumFusedTmsClocks == 0)
+            dwFusedTdiBit = dwTdiBit;
+
+          dwFusedTmsBits = (dwFusedTmsBits | (dwTmsBit << dwNumFusedTmsClocks));
+          dwNumFusedTmsClocks = (dwNumFusedTmsClocks + 1);
+        }
+      }
+
+      bByteShiftWritten = false;
+    }
+    else
+    {
+      if (dwNumFusedTmsClocks > 0)
+      {
+        dwWriteIndex = (dwWriteIndex + WriteTMSCommand(&pCommandBytes[dwWriteIndex], dwNumFusedTmsClocks, dwFusedTmsBits, dwFusedTdiBit));
+
+        dwNumFusedTmsClocks = 0;
+        dwFusedTmsBits = 0;
+      }
+
+      dwNumTmsHighClocks = 0;
+
+      if (bKnownCommand &&
+          ((pCommandBytes[dwReadIndex] == CLK_DATA_BYTES_OUT_ON_NEG_CLK_LSB_FIRST_CMD) ||
+           (pCommandBytes[dwReadIndex] == CLK_DATA_BYTES_IN_ON_POS_CLK_LSB_FIRST_CMD) ||
+           (pCommandBytes[dwReadIndex] == CLK_DATA_BYTES_OUT_ON_NEG_CLK_IN_ON_POS_CLK_LSB_FIRST_CMD)))
+        dwNumShiftBytes = ((pCommandBytes[dwReadIndex + 1] | (pCommandBytes[dwReadIndex + 2] << 8)) + 1);
+      else
+        dwNumShiftBytes = 0;
+
+      if ((dwNumShiftBytes > 0) && bByteShiftWritten && (pCommandBytes[dwByteShiftIndex] == pCommandBytes[dwReadIndex]) &&
+          ((dwNumMergedShiftBytes + dwNumShiftBytes) <= MAX_NUM_BYTE_SHIFT_DATA_BYTES))
+      {
+        // Append the data bytes, if any, to those of the previous byte shift command and drop the command bytes
+        memmove(&pCommandBytes[dwWriteIndex], &pCommandBytes[dwReadIndex + 3], (dwCommandLength - 3));
+        dwWriteIndex = (dwWriteIndex + (dwCommandLength - 3));
+
+        dwNumMergedShiftBytes = (dwNumMergedShiftBytes + dwNumShiftBytes);
+
+        pCommandBytes[dwByteShiftIndex + 1] = ((dwNumMergedShiftBytes - 1) & '\xFF');
+        pCommandBytes[dwByteShiftIndex + 2] = (((dwNumMergedShiftBytes - 1) / 256) & '\xFF');
+      }
+      else
+      {
+        memmove(&pCommandBytes[dwWriteIndex], &pCommandBytes[dwReadIndex], dwCommandLength);
+
+        bByteShiftWritten = (dwNumShiftBytes > 0);
+        dwByteShiftIndex = dwWriteIndex;
+        dwNumMergedShiftBytes = dwNumShiftBytes;
+
+        dwWriteIndex = (dwWriteIndex + dwCommandLength);
+      }
+    }
+
+    dwReadIndex = (dwReadIndex + dwCommandLength);
+  }
+
+  if (dwNumFusedTmsClocks > 0)
+    dwWriteIndex = (dwWriteIndex + WriteTMSCommand(&pCommandBytes[dwWriteIndex], dwNumFusedTmsClocks, dwFusedTmsBits, dwFusedTdiBit));
+
+  return dwWriteIndex;
+}
+
+DWORD FT2232hMpsseJtag::CompleteCommandsSequence(void)
+{
+  // Ends the sequence being built with the command that makes the device send back the bytes read straight away and
+  // optimizes it, returns the number of command bytes left in the sequence
+  PFTC_DEVICE_CMD_SEQUENCE_DATA pCmdSequenceData = &OpenedDevicesCommandsSequenceData[iCommandsSequenceDataDeviceIndex];
+  DWORD dwNumCmdSequenceBytes = 0;
+
+  AddByteToOutputBuffer(SEND_ANSWER_BACK_IMMEDIATELY_CMD, false);
+
+  if (pCmdSequenceData->bOptimizerEnabled)
+  {
+    dwNumCmdSequenceBytes = OptimizeCommandsSequence(*pCmdSequenceData->pCommandsSequenceDataOutPutBuffer, pCmdSequenceData->dwNumBytesToSend);
+
+    pCmdSequenceData->dwNumOptimizerBytesSaved += (pCmdSequenceData->dwNumBytesToSend - dwNumCmdSequenceBytes);
+    pCmdSequenceData->dwNumBytesToSend = dwNumCmdSequenceBytes;
+  }
+
+  return GetNumBytesInCommandsSequenceDataBuffer();
+}
+
+void FT2232hMpsseJtag::TransferCommandsSequenceToOutputBuffer(void)
+{
+  PFTC_DEVICE_CMD_SEQUENCE_DATA pCmdSequenceData = &OpenedDevicesCommandsSequenceData[iCommandsSequenceDataDeviceIndex];
+  DWORD dwNumCmdSequenceBytes = 0;
+
+  dwNumCmdSequenceBytes = CompleteCommandsSequence();
+
+  FTC_ClearOutputBuffer();
+
+  // Transfer sequence of commands for specified device to output buffer for transmission to device. The sequence is
+  // added as a data block, so it is only referenced and is written to the device straight from the sequence buffer,
+  // which every caller sends before anything is added to the sequence buffer again
+  FTC_AddDataBytesToOutputBuffer(*pCmdSequenceData->pCommandsSequenceDataOutPutBuffer, dwNumCmdSequenceBytes);
+
+  pCmdSequenceData->dwNumBytesToSend = 0;
+
+  // the instruction register scans of a sequence are not tracked
+  pCmdSequenceData->bInstructionRegisterCacheValid = false;
+}
+
+void FT2232hMpsseJtag::SetCommandsSequenceStartJtagState(void)
+{
+  // The first command of a sequence moves the TAP controller on from the current state, so a recorded sequence has to
+  // be replayed from that state
+  if (GetNumBytesInCommandsSequenceDataBuffer() == 0)
+    OpenedDevicesCommandsSequenceData[iCommandsSequenceDataDeviceIndex].StartJtagState = CurrentJtagState;
+}
+
+void FT2232hMpsseJtag::SignalCommandSequenceCompletion(DWORD dwDeviceIndex, FTC_STATUS CompletionStatus)
+{
+  ULONGLONG ulCompletionCount = 1;
+
+  OpenedDevicesCommandsSequenceData[dwDeviceIndex].CompletionStatus = CompletionStatus;
+
+#ifndef _WIN32
+  if ((OpenedDevicesCommandsSequenceData[dwDeviceIndex].iCompletionFd != -1) &&
+      !OpenedDevicesCommandsSequenceData[dwDeviceIndex].bCompletionSignalled)
+  {
+    if (write(OpenedDevicesCommandsSequenceData[dwDeviceIndex].iCompletionFd, &ulCompletionCount, sizeof(ulCompletionCount)) == sizeof(ulCompletionCount))
+      OpenedDevicesCommandsSequenceData[dwDeviceIndex].bCompletionSignalled = true;
+  }
+#else
+  (void)ulCompletionCount;
+#endif
+}
+
+// The bytes a submitted command sequence returns are read back before the bytes of any other command, so nothing else
+// that clocks the TAP controller or reads the device can be sent until the submitted sequence has been collected
+FTC_STATUS FT2232hMpsseJtag::CheckCommandSequenceNotSubmitted(FTC_HANDLE ftHandle)
+{
+  FTC_STATUS Status = FTC_SUCCESS;
+
+  if (OpenedDevicesCommandsSequenceData[GetCommandsSequenceDataDeviceIndex(ftHandle)].bCommandSequenceSubmitted)
+    Status = FTC_COMMAND_SEQUENCE_SUBMITTED;
+
+  return Status;
+}
+
+void FT2232hMpsseJtag::EndSubmittedCommandSequence(DWORD dwDeviceIndex)
+{
+  ULONGLONG ulCompletionCount = 0;
+
+  OpenedDevicesCommandsSequenceData[dwDeviceIndex].bCommandSequenceSubmitted = false;
+  OpenedDevicesCommandsSequenceData[dwDeviceIndex].dwNumSubmittedReadBytes = 0;
+
+  // Ends the command deadline started when the sequence was submitted
+  FTC_EndDeviceCommandDeadline(OpenedDevicesCommandsSequenceData[dwDeviceIndex].hDevice);
+  OpenedDevicesCommandsSequenceData[dwDeviceIndex].CompletionStatus = FTC_SUCCESS;
+  OpenedDevicesCommandsSequenceData[dwDeviceIndex].dwNumSubmittedReadCommandSequences = 0;
+
+#ifndef _WIN32
+  // Reading the eventfd resets its count, so the completion fd stays unreadable until the next sequence completes
+  if (OpenedDevicesCommandsSequenceData[dwDeviceIndex].bCompletionSignalled)
+  {
+    if (read(OpenedDevicesCommandsSequenceData[dwDeviceIndex].iCompletionFd, &ulCompletionCount, sizeof(ulCompletionCount)) != sizeof(ulCompletionCount))
+      ulCompletionCount = 0;
+  }
+#else
+  (void)ulCompletionCount;
+#endif
+
+  OpenedDevicesCommandsSequenceData[dwDeviceIndex].bCompletionSignalled = false;
+}
+
+#ifndef _WIN32
+void *FT2232hMpsseJtag::CompletionWatcherMain(void *pParameter)
+{
+  ((FT2232hMpsseJtag *)pParameter)->WatchSubmittedCommandSequences();
+
+  return NULL;
+}
+
+void FT2232hMpsseJtag::WatchSubmittedCommandSequences(void)
+{
+  FTC_STATUS Status = FTC_SUCCESS;
+  DWORD dwDeviceIndex = 0;
+  DWORD dwNumSubmittedReadBytes = 0;
+  DWORD dwNumBytesInQueue = 0;
+  FtcTransport *pTransport = NULL;
+
+  EnterCriticalSection(&threadAccess);
+
+  while (!bStopCompletionWatcher)
+  {
+    if (PollSubmittedCommandSequences(&dwDeviceIndex) &&
+        ((pTransport = FTC_GetDeviceTransport(OpenedDevicesCommandsSequenceData[dwDeviceIndex].hDevice)) != NULL))
+    {
+      dwNumSubmittedReadBytes = OpenedDevicesCommandsSequenceData[dwDeviceIndex].dwNumSubmittedReadBytes;
+
+      // Waiting for no time asks the driver to signal the transport's receive event, which is never done concurrently
+      pTransport->WaitForBytes(dwNumSubmittedReadBytes, 0, &dwNumBytesInQueue);
+
+      OpenedDevicesCommandsSequenceData[dwDeviceIndex].bCompletionWatched = true;
+
+      // Let the public methods run while the watcher sleeps until the device has returned the bytes of its sequence
+      LeaveCriticalSection(&threadAccess);
+
+      Status = pTransport->WaitForBytesConcurrently(dwNumSubmittedReadBytes, COMPLETION_WATCH_PERIOD, &dwNumBytesInQueue);
+
+      if (Status == FTC_NOT_SUPPORTED_BY_TRANSPORT)
+        Sleep(COMPLETION_POLL_PERIOD);
+
+      EnterCriticalSection(&threadAccess);
+
+      OpenedDevicesCommandsSequenceData[dwDeviceIndex].bCompletionWatched = false;
+
+      pthread_cond_broadcast(&CompletionWatchEnded);
+    }
+    else
+      pthread_cond_wait(&CommandSequenceSubmitted, &threadAccess);
+  }
+
+  LeaveCriticalSection(&threadAccess);
+}
+
+BOOL FT2232hMpsseJtag::PollSubmittedCommandSequences(LPDWORD lpdwDeviceIndex)
+{
+  // Signals the completion fd of every device whose submitted command sequence has returned all of its bytes or has
+  // failed, returns true if there are any sequences still to be watched. The devices are checked starting after the
+  // device last watched, which is replaced by the first device still to be watched, so every device gets its turn.
+  FTC_STATUS Status = FTC_SUCCESS;
+  DWORD dwDeviceCntr = 0;
+  DWORD dwDeviceIndex = 0;
+  DWORD dwNumBytesDeviceInputBuffer = 0;
+  BOOL bCommandSequencePending = false;
+  DWORD dwPendingDeviceIndex = *lpdwDeviceIndex;
+
+  for (dwDeviceCntr = 1; (dwDeviceCntr <= MAX_NUM_DEVICES); dwDeviceCntr++)
+  {
+    dwDeviceIndex = ((*lpdwDeviceIndex + dwDeviceCntr) % MAX_NUM_DEVICES);
+
+    if ((OpenedDevicesCommandsSequenceData[dwDeviceIndex].hDevice != 0) &&
+        (OpenedDevicesCommandsSequenceData[dwDeviceIndex].iCompletionFd != -1) &&
+        OpenedDevicesCommandsSequenceData[dwDeviceIndex].bCommandSequenceSubmitted &&
+        !OpenedDevicesCommandsSequenceData[dwDeviceIndex].bCompletionSignalled)
+    {
+      Status = FTC_PollDeviceInputBytes(OpenedDevicesCommandsSequenceData[dwDeviceIndex].hDevice,
+                                        OpenedDevicesCommandsSequenceData[dwDeviceIndex].dwNumSubmittedReadBytes,
+                                        &dwNumBytesDeviceInputBuffer);
+
+      if ((Status != FTC_SUCCESS) || (dwNumBytesDeviceInputBuffer >= OpenedDevicesCommandsSequenceData[dwDeviceIndex].dwNumSubmittedReadBytes))
+        SignalCommandSequenceCompletion(dwDeviceIndex, Status);
+      else if (!bCommandSequencePending)
+      {
+        bCommandSequencePending = true;
+
+        dwPendingDeviceIndex = dwDeviceIndex;
+      }
+    }
+  }
+
+  *lpdwDeviceIndex = dwPendingDeviceIndex;
+
+  return bCommandSequencePending;
+}
+
+void FT2232hMpsseJtag::WaitForCompletionWatcher(FTC_HANDLE ftHandle)
+{
+  // Called with the threadAccess object held, before the transport of a device is deleted or replaced
+  while (OpenedDevicesCommandsSequenceData[GetCommandsSequenceDataDeviceIndex(ftHandle)].bCompletionWatched)
+    pthread_cond_wait(&CompletionWatchEnded, &threadAccess);
+}
+
+FTC_STATUS FT2232hMpsseJtag::StartCompletionWatcher(void)
+{
+  FTC_STATUS Status = FTC_SUCCESS;
+
+  if (!bCompletionWatcherStarted)
+  {
+    bStopCompletionWatcher = false;
+
+    if (pthread_create(&CompletionWatcherThread, NULL, CompletionWatcherMain, this) == 0)
+      bCompletionWatcherStarted = true;
+    else
+      Status = FTC_INSUFFICIENT_RESOURCES;
+  }
+
+  return Status;
+}
+
+void FT2232hMpsseJtag::StopCompletionWatcher(void)
+{
+  if (bCompletionWatcherStarted)
+  {
+    EnterCriticalSection(&threadAccess);
+
+    bStopCompletionWatcher = true;
+
+    pthread_cond_signal(&CommandSequenceSubmitted);
+
+    LeaveCriticalSection(&threadAccess);
+
+    pthread_join(CompletionWatcherThread, NULL);
+
+    bCompletionWatcherStarted = false;
+  }
+}
+#endif
+
+FTC_STATUS FT2232hMpsseJtag::CheckScanTemplateScans(PFTC_SCAN_TEMPLATE_SCAN pScans, DWORD dwNumScans)
+{
+  FTC_STATUS Status = FTC_SUCCESS;
+  DWORD dwScanIndex = 0;
+  DWORD dwNumReadDataBytes = 0;
+  DWORD dwTotalNumReadDataBytes = 0;
+  DWORD dwNumRemainingDataBits = 0;
+
+  if ((dwNumScans >= 1) && (dwNumScans <= MAX_NUM_SCAN_TEMPLATE_SCANS))
+  {
+    for (dwScanIndex = 0; ((dwScanIndex < dwNumScans) && (Status == FTC_SUCCESS)); dwScanIndex++)
+    {
+      if (pScans[dwScanIndex].dwScanType <= SCAN_TEMPLATE_WRITE_READ)
+      {
+        if ((pScans[dwScanIndex].dwNumBits >= MIN_NUM_BITS) && (pScans[dwScanIndex].dwNumBits <= MAX_NUM_BITS))
+        {
+          if ((pScans[dwScanIndex].dwTapControllerState < TEST_LOGIC_STATE) ||
+              (pScans[dwScanIndex].dwTapControllerState > UPDATE_INSTRUCTION_REGISTER_STATE))
+            Status = FTC_INVALID_TAP_CONTROLLER_STATE;
+          else
+          {
+            if (pScans[dwScanIndex].dwScanType != SCAN_TEMPLATE_WRITE)
+            {
+              GetNumDataBytesToRead(pScans[dwScanIndex].dwNumBits, &dwNumReadDataBytes, &dwNumRemainingDataBits);
+
+              dwTotalNumReadDataBytes = (dwTotalNumReadDataBytes + dwNumReadDataBytes);
+
+              // every byte returned by the scans must fit in the caller's read buffer before they are realigned
+              if (dwTotalNumReadDataBytes > MAX_READ_CMDS_DATA_BYTES_BUFFER_SIZE)
+                Status = FTC_INVALID_NUMBER_BITS;
+            }
+          }
+        }
+        else
+          Status = FTC_INVALID_NUMBER_BITS;
+      }
+      else
+        Status = FTC_INVALID_SCAN_TYPE;
+    }
+  }
+  else
+    Status = FTC_INVALID_NUMBER_SCANS;
+
+  return Status;
+}
+
+FTC_STATUS FT2232hMpsseJtag::CompileScanTemplate(PFTC_SCAN_TEMPLATE_DATA pScanTemplate, PFTC_SCAN_TEMPLATE_SCAN pScans, DWORD dwNumScans)
+{
+  FTC_STATUS Status = FTC_SUCCESS;
+  JtagStates SavedJtagState = CurrentJtagState;
+  PFTC_SCAN_TEMPLATE_SLOT pSlot = NULL;
+  DWORD dwScanIndex = 0;
+  DWORD dwModNumBits = 0;
+  DWORD dwNumRemainingDataBits = 0;
+  DWORD dwNumCommandBytes = 0;
+  BYTE DataBytesCommand = 0;
+  BYTE DataBitsCommand = 0;
+  LPBYTE pCommandBytes = NULL;
+
+  // The commands are built in the output buffer, starting in the shift state of the first scan, as the move into it
+  // depends on the state the TAP controller is in when the template is executed. The whole data bytes are not part
+  // of the commands, they are sent straight from the caller's write data buffers when the template is executed.
+  FTC_ClearOutputBuffer();
+
+  if (pScans[0].bInstructionTestData == FALSE)
+    pScanTemplate->StartJtagState = ShiftDataRegister;
+  else
+    pScanTemplate->StartJtagState = ShiftInstructionRegister;
+
+  CurrentJtagState = pScanTemplate->StartJtagState;
+
+  pScanTemplate->dwNumScans = dwNumScans;
+  pScanTemplate->dwNumReadDataBytes = 0;
+
+  for (dwScanIndex = 0; (dwScanIndex < dwNumScans); dwScanIndex++)
+  {
+    pSlot = &pScanTemplate->Slots[dwScanIndex];
+
+    pSlot->dwScanType = pScans[dwScanIndex].dwScanType;
+
+    switch (pSlot->dwScanType)
+    {
+      case SCAN_TEMPLATE_WRITE:
+        DataBytesCommand = CLK_DATA_BYTES_OUT_ON_NEG_CLK_LSB_FIRST_CMD;
+        DataBitsCommand = CLK_DATA_BITS_OUT_ON_NEG_CLK_LSB_FIRST_CMD;
+      break;
+      case SCAN_TEMPLATE_READ:
+        DataBytesCommand = CLK_DATA_BYTES_IN_ON_POS_CLK_LSB_FIRST_CMD;
+        DataBitsCommand = CLK_DATA_BITS_IN_ON_POS_CLK_LSB_FIRST_CMD;
+      break;
+      default:
+        DataBytesCommand = CLK_DATA_BYTES_OUT_ON_NEG_CLK_IN_ON_POS_CLK_LSB_FIRST_CMD;
+        DataBitsCommand = CLK_DATA_BITS_OUT_ON_NEG_CLK_IN_ON_POS_CLK_LSB_FIRST_CMD;
+      break;
+    }
+
+    if (pScans[dwScanIndex].bInstructionTestData == FALSE)
+      MoveJTAGFromOneStateToAnother(ShiftDataRegister, NO_LAST_DATA_BIT, false);
+    else
+      MoveJTAGFromOneStateToAnother(ShiftInstructionRegister, NO_LAST_DATA_BIT, false);
+
+    // adjust for bit count of 1 less than no of bits
+    dwModNumBits = (pScans[dwScanIndex].dwNumBits - 1);
+
+    pSlot->dwNumDataBytes = (dwModNumBits / 8);
+
+    if (pSlot->dwNumDataBytes > 0)
+    {
+      pCommandBytes = GetOutputBufferEnd();
+      pCommandBytes[0] = DataBytesCommand;
+      pCommandBytes[1] = ((pSlot->dwNumDataBytes - 1) & '\xFF');
+      pCommandBytes[2] = (((pSlot->dwNumDataBytes - 1) / 256) & '\xFF');
+      CommitOutputBufferBytes(3);
+    }
+
+    pSlot->dwDataBytesIndex = FTC_GetNumBytesInOutputBuffer();
+    pSlot->dwDataBitsIndex = NO_SCAN_TEMPLATE_SLOT;
+
+    dwNumRemainingDataBits = (dwModNumBits % 8);
+
+    if (dwNumRemainingDataBits > 0)
+    {
+      pCommandBytes = GetOutputBufferEnd();
+      pCommandBytes[0] = DataBitsCommand;
+      pCommandBytes[1] = ((dwNumRemainingDataBits - 1) & '\xFF');
+
+      if (pSlot->dwScanType != SCAN_TEMPLATE_READ)
+      {
+        pCommandBytes[2] = 0;
+        pSlot->dwDataBitsIndex = (pSlot->dwDataBytesIndex + 2);
+        CommitOutputBufferBytes(3);
+      }
+      else
+        CommitOutputBufferBytes(2);
+    }
+
+    // the last data bit is clocked out by the first TMS command of the move to the end state
+    pSlot->dwLastDataBitShift = dwNumRemainingDataBits;
+
+    dwNumCommandBytes = FTC_GetNumBytesInOutputBuffer();
+
+    // end it in state passed in, take 1 off the dwTapControllerState variable to correspond with JtagStates enumerated types
+    pSlot->dwNumTmsClocks = MoveJTAGFromOneStateToAnother(JtagStates((pScans[dwScanIndex].dwTapControllerState - 1)),
+                                                          NO_LAST_DATA_BIT, (pSlot->dwScanType != SCAN_TEMPLATE_WRITE));
+
+    if (FTC_GetNumBytesInOutputBuffer() > dwNumCommandBytes)
+      pSlot->dwLastDataBitIndex = (dwNumCommandBytes + 2);
+    else
+      pSlot->dwLastDataBitIndex = NO_SCAN_TEMPLATE_SLOT;
+
+    pSlot->dwNumReadDataBytes = 0;
+    pSlot->dwNumRemainingDataBits = 0;
+
+    if (pSlot->dwScanType != SCAN_TEMPLATE_WRITE)
+    {
+      GetNumDataBytesToRead(pScans[dwScanIndex].dwNumBits, &pSlot->dwNumReadDataBytes, &pSlot->dwNumRemainingDataBits);
+
+      pScanTemplate->dwNumReadDataBytes = (pScanTemplate->dwNumReadDataBytes + pSlot->dwNumReadDataBytes);
+    }
+  }
+
+  if (pScanTemplate->dwNumReadDataBytes > 0)
+    AddByteToOutputBuffer(SEND_ANSWER_BACK_IMMEDIATELY_CMD, false);
+
+  pScanTemplate->EndJtagState = CurrentJtagState;
+
+  // Nothing was added to the output buffer by reference, so all the commands are in the output buffer itself
+  pScanTemplate->dwNumCommandBytes = FTC_GetNumBytesInOutputBuffer();
+  pScanTemplate->pCommandBytes = new BYTE[pScanTemplate->dwNumCommandBytes];
+
+  if (pScanTemplate->pCommandBytes != NULL)
+    memcpy(pScanTemplate->pCommandBytes, (GetOutputBufferEnd() - pScanTemplate->dwNumCommandBytes), pScanTemplate->dwNumCommandBytes);
+  else
+    Status = FTC_INSUFFICIENT_RESOURCES;
+
+  FTC_ClearOutputBuffer();
+
+  CurrentJtagState = SavedJtagState;
+
+  return Status;
+}
+
+FTC_STATUS FT2232hMpsseJtag::ExecuteScanTemplate(FTC_HANDLE ftHandle, PFTC_SCAN_TEMPLATE_DATA pScanTemplate,
+                                                 PScanTemplateWriteDataBuffers pWriteDataBuffers,
+                                                 PReadCmdSequenceDataByteBuffer pReadDataBuffer, LPDWORD lpdwNumBytesReturned)
+{
+  FTC_STATUS Status = FTC_SUCCESS;
+  PFTC_SCAN_TEMPLATE_SLOT pSlot = NULL;
+  DWORD dwScanIndex = 0;
+  DWORD dwCommandBytesIndex = 0;
+  DWORD dwLastDataBit = 0;
+  DWORD dwReadDataBytesIndex = 0;
+  DWORD dwNumScanDataBits = 0;
+  DWORD dwNumBytesReturned = 0;
+  DWORD dwNumDataBytesRead = 0;
+  LPBYTE pWriteDataBytes = NULL;
+  LPBYTE pCommandBytes = pScanTemplate->pCommandBytes;
+
+  FTC_ClearOutputBuffer();
+
+  MoveJTAGFromOneStateToAnother(pScanTemplate->StartJtagState, NO_LAST_DATA_BIT, false);
+
+  // Only the data bits byte and the last data bit of each write scan are patched into the template commands, the
+  // commands are then sent in between the whole data bytes of the caller's write data buffers
+  for (dwScanIndex = 0; (dwScanIndex < pScanTemplate->dwNumScans); dwScanIndex++)
+  {
+    pSlot = &pScanTemplate->Slots[dwScanIndex];
+
+    if (pSlot->dwScanType != SCAN_TEMPLATE_READ)
+    {
+      pWriteDataBytes = *(*pWriteDataBuffers)[dwScanIndex];
+
+      if (pSlot->dwDataBitsIndex != NO_SCAN_TEMPLATE_SLOT)
+        pCommandBytes[pSlot->dwDataBitsIndex] = pWriteDataBytes[pSlot->dwNumDataBytes];
+
+      if (pSlot->dwLastDataBitIndex != NO_SCAN_TEMPLATE_SLOT)
+      {
+        dwLastDataBit = ((pWriteDataBytes[pSlot->dwNumDataBytes] >> pSlot->dwLastDataBitShift) & '\x01');
+
+        pCommandBytes[pSlot->dwLastDataBitIndex] = ((pCommandBytes[pSlot->dwLastDataBitIndex] & '\x7F') | (dwLastDataBit << 7));
+      }
+    }
+
+    AddDataBytesToOutputBuffer(&pCommandBytes[dwCommandBytesIndex], (pSlot->dwDataBytesIndex - dwCommandBytesIndex));
+
+    dwCommandBytesIndex = pSlot->dwDataBytesIndex;
+
+    if ((pSlot->dwScanType != SCAN_TEMPLATE_READ) && (pSlot->dwNumDataBytes > 0))
+      AddDataBytesToOutputBuffer(pWriteDataBytes, pSlot->dwNumDataBytes);
+  }
+
+  AddDataBytesToOutputBuffer(&pCommandBytes[dwCommandBytesIndex], (pScanTemplate->dwNumCommandBytes - dwCommandBytesIndex));
+
+  CurrentJtagState = pScanTemplate->EndJtagState;
+
+  if (pScanTemplate->dwNumReadDataBytes > 0)
+  {
+    Status = FTC_SendReadBytesToFromDevice(ftHandle, *pReadDataBuffer, pScanTemplate->dwNumReadDataBytes, &dwNumDataBytesRead);
+
+    if (Status == FTC_SUCCESS)
+    {
+      // The bytes returned by each read scan are realigned and moved down over the bytes dropped by the scans before
+      for (dwScanIndex = 0; (dwScanIndex < pScanTemplate->dwNumScans); dwScanIndex++)
+      {
+        pSlot = &pScanTemplate->Slots[dwScanIndex];
+
+        if (pSlot->dwScanType != SCAN_TEMPLATE_WRITE)
+        {
+          dwNumScanDataBits = ExtractReadDataBits(*pReadDataBuffer, (dwNumBytesReturned * NUMBITSINBYTE),
+                                                  &(*pReadDataBuffer)[dwReadDataBytesIndex], pSlot->dwNumReadDataBytes,
+                                                  pSlot->dwNumRemainingDataBits, pSlot->dwNumTmsClocks);
+
+          dwReadDataBytesIndex = (dwReadDataBytesIndex + pSlot->dwNumReadDataBytes);
+          dwNumBytesReturned = (dwNumBytesReturned + ((dwNumScanDataBits + (NUMBITSINBYTE - 1)) / NUMBITSINBYTE));
+        }
+      }
+    }
+  }
+  else
+    Status = FTC_SendBytesToDevice(ftHandle);
+
+  if ((Status == FTC_SUCCESS) && (lpdwNumBytesReturned != NULL))
+    *lpdwNumBytesReturned = dwNumBytesReturned;
+
+  InvalidateInstructionRegisterCache(ftHandle);
+
+  return Status;
+}
+
+PFTC_SCAN_TEMPLATE_DATA FT2232hMpsseJtag::GetScanTemplate(FTC_HANDLE ftHandle, DWORD dwScanTemplate)
+{
+  PFTC_SCAN_TEMPLATE_DATA pScanTemplate = NULL;
+
+  // A scan template is identified by its index plus one and can only be used with the device it was created for
+  if ((dwScanTemplate >= 1) && (dwScanTemplate <= MAX_NUM_SCAN_TEMPLATES))
+  {
+    if (ScanTemplates[(dwScanTemplate - 1)].hDevice == ftHandle)
+      pScanTemplate = &ScanTemplates[(dwScanTemplate - 1)];
+  }
+
+  return pScanTemplate;
+}
+
+void FT2232hMpsseJtag::DeleteScanTemplate(PFTC_SCAN_TEMPLATE_DATA pScanTemplate)
+{
+  if (pScanTemplate->pCommandBytes != NULL)
+    delete [] pScanTemplate->pCommandBytes;
+
+  pScanTemplate->pCommandBytes = NULL;
+  pScanTemplate->hDevice = 0;
+}
+
+void FT2232hMpsseJtag::DeleteDeviceScanTemplates(FTC_HANDLE ftHandle)
+{
+  DWORD dwScanTemplateIndex = 0;
+
+  for (dwScanTemplateIndex = 0; (dwScanTemplateIndex < MAX_NUM_SCAN_TEMPLATES); dwScanTemplateIndex++)
+  {
+    if (ScanTemplates[dwScanTemplateIndex].hDevice == ftHandle)
+      DeleteScanTemplate(&ScanTemplates[dwScanTemplateIndex]);
+  }
+}
+
+FTC_STATUS FT2232hMpsseJtag::RecordCommandsSequence(FTC_HANDLE ftHandle, PFTC_RECORDED_CMD_SEQUENCE_DATA pRecordedCmdSequence)
+{
+  // Freezes the sequence built for a device, the sequence is then cleared whether or not it could be recorded
+  FTC_STATUS Status = FTC_SUCCESS;
+  PFTC_DEVICE_CMD_SEQUENCE_DATA pCmdSequenceData = &OpenedDevicesCommandsSequenceData[iCommandsSequenceDataDeviceIndex];
+  DWORD dwNumCmdSequenceBytes = 0;
+
+  dwNumCmdSequenceBytes = CompleteCommandsSequence();
+
+  pRecordedCmdSequence->pCommandBytes = new BYTE[dwNumCmdSequenceBytes];
+  pRecordedCmdSequence->pReadCommandsSequenceData = CreateReadCommandsSequenceDataBuffer(pCmdSequenceData->dwNumReadCommandSequences);
+
+  if ((pRecordedCmdSequence->pCommandBytes != NULL) && (pRecordedCmdSequence->pReadCommandsSequenceData != NULL))
+  {
+    memcpy(pRecordedCmdSequence->pCommandBytes, *pCmdSequenceData->pCommandsSequenceDataOutPutBuffer, dwNumCmdSequenceBytes);
+    memcpy(pRecordedCmdSequence->pReadCommandsSequenceData, pCmdSequenceData->pReadCommandsSequenceDataBuffer,
+           (pCmdSequenceData->dwNumReadCommandSequences * sizeof(FTC_READ_CMD_SEQUENCE_DATA)));
+
+    pRecordedCmdSequence->bRecorded = true;
+    pRecordedCmdSequence->bHiSpeedDevice = (FTC_IsHiSpeedDeviceHandleValid(ftHandle) == FTC_SUCCESS);
+    pRecordedCmdSequence->dwNumCommandBytes = dwNumCmdSequenceBytes;
+    pRecordedCmdSequence->dwNumReadCommandSequences = pCmdSequenceData->dwNumReadCommandSequences;
+    pRecordedCmdSequence->dwNumReadDataBytes = GetTotalNumCommandsSequenceDataBytesToRead();
+    pRecordedCmdSequence->StartJtagState = pCmdSequenceData->StartJtagState;
+    pRecordedCmdSequence->EndJtagState = CurrentJtagState;
+  }
+  else
+  {
+    DeleteRecordedCommandsSequence(pRecordedCmdSequence);
+
+    Status = FTC_INSUFFICIENT_RESOURCES;
+  }
+
+  pCmdSequenceData->dwNumBytesToSend = 0;
+  pCmdSequenceData->dwNumReadCommandSequences = 0;
+
+  return Status;
+}
+
+FTC_STATUS FT2232hMpsseJtag::ExecuteRecordedCommandsSequence(FTC_HANDLE ftHandle, PFTC_RECORDED_CMD_SEQUENCE_DATA pRecordedCmdSequence,
+                                                             PReadCmdSequenceDataByteBuffer pReadCmdSequenceDataBuffer, LPDWORD lpdwNumBytesReturned)
+{
+  FTC_STATUS Status = FTC_SUCCESS;
+  PFTC_DEVICE_CMD_SEQUENCE_DATA pCmdSequenceData = &OpenedDevicesCommandsSequenceData[GetCommandsSequenceDataDeviceIndex(ftHandle)];
+  DWORD dwNumBytesRead = 0;
+  DWORD dwNumBytesReturned = 0;
+
+  // The bytes read are kept in a buffer of the device allocated by its first replay that reads, which every later
+  // replay reuses
+  if ((pRecordedCmdSequence->dwNumReadCommandSequences > 0) && (pCmdSequenceData->pReplayInputBuffer == NULL))
+  {
+    pCmdSequenceData->pReplayInputBuffer = PInputByteBuffer(new InputByteBuffer);
+
+    if (pCmdSequenceData->pReplayInputBuffer == NULL)
+      Status = FTC_INSUFFICIENT_RESOURCES;
+  }
+
+  if (Status == FTC_SUCCESS)
+  {
+    FTC_ClearOutputBuffer();
+
+    // A sequence that starts with a reset of the TAP controller can be replayed from any state
+    if ((pRecordedCmdSequence->StartJtagState != Undefined) && (CurrentJtagState != pRecordedCmdSequence->StartJtagState))
+      MoveJTAGFromOneStateToAnother(pRecordedCmdSequence->StartJtagState, NO_LAST_DATA_BIT, false);
+
+    // The recorded commands are only referenced, they are written to the device straight from the recorded sequence
+    FTC_AddDataBytesToOutputBuffer(pRecordedCmdSequence->pCommandBytes, pRecordedCmdSequence->dwNumCommandBytes);
+
+    CurrentJtagState = pRecordedCmdSequence->EndJtagState;
+
+    if (pRecordedCmdSequence->dwNumReadCommandSequences > 0)
+    {
+      Status = FTC_SendReadBytesToFromDevice(ftHandle, *pCmdSequenceData->pReplayInputBuffer, pRecordedCmdSequence->dwNumReadDataBytes,
+                                             &dwNumBytesRead);
+
+      if (Status == FTC_SUCCESS)
+        ProcessReadCommandsSequenceBytes(pRecordedCmdSequence->pReadCommandsSequenceData, pRecordedCmdSequence->dwNumReadCommandSequences,
+                                         pCmdSequenceData->pReplayInputBuffer, dwNumBytesRead, pReadCmdSequenceDataBuffer,
+                                         &dwNumBytesReturned);
+    }
+    else
+      Status = FTC_SendCommandsSequenceToDevice(ftHandle);
+
+    if ((Status == FTC_SUCCESS) && (lpdwNumBytesReturned != NULL))
+      *lpdwNumBytesReturned = dwNumBytesReturned;
+
+    InvalidateInstructionRegisterCache(ftHandle);
+  }
+
+  return Status;
+}
+
+PFTC_RECORDED_CMD_SEQUENCE_DATA FT2232hMpsseJtag::GetRecordedCommandsSequence(DWORD dwRecordedCmdSequence)
+{
+  PFTC_RECORDED_CMD_SEQUENCE_DATA pRecordedCmdSequence = NULL;
+
+  // A recorded command sequence is identified by its index plus one
+  if ((dwRecordedCmdSequence >= 1) && (dwRecordedCmdSequence <= MAX_NUM_RECORDED_CMD_SEQUENCES))
+  {
+    if (RecordedCommandSequences[(dwRecordedCmdSequence - 1)].bRecorded)
+      pRecordedCmdSequence = &RecordedCommandSequences[(dwRecordedCmdSequence - 1)];
+  }
+
+  return pRecordedCmdSequence;
+}
+
+void FT2232hMpsseJtag::DeleteRecordedCommandsSequence(PFTC_RECORDED_CMD_SEQUENCE_DATA pRecordedCmdSequence)
+{
+  if (pRecordedCmdSequence->pCommandBytes != NULL)
+    delete [] pRecordedCmdSequence->pCommandBytes;
+
+  if (pRecordedCmdSequence->pReadCommandsSequenceData != NULL)
+    DeleteReadCommandsSequenceDataBuffer(pRecordedCmdSequence->pReadCommandsSequenceData);
+
+  pRecordedCmdSequence->pCommandBytes = NULL;
+  pRecordedCmdSequence->pReadCommandsSequenceData = NULL;
+  pRecordedCmdSequence->bRecorded = false;
+}
+
+FTC_STATUS FT2232hMpsseJtag::AddDeviceWriteCommand(FTC_HANDLE ftHandle, BOOL bInstructionTestData, DWORD dwNumBitsToWrite,
+                                                   PWriteDataByteBuffer pWriteDataBuffer, DWORD dwNumBytesToWrite,
+                                                   DWORD dwTapControllerState, DWORD dwNumIdleCycles)
+{
+  FTC_STATUS Status = FTC_SUCCESS;
+  DWORD dwNumCommandDataBytes = 0;
+  DWORD dwNumTmsClocks = 0;
+
+  if (pWriteDataBuffer != NULL)
+  {
+    Status = CheckWriteDataToExternalDeviceBitsBytesParameters(dwNumBitsToWrite, dwNumBytesToWrite);
+
+    if (Status == FTC_SUCCESS)
+    {
+      if ((dwTapControllerState >= TEST_LOGIC_STATE) && (dwTapControllerState <= UPDATE_INSTRUCTION_REGISTER_STATE))
+        Status = CheckIdleCyclesParameters(dwNumIdleCycles, dwTapControllerState);
+      else
+        Status = FTC_INVALID_TAP_CONTROLLER_STATE;
+
+      if (Status == FTC_SUCCESS)
+      {
+        dwNumCommandDataBytes = (NUM_WRITE_COMMAND_BYTES + dwNumBytesToWrite + GetNumIdleCyclesCommandBytes(dwNumIdleCycles));
+
+        iCommandsSequenceDataDeviceIndex = GetCommandsSequenceDataDeviceIndex(ftHandle);
+
+        // The next sequence can be built while a submitted sequence is executed
+        Status = FlushStreamingCommandsSequence(ftHandle, dwNumCommandDataBytes, 0);
+
+        if (Status == FTC_SUCCESS)
+        {
+          if ((GetNumBytesInCommandsSequenceDataBuffer() + dwNumCommandDataBytes) < OUTPUT_BUFFER_SIZE)
+          {
+            SetCommandsSequenceStartJtagState();
+
+            dwNumTmsClocks = AddWriteCommandDataToOutPutBuffer(bInstructionTestData, dwNumBitsToWrite, pWriteDataBuffer,
+                                                               dwNumBytesToWrite, dwTapControllerState);
+
+            AddIdleCyclesToOutputBuffer(ftHandle, dwNumTmsClocks, dwNumIdleCycles);
+          }
+          else
+            Status = FTC_COMMAND_SEQUENCE_BUFFER_FULL;
+        }
+
+        // Reset to indicate that you are not building up a sequence of commands
+        iCommandsSequenceDataDeviceIndex = -1;
+      }
+    }
+  }
+  else
+    Status = FTC_NULL_WRITE_DATA_BUFFER_POINTER;
+
+  return Status;
+}
+
+FTC_STATUS FT2232hMpsseJtag::AddDeviceReadCommand(FTC_HANDLE ftHandle, BOOL bInstructionTestData, DWORD dwNumBitsToRead,
+                                                  DWORD dwTapControllerState, DWORD dwNumIdleCycles)
+{
+  FTC_STATUS Status = FTC_SUCCESS;
+  DWORD dwNumCommandDataBytes = 0;
+  DWORD dwNumTmsClocks = 0;
+
+  if ((dwNumBitsToRead >= MIN_NUM_BITS) && (dwNumBitsToRead <= MAX_NUM_BITS))
+  {
+    if ((dwTapControllerState >= TEST_LOGIC_STATE) && (dwTapControllerState <= UPDATE_INSTRUCTION_REGISTER_STATE))
+      Status = CheckIdleCyclesParameters(dwNumIdleCycles, dwTapControllerState);
+    else
+      Status = FTC_INVALID_TAP_CONTROLLER_STATE;
+
+    if (Status == FTC_SUCCESS)
+    {
+      dwNumCommandDataBytes = (NUM_READ_COMMAND_BYTES + GetNumIdleCyclesCommandBytes(dwNumIdleCycles));
+
+      iCommandsSequenceDataDeviceIndex = GetCommandsSequenceDataDeviceIndex(ftHandle);
+
+      // The next sequence can be built while a submitted sequence is executed
+      Status = FlushStreamingCommandsSequence(ftHandle, dwNumCommandDataBytes, dwNumBitsToRead);
+
+      if (Status == FTC_SUCCESS)
+      {
+        if ((GetNumBytesInCommandsSequenceDataBuffer() + dwNumCommandDataBytes) < OUTPUT_BUFFER_SIZE)
+        {
+          SetCommandsSequenceStartJtagState();
+
+          dwNumTmsClocks = AddReadCommandToOutputBuffer(bInstructionTestData, dwNumBitsToRead, dwTapControllerState);
+
+          dwNumTmsClocks = (dwNumTmsClocks + AddIdleCyclesToOutputBuffer(ftHandle, dwNumTmsClocks, dwNumIdleCycles));
+
+          Status = AddReadCommandSequenceData(dwNumBitsToRead, dwNumTmsClocks);
+        }
+        else
+          Status = FTC_COMMAND_SEQUENCE_BUFFER_FULL;
+      }
+
+      // Reset to indicate that you are not building up a sequence of commands
+      iCommandsSequenceDataDeviceIndex = -1;
+    }
+  }
+  else
+    Status = FTC_INVALID_NUMBER_BITS;
+
+  return Status;
+}
+
+FTC_STATUS FT2232hMpsseJtag::AddDeviceWriteReadCommand(FTC_HANDLE ftHandle, BOOL bInstructionTestData, DWORD dwNumBitsToWriteRead,
+                                                       PWriteDataByteBuffer pWriteDataBuffer, DWORD dwNumBytesToWrite,
+                                                       DWORD dwTapControllerState, DWORD dwNumIdleCycles)
+{
+  FTC_STATUS Status = FTC_SUCCESS;
   DWORD dwNumCommandDataBytes = 0;
+  DWORD dwNumTmsClocks = 0;
+
+  if (pWriteDataBuffer != NULL)
+  {
+    Status = CheckWriteDataToExternalDeviceBitsBytesParameters(dwNumBitsToWriteRead, dwNumBytesToWrite);
+
+    if (Status == FTC_SUCCESS)
+    {
+      if ((dwTapControllerState >= TEST_LOGIC_STATE) && (dwTapControllerState <= UPDATE_INSTRUCTION_REGISTER_STATE))
+        Status = CheckIdleCyclesParameters(dwNumIdleCycles, dwTapControllerState);
+      else
+        Status = FTC_INVALID_TAP_CONTROLLER_STATE;
+
+      if (Status == FTC_SUCCESS)
+      {
+        dwNumCommandDataBytes = (NUM_WRITE_READ_COMMAND_BYTES + dwNumBytesToWrite + GetNumIdleCyclesCommandBytes(dwNumIdleCycles));
+
+        iCommandsSequenceDataDeviceIndex = GetCommandsSequenceDataDeviceIndex(ftHandle);
+
+        // The next sequence can be built while a submitted sequence is executed
+        Status = FlushStreamingCommandsSequence(ftHandle, dwNumCommandDataBytes, dwNumBitsToWriteRead);
+
+        if (Status == FTC_SUCCESS)
+        {
+          if ((GetNumBytesInCommandsSequenceDataBuffer() + dwNumCommandDataBytes) < OUTPUT_BUFFER_SIZE)
+          {
+            SetCommandsSequenceStartJtagState();
+
+            dwNumTmsClocks = AddWriteReadCommandDataToOutPutBuffer(bInstructionTestData, dwNumBitsToWriteRead, pWriteDataBuffer,
+                                                                     dwNumBytesToWrite, dwTapControllerState);
+
+            dwNumTmsClocks = (dwNumTmsClocks + AddIdleCyclesToOutputBuffer(ftHandle, dwNumTmsClocks, dwNumIdleCycles));
+
+            Status = AddReadCommandSequenceData(dwNumBitsToWriteRead, dwNumTmsClocks);
+          }
+          else
+            Status = FTC_COMMAND_SEQUENCE_BUFFER_FULL;
+        }
+
+        // Reset to indicate that you are not building up a sequence of commands
+        iCommandsSequenceDataDeviceIndex = -1;
+      }
+    }
+  }
+  else
+    Status = FTC_NULL_WRITE_DATA_BUFFER_POINTER;
+
+  return Status;
+}
+
+FT2232hMpsseJtag::FT2232hMpsseJtag(void)
+{
+  DWORD dwDeviceIndex = 0;
+  DWORD dwScanTemplateIndex = 0;
+  DWORD dwRecordedCmdSequenceIndex = 0;
+
+  CurrentJtagState = Undefined;
+
+  dwSavedLowPinsDirection = 0;
+  dwSavedLowPinsValue = 0;
+
+  dwNumOpenedDevices = 0;
+
+  for (dwDeviceIndex = 0; (dwDeviceIndex < MAX_NUM_DEVICES); dwDeviceIndex++)
+    OpenedDevicesCommandsSequenceData[dwDeviceIndex].hDevice = 0;
+
+  iCommandsSequenceDataDeviceIndex = -1;
+
+  for (dwScanTemplateIndex = 0; (dwScanTemplateIndex < MAX_NUM_SCAN_TEMPLATES); dwScanTemplateIndex++)
+  {
+    ScanTemplates[dwScanTemplateIndex].hDevice = 0;
+    ScanTemplates[dwScanTemplateIndex].pCommandBytes = NULL;
+  }
+
+  for (dwRecordedCmdSequenceIndex = 0; (dwRecordedCmdSequenceIndex < MAX_NUM_RECORDED_CMD_SEQUENCES); dwRecordedCmdSequenceIndex++)
+  {
+    RecordedCommandSequences[dwRecordedCmdSequenceIndex].bRecorded = false;
+    RecordedCommandSequences[dwRecordedCmdSequenceIndex].pCommandBytes = NULL;
+    RecordedCommandSequences[dwRecordedCmdSequenceIndex].pReadCommandsSequenceData = NULL;
+  }
+
+  InitializeCriticalSection(&threadAccess);
+
+#ifndef _WIN32
+  pthread_cond_init(&CommandSequenceSubmitted, NULL);
+  pthread_cond_init(&CompletionWatchEnded, NULL);
+  bCompletionWatcherStarted = false;
+  bStopCompletionWatcher = false;
+#endif
+}
+
+FT2232hMpsseJtag::~FT2232hMpsseJtag(void)
+{
+  DWORD dwDeviceIndex = 0;
+  DWORD dwScanTemplateIndex = 0;
+  DWORD dwRecordedCmdSequenceIndex = 0;
+  POutputByteBuffer pCmdsSequenceDataOutPutBuffer;
+
+#ifndef _WIN32
+  StopCompletionWatcher();
+#endif
+
+  if (dwNumOpenedDevices > 0)
+  {
+    for (dwDeviceIndex = 0; (dwDeviceIndex < MAX_NUM_DEVICES); dwDeviceIndex++)
+    {
+      if (OpenedDevicesCommandsSequenceData[dwDeviceIndex].hDevice != 0)
+      {
+        OpenedDevicesCommandsSequenceData[dwDeviceIndex].hDevice = 0;
+
+        pCmdsSequenceDataOutPutBuffer = OpenedDevicesCommandsSequenceData[dwDeviceIndex].pCommandsSequenceDataOutPutBuffer;
+
+        if (pCmdsSequenceDataOutPutBuffer != NULL)
+          delete [] pCmdsSequenceDataOutPutBuffer;
+
+        OpenedDevicesCommandsSequenceData[dwDeviceIndex].pCommandsSequenceDataOutPutBuffer = NULL;
+
+        if (OpenedDevicesCommandsSequenceData[dwDeviceIndex].pReadCommandsSequenceDataBuffer != NULL)
+          DeleteReadCommandsSequenceDataBuffer(OpenedDevicesCommandsSequenceData[dwDeviceIndex].pReadCommandsSequenceDataBuffer);
+
+        OpenedDevicesCommandsSequenceData[dwDeviceIndex].pReadCommandsSequenceDataBuffer = NULL;
+
+        if (OpenedDevicesCommandsSequenceData[dwDeviceIndex].pSubmittedReadCommandsSequenceDataBuffer != NULL)
+          DeleteReadCommandsSequenceDataBuffer(OpenedDevicesCommandsSequenceData[dwDeviceIndex].pSubmittedReadCommandsSequenceDataBuffer);
+
+        OpenedDevicesCommandsSequenceData[dwDeviceIndex].pSubmittedReadCommandsSequenceDataBuffer = NULL;
+
+        DeleteStreamingCommandsSequenceBuffers(dwDeviceIndex);
+
+        if (OpenedDevicesCommandsSequenceData[dwDeviceIndex].pReplayInputBuffer != NULL)
+          delete [] OpenedDevicesCommandsSequenceData[dwDeviceIndex].pReplayInputBuffer;
+
+        OpenedDevicesCommandsSequenceData[dwDeviceIndex].pReplayInputBuffer = NULL;
+
+#ifndef _WIN32
+        if (OpenedDevicesCommandsSequenceData[dwDeviceIndex].iCompletionFd != -1)
+          close(OpenedDevicesCommandsSequenceData[dwDeviceIndex].iCompletionFd);
+#endif
+        OpenedDevicesCommandsSequenceData[dwDeviceIndex].iCompletionFd = -1;
+      }
+    }
+  }
+
+  for (dwScanTemplateIndex = 0; (dwScanTemplateIndex < MAX_NUM_SCAN_TEMPLATES); dwScanTemplateIndex++)
+    DeleteScanTemplate(&ScanTemplates[dwScanTemplateIndex]);
+
+  for (dwRecordedCmdSequenceIndex = 0; (dwRecordedCmdSequenceIndex < MAX_NUM_RECORDED_CMD_SEQUENCES); dwRecordedCmdSequenceIndex++)
+    DeleteRecordedCommandsSequence(&RecordedCommandSequences[dwRecordedCmdSequenceIndex]);
+
+#ifndef _WIN32
+  pthread_cond_destroy(&CommandSequenceSubmitted);
+  pthread_cond_destroy(&CompletionWatchEnded);
+#endif
+
+  DeleteCriticalSection(&threadAccess);
+}
+
+FTC_STATUS FT2232hMpsseJtag::JTAG_GetNumDevices(LPDWORD lpdwNumDevices)
+{
+  FTC_STATUS Status = FTC_SUCCESS;
+  FT2232CDeviceIndexes FT2232CIndexes;
+
+  EnterCriticalSection(&threadAccess);
+
+  *lpdwNumDevices = 0;
+
+  Status = FTC_GetNumDevices(lpdwNumDevices, &FT2232CIndexes);
+
+  LeaveCriticalSection(&threadAccess);
+
+  return Status;
+}
+
+FTC_STATUS FT2232hMpsseJtag::JTAG_GetNumHiSpeedDevices(LPDWORD lpdwNumHiSpeedDevices)
+{
+  FTC_STATUS Status = FTC_SUCCESS;
+  HiSpeedDeviceIndexes HiSpeedIndexes;
+
+  EnterCriticalSection(&threadAccess);
+
+  *lpdwNumHiSpeedDevices = 0;
+
+  Status = FTC_GetNumHiSpeedDevices(lpdwNumHiSpeedDevices, &HiSpeedIndexes);
+
+  LeaveCriticalSection(&threadAccess);
+
+  return Status;
+}
+
+FTC_STATUS FT2232hMpsseJtag::JTAG_GetDeviceNameLocationID(DWORD dwDeviceNameIndex, LPSTR lpDeviceNameBuffer, DWORD dwBufferSize, LPDWORD lpdwLocationID)
+{
+  FTC_STATUS Status = FTC_SUCCESS;
+
+  EnterCriticalSection(&threadAccess);
+
+  Status = FTC_GetDeviceNameLocationID(dwDeviceNameIndex, lpDeviceNameBuffer, dwBufferSize, lpdwLocationID);
+
+  LeaveCriticalSection(&threadAccess);
+
+  return Status;
+}
+
+FTC_STATUS FT2232hMpsseJtag::JTAG_GetHiSpeedDeviceNameLocationIDChannel(DWORD dwDeviceNameIndex, LPSTR lpDeviceNameBuffer, DWORD dwBufferSize, LPDWORD lpdwLocationID, LPSTR lpChannel, DWORD dwChannelBufferSize, LPDWORD lpdwHiSpeedDeviceType)
+{
+  FTC_STATUS Status = FTC_SUCCESS;
+  DWORD dwDeviceType = 0;
+
+  EnterCriticalSection(&threadAccess);
+
+  *lpdwHiSpeedDeviceType = 0;
+
+  Status = FTC_GetHiSpeedDeviceNameLocationIDChannel(dwDeviceNameIndex, lpDeviceNameBuffer, dwBufferSize, lpdwLocationID, lpChannel, dwChannelBufferSize, &dwDeviceType);
+
+  if (Status == FTC_SUCCESS)
+  {
+    if ((dwDeviceType == FT_DEVICE_2232H) || (dwDeviceType == FT_DEVICE_4232H))
+    {
+      if (dwDeviceType == FT_DEVICE_2232H)
+        *lpdwHiSpeedDeviceType = FT2232H_DEVICE_TYPE;
+      else
+        *lpdwHiSpeedDeviceType = FT4232H_DEVICE_TYPE;
+    }
+    else
+      Status = FTC_DEVICE_NOT_FOUND;
+  }
+
+  LeaveCriticalSection(&threadAccess);
+
+  return Status;
+}
+
+FTC_STATUS FT2232hMpsseJtag::JTAG_OpenDevice(FTC_HANDLE *pftHandle)
+{
+  FTC_STATUS Status = FTC_SUCCESS;
+
+  EnterCriticalSection(&threadAccess);
+
+  Status = FTC_OpenDevice(pftHandle);
+
+  if (Status == FTC_SUCCESS)
+  {
+    Status = CreateDeviceCommandsSequenceDataBuffers(*pftHandle);
+
+    if (Status != FTC_SUCCESS)
+    {
+      FTC_CloseDevice(*pftHandle);
+
+      *pftHandle = 0;
+    }
+  }
+
+  LeaveCriticalSection(&threadAccess);
+
+  return Status;
+}
+
+FTC_STATUS FT2232hMpsseJtag::JTAG_OpenSpecifiedDevice(LPSTR lpDeviceName, DWORD dwLocationID, FTC_HANDLE *pftHandle)
+{
+  FTC_STATUS Status = FTC_SUCCESS;
+
+  EnterCriticalSection(&threadAccess);
+
+  Status = FTC_OpenSpecifiedDevice(lpDeviceName, dwLocationID, pftHandle);
+
+  if (Status == FTC_SUCCESS)
+  {
+    Status = CreateDeviceCommandsSequenceDataBuffers(*pftHandle);
+
+    if (Status != FTC_SUCCESS)
+    {
+      FTC_CloseDevice(*pftHandle);
+
+      *pftHandle = 0;
+    }
+  }
+
+  LeaveCriticalSection(&threadAccess);
+
+  return Status;
+}
+
+FTC_STATUS FT2232hMpsseJtag::JTAG_OpenSpecifiedHiSpeedDevice(LPSTR lpDeviceName, DWORD dwLocationID, LPSTR lpChannel, FTC_HANDLE *pftHandle)
+{
+  FTC_STATUS Status = FTC_SUCCESS;
+
+  EnterCriticalSection(&threadAccess);
+
+  Status = FTC_OpenSpecifiedHiSpeedDevice(lpDeviceName, dwLocationID, lpChannel, pftHandle);
+
+  if (Status == FTC_SUCCESS)
+  {
+    Status = CreateDeviceCommandsSequenceDataBuffers(*pftHandle);
+
+    if (Status != FTC_SUCCESS)
+    {
+      FTC_CloseDevice(*pftHandle);
+
+      *pftHandle = 0;
+    }
+  }
+
+  LeaveCriticalSection(&threadAccess);
+
+  return Status;
+}
+
+FTC_STATUS FT2232hMpsseJtag::JTAG_OpenTransportDevice(DWORD dwTransportType, DWORD dwDeviceIndex, FTC_HANDLE *pftHandle)
+{
+  FTC_STATUS Status = FTC_SUCCESS;
+
+  EnterCriticalSection(&threadAccess);
+
+  Status = FTC_OpenTransportDevice(dwTransportType, dwDeviceIndex, pftHandle);
+
+  if (Status == FTC_SUCCESS)
+  {
+    Status = CreateDeviceCommandsSequenceDataBuffers(*pftHandle);
+
+    if (Status != FTC_SUCCESS)
+    {
+      FTC_CloseDevice(*pftHandle);
+
+      *pftHandle = 0;
+    }
+  }
+
+  LeaveCriticalSection(&threadAccess);
+
+  return Status;
+}
+
+FTC_STATUS FT2232hMpsseJtag::JTAG_GetDeviceTransportType(FTC_HANDLE ftHandle, LPDWORD lpdwTransportType)
+{
+  FTC_STATUS Status = FTC_SUCCESS;
+  FtcTransport *pTransport = NULL;
+
+  EnterCriticalSection(&threadAccess);
+
+  if ((Status = FTC_IsDeviceHandleValid(ftHandle)) == FTC_SUCCESS)
+  {
+    if ((pTransport = FTC_GetDeviceTransport(ftHandle)) != NULL)
+      *lpdwTransportType = pTransport->GetTransportType();
+    else
+      Status = FTC_INVALID_HANDLE;
+  }
+
+  LeaveCriticalSection(&threadAccess);
+
+  return Status;
+}
+
+FTC_STATUS FT2232hMpsseJtag::JTAG_GetEmulatorState(FTC_HANDLE ftHandle, PFTC_EMULATOR_STATE pEmulatorState)
+{
+  FTC_STATUS Status = FTC_SUCCESS;
+  FtcTransport *pTransport = NULL;
+
+  EnterCriticalSection(&threadAccess);
+
+  if ((Status = FTC_IsDeviceHandleValid(ftHandle)) == FTC_SUCCESS)
+  {
+    if ((pTransport = FTC_GetDeviceTransport(ftHandle)) != NULL)
+      Status = pTransport->GetEmulatorState(pEmulatorState);
+    else
+      Status = FTC_INVALID_HANDLE;
+  }
+
+  LeaveCriticalSection(&threadAccess);
+
+  return Status;
+}
+
+FTC_STATUS FT2232hMpsseJtag::JTAG_SetDeviceTransferQueueDepth(FTC_HANDLE ftHandle, DWORD dwNumWriteTransfers, DWORD dwNumReadTransfers)
+{
+  FTC_STATUS Status = FTC_SUCCESS;
+
+  EnterCriticalSection(&threadAccess);
+
+  Status = FTC_SetDeviceTransferQueueDepth(ftHandle, dwNumWriteTransfers, dwNumReadTransfers);
+
+  LeaveCriticalSection(&threadAccess);
+
+  return Status;
+}
+
+FTC_STATUS FT2232hMpsseJtag::JTAG_GetDeviceTransferQueueDepth(FTC_HANDLE ftHandle, LPDWORD lpdwNumWriteTransfers, LPDWORD lpdwNumReadTransfers)
+{
+  FTC_STATUS Status = FTC_SUCCESS;
+
+  EnterCriticalSection(&threadAccess);
+
+  Status = FTC_GetDeviceTransferQueueDepth(ftHandle, lpdwNumWriteTransfers, lpdwNumReadTransfers);
+
+  LeaveCriticalSection(&threadAccess);
+
+  return Status;
+}
+
+FTC_STATUS FT2232hMpsseJtag::JTAG_SetDeviceWaitPolicy(FTC_HANDLE ftHandle, DWORD dwWaitPolicy, DWORD dwSpinPeriodMicroSecs)
+{
+  FTC_STATUS Status = FTC_SUCCESS;
+
+  EnterCriticalSection(&threadAccess);
+
+  Status = FTC_SetDeviceWaitPolicy(ftHandle, dwWaitPolicy, dwSpinPeriodMicroSecs);
+
+  LeaveCriticalSection(&threadAccess);
+
+  return Status;
+}
+
+FTC_STATUS FT2232hMpsseJtag::JTAG_GetDeviceWaitPolicy(FTC_HANDLE ftHandle, LPDWORD lpdwWaitPolicy, LPDWORD lpdwSpinPeriodMicroSecs)
+{
+  FTC_STATUS Status = FTC_SUCCESS;
+
+  EnterCriticalSection(&threadAccess);
+
+  Status = FTC_GetDeviceWaitPolicy(ftHandle, lpdwWaitPolicy, lpdwSpinPeriodMicroSecs);
+
+  LeaveCriticalSection(&threadAccess);
+
+  return Status;
+}
+
+FTC_STATUS FT2232hMpsseJtag::JTAG_SetDeviceUSBTransferChunkSize(FTC_HANDLE ftHandle, DWORD dwUSBTransferChunkSize)
+{
+  FTC_STATUS Status = FTC_SUCCESS;
+
+  EnterCriticalSection(&threadAccess);
+
+  Status = FTC_SetDeviceUSBTransferChunkSize(ftHandle, dwUSBTransferChunkSize);
+
+  LeaveCriticalSection(&threadAccess);
+
+  return Status;
+}
+
+FTC_STATUS FT2232hMpsseJtag::JTAG_GetDeviceUSBTransferChunkSize(FTC_HANDLE ftHandle, LPDWORD lpdwUSBTransferChunkSize)
+{
+  FTC_STATUS Status = FTC_SUCCESS;
+
+  EnterCriticalSection(&threadAccess);
+
+  Status = FTC_GetDeviceUSBTransferChunkSize(ftHandle, lpdwUSBTransferChunkSize);
+
+  LeaveCriticalSection(&threadAccess);
+
+  return Status;
+}
+
+FTC_STATUS FT2232hMpsseJtag::JTAG_SetDeviceCommandTimeout(FTC_HANDLE ftHandle, DWORD dwCommandTimeoutmSec)
+{
+  FTC_STATUS Status = FTC_SUCCESS;
+
+  EnterCriticalSection(&threadAccess);
+
+  Status = FTC_SetDeviceCommandTimeout(ftHandle, dwCommandTimeoutmSec);
+
+  LeaveCriticalSection(&threadAccess);
+
+  return Status;
+}
+
+FTC_STATUS FT2232hMpsseJtag::JTAG_GetDeviceCommandTimeout(FTC_HANDLE ftHandle, LPDWORD lpdwCommandTimeoutmSec)
+{
+  FTC_STATUS Status = FTC_SUCCESS;
+
+  EnterCriticalSection(&threadAccess);
+
+  Status = FTC_GetDeviceCommandTimeout(ftHandle, lpdwCommandTimeoutmSec);
+
+  LeaveCriticalSection(&threadAccess);
+
+  return Status;
+}
+
+FTC_STATUS FT2232hMpsseJtag::JTAG_SetDeviceIOThread(FTC_HANDLE ftHandle, BOOL bIOThreadEnabled)
+{
+  FTC_STATUS Status = FTC_SUCCESS;
+
+  EnterCriticalSection(&threadAccess);
+
+#ifndef _WIN32
+  WaitForCompletionWatcher(ftHandle);
+#endif
+
+  Status = FTC_SetDeviceIOThread(ftHandle, bIOThreadEnabled);
+
+  LeaveCriticalSection(&threadAccess);
+
+  return Status;
+}
+
+FTC_STATUS FT2232hMpsseJtag::JTAG_GetDeviceIOThread(FTC_HANDLE ftHandle, LPBOOL lpbIOThreadEnabled)
+{
+  FTC_STATUS Status = FTC_SUCCESS;
+
+  EnterCriticalSection(&threadAccess);
+
+  Status = FTC_GetDeviceIOThread(ftHandle, lpbIOThreadEnabled);
+
+  LeaveCriticalSection(&threadAccess);
+
+  return Status;
+}
+
+FTC_STATUS FT2232hMpsseJtag::JTAG_GetHiSpeedDeviceType(FTC_HANDLE ftHandle, LPDWORD lpdwHiSpeedDeviceType)
+{
+  FTC_STATUS Status = FTC_SUCCESS;
+  BOOL bHiSpeedFT2232HTDeviceType = FALSE;
+
+  EnterCriticalSection(&threadAccess);
+
+  *lpdwHiSpeedDeviceType = 0;
+
+  Status = FTC_GetHiSpeedDeviceType(ftHandle, &bHiSpeedFT2232HTDeviceType);
+
+  if (Status == FTC_SUCCESS)
+  {
+    // Is the device a FT2232H hi-speed device
+    if (bHiSpeedFT2232HTDeviceType == TRUE)
+      *lpdwHiSpeedDeviceType = FT2232H_DEVICE_TYPE;
+    else
+      *lpdwHiSpeedDeviceType = FT4232H_DEVICE_TYPE;
+  }
+
+  LeaveCriticalSection(&threadAccess);
+
+  return Status;
+}
+
+
+FTC_STATUS FT2232hMpsseJtag::JTAG_CloseDevice(FTC_HANDLE ftHandle)
+{
+  FTC_STATUS Status = FTC_SUCCESS;
+
+  EnterCriticalSection(&threadAccess);
+
+#ifndef _WIN32
+  WaitForCompletionWatcher(ftHandle);
+#endif
+
+  if ((Status = FTC_CloseDevice(ftHandle)) == FTC_SUCCESS)
+  {
+    DeleteDeviceCommandsSequenceDataBuffers(ftHandle);
+
+    DeleteDeviceScanTemplates(ftHandle);
+  }
+
+  LeaveCriticalSection(&threadAccess);
+
+  return Status;
+}
+
+FTC_STATUS WINAPI FT2232hMpsseJtag::JTAG_CloseDevice(FTC_HANDLE ftHandle, PFTC_CLOSE_FINAL_STATE_PINS pCloseFinalStatePinsData)
+{
+  FTC_STATUS Status = FTC_SUCCESS;
+
+  EnterCriticalSection(&threadAccess);
+
+  if ((Status = FTC_IsDeviceHandleValid(ftHandle)) == FTC_SUCCESS)
+  {
+    if (pCloseFinalStatePinsData != NULL)
+    {
+      if ((Status = SetTCKTDITMSPinsCloseState(ftHandle, pCloseFinalStatePinsData)) == FTC_SUCCESS)
+        Status = JTAG_CloseDevice(ftHandle);
+    }
+    else
+      Status = FTC_NULL_CLOSE_FINAL_STATE_BUFFER_POINTER;
+  }
+
+  LeaveCriticalSection(&threadAccess);
+
+  return Status;
+}
+
+FTC_STATUS FT2232hMpsseJtag::JTAG_InitDevice(FTC_HANDLE ftHandle, DWORD dwClockDivisor)
+{
+  FTC_STATUS Status = FTC_SUCCESS;
+
+  EnterCriticalSection(&threadAccess);
+
+  if ((Status = FTC_IsHiSpeedDeviceHandleValid(ftHandle)) == FTC_SUCCESS)
+  {
+    if ((Status = FTC_InitHiSpeedDevice(ftHandle)) == FTC_SUCCESS)
+    {
+      Status = InitDevice(ftHandle, dwClockDivisor);
+    }
+  }
+
+  if (Status == FTC_INVALID_HANDLE)
+  {
+    if ((Status = FT2232c::FTC_IsDeviceHandleValid(ftHandle)) == FTC_SUCCESS)
+    {
+      Status = InitDevice(ftHandle, dwClockDivisor);
+    }
+  }
+
+  LeaveCriticalSection(&threadAccess);
+
+  return Status;
+}
+
+FTC_STATUS FT2232hMpsseJtag::JTAG_TurnOnDivideByFiveClockingHiSpeedDevice(FTC_HANDLE ftHandle)
+{
+  FTC_STATUS Status = FTC_SUCCESS;
+
+  EnterCriticalSection(&threadAccess);
+
+  Status = FTC_TurnOnDivideByFiveClockingHiSpeedDevice(ftHandle);
+
+  LeaveCriticalSection(&threadAccess);
+
+  return Status;
+}
+
+FTC_STATUS FT2232hMpsseJtag::JTAG_TurnOffDivideByFiveClockingHiSpeedDevice(FTC_HANDLE ftHandle)
+{
+  FTC_STATUS Status = FTC_SUCCESS;
+
+  EnterCriticalSection(&threadAccess);
+
+  Status = FTC_TurnOffDivideByFiveClockingHiSpeedDevice(ftHandle);
+
+  LeaveCriticalSection(&threadAccess);
+
+  return Status;
+}
+
+FTC_STATUS FT2232hMpsseJtag::JTAG_TurnOnAdaptiveClockingHiSpeedDevice(FTC_HANDLE ftHandle)
+{
+  FTC_STATUS Status = FTC_SUCCESS;
+
+  EnterCriticalSection(&threadAccess);
+
+  Status = FTC_TurnOnAdaptiveClockingHiSpeedDevice(ftHandle);
+
+  LeaveCriticalSection(&threadAccess);
+
+  return Status;
+}
+
+FTC_STATUS FT2232hMpsseJtag::JTAG_TurnOffAdaptiveClockingHiSpeedDevice(FTC_HANDLE ftHandle)
+{
+  FTC_STATUS Status = FTC_SUCCESS;
+
+  EnterCriticalSection(&threadAccess);
+
+  Status = FTC_TurnOffAdaptiveClockingHiSpeedDevice(ftHandle);
+
+  LeaveCriticalSection(&threadAccess);
+
+  return Status;
+}
+
+FTC_STATUS FT2232hMpsseJtag::JTAG_SetDeviceLatencyTimer(FTC_HANDLE ftHandle, BYTE LatencyTimermSec)
+{
+  FTC_STATUS Status = FTC_SUCCESS;
+
+  EnterCriticalSection(&threadAccess);
+
+  Status = FTC_SetDeviceLatencyTimer(ftHandle, LatencyTimermSec);
+
+  LeaveCriticalSection(&threadAccess);
+
+  return Status;
+}
+
+FTC_STATUS FT2232hMpsseJtag::JTAG_GetDeviceLatencyTimer(FTC_HANDLE ftHandle, LPBYTE lpLatencyTimermSec)
+{
+  FTC_STATUS Status = FTC_SUCCESS;
+
+  EnterCriticalSection(&threadAccess);
+
+  Status = FTC_GetDeviceLatencyTimer(ftHandle, lpLatencyTimermSec);
+
+  LeaveCriticalSection(&threadAccess);
+
+  return Status;
+}
+
+FTC_STATUS FT2232hMpsseJtag::JTAG_GetClock(DWORD dwClockDivisor, LPDWORD lpdwClockFrequencyHz)
+{
+  FTC_STATUS Status = FTC_SUCCESS;
+
+  EnterCriticalSection(&threadAccess);
+
+  if ((dwClockDivisor >= MIN_CLOCK_DIVISOR) && (dwClockDivisor <= MAX_CLOCK_DIVISOR))
+    FTC_GetClockFrequencyValues(dwClockDivisor, lpdwClockFrequencyHz);
+  else
+    Status = FTC_INVALID_CLOCK_DIVISOR;
+
+  LeaveCriticalSection(&threadAccess);
+
+  return Status;
+}
 
-  if (pWriteDataBuffer != NULL)
+FTC_STATUS FT2232hMpsseJtag::JTAG_GetHiSpeedDeviceClock(DWORD dwClockDivisor, LPDWORD lpdwClockFrequencyHz)
+{
+  FTC_STATUS Status = FTC_SUCCESS;
+
+  EnterCriticalSection(&threadAccess);
+
+  if ((dwClockDivisor >= MIN_CLOCK_DIVISOR) && (dwClockDivisor <= MAX_CLOCK_DIVISOR))
+    FTC_GetHiSpeedDeviceClockFrequencyValues(dwClockDivisor, lpdwClockFrequencyHz);
+  else
+    Status = FTC_INVALID_CLOCK_DIVISOR;
+
+  LeaveCriticalSection(&threadAccess);
+
+  return Status;
+}
+
+FTC_STATUS FT2232hMpsseJtag::JTAG_SetClock(FTC_HANDLE ftHandle, DWORD dwClockDivisor, LPDWORD lpdwClockFrequencyHz)
+{
+  FTC_STATUS Status = FTC_SUCCESS;
+
+  EnterCriticalSection(&threadAccess);
+
+  if ((dwClockDivisor >= MIN_CLOCK_DIVISOR) && (dwClockDivisor <= MAX_CLOCK_DIVISOR))
   {
-    Status = CheckWriteDataToExternalDeviceBitsBytesParameters(dwNumBitsToWrite, dwNumBytesToWrite);
+    if ((Status = FTC_IsHiSpeedDeviceHandleValid(ftHandle)) == FTC_SUCCESS)
+    {
+      FTC_GetHiSpeedDeviceClockFrequencyValues(ftHandle, dwClockDivisor, lpdwClockFrequencyHz);
+    }
+
+    if (Status == FTC_INVALID_HANDLE)
+    {
+      if ((Status = FT2232c::FTC_IsDeviceHandleValid(ftHandle)) == FTC_SUCCESS)
+      {
+        FTC_GetClockFrequencyValues(dwClockDivisor, lpdwClockFrequencyHz);
+      }
+    }
 
     if (Status == FTC_SUCCESS)
     {
-      if ((dwTapControllerState >= TEST_LOGIC_STATE) && (dwTapControllerState <= SHIFT_INSTRUCTION_REGISTER_STATE))
+      Status = SetDataInOutClockFrequency(ftHandle, dwClockDivisor);
+    }
+  }
+  else
+    Status = FTC_INVALID_CLOCK_DIVISOR;
+
+  LeaveCriticalSection(&threadAccess);
+
+  return Status;
+}
+
+FTC_STATUS FT2232hMpsseJtag::JTAG_SetDeviceLoopbackState(FTC_HANDLE ftHandle, BOOL bLoopbackState)
+{
+  FTC_STATUS Status = FTC_SUCCESS;
+
+  EnterCriticalSection(&threadAccess);
+
+  if ((Status = FTC_IsDeviceHandleValid(ftHandle)) == FTC_SUCCESS) {
+    Status = FTC_SetDeviceLoopbackState(ftHandle, bLoopbackState);
+  }
+
+  LeaveCriticalSection(&threadAccess);
+
+  return Status;
+}
+
+FTC_STATUS FT2232hMpsseJtag::JTAG_SetGeneralPurposeInputOutputPins(FTC_HANDLE ftHandle, BOOL bControlLowInputOutputPins,
+                                                                   PFTC_INPUT_OUTPUT_PINS pLowInputOutputPinsData,
+                                                                   BOOL bControlHighInputOutputPins,
+                                                                   PFTC_INPUT_OUTPUT_PINS pHighInputOutputPinsData)
+{
+  FTC_STATUS Status = FTC_SUCCESS;
+
+  EnterCriticalSection(&threadAccess);
+
+  Status = FTC_IsDeviceHandleValid(ftHandle);
+
+  if (Status == FTC_SUCCESS)
+  {
+    if ((pLowInputOutputPinsData != NULL) && (pHighInputOutputPinsData != NULL))
+      Status = SetGeneralPurposeInputOutputPins(ftHandle, bControlLowInputOutputPins,
+                                                pLowInputOutputPinsData,
+                                                bControlHighInputOutputPins,
+                                                pHighInputOutputPinsData);
+    else
+      Status = FTC_NULL_INPUT_OUTPUT_BUFFER_POINTER;
+  }
+
+  LeaveCriticalSection(&threadAccess);
+
+  return Status;
+}
+
+FTC_STATUS FT2232hMpsseJtag::JTAG_SetHiSpeedDeviceGeneralPurposeInputOutputPins(FTC_HANDLE ftHandle, BOOL bControlLowInputOutputPins,
+                                                                                PFTC_INPUT_OUTPUT_PINS pLowInputOutputPinsData,
+                                                                                BOOL bControlHighInputOutputPins,
+                                                                                PFTH_INPUT_OUTPUT_PINS pHighInputOutputPinsData)
+{
+  FTC_STATUS Status = FTC_SUCCESS;
+
+  EnterCriticalSection(&threadAccess);
+
+  if ((Status = FTC_IsHiSpeedDeviceHandleValid(ftHandle)) == FTC_SUCCESS)
+  {
+    if ((pLowInputOutputPinsData != NULL) && (pHighInputOutputPinsData != NULL))
+      Status = SetHiSpeedDeviceGeneralPurposeInputOutputPins(ftHandle, bControlLowInputOutputPins,
+                                                             pLowInputOutputPinsData,
+                                                             bControlHighInputOutputPins,
+                                                             pHighInputOutputPinsData);
+    else
+      Status = FTC_NULL_INPUT_OUTPUT_BUFFER_POINTER;
+  }
+
+  LeaveCriticalSection(&threadAccess);
+
+  return Status;
+}
+
+FTC_STATUS FT2232hMpsseJtag::JTAG_GetGeneralPurposeInputOutputPins(FTC_HANDLE ftHandle, BOOL bControlLowInputOutputPins,
+                                                                   PFTC_LOW_HIGH_PINS pLowPinsInputData,
+                                                                   BOOL bControlHighInputOutputPins,
+                                                                   PFTC_LOW_HIGH_PINS pHighPinsInputData)
+{
+  FTC_STATUS Status = FTC_SUCCESS;
+
+  EnterCriticalSection(&threadAccess);
+
+  Status = FTC_IsDeviceHandleValid(ftHandle);
+
+  if (Status == FTC_SUCCESS)
+    Status = CheckCommandSequenceNotSubmitted(ftHandle);
+
+  if (Status == FTC_SUCCESS)
+  {
+    if ((pLowPinsInputData != NULL) && (pHighPinsInputData != NULL))
+      Status = GetGeneralPurposeInputOutputPins(ftHandle, bControlLowInputOutputPins, pLowPinsInputData,
+                                                bControlHighInputOutputPins, pHighPinsInputData);
+    else
+      Status = FTC_NULL_INPUT_OUTPUT_BUFFER_POINTER;
+  }
+
+  LeaveCriticalSection(&threadAccess);
+
+  return Status;
+}
+
+FTC_STATUS FT2232hMpsseJtag::JTAG_GetHiSpeedDeviceGeneralPurposeInputOutputPins(FTC_HANDLE ftHandle, BOOL bControlLowInputOutputPins,
+                                                                                PFTC_LOW_HIGH_PINS pLowPinsInputData,
+                                                                                BOOL bControlHighInputOutputPins,
+                                                                                PFTH_LOW_HIGH_PINS pHighPinsInputData)
+{
+  FTC_STATUS Status = FTC_SUCCESS;
+
+  EnterCriticalSection(&threadAccess);
+
+  if ((Status = FTC_IsHiSpeedDeviceHandleValid(ftHandle)) == FTC_SUCCESS)
+    Status = CheckCommandSequenceNotSubmitted(ftHandle);
+
+  if (Status == FTC_SUCCESS)
+  {
+    if ((pLowPinsInputData != NULL) && (pHighPinsInputData != NULL))
+      Status = GetHiSpeedDeviceGeneralPurposeInputOutputPins(ftHandle, bControlLowInputOutputPins, pLowPinsInputData,
+                                                             bControlHighInputOutputPins, pHighPinsInputData);
+    else
+      Status = FTC_NULL_INPUT_OUTPUT_BUFFER_POINTER;
+  }
+
+  LeaveCriticalSection(&threadAccess);
+
+  return Status;
+}
+
+FTC_STATUS FT2232hMpsseJtag::JTAG_WriteDataToExternalDevice(FTC_HANDLE ftHandle, BOOL bInstructionTestData, DWORD dwNumBitsToWrite,
+                                                            PWriteDataByteBuffer pWriteDataBuffer, DWORD dwNumBytesToWrite,
+                                                            DWORD dwTapControllerState, DWORD dwNumIdleCycles)
+{
+  FTC_STATUS Status = FTC_SUCCESS;
+
+  EnterCriticalSection(&threadAccess);
+
+  Status = FTC_IsDeviceHandleValid(ftHandle);
+
+  if (Status == FTC_SUCCESS)
+    Status = CheckCommandSequenceNotSubmitted(ftHandle);
+
+  if (Status == FTC_SUCCESS)
+  {
+    if (pWriteDataBuffer != NULL)
+    {
+      Status = CheckWriteDataToExternalDeviceBitsBytesParameters(dwNumBitsToWrite, dwNumBytesToWrite);
+
+      if (Status == FTC_SUCCESS)
       {
-        dwNumCommandDataBytes = (NUM_WRITE_COMMAND_BYTES + dwNumBytesToWrite);
+        if ((dwTapControllerState >= TEST_LOGIC_STATE) && (dwTapControllerState <= UPDATE_INSTRUCTION_REGISTER_STATE))
+          Status = CheckIdleCyclesParameters(dwNumIdleCycles, dwTapControllerState);
+        else
+          Status = FTC_INVALID_TAP_CONTROLLER_STATE;
 
-        iCommandsSequenceDataDeviceIndex = GetCommandsSequenceDataDeviceIndex(ftHandle);
+        if (Status == FTC_SUCCESS)
+          Status = WriteDataToExternalDevice(ftHandle, bInstructionTestData, dwNumBitsToWrite, pWriteDataBuffer,
+                                             dwNumBytesToWrite, dwTapControllerState, dwNumIdleCycles);
+      }
+    }
+    else
+      Status = FTC_NULL_WRITE_DATA_BUFFER_POINTER;
+  }
 
-        if ((GetNumBytesInCommandsSequenceDataBuffer() + dwNumCommandDataBytes) < OUTPUT_BUFFER_SIZE)
-          AddWriteCommandDataToOutPutBuffer(bInstructionTestData, dwNumBitsToWrite, pWriteDataBuffer,
-                                            dwNumBytesToWrite, dwTapControllerState);
+  LeaveCriticalSection(&threadAccess);
+
+  return Status;
+}
+
+FTC_STATUS FT2232hMpsseJtag::JTAG_ReadDataFromExternalDevice(FTC_HANDLE ftHandle, BOOL bInstructionTestData, DWORD dwNumBitsToRead,
+                                                             PReadDataByteBuffer pReadDataBuffer, LPDWORD lpdwNumBytesReturned,
+                                                             DWORD dwTapControllerState, DWORD dwNumIdleCycles)
+{
+  FTC_STATUS Status = FTC_SUCCESS;
+
+  EnterCriticalSection(&threadAccess);
+
+  Status = FTC_IsDeviceHandleValid(ftHandle);
+
+  if (Status == FTC_SUCCESS)
+    Status = CheckCommandSequenceNotSubmitted(ftHandle);
+
+  if (Status == FTC_SUCCESS)
+  {
+    if (pReadDataBuffer != NULL)
+    {
+      if ((dwNumBitsToRead >= MIN_NUM_BITS) && (dwNumBitsToRead <= MAX_NUM_BITS))
+      {
+        if ((dwTapControllerState >= TEST_LOGIC_STATE) && (dwTapControllerState <= UPDATE_INSTRUCTION_REGISTER_STATE))
+          Status = CheckIdleCyclesParameters(dwNumIdleCycles, dwTapControllerState);
+        else
+          Status = FTC_INVALID_TAP_CONTROLLER_STATE;
+
+        if (Status == FTC_SUCCESS)
+          Status = ReadDataFromExternalDevice(ftHandle, bInstructionTestData, dwNumBitsToRead, pReadDataBuffer,
+                                              lpdwNumBytesReturned, dwTapControllerState, dwNumIdleCycles);
+      }
+      else
+        Status = FTC_INVALID_NUMBER_BITS;
+    }
+    else
+      Status = FTC_NULL_READ_DATA_BUFFER_POINTER;
+  }
+
+  LeaveCriticalSection(&threadAccess);
+
+  return Status;
+}
+
+FTC_STATUS FT2232hMpsseJtag::JTAG_WriteReadDataToFromExternalDevice(FTC_HANDLE ftHandle, BOOL bInstructionTestData, DWORD dwNumBitsToWriteRead,
+                                                                    PWriteDataByteBuffer pWriteDataBuffer, DWORD dwNumBytesToWrite,
+                                                                    PReadDataByteBuffer pReadDataBuffer, LPDWORD lpdwNumBytesReturned,
+                                                                    DWORD dwTapControllerState, DWORD dwNumIdleCycles)
+{
+  FTC_STATUS Status = FTC_SUCCESS;
+
+  EnterCriticalSection(&threadAccess);
+
+  Status = FTC_IsDeviceHandleValid(ftHandle);
+
+  if (Status == FTC_SUCCESS)
+    Status = CheckCommandSequenceNotSubmitted(ftHandle);
+
+  if (Status == FTC_SUCCESS)
+  {
+    if ((pWriteDataBuffer != NULL) && (pReadDataBuffer != NULL))
+    {
+      Status = CheckWriteDataToExternalDeviceBitsBytesParameters(dwNumBitsToWriteRead, dwNumBytesToWrite);
+
+      if (Status == FTC_SUCCESS)
+      {
+        if ((dwTapControllerState >= TEST_LOGIC_STATE) && (dwTapControllerState <= UPDATE_INSTRUCTION_REGISTER_STATE))
+          Status = CheckIdleCyclesParameters(dwNumIdleCycles, dwTapControllerState);
         else
-          Status = FTC_COMMAND_SEQUENCE_BUFFER_FULL;
+          Status = FTC_INVALID_TAP_CONTROLLER_STATE;
 
-        // Reset to indicate that you are not building up a sequence of commands
-        iCommandsSequenceDataDeviceIndex = -1;
+        if (Status == FTC_SUCCESS)
+          Status = WriteReadDataToFromExternalDevice(ftHandle, bInstructionTestData, dwNumBitsToWriteRead,
+                                                     pWriteDataBuffer, dwNumBytesToWrite, pReadDataBuffer,
+                                                     lpdwNumBytesReturned, dwTapControllerState, dwNumIdleCycles);
       }
+    }
+    else
+    {
+      if (pWriteDataBuffer == NULL)
+        Status = FTC_NULL_WRITE_DATA_BUFFER_POINTER;
       else
-        Status = FTC_INVALID_TAP_CONTROLLER_STATE;
+        Status = FTC_NULL_READ_DATA_BUFFER_POINTER;
     }
   }
-  else
-    Status = FTC_NULL_WRITE_DATA_BUFFER_POINTER;
+
+  LeaveCriticalSection(&threadAccess);
 
   return Status;
 }
 
-FTC_STATUS FT2232hMpsseJtag::AddDeviceReadCommand(FTC_HANDLE ftHandle, BOOL bInstructionTestData, DWORD dwNumBitsToRead, DWORD dwTapControllerState)
+FTC_STATUS FT2232hMpsseJtag::JTAG_WriteReadCompare(FTC_HANDLE ftHandle, BOOL bInstructionTestData, DWORD dwNumBitsToWriteRead,
+                                                   PWriteDataByteBuffer pWriteDataBuffer, DWORD dwNumBytesToWrite,
+                                                   PWriteDataByteBuffer pExpectedDataBuffer, PWriteDataByteBuffer pMaskDataBuffer,
+                                                   LPDWORD lpdwMismatchBitOffset, DWORD dwTapControllerState)
 {
   FTC_STATUS Status = FTC_SUCCESS;
-  DWORD dwNumTmsClocks = 0;
 
-  if ((dwNumBitsToRead >= MIN_NUM_BITS) && (dwNumBitsToRead <= MAX_NUM_BITS))
+  EnterCriticalSection(&threadAccess);
+
+  Status = FTC_IsDeviceHandleValid(ftHandle);
+
+  if (Status == FTC_SUCCESS)
+    Status = CheckCommandSequenceNotSubmitted(ftHandle);
+
+  if (Status == FTC_SUCCESS)
   {
-    if ((dwTapControllerState >= TEST_LOGIC_STATE) && (dwTapControllerState <= SHIFT_INSTRUCTION_REGISTER_STATE))
+    if ((pWriteDataBuffer != NULL) && (pExpectedDataBuffer != NULL))
     {
-      iCommandsSequenceDataDeviceIndex = GetCommandsSequenceDataDeviceIndex(ftHandle);
+      Status = CheckWriteDataToExternalDeviceBitsBytesParameters(dwNumBitsToWriteRead, dwNumBytesToWrite);
 
-      if ((GetNumBytesInCommandsSequenceDataBuffer() + NUM_READ_COMMAND_BYTES) < OUTPUT_BUFFER_SIZE)
+      if (Status == FTC_SUCCESS)
       {
-        dwNumTmsClocks = AddReadCommandToOutputBuffer(bInstructionTestData, dwNumBitsToRead, dwTapControllerState);
-
-        Status = AddReadCommandSequenceData(dwNumBitsToRead, dwNumTmsClocks);
+        if ((dwTapControllerState >= TEST_LOGIC_STATE) && (dwTapControllerState <= UPDATE_INSTRUCTION_REGISTER_STATE))
+          Status = WriteReadCompareDataToFromExternalDevice(ftHandle, bInstructionTestData, dwNumBitsToWriteRead,
+                                                            pWriteDataBuffer, pExpectedDataBuffer, pMaskDataBuffer,
+                                                            lpdwMismatchBitOffset, dwTapControllerState);
+        else
+          Status = FTC_INVALID_TAP_CONTROLLER_STATE;
       }
-      else
-        Status = FTC_COMMAND_SEQUENCE_BUFFER_FULL;
-
-      // Reset to indicate that you are not building up a sequence of commands
-      iCommandsSequenceDataDeviceIndex = -1;
     }
     else
-      Status = FTC_INVALID_TAP_CONTROLLER_STATE;
+    {
+      if (pWriteDataBuffer == NULL)
+        Status = FTC_NULL_WRITE_DATA_BUFFER_POINTER;
+      else
+        Status = FTC_NULL_EXPECTED_DATA_BUFFER_POINTER;
+    }
   }
-  else
-    Status = FTC_INVALID_NUMBER_BITS;
+
+  LeaveCriticalSection(&threadAccess);
 
   return Status;
 }
 
-FTC_STATUS FT2232hMpsseJtag::AddDeviceWriteReadCommand(FTC_HANDLE ftHandle, BOOL bInstructionTestData, DWORD dwNumBitsToWriteRead,
-                                                       PWriteDataByteBuffer pWriteDataBuffer, DWORD dwNumBytesToWrite,
-                                                       DWORD dwTapControllerState)
+FTC_STATUS FT2232hMpsseJtag::JTAG_StreamScan(FTC_HANDLE ftHandle, BOOL bInstructionTestData, ULONGLONG ulNumBitsToScan,
+                                             PFTC_SCAN_DATA_SOURCE pDataSource, PFTC_SCAN_DATA_SINK pDataSink,
+                                             LPVOID pContext, DWORD dwTapControllerState)
 {
   FTC_STATUS Status = FTC_SUCCESS;
-  DWORD dwNumCommandDataBytes = 0;
-  DWORD dwNumTmsClocks = 0;
 
-  if (pWriteDataBuffer != NULL)
-  {
-    Status = CheckWriteDataToExternalDeviceBitsBytesParameters(dwNumBitsToWriteRead, dwNumBytesToWrite);
+  EnterCriticalSection(&threadAccess);
 
-    if (Status == FTC_SUCCESS)
-    {
-      if ((dwTapControllerState >= TEST_LOGIC_STATE) && (dwTapControllerState <= SHIFT_INSTRUCTION_REGISTER_STATE))
-      {
-        dwNumCommandDataBytes = (NUM_WRITE_READ_COMMAND_BYTES + dwNumBytesToWrite);
+  Status = FTC_IsDeviceHandleValid(ftHandle);
 
-        iCommandsSequenceDataDeviceIndex = GetCommandsSequenceDataDeviceIndex(ftHandle);
+  if (Status == FTC_SUCCESS)
+    Status = CheckCommandSequenceNotSubmitted(ftHandle);
 
-        if ((GetNumBytesInCommandsSequenceDataBuffer() + dwNumCommandDataBytes) < OUTPUT_BUFFER_SIZE)
-        {
-          dwNumTmsClocks = AddWriteReadCommandDataToOutPutBuffer(bInstructionTestData, dwNumBitsToWriteRead, pWriteDataBuffer,
-                                                                   dwNumBytesToWrite, dwTapControllerState);
- 
-          Status = AddReadCommandSequenceData(dwNumBitsToWriteRead, dwNumTmsClocks);
-        }
+  if (Status == FTC_SUCCESS)
+  {
+    if ((pDataSource != NULL) || (pDataSink != NULL))
+    {
+      if (ulNumBitsToScan >= MIN_NUM_BITS)
+      {
+        if ((dwTapControllerState >= TEST_LOGIC_STATE) && (dwTapControllerState <= UPDATE_INSTRUCTION_REGISTER_STATE))
+          Status = StreamScanDataToFromExternalDevice(ftHandle, bInstructionTestData, ulNumBitsToScan, pDataSource,
+                                                      pDataSink, pContext, dwTapControllerState);
         else
-          Status = FTC_COMMAND_SEQUENCE_BUFFER_FULL;
-
-        // Reset to indicate that you are not building up a sequence of commands
-        iCommandsSequenceDataDeviceIndex = -1;
+          Status = FTC_INVALID_TAP_CONTROLLER_STATE;
       }
       else
-        Status = FTC_INVALID_TAP_CONTROLLER_STATE;
+        Status = FTC_INVALID_NUMBER_BITS;
     }
+    else
+      Status = FTC_NULL_WRITE_DATA_BUFFER_POINTER;
   }
-  else
-    Status = FTC_NULL_WRITE_DATA_BUFFER_POINTER;
+
+  LeaveCriticalSection(&threadAccess);
 
   return Status;
 }
 
-FT2232hMpsseJtag::FT2232hMpsseJtag(void)
+FTC_STATUS FT2232hMpsseJtag::JTAG_GenerateTCKClockPulses(FTC_HANDLE ftHandle, DWORD dwNumClockPulses)
 {
-  DWORD dwDeviceIndex = 0;
-
-  CurrentJtagState = Undefined;
-
-  dwSavedLowPinsDirection = 0;
-  dwSavedLowPinsValue = 0;
-
-  dwNumOpenedDevices = 0;
-
-  for (dwDeviceIndex = 0; (dwDeviceIndex < MAX_NUM_DEVICES); dwDeviceIndex++)
-    OpenedDevicesCommandsSequenceData[dwDeviceIndex].hDevice = 0;
-
-  iCommandsSequenceDataDeviceIndex = -1;
+  FTC_STATUS Status = FTC_SUCCESS;
 
-  InitializeCriticalSection(&threadAccess);
-}
+  EnterCriticalSection(&threadAccess);
 
-FT2232hMpsseJtag::~FT2232hMpsseJtag(void)
-{
-  DWORD dwDeviceIndex = 0;
-  POutputByteBuffer pCmdsSequenceDataOutPutBuffer;
+  if ((Status = FTC_IsDeviceHandleValid(ftHandle)) == FTC_SUCCESS)
+    Status = CheckCommandSequenceNotSubmitted(ftHandle);
 
-  if (dwNumOpenedDevices > 0)
+  if (Status == FTC_SUCCESS)
   {
-    for (dwDeviceIndex = 0; (dwDeviceIndex < MAX_NUM_DEVICES); dwDeviceIndex++)
+    if ((dwNumClockPulses >= MIN_NUM_CLOCK_PULSES) && (dwNumClockPulses <= MAX_NUM_CLOCK_PULSES))
     {
-      if (OpenedDevicesCommandsSequenceData[dwDeviceIndex].hDevice != 0)
-      {
-        OpenedDevicesCommandsSequenceData[dwDeviceIndex].hDevice = 0;
-
-        pCmdsSequenceDataOutPutBuffer = OpenedDevicesCommandsSequenceData[dwDeviceIndex].pCommandsSequenceDataOutPutBuffer;
-
-        if (pCmdsSequenceDataOutPutBuffer != NULL)
-          delete [] pCmdsSequenceDataOutPutBuffer;
-
-        OpenedDevicesCommandsSequenceData[dwDeviceIndex].pCommandsSequenceDataOutPutBuffer = NULL;
-
-        if (OpenedDevicesCommandsSequenceData[dwDeviceIndex].pReadCommandsSequenceDataBuffer != NULL)
-          DeleteReadCommandsSequenceDataBuffer(OpenedDevicesCommandsSequenceData[dwDeviceIndex].pReadCommandsSequenceDataBuffer,
-                                               OpenedDevicesCommandsSequenceData[dwDeviceIndex].dwSizeReadCommandsSequenceDataBuffer);
+      // The clock is pulsed in the run test idle state, the move there may reset the instruction register
+      if (!IsInstructionRegisterKept(CurrentJtagState, RunTestIdle))
+        InvalidateInstructionRegisterCache(ftHandle);
 
-        OpenedDevicesCommandsSequenceData[dwDeviceIndex].pReadCommandsSequenceDataBuffer = NULL;
-      }
+      // Only FT2232D dual devices have to clock data bytes out to pulse the clock
+      if (FTC_IsHiSpeedDeviceHandleValid(ftHandle) == FTC_SUCCESS)
+        Status = GenerateTCKClockOnlyPulses(ftHandle, dwNumClockPulses);
+      else
+        Status = GenerateTCKClockPulses(ftHandle, dwNumClockPulses);
     }
+    else
+      Status = FTC_INVALID_NUMBER_CLOCK_PULSES;
   }
 
-  DeleteCriticalSection(&threadAccess);
+  LeaveCriticalSection(&threadAccess);
+
+  return Status;
 }
 
-FTC_STATUS FT2232hMpsseJtag::JTAG_GetNumDevices(LPDWORD lpdwNumDevices)
+FTC_STATUS FT2232hMpsseJtag::JTAG_GenerateClockPulsesHiSpeedDevice(FTC_HANDLE ftHandle, BOOL bPulseClockTimesEightFactor, DWORD dwNumClockPulses, BOOL bControlLowInputOutputPin, BOOL bStopClockPulsesState)
 {
   FTC_STATUS Status = FTC_SUCCESS;
-  FT2232CDeviceIndexes FT2232CIndexes;
 
   EnterCriticalSection(&threadAccess);
 
-  *lpdwNumDevices = 0;
+  if ((Status = FTC_IsHiSpeedDeviceHandleValid(ftHandle)) == FTC_SUCCESS)
+    Status = CheckCommandSequenceNotSubmitted(ftHandle);
 
-  Status = FTC_GetNumDevices(lpdwNumDevices, &FT2232CIndexes);
+  if (Status == FTC_SUCCESS)
+  {
+    if (bPulseClockTimesEightFactor)
+    {
+      if ((dwNumClockPulses < MIN_NUM_CLOCK_PULSES) || (dwNumClockPulses > MAX_NUM_TIMES_EIGHT_CLOCK_PULSES))
+        Status = FTC_INVALID_NUMBER_TIMES_EIGHT_CLOCK_PULSES;
+    }
+    else
+    {
+      if ((dwNumClockPulses < MIN_NUM_CLOCK_PULSES) || (dwNumClockPulses > MAX_NUM_SINGLE_CLOCK_PULSES))
+        Status = FTC_INVALID_NUMBER_SINGLE_CLOCK_PULSES;
+    }
+  }
+
+  if (Status == FTC_SUCCESS)
+  {
+    Status = GenerateClockPulsesHiSpeedDevice(ftHandle, bPulseClockTimesEightFactor, dwNumClockPulses, bControlLowInputOutputPin, bStopClockPulsesState);
+  }
 
   LeaveCriticalSection(&threadAccess);
 
   return Status;
 }
 
-FTC_STATUS FT2232hMpsseJtag::JTAG_GetNumHiSpeedDevices(LPDWORD lpdwNumHiSpeedDevices)
+
+FTC_STATUS FT2232hMpsseJtag::JTAG_ClearCommandSequence(void)
 {
   FTC_STATUS Status = FTC_SUCCESS;
-  HiSpeedDeviceIndexes HiSpeedIndexes;
+  DWORD dwNumDevices;
+  FT2232CDeviceIndexes FT2232CIndexes;
 
   EnterCriticalSection(&threadAccess);
 
-  *lpdwNumHiSpeedDevices = 0;
+  Status = FTC_GetNumDevices(&dwNumDevices, &FT2232CIndexes);
 
-  Status = FTC_GetNumHiSpeedDevices(lpdwNumHiSpeedDevices, &HiSpeedIndexes);
+  if (Status == FTC_SUCCESS)
+  {
+    if (dwNumDevices == 1)
+      ClearDeviceCommandSequenceData(0);
+    else
+      Status = FTC_TOO_MANY_DEVICES;
+  }
 
   LeaveCriticalSection(&threadAccess);
 
   return Status;
 }
 
-FTC_STATUS FT2232hMpsseJtag::JTAG_GetDeviceNameLocationID(DWORD dwDeviceNameIndex, LPSTR lpDeviceNameBuffer, DWORD dwBufferSize, LPDWORD lpdwLocationID)
+FTC_STATUS FT2232hMpsseJtag::JTAG_AddWriteCommand(BOOL bInstructionTestData, DWORD dwNumBitsToWrite,
+                                                  PWriteDataByteBuffer pWriteDataBuffer, DWORD dwNumBytesToWrite,
+                                                  DWORD dwTapControllerState)
 {
   FTC_STATUS Status = FTC_SUCCESS;
+  DWORD dwNumCommandDataBytes = 0;
+  DWORD dwNumDevices;
+  FT2232CDeviceIndexes FT2232CIndexes;
 
   EnterCriticalSection(&threadAccess);
 
-  Status = FTC_GetDeviceNameLocationID(dwDeviceNameIndex, lpDeviceNameBuffer, dwBufferSize, lpdwLocationID);
+  Status = FTC_GetNumDevices(&dwNumDevices, &FT2232CIndexes);
+
+  if (Status == FTC_SUCCESS)
+  {
+    if (dwNumDevices == 1)
+      // ftHandle parameter set to 0 to indicate only one device present in the system
+      Status = AddDeviceWriteCommand(0, bInstructionTestData, dwNumBitsToWrite, pWriteDataBuffer, dwNumBytesToWrite, dwTapControllerState, 0);
+    else
+      Status = FTC_TOO_MANY_DEVICES;
+  }
 
   LeaveCriticalSection(&threadAccess);
 
   return Status;
 }
 
-FTC_STATUS FT2232hMpsseJtag::JTAG_GetHiSpeedDeviceNameLocationIDChannel(DWORD dwDeviceNameIndex, LPSTR lpDeviceNameBuffer, DWORD dwBufferSize, LPDWORD lpdwLocationID, LPSTR lpChannel, DWORD dwChannelBufferSize, LPDWORD lpdwHiSpeedDeviceType)
+FTC_STATUS FT2232hMpsseJtag::JTAG_AddReadCommand(BOOL bInstructionTestData, DWORD dwNumBitsToRead, DWORD dwTapControllerState)
 {
   FTC_STATUS Status = FTC_SUCCESS;
-  DWORD dwDeviceType = 0;
+  DWORD dwNumTmsClocks = 0;
+  DWORD dwNumDevices;
+  FT2232CDeviceIndexes FT2232CIndexes;
 
   EnterCriticalSection(&threadAccess);
 
-  *lpdwHiSpeedDeviceType = 0;
-
-  Status = FTC_GetHiSpeedDeviceNameLocationIDChannel(dwDeviceNameIndex, lpDeviceNameBuffer, dwBufferSize, lpdwLocationID, lpChannel, dwChannelBufferSize, &dwDeviceType);
+  Status = FTC_GetNumDevices(&dwNumDevices, &FT2232CIndexes);
 
   if (Status == FTC_SUCCESS)
   {
-    if ((dwDeviceType == FT_DEVICE_2232H) || (dwDeviceType == FT_DEVICE_4232H))
-    {
-      if (dwDeviceType == FT_DEVICE_2232H)
-        *lpdwHiSpeedDeviceType = FT2232H_DEVICE_TYPE;
-      else
-        *lpdwHiSpeedDeviceType = FT4232H_DEVICE_TYPE;
-    }
+    if (dwNumDevices == 1)
+      // ftHandle parameter set to 0 to indicate only one device present in the system
+      Status = AddDeviceReadCommand(0, bInstructionTestData, dwNumBitsToRead, dwTapControllerState, 0);
     else
-      Status = FTC_DEVICE_NOT_FOUND;
+      Status = FTC_TOO_MANY_DEVICES;
   }
 
   LeaveCriticalSection(&threadAccess);
@@ -1778,24 +4382,27 @@ FTC_STATUS FT2232hMpsseJtag::JTAG_GetHiSpeedDeviceNameLocationIDChannel(DWORD dw
   return Status;
 }
 
-FTC_STATUS FT2232hMpsseJtag::JTAG_OpenDevice(FTC_HANDLE *pftHandle)
+FTC_STATUS FT2232hMpsseJtag::JTAG_AddWriteReadCommand(BOOL bInstructionTestData, DWORD dwNumBitsToWriteRead,
+                                                      PWriteDataByteBuffer pWriteDataBuffer, DWORD dwNumBytesToWrite,
+                                                      DWORD dwTapControllerState)
 {
   FTC_STATUS Status = FTC_SUCCESS;
+  DWORD dwNumCommandDataBytes = 0;
+  DWORD dwNumTmsClocks = 0;
+  DWORD dwNumDevices;
+  FT2232CDeviceIndexes FT2232CIndexes;
 
   EnterCriticalSection(&threadAccess);
 
-  Status = FTC_OpenDevice(pftHandle);
+  Status = FTC_GetNumDevices(&dwNumDevices, &FT2232CIndexes);
 
   if (Status == FTC_SUCCESS)
   {
-    Status = CreateDeviceCommandsSequenceDataBuffers(*pftHandle);
-
-    if (Status != FTC_SUCCESS)
-    {
-      FTC_CloseDevice(*pftHandle);
-
-      *pftHandle = 0;
-    }
+    if (dwNumDevices == 1)
+      // ftHandle parameter set to 0 to indicate only one device present in the system
+      Status = AddDeviceWriteReadCommand(0, bInstructionTestData, dwNumBitsToWriteRead, pWriteDataBuffer, dwNumBytesToWrite, dwTapControllerState, 0);
+    else
+      Status = FTC_TOO_MANY_DEVICES;
   }
 
   LeaveCriticalSection(&threadAccess);
@@ -1803,308 +4410,424 @@ FTC_STATUS FT2232hMpsseJtag::JTAG_OpenDevice(FTC_HANDLE *pftHandle)
   return Status;
 }
 
-FTC_STATUS FT2232hMpsseJtag::JTAG_OpenSpecifiedDevice(LPSTR lpDeviceName, DWORD dwLocationID, FTC_HANDLE *pftHandle)
+FTC_STATUS FT2232hMpsseJtag::JTAG_ClearDeviceCommandSequence(FTC_HANDLE ftHandle)
 {
   FTC_STATUS Status = FTC_SUCCESS;
 
   EnterCriticalSection(&threadAccess);
 
-  Status = FTC_OpenSpecifiedDevice(lpDeviceName, dwLocationID, pftHandle);
+  Status = FTC_IsDeviceHandleValid(ftHandle);
 
   if (Status == FTC_SUCCESS)
-  {
-    Status = CreateDeviceCommandsSequenceDataBuffers(*pftHandle);
-
-    if (Status != FTC_SUCCESS)
-    {
-      FTC_CloseDevice(*pftHandle);
-
-      *pftHandle = 0;
-    }
-  }
+    ClearDeviceCommandSequenceData(ftHandle);
 
   LeaveCriticalSection(&threadAccess);
 
   return Status;
 }
 
-FTC_STATUS FT2232hMpsseJtag::JTAG_OpenSpecifiedHiSpeedDevice(LPSTR lpDeviceName, DWORD dwLocationID, LPSTR lpChannel, FTC_HANDLE *pftHandle)
+FTC_STATUS FT2232hMpsseJtag::JTAG_AddDeviceWriteCommand(FTC_HANDLE ftHandle, BOOL bInstructionTestData, DWORD dwNumBitsToWrite,
+                                                        PWriteDataByteBuffer pWriteDataBuffer, DWORD dwNumBytesToWrite,
+                                                        DWORD dwTapControllerState, DWORD dwNumIdleCycles)
 {
   FTC_STATUS Status = FTC_SUCCESS;
 
   EnterCriticalSection(&threadAccess);
 
-  Status = FTC_OpenSpecifiedHiSpeedDevice(lpDeviceName, dwLocationID, lpChannel, pftHandle);
-
-  if (Status == FTC_SUCCESS)
-  {
-    Status = CreateDeviceCommandsSequenceDataBuffers(*pftHandle);
-
-    if (Status != FTC_SUCCESS)
-    {
-      FTC_CloseDevice(*pftHandle);
+  Status = FTC_IsDeviceHandleValid(ftHandle);
 
-      *pftHandle = 0;
-    }
-  }
+  if (Status == FTC_SUCCESS)
+    Status = AddDeviceWriteCommand(ftHandle, bInstructionTestData, dwNumBitsToWrite, pWriteDataBuffer, dwNumBytesToWrite,
+                                   dwTapControllerState, dwNumIdleCycles);
 
   LeaveCriticalSection(&threadAccess);
 
   return Status;
 }
 
-FTC_STATUS FT2232hMpsseJtag::JTAG_GetHiSpeedDeviceType(FTC_HANDLE ftHandle, LPDWORD lpdwHiSpeedDeviceType)
+FTC_STATUS FT2232hMpsseJtag::JTAG_AddDeviceReadCommand(FTC_HANDLE ftHandle, BOOL bInstructionTestData, DWORD dwNumBitsToRead,
+                                                       DWORD dwTapControllerState, DWORD dwNumIdleCycles)
 {
   FTC_STATUS Status = FTC_SUCCESS;
-  BOOL bHiSpeedFT2232HTDeviceType = FALSE;
 
   EnterCriticalSection(&threadAccess);
 
-  *lpdwHiSpeedDeviceType = 0;
-
-  Status = FTC_GetHiSpeedDeviceType(ftHandle, &bHiSpeedFT2232HTDeviceType);
+  Status = FTC_IsDeviceHandleValid(ftHandle);
 
   if (Status == FTC_SUCCESS)
-  {
-    // Is the device a FT2232H hi-speed device
-    if (bHiSpeedFT2232HTDeviceType == TRUE)
-      *lpdwHiSpeedDeviceType = FT2232H_DEVICE_TYPE;
-    else
-      *lpdwHiSpeedDeviceType = FT4232H_DEVICE_TYPE;
-  }
+    Status = AddDeviceReadCommand(ftHandle, bInstructionTestData, dwNumBitsToRead, dwTapControllerState, dwNumIdleCycles);
 
   LeaveCriticalSection(&threadAccess);
 
   return Status;
 }
 
-
-FTC_STATUS FT2232hMpsseJtag::JTAG_CloseDevice(FTC_HANDLE ftHandle)
+FTC_STATUS FT2232hMpsseJtag::JTAG_AddDeviceWriteReadCommand(FTC_HANDLE ftHandle, BOOL bInstructionTestData, DWORD dwNumBitsToWriteRead,
+                                                            PWriteDataByteBuffer pWriteDataBuffer, DWORD dwNumBytesToWrite,
+                                                            DWORD dwTapControllerState, DWORD dwNumIdleCycles)
 {
   FTC_STATUS Status = FTC_SUCCESS;
 
   EnterCriticalSection(&threadAccess);
 
-  if ((Status = FTC_CloseDevice(ftHandle)) == FTC_SUCCESS)
-    DeleteDeviceCommandsSequenceDataBuffers(ftHandle);
+  Status = FTC_IsDeviceHandleValid(ftHandle);
+
+  if (Status == FTC_SUCCESS)
+    Status = AddDeviceWriteReadCommand(ftHandle, bInstructionTestData, dwNumBitsToWriteRead, pWriteDataBuffer, dwNumBytesToWrite,
+                                       dwTapControllerState, dwNumIdleCycles);
 
   LeaveCriticalSection(&threadAccess);
 
   return Status;
 }
 
-FTC_STATUS WINAPI FT2232hMpsseJtag::JTAG_CloseDevice(FTC_HANDLE ftHandle, PFTC_CLOSE_FINAL_STATE_PINS pCloseFinalStatePinsData)
+FTC_STATUS FT2232hMpsseJtag::ExecuteCommandsSequence(FTC_HANDLE ftHandle, PReadCmdSequenceDataByteBuffer pReadCmdSequenceDataBuffer,
+                                                     LPDWORD lpdwNumBytesReturned)
 {
   FTC_STATUS Status = FTC_SUCCESS;
+  DWORD dwNumCmdSequenceBytes = 0;
+  InputByteBuffer InputBuffer;
+  DWORD dwTotalNumBytesToBeRead = 0;
+  DWORD dwNumBytesRead = 0;
 
-  EnterCriticalSection(&threadAccess);
+  iCommandsSequenceDataDeviceIndex = GetCommandsSequenceDataDeviceIndex(ftHandle);
 
-  if ((Status = FTC_IsDeviceHandleValid(ftHandle)) == FTC_SUCCESS)
+  dwNumCmdSequenceBytes = GetNumBytesInCommandsSequenceDataBuffer();
+
+  if (OpenedDevicesCommandsSequenceData[iCommandsSequenceDataDeviceIndex].bCommandSequenceSubmitted)
+    Status = FTC_COMMAND_SEQUENCE_SUBMITTED;
+  else if (OpenedDevicesCommandsSequenceData[iCommandsSequenceDataDeviceIndex].bStreamingEnabled)
+    Status = FTC_COMMAND_SEQUENCE_STREAMING;
+  else if (dwNumCmdSequenceBytes > 0)
   {
-    if (pCloseFinalStatePinsData != NULL)
+    TransferCommandsSequenceToOutputBuffer();
+
+    if (OpenedDevicesCommandsSequenceData[iCommandsSequenceDataDeviceIndex].dwNumReadCommandSequences > 0)
     {
-      if ((Status = SetTCKTDITMSPinsCloseState(ftHandle, pCloseFinalStatePinsData)) == FTC_SUCCESS)
-        Status = JTAG_CloseDevice(ftHandle);
+      // Calculate the total number of bytes to be read, as a result of a command sequence
+      dwTotalNumBytesToBeRead = GetTotalNumCommandsSequenceDataBytesToRead();
+
+      // Overlap sending the sequence with reading back the bytes it returns
+      Status = FTC_SendReadBytesToFromDevice(ftHandle, InputBuffer, dwTotalNumBytesToBeRead, &dwNumBytesRead);
+
+      if (Status == FTC_SUCCESS)
+      {
+        // Process all bytes received and return them in the read data buffer
+        ProcessReadCommandsSequenceBytes(OpenedDevicesCommandsSequenceData[iCommandsSequenceDataDeviceIndex].pReadCommandsSequenceDataBuffer,
+                                         OpenedDevicesCommandsSequenceData[iCommandsSequenceDataDeviceIndex].dwNumReadCommandSequences,
+                                         &InputBuffer, dwNumBytesRead, pReadCmdSequenceDataBuffer, lpdwNumBytesReturned);
+      }
     }
     else
-      Status = FTC_NULL_CLOSE_FINAL_STATE_BUFFER_POINTER;
+      Status = FTC_SendCommandsSequenceToDevice(ftHandle);
+
+    OpenedDevicesCommandsSequenceData[iCommandsSequenceDataDeviceIndex].dwNumReadCommandSequences = 0;
   }
+  else
+    Status = FTC_NO_COMMAND_SEQUENCE;
 
-  LeaveCriticalSection(&threadAccess);
+  iCommandsSequenceDataDeviceIndex = -1;
 
   return Status;
 }
 
-FTC_STATUS FT2232hMpsseJtag::JTAG_InitDevice(FTC_HANDLE ftHandle, DWORD dwClockDivisor)
+FTC_STATUS FT2232hMpsseJtag::SendStreamingCommandsSequenceSegment(FTC_HANDLE ftHandle)
 {
+  // Sends the commands of a streamed sequence built so far and passes the bytes they read to the sink, the commands
+  // are discarded whether or not they could be sent. The bytes are read into the buffers allocated for the device
+  // when streaming was enabled, so no buffer is allocated for each segment.
   FTC_STATUS Status = FTC_SUCCESS;
+  PFTC_DEVICE_CMD_SEQUENCE_DATA pCmdSequenceData = &OpenedDevicesCommandsSequenceData[iCommandsSequenceDataDeviceIndex];
+  DWORD dwTotalNumBytesToBeRead = 0;
+  DWORD dwNumBytesRead = 0;
+  DWORD dwNumBytesReturned = 0;
 
-  EnterCriticalSection(&threadAccess);
+  TransferCommandsSequenceToOutputBuffer();
 
-  if ((Status = FTC_IsHiSpeedDeviceHandleValid(ftHandle)) == FTC_SUCCESS)
+  if (pCmdSequenceData->dwNumReadCommandSequences > 0)
   {
-    if ((Status = FTC_InitHiSpeedDevice(ftHandle)) == FTC_SUCCESS)
-    {
-      Status = InitDevice(ftHandle, dwClockDivisor);
-    }
-  }
+    dwTotalNumBytesToBeRead = GetTotalNumCommandsSequenceDataBytesToRead();
 
-  if (Status == FTC_INVALID_HANDLE)
-  {
-    if ((Status = FT2232c::FTC_IsDeviceHandleValid(ftHandle)) == FTC_SUCCESS)
+    Status = FTC_SendReadBytesToFromDevice(ftHandle, *pCmdSequenceData->pStreamingInputBuffer, dwTotalNumBytesToBeRead, &dwNumBytesRead);
+
+    if (Status == FTC_SUCCESS)
     {
-      Status = InitDevice(ftHandle, dwClockDivisor);
+      ProcessReadCommandsSequenceBytes(pCmdSequenceData->pReadCommandsSequenceDataBuffer, pCmdSequenceData->dwNumReadCommandSequences,
+                                       pCmdSequenceData->pStreamingInputBuffer, dwNumBytesRead, pCmdSequenceData->pStreamingReadDataBuffer,
+                                       &dwNumBytesReturned);
+
+      if (pCmdSequenceData->pStreamingDataSink != NULL)
+        Status = pCmdSequenceData->pStreamingDataSink(pCmdSequenceData->pStreamingContext, *pCmdSequenceData->pStreamingReadDataBuffer,
+                                                      dwNumBytesReturned);
+
+      pCmdSequenceData->dwNumStreamedReadBytes = (pCmdSequenceData->dwNumStreamedReadBytes + dwNumBytesReturned);
     }
   }
+  else
+    Status = FTC_SendCommandsSequenceToDevice(ftHandle);
 
-  LeaveCriticalSection(&threadAccess);
+  pCmdSequenceData->dwNumReadCommandSequences = 0;
 
   return Status;
 }
 
-FTC_STATUS FT2232hMpsseJtag::JTAG_TurnOnDivideByFiveClockingHiSpeedDevice(FTC_HANDLE ftHandle)
+FTC_STATUS FT2232hMpsseJtag::CreateStreamingCommandsSequenceBuffers(DWORD dwDeviceIndex)
 {
   FTC_STATUS Status = FTC_SUCCESS;
 
-  EnterCriticalSection(&threadAccess);
+  if (OpenedDevicesCommandsSequenceData[dwDeviceIndex].pStreamingInputBuffer == NULL)
+    OpenedDevicesCommandsSequenceData[dwDeviceIndex].pStreamingInputBuffer = PInputByteBuffer(new InputByteBuffer);
 
-  Status = FTC_TurnOnDivideByFiveClockingHiSpeedDevice(ftHandle);
+  if (OpenedDevicesCommandsSequenceData[dwDeviceIndex].pStreamingReadDataBuffer == NULL)
+    OpenedDevicesCommandsSequenceData[dwDeviceIndex].pStreamingReadDataBuffer = (PReadCmdSequenceDataByteBuffer)new BYTE[MAX_READ_CMDS_DATA_BYTES_BUFFER_SIZE];
 
-  LeaveCriticalSection(&threadAccess);
+  if ((OpenedDevicesCommandsSequenceData[dwDeviceIndex].pStreamingInputBuffer == NULL) ||
+      (OpenedDevicesCommandsSequenceData[dwDeviceIndex].pStreamingReadDataBuffer == NULL))
+  {
+    DeleteStreamingCommandsSequenceBuffers(dwDeviceIndex);
+
+    Status = FTC_INSUFFICIENT_RESOURCES;
+  }
 
   return Status;
 }
 
-FTC_STATUS FT2232hMpsseJtag::JTAG_TurnOffDivideByFiveClockingHiSpeedDevice(FTC_HANDLE ftHandle)
+void FT2232hMpsseJtag::DeleteStreamingCommandsSequenceBuffers(DWORD dwDeviceIndex)
 {
-  FTC_STATUS Status = FTC_SUCCESS;
-
-  EnterCriticalSection(&threadAccess);
+  if (OpenedDevicesCommandsSequenceData[dwDeviceIndex].pStreamingInputBuffer != NULL)
+    delete [] OpenedDevicesCommandsSequenceData[dwDeviceIndex].pStreamingInputBuffer;
 
-  Status = FTC_TurnOffDivideByFiveClockingHiSpeedDevice(ftHandle);
+  OpenedDevicesCommandsSequenceData[dwDeviceIndex].pStreamingInputBuffer = NULL;
 
-  LeaveCriticalSection(&threadAccess);
+  if (OpenedDevicesCommandsSequenceData[dwDeviceIndex].pStreamingReadDataBuffer != NULL)
+    delete [] (LPBYTE)OpenedDevicesCommandsSequenceData[dwDeviceIndex].pStreamingReadDataBuffer;
 
-  return Status;
+  OpenedDevicesCommandsSequenceData[dwDeviceIndex].pStreamingReadDataBuffer = NULL;
 }
 
-FTC_STATUS FT2232hMpsseJtag::JTAG_TurnOnAdaptiveClockingHiSpeedDevice(FTC_HANDLE ftHandle)
+FTC_STATUS FT2232hMpsseJtag::FlushStreamingCommandsSequence(FTC_HANDLE ftHandle, DWORD dwNumCommandDataBytes, DWORD dwNumBitsToRead)
 {
   FTC_STATUS Status = FTC_SUCCESS;
+  DWORD dwNumCmdSequenceBytes = 0;
+  DWORD dwNumReadDataBytes = 0;
+  DWORD dwNumRemainingDataBits = 0;
 
-  EnterCriticalSection(&threadAccess);
+  dwNumCmdSequenceBytes = GetNumBytesInCommandsSequenceDataBuffer();
 
-  Status = FTC_TurnOnAdaptiveClockingHiSpeedDevice(ftHandle);
+  // The segment built so far is sent before a command that would take it over the segment size is added
+  if (OpenedDevicesCommandsSequenceData[iCommandsSequenceDataDeviceIndex].bStreamingEnabled && (dwNumCmdSequenceBytes > 0))
+  {
+    if (dwNumBitsToRead > 0)
+      GetNumDataBytesToRead(dwNumBitsToRead, &dwNumReadDataBytes, &dwNumRemainingDataBits);
 
-  LeaveCriticalSection(&threadAccess);
+    if (((dwNumCmdSequenceBytes + dwNumCommandDataBytes) > STREAMING_CMD_SEQUENCE_SEGMENT_SIZE) ||
+        ((GetTotalNumCommandsSequenceDataBytesToRead() + dwNumReadDataBytes) > STREAMING_CMD_SEQUENCE_SEGMENT_SIZE))
+      Status = SendStreamingCommandsSequenceSegment(ftHandle);
+  }
 
   return Status;
 }
 
-FTC_STATUS FT2232hMpsseJtag::JTAG_TurnOffAdaptiveClockingHiSpeedDevice(FTC_HANDLE ftHandle)
+FTC_STATUS FT2232hMpsseJtag::ExecuteStreamingCommandsSequence(FTC_HANDLE ftHandle, LPDWORD lpdwNumBytesReturned)
 {
   FTC_STATUS Status = FTC_SUCCESS;
 
-  EnterCriticalSection(&threadAccess);
+  iCommandsSequenceDataDeviceIndex = GetCommandsSequenceDataDeviceIndex(ftHandle);
 
-  Status = FTC_TurnOffAdaptiveClockingHiSpeedDevice(ftHandle);
+  if (GetNumBytesInCommandsSequenceDataBuffer() > 0)
+  {
+    Status = SendStreamingCommandsSequenceSegment(ftHandle);
 
-  LeaveCriticalSection(&threadAccess);
+    if (Status == FTC_SUCCESS)
+      *lpdwNumBytesReturned = OpenedDevicesCommandsSequenceData[iCommandsSequenceDataDeviceIndex].dwNumStreamedReadBytes;
+  }
+  else
+    Status = FTC_NO_COMMAND_SEQUENCE;
+
+  OpenedDevicesCommandsSequenceData[iCommandsSequenceDataDeviceIndex].dwNumStreamedReadBytes = 0;
+
+  iCommandsSequenceDataDeviceIndex = -1;
 
   return Status;
 }
 
-FTC_STATUS FT2232hMpsseJtag::JTAG_SetDeviceLatencyTimer(FTC_HANDLE ftHandle, BYTE LatencyTimermSec)
+FTC_STATUS FT2232hMpsseJtag::JTAG_ExecuteCommandSequence(FTC_HANDLE ftHandle, PReadCmdSequenceDataByteBuffer pReadCmdSequenceDataBuffer,
+                                                         LPDWORD lpdwNumBytesReturned)
 {
   FTC_STATUS Status = FTC_SUCCESS;
 
   EnterCriticalSection(&threadAccess);
 
-  Status = FTC_SetDeviceLatencyTimer(ftHandle, LatencyTimermSec);
+  Status = FTC_IsDeviceHandleValid(ftHandle);
+
+  if (Status == FTC_SUCCESS)
+  {
+    if (OpenedDevicesCommandsSequenceData[GetCommandsSequenceDataDeviceIndex(ftHandle)].bStreamingEnabled)
+      Status = ExecuteStreamingCommandsSequence(ftHandle, lpdwNumBytesReturned);
+    else if (pReadCmdSequenceDataBuffer != NULL)
+      Status = ExecuteCommandsSequence(ftHandle, pReadCmdSequenceDataBuffer, lpdwNumBytesReturned);
+    else
+      Status = FTC_NULL_READ_CMDS_DATA_BUFFER_POINTER;
+  }
 
   LeaveCriticalSection(&threadAccess);
 
   return Status;
 }
 
-FTC_STATUS FT2232hMpsseJtag::JTAG_GetDeviceLatencyTimer(FTC_HANDLE ftHandle, LPBYTE lpLatencyTimermSec)
+FTC_STATUS FT2232hMpsseJtag::JTAG_ExecuteCommandSequenceCompare(FTC_HANDLE ftHandle, PReadCmdSequenceDataByteBuffer pExpectedDataBuffer,
+                                                                PReadCmdSequenceDataByteBuffer pMaskDataBuffer, LPDWORD lpdwMismatchBitOffset)
 {
   FTC_STATUS Status = FTC_SUCCESS;
+  PReadCmdSequenceDataByteBuffer pReadCmdSequenceDataBuffer = NULL;
+  DWORD dwNumBytesReturned = 0;
+  DWORD dwMismatchBitOffset = NO_TDO_DATA_MISMATCH;
 
   EnterCriticalSection(&threadAccess);
 
-  Status = FTC_GetDeviceLatencyTimer(ftHandle, lpLatencyTimermSec);
+  Status = FTC_IsDeviceHandleValid(ftHandle);
 
-  LeaveCriticalSection(&threadAccess);
+  if (Status == FTC_SUCCESS)
+  {
+    if (pExpectedDataBuffer != NULL)
+    {
+      pReadCmdSequenceDataBuffer = (PReadCmdSequenceDataByteBuffer)new BYTE[MAX_READ_CMDS_DATA_BYTES_BUFFER_SIZE];
 
-  return Status;
-}
+      if (pReadCmdSequenceDataBuffer != NULL)
+      {
+        Status = ExecuteCommandsSequence(ftHandle, pReadCmdSequenceDataBuffer, &dwNumBytesReturned);
 
-FTC_STATUS FT2232hMpsseJtag::JTAG_GetClock(DWORD dwClockDivisor, LPDWORD lpdwClockFrequencyHz)
-{
-  FTC_STATUS Status = FTC_SUCCESS;
+        if ((Status == FTC_SUCCESS) && (dwNumBytesReturned > 0))
+        {
+          dwMismatchBitOffset = FTC_FindFirstMismatchBit(*pReadCmdSequenceDataBuffer, *pExpectedDataBuffer,
+                                                         ((pMaskDataBuffer != NULL) ? *pMaskDataBuffer : NULL),
+                                                         (dwNumBytesReturned * NUMBITSINBYTE));
 
-  EnterCriticalSection(&threadAccess);
+          if (dwMismatchBitOffset == FTC_NO_BIT_MISMATCH)
+            dwMismatchBitOffset = NO_TDO_DATA_MISMATCH;
+        }
 
-  if ((dwClockDivisor >= MIN_CLOCK_DIVISOR) && (dwClockDivisor <= MAX_CLOCK_DIVISOR))
-    FTC_GetClockFrequencyValues(dwClockDivisor, lpdwClockFrequencyHz);
-  else
-    Status = FTC_INVALID_CLOCK_DIVISOR;
+        if (Status == FTC_SUCCESS)
+        {
+          if (lpdwMismatchBitOffset != NULL)
+            *lpdwMismatchBitOffset = dwMismatchBitOffset;
+
+          if (dwMismatchBitOffset != NO_TDO_DATA_MISMATCH)
+            Status = FTC_TDO_DATA_MISMATCH;
+        }
+
+        delete [] (LPBYTE)pReadCmdSequenceDataBuffer;
+      }
+      else
+        Status = FTC_INSUFFICIENT_RESOURCES;
+    }
+    else
+      Status = FTC_NULL_EXPECTED_DATA_BUFFER_POINTER;
+  }
 
   LeaveCriticalSection(&threadAccess);
 
   return Status;
 }
 
-FTC_STATUS FT2232hMpsseJtag::JTAG_GetHiSpeedDeviceClock(DWORD dwClockDivisor, LPDWORD lpdwClockFrequencyHz)
+FTC_STATUS FT2232hMpsseJtag::SubmitCommandsSequence(FTC_HANDLE ftHandle)
 {
   FTC_STATUS Status = FTC_SUCCESS;
+  PFTC_DEVICE_CMD_SEQUENCE_DATA pCmdSequenceData = NULL;
+  PFTC_READ_CMD_SEQUENCE_DATA pReadCommandsSequenceDataBuffer = NULL;
+  DWORD dwSizeReadCommandsSequenceDataBuffer = 0;
+  DWORD dwNumCmdSequenceBytes = 0;
+  DWORD dwTotalNumBytesToBeRead = 0;
 
-  EnterCriticalSection(&threadAccess);
+  iCommandsSequenceDataDeviceIndex = GetCommandsSequenceDataDeviceIndex(ftHandle);
 
-  if ((dwClockDivisor >= MIN_CLOCK_DIVISOR) && (dwClockDivisor <= MAX_CLOCK_DIVISOR))
-    FTC_GetHiSpeedDeviceClockFrequencyValues(dwClockDivisor, lpdwClockFrequencyHz);
-  else
-    Status = FTC_INVALID_CLOCK_DIVISOR;
+  pCmdSequenceData = &OpenedDevicesCommandsSequenceData[iCommandsSequenceDataDeviceIndex];
 
-  LeaveCriticalSection(&threadAccess);
+  dwNumCmdSequenceBytes = GetNumBytesInCommandsSequenceDataBuffer();
 
-  return Status;
-}
+  if (pCmdSequenceData->bCommandSequenceSubmitted)
+    Status = FTC_COMMAND_SEQUENCE_SUBMITTED;
+  else if (pCmdSequenceData->bStreamingEnabled)
+    Status = FTC_COMMAND_SEQUENCE_STREAMING;
+  else if (dwNumCmdSequenceBytes > 0)
+  {
+    TransferCommandsSequenceToOutputBuffer();
 
-FTC_STATUS FT2232hMpsseJtag::JTAG_SetClock(FTC_HANDLE ftHandle, DWORD dwClockDivisor, LPDWORD lpdwClockFrequencyHz)
-{
-  FTC_STATUS Status = FTC_SUCCESS;
+    // Calculate the total number of bytes to be read, as a result of a command sequence
+    if (pCmdSequenceData->dwNumReadCommandSequences > 0)
+      dwTotalNumBytesToBeRead = GetTotalNumCommandsSequenceDataBytesToRead();
 
-  EnterCriticalSection(&threadAccess);
+    // The device is given the command timeout to return the bytes of the sequence from when it is submitted, the
+    // deadline is ended when the sequence is reaped or abandoned
+    FTC_StartDeviceCommandDeadline(ftHandle);
 
-  if ((dwClockDivisor >= MIN_CLOCK_DIVISOR) && (dwClockDivisor <= MAX_CLOCK_DIVISOR))
-  {
-    if ((Status = FTC_IsHiSpeedDeviceHandleValid(ftHandle)) == FTC_SUCCESS)
-    {
-      FTC_GetHiSpeedDeviceClockFrequencyValues(ftHandle, dwClockDivisor, lpdwClockFrequencyHz);
-    }
+    Status = FTC_SendCommandsSequenceToDevice(ftHandle);
 
-    if (Status == FTC_INVALID_HANDLE)
+    if (Status != FTC_SUCCESS)
+      FTC_EndDeviceCommandDeadline(ftHandle);
+    else
     {
-      if ((Status = FT2232c::FTC_IsDeviceHandleValid(ftHandle)) == FTC_SUCCESS)
-      {
-        FTC_GetClockFrequencyValues(dwClockDivisor, lpdwClockFrequencyHz);
-      }
-    }
+      // The read command sequences describe the bytes to be returned, so they are kept until the sequence is reaped.
+      // They are swapped with the read command sequences of the last submitted sequence, which are no longer needed,
+      // so the next sequence can be built while this one is executed
+      pReadCommandsSequenceDataBuffer = pCmdSequenceData->pSubmittedReadCommandsSequenceDataBuffer;
+      dwSizeReadCommandsSequenceDataBuffer = pCmdSequenceData->dwSizeSubmittedReadCommandsSequenceDataBuffer;
 
-    if (Status == FTC_SUCCESS)
-    {
-      Status = SetDataInOutClockFrequency(ftHandle, dwClockDivisor);
+      pCmdSequenceData->pSubmittedReadCommandsSequenceDataBuffer = pCmdSequenceData->pReadCommandsSequenceDataBuffer;
+      pCmdSequenceData->dwSizeSubmittedReadCommandsSequenceDataBuffer = pCmdSequenceData->dwSizeReadCommandsSequenceDataBuffer;
+      pCmdSequenceData->dwNumSubmittedReadCommandSequences = pCmdSequenceData->dwNumReadCommandSequences;
+
+      pCmdSequenceData->pReadCommandsSequenceDataBuffer = pReadCommandsSequenceDataBuffer;
+      pCmdSequenceData->dwSizeReadCommandsSequenceDataBuffer = dwSizeReadCommandsSequenceDataBuffer;
+
+      pCmdSequenceData->bCommandSequenceSubmitted = true;
+      pCmdSequenceData->dwNumSubmittedReadBytes = dwTotalNumBytesToBeRead;
+      pCmdSequenceData->CompletionStatus = FTC_SUCCESS;
+
+      // Tickets run from 1, so 0 is never a valid ticket
+      pCmdSequenceData->dwSubmittedCommandSequenceTicket = pCmdSequenceData->dwNextCommandSequenceTicket;
+
+      if (++pCmdSequenceData->dwNextCommandSequenceTicket == 0)
+        pCmdSequenceData->dwNextCommandSequenceTicket = 1;
+
+      if (dwTotalNumBytesToBeRead == 0)
+        SignalCommandSequenceCompletion(iCommandsSequenceDataDeviceIndex, FTC_SUCCESS);
+#ifndef _WIN32
+      else
+        pthread_cond_signal(&CommandSequenceSubmitted);
+#endif
     }
+
+    pCmdSequenceData->dwNumReadCommandSequences = 0;
   }
   else
-    Status = FTC_INVALID_CLOCK_DIVISOR;
+    Status = FTC_NO_COMMAND_SEQUENCE;
 
-  LeaveCriticalSection(&threadAccess);
+  iCommandsSequenceDataDeviceIndex = -1;
 
   return Status;
 }
 
-FTC_STATUS FT2232hMpsseJtag::JTAG_SetDeviceLoopbackState(FTC_HANDLE ftHandle, BOOL bLoopbackState)
+FTC_STATUS FT2232hMpsseJtag::JTAG_SubmitCommandSequence(FTC_HANDLE ftHandle)
 {
+  // Sends a command sequence to a device without waiting for the bytes it returns. The sequence is completed by
+  // JTAG_ReapCommandSequence, until then the device should only be used to build the next sequence, or to reap or
+  // abandon the submitted sequence
   FTC_STATUS Status = FTC_SUCCESS;
 
   EnterCriticalSection(&threadAccess);
 
-  if ((Status = FTC_IsDeviceHandleValid(ftHandle)) == FTC_SUCCESS) {
-    Status = FTC_SetDeviceLoopbackState(ftHandle, bLoopbackState);
-  }
+  Status = FTC_IsDeviceHandleValid(ftHandle);
+
+  if (Status == FTC_SUCCESS)
+    Status = SubmitCommandsSequence(ftHandle);
 
   LeaveCriticalSection(&threadAccess);
 
   return Status;
 }
 
-FTC_STATUS FT2232hMpsseJtag::JTAG_SetGeneralPurposeInputOutputPins(FTC_HANDLE ftHandle, BOOL bControlLowInputOutputPins,
-                                                                   PFTC_INPUT_OUTPUT_PINS pLowInputOutputPinsData,
-                                                                   BOOL bControlHighInputOutputPins,
-                                                                   PFTC_INPUT_OUTPUT_PINS pHighInputOutputPinsData)
+FTC_STATUS FT2232hMpsseJtag::JTAG_ExecuteCommandSequenceAsync(FTC_HANDLE ftHandle, LPDWORD lpdwTicket)
 {
   FTC_STATUS Status = FTC_SUCCESS;
 
@@ -2114,13 +4837,10 @@ FTC_STATUS FT2232hMpsseJtag::JTAG_SetGeneralPurposeInputOutputPins(FTC_HANDLE ft
 
   if (Status == FTC_SUCCESS)
   {
-    if ((pLowInputOutputPinsData != NULL) && (pHighInputOutputPinsData != NULL))
-      Status = SetGeneralPurposeInputOutputPins(ftHandle, bControlLowInputOutputPins,
-                                                pLowInputOutputPinsData,
-                                                bControlHighInputOutputPins,
-                                                pHighInputOutputPinsData);
-    else
-      Status = FTC_NULL_INPUT_OUTPUT_BUFFER_POINTER;
+    Status = SubmitCommandsSequence(ftHandle);
+
+    if (Status == FTC_SUCCESS)
+      *lpdwTicket = OpenedDevicesCommandsSequenceData[GetCommandsSequenceDataDeviceIndex(ftHandle)].dwSubmittedCommandSequenceTicket;
   }
 
   LeaveCriticalSection(&threadAccess);
@@ -2128,36 +4848,63 @@ FTC_STATUS FT2232hMpsseJtag::JTAG_SetGeneralPurposeInputOutputPins(FTC_HANDLE ft
   return Status;
 }
 
-FTC_STATUS FT2232hMpsseJtag::JTAG_SetHiSpeedDeviceGeneralPurposeInputOutputPins(FTC_HANDLE ftHandle, BOOL bControlLowInputOutputPins,
-                                                                                PFTC_INPUT_OUTPUT_PINS pLowInputOutputPinsData,
-                                                                                BOOL bControlHighInputOutputPins,
-                                                                                PFTH_INPUT_OUTPUT_PINS pHighInputOutputPinsData)
+FTC_STATUS FT2232hMpsseJtag::ReapCommandsSequence(FTC_HANDLE ftHandle, BOOL bWaitForCompletion, PReadCmdSequenceDataByteBuffer pReadCmdSequenceDataBuffer,
+                                                  LPDWORD lpdwNumBytesReturned)
 {
+  // Completes the submitted command sequence of a device. Without waiting, FTC_COMMAND_SEQUENCE_NOT_COMPLETE is
+  // returned if the device has not yet returned all the bytes of the sequence
   FTC_STATUS Status = FTC_SUCCESS;
+  PFTC_DEVICE_CMD_SEQUENCE_DATA pCmdSequenceData = NULL;
+  InputByteBuffer InputBuffer;
+  DWORD dwNumBytesDeviceInputBuffer = 0;
+  DWORD dwNumBytesRead = 0;
 
-  EnterCriticalSection(&threadAccess);
+  iCommandsSequenceDataDeviceIndex = GetCommandsSequenceDataDeviceIndex(ftHandle);
 
-  if ((Status = FTC_IsHiSpeedDeviceHandleValid(ftHandle)) == FTC_SUCCESS)
+  pCmdSequenceData = &OpenedDevicesCommandsSequenceData[iCommandsSequenceDataDeviceIndex];
+
+  if (pCmdSequenceData->bCommandSequenceSubmitted)
   {
-    if ((pLowInputOutputPinsData != NULL) && (pHighInputOutputPinsData != NULL))
-      Status = SetHiSpeedDeviceGeneralPurposeInputOutputPins(ftHandle, bControlLowInputOutputPins,
-                                                             pLowInputOutputPinsData,
-                                                             bControlHighInputOutputPins,
-                                                             pHighInputOutputPinsData);
-    else
-      Status = FTC_NULL_INPUT_OUTPUT_BUFFER_POINTER;
+    if (((Status = pCmdSequenceData->CompletionStatus) == FTC_SUCCESS) && !bWaitForCompletion)
+      Status = FTC_PollDeviceInputBytes(ftHandle, pCmdSequenceData->dwNumSubmittedReadBytes, &dwNumBytesDeviceInputBuffer);
+
+    if (Status == FTC_SUCCESS)
+    {
+      if (bWaitForCompletion || (dwNumBytesDeviceInputBuffer >= pCmdSequenceData->dwNumSubmittedReadBytes))
+      {
+        if (pCmdSequenceData->dwNumSubmittedReadBytes > 0)
+        {
+          Status = FTC_ReadFixedNumBytesFromDevice(ftHandle, InputBuffer, pCmdSequenceData->dwNumSubmittedReadBytes, &dwNumBytesRead);
+
+          if (Status == FTC_SUCCESS)
+            // Process all bytes received and return them in the read data buffer
+            ProcessReadCommandsSequenceBytes(pCmdSequenceData->pSubmittedReadCommandsSequenceDataBuffer,
+                                             pCmdSequenceData->dwNumSubmittedReadCommandSequences,
+                                             &InputBuffer, dwNumBytesRead, pReadCmdSequenceDataBuffer, lpdwNumBytesReturned);
+        }
+        else
+          *lpdwNumBytesReturned = 0;
+      }
+      else
+        Status = FTC_COMMAND_SEQUENCE_NOT_COMPLETE;
+    }
+
+    if (Status != FTC_COMMAND_SEQUENCE_NOT_COMPLETE)
+      EndSubmittedCommandSequence(iCommandsSequenceDataDeviceIndex);
   }
+  else
+    Status = FTC_NO_COMMAND_SEQUENCE;
 
-  LeaveCriticalSection(&threadAccess);
+  iCommandsSequenceDataDeviceIndex = -1;
 
   return Status;
 }
 
-FTC_STATUS FT2232hMpsseJtag::JTAG_GetGeneralPurposeInputOutputPins(FTC_HANDLE ftHandle, BOOL bControlLowInputOutputPins,
-                                                                   PFTC_LOW_HIGH_PINS pLowPinsInputData,
-                                                                   BOOL bControlHighInputOutputPins,
-                                                                   PFTC_LOW_HIGH_PINS pHighPinsInputData)
+FTC_STATUS FT2232hMpsseJtag::JTAG_ReapCommandSequence(FTC_HANDLE ftHandle, PReadCmdSequenceDataByteBuffer pReadCmdSequenceDataBuffer,
+                                                      LPDWORD lpdwNumBytesReturned)
 {
+  // Completes a command sequence sent by JTAG_SubmitCommandSequence without waiting, FTC_COMMAND_SEQUENCE_NOT_COMPLETE
+  // is returned if the device has not yet returned all the bytes of the sequence
   FTC_STATUS Status = FTC_SUCCESS;
 
   EnterCriticalSection(&threadAccess);
@@ -2166,11 +4913,10 @@ FTC_STATUS FT2232hMpsseJtag::JTAG_GetGeneralPurposeInputOutputPins(FTC_HANDLE ft
 
   if (Status == FTC_SUCCESS)
   {
-    if ((pLowPinsInputData != NULL) && (pHighPinsInputData != NULL))
-      Status = GetGeneralPurposeInputOutputPins(ftHandle, bControlLowInputOutputPins, pLowPinsInputData,
-                                                bControlHighInputOutputPins, pHighPinsInputData);
+    if (pReadCmdSequenceDataBuffer != NULL)
+      Status = ReapCommandsSequence(ftHandle, false, pReadCmdSequenceDataBuffer, lpdwNumBytesReturned);
     else
-      Status = FTC_NULL_INPUT_OUTPUT_BUFFER_POINTER;
+      Status = FTC_NULL_READ_CMDS_DATA_BUFFER_POINTER;
   }
 
   LeaveCriticalSection(&threadAccess);
@@ -2178,22 +4924,27 @@ FTC_STATUS FT2232hMpsseJtag::JTAG_GetGeneralPurposeInputOutputPins(FTC_HANDLE ft
   return Status;
 }
 
-FTC_STATUS FT2232hMpsseJtag::JTAG_GetHiSpeedDeviceGeneralPurposeInputOutputPins(FTC_HANDLE ftHandle, BOOL bControlLowInputOutputPins,
-                                                                                PFTC_LOW_HIGH_PINS pLowPinsInputData,
-                                                                                BOOL bControlHighInputOutputPins,
-                                                                                PFTH_LOW_HIGH_PINS pHighPinsInputData)
+FTC_STATUS FT2232hMpsseJtag::JTAG_PollCommandSequence(FTC_HANDLE ftHandle, DWORD dwTicket, PReadCmdSequenceDataByteBuffer pReadCmdSequenceDataBuffer,
+                                                      LPDWORD lpdwNumBytesReturned)
 {
   FTC_STATUS Status = FTC_SUCCESS;
+  DWORD dwDeviceIndex = 0;
 
   EnterCriticalSection(&threadAccess);
 
-  if ((Status = FTC_IsHiSpeedDeviceHandleValid(ftHandle)) == FTC_SUCCESS)
+  Status = FTC_IsDeviceHandleValid(ftHandle);
+
+  if (Status == FTC_SUCCESS)
   {
-    if ((pLowPinsInputData != NULL) && (pHighPinsInputData != NULL))
-      Status = GetHiSpeedDeviceGeneralPurposeInputOutputPins(ftHandle, bControlLowInputOutputPins, pLowPinsInputData,
-                                                             bControlHighInputOutputPins, pHighPinsInputData);
+    dwDeviceIndex = GetCommandsSequenceDataDeviceIndex(ftHandle);
+
+    if (pReadCmdSequenceDataBuffer == NULL)
+      Status = FTC_NULL_READ_CMDS_DATA_BUFFER_POINTER;
+    else if (!OpenedDevicesCommandsSequenceData[dwDeviceIndex].bCommandSequenceSubmitted ||
+             (OpenedDevicesCommandsSequenceData[dwDeviceIndex].dwSubmittedCommandSequenceTicket != dwTicket))
+      Status = FTC_INVALID_COMMAND_SEQUENCE_TICKET;
     else
-      Status = FTC_NULL_INPUT_OUTPUT_BUFFER_POINTER;
+      Status = ReapCommandsSequence(ftHandle, false, pReadCmdSequenceDataBuffer, lpdwNumBytesReturned);
   }
 
   LeaveCriticalSection(&threadAccess);
@@ -2201,11 +4952,12 @@ FTC_STATUS FT2232hMpsseJtag::JTAG_GetHiSpeedDeviceGeneralPurposeInputOutputPins(
   return Status;
 }
 
-FTC_STATUS FT2232hMpsseJtag::JTAG_WriteDataToExternalDevice(FTC_HANDLE ftHandle, BOOL bInstructionTestData, DWORD dwNumBitsToWrite,
-                                                            PWriteDataByteBuffer pWriteDataBuffer, DWORD dwNumBytesToWrite,
-                                                            DWORD dwTapControllerState)
+FTC_STATUS FT2232hMpsseJtag::JTAG_WaitCommandSequence(FTC_HANDLE ftHandle, DWORD dwTicket, PReadCmdSequenceDataByteBuffer pReadCmdSequenceDataBuffer,
+                                                      LPDWORD lpdwNumBytesReturned)
 {
+  // Waits for the device to return all the bytes of the sequence, for no longer than the command timeout of the device
   FTC_STATUS Status = FTC_SUCCESS;
+  DWORD dwDeviceIndex = 0;
 
   EnterCriticalSection(&threadAccess);
 
@@ -2213,21 +4965,15 @@ FTC_STATUS FT2232hMpsseJtag::JTAG_WriteDataToExternalDevice(FTC_HANDLE ftHandle,
 
   if (Status == FTC_SUCCESS)
   {
-    if (pWriteDataBuffer != NULL)
-    {
-      Status = CheckWriteDataToExternalDeviceBitsBytesParameters(dwNumBitsToWrite, dwNumBytesToWrite);
+    dwDeviceIndex = GetCommandsSequenceDataDeviceIndex(ftHandle);
 
-      if (Status == FTC_SUCCESS)
-      {
-        if ((dwTapControllerState >= TEST_LOGIC_STATE) && (dwTapControllerState <= SHIFT_INSTRUCTION_REGISTER_STATE))
-          Status = WriteDataToExternalDevice(ftHandle, bInstructionTestData, dwNumBitsToWrite, pWriteDataBuffer,
-                                             dwNumBytesToWrite, dwTapControllerState);
-        else
-          Status = FTC_INVALID_TAP_CONTROLLER_STATE;
-      }
-    }
+    if (pReadCmdSequenceDataBuffer == NULL)
+      Status = FTC_NULL_READ_CMDS_DATA_BUFFER_POINTER;
+    else if (!OpenedDevicesCommandsSequenceData[dwDeviceIndex].bCommandSequenceSubmitted ||
+             (OpenedDevicesCommandsSequenceData[dwDeviceIndex].dwSubmittedCommandSequenceTicket != dwTicket))
+      Status = FTC_INVALID_COMMAND_SEQUENCE_TICKET;
     else
-      Status = FTC_NULL_WRITE_DATA_BUFFER_POINTER;
+      Status = ReapCommandsSequence(ftHandle, true, pReadCmdSequenceDataBuffer, lpdwNumBytesReturned);
   }
 
   LeaveCriticalSection(&threadAccess);
@@ -2235,11 +4981,12 @@ FTC_STATUS FT2232hMpsseJtag::JTAG_WriteDataToExternalDevice(FTC_HANDLE ftHandle,
   return Status;
 }
 
-FTC_STATUS FT2232hMpsseJtag::JTAG_ReadDataFromExternalDevice(FTC_HANDLE ftHandle, BOOL bInstructionTestData, DWORD dwNumBitsToRead,
-                                                             PReadDataByteBuffer pReadDataBuffer, LPDWORD lpdwNumBytesReturned,
-                                                             DWORD dwTapControllerState)
+FTC_STATUS FT2232hMpsseJtag::JTAG_AbandonDeviceCommandSequence(FTC_HANDLE ftHandle)
 {
+  // Discards a submitted command sequence, whatever it has returned or is still to return is purged from the device.
+  // The sequence being built is left as it is
   FTC_STATUS Status = FTC_SUCCESS;
+  DWORD dwDeviceIndex = 0;
 
   EnterCriticalSection(&threadAccess);
 
@@ -2247,21 +4994,14 @@ FTC_STATUS FT2232hMpsseJtag::JTAG_ReadDataFromExternalDevice(FTC_HANDLE ftHandle
 
   if (Status == FTC_SUCCESS)
   {
-    if (pReadDataBuffer != NULL)
+    dwDeviceIndex = GetCommandsSequenceDataDeviceIndex(ftHandle);
+
+    if (OpenedDevicesCommandsSequenceData[dwDeviceIndex].bCommandSequenceSubmitted)
     {
-      if ((dwNumBitsToRead >= MIN_NUM_BITS) && (dwNumBitsToRead <= MAX_NUM_BITS))
-      {
-        if ((dwTapControllerState >= TEST_LOGIC_STATE) && (dwTapControllerState <= SHIFT_INSTRUCTION_REGISTER_STATE))
-          Status = ReadDataFromExternalDevice(ftHandle, bInstructionTestData, dwNumBitsToRead, pReadDataBuffer,
-                                              lpdwNumBytesReturned, dwTapControllerState);
-        else
-          Status = FTC_INVALID_TAP_CONTROLLER_STATE;
-      }
-      else
-        Status = FTC_INVALID_NUMBER_BITS;
+      FTC_PurgeDevice(ftHandle);
+
+      EndSubmittedCommandSequence(dwDeviceIndex);
     }
-    else
-      Status = FTC_NULL_READ_DATA_BUFFER_POINTER;
   }
 
   LeaveCriticalSection(&threadAccess);
@@ -2269,12 +5009,13 @@ FTC_STATUS FT2232hMpsseJtag::JTAG_ReadDataFromExternalDevice(FTC_HANDLE ftHandle
   return Status;
 }
 
-FTC_STATUS FT2232hMpsseJtag::JTAG_WriteReadDataToFromExternalDevice(FTC_HANDLE ftHandle, BOOL bInstructionTestData, DWORD dwNumBitsToWriteRead,
-                                                                    PWriteDataByteBuffer pWriteDataBuffer, DWORD dwNumBytesToWrite,
-                                                                    PReadDataByteBuffer pReadDataBuffer, LPDWORD lpdwNumBytesReturned,
-                                                                    DWORD dwTapControllerState)
+FTC_STATUS FT2232hMpsseJtag::JTAG_GetDeviceCompletionFd(FTC_HANDLE ftHandle, INT *piCompletionFd)
 {
+  // Returns a file descriptor, that becomes readable when the command sequence submitted to a device can be reaped.
+  // It can be waited on with poll, select or epoll alongside the descriptors of other devices, and is owned by the
+  // library, it is closed when the device is closed
   FTC_STATUS Status = FTC_SUCCESS;
+  PFTC_DEVICE_CMD_SEQUENCE_DATA pCmdSequenceData = NULL;
 
   EnterCriticalSection(&threadAccess);
 
@@ -2282,27 +5023,36 @@ FTC_STATUS FT2232hMpsseJtag::JTAG_WriteReadDataToFromExternalDevice(FTC_HANDLE f
 
   if (Status == FTC_SUCCESS)
   {
-    if ((pWriteDataBuffer != NULL) && (pReadDataBuffer != NULL))
-    {
-      Status = CheckWriteDataToExternalDeviceBitsBytesParameters(dwNumBitsToWriteRead, dwNumBytesToWrite);
+#ifndef _WIN32
+    pCmdSequenceData = &OpenedDevicesCommandsSequenceData[GetCommandsSequenceDataDeviceIndex(ftHandle)];
 
-      if (Status == FTC_SUCCESS)
+    if (pCmdSequenceData->iCompletionFd == -1)
+    {
+      if ((Status = StartCompletionWatcher()) == FTC_SUCCESS)
       {
-        if ((dwTapControllerState >= TEST_LOGIC_STATE) && (dwTapControllerState <= SHIFT_INSTRUCTION_REGISTER_STATE))
-          Status = WriteReadDataToFromExternalDevice(ftHandle, bInstructionTestData, dwNumBitsToWriteRead,
-                                                     pWriteDataBuffer, dwNumBytesToWrite, pReadDataBuffer,
-                                                     lpdwNumBytesReturned, dwTapControllerState);
+        if ((pCmdSequenceData->iCompletionFd = eventfd(0, (EFD_NONBLOCK | EFD_CLOEXEC))) != -1)
+        {
+          // Watch a sequence that was submitted before the completion fd was created
+          if (pCmdSequenceData->bCommandSequenceSubmitted)
+          {
+            if (pCmdSequenceData->dwNumSubmittedReadBytes == 0)
+              SignalCommandSequenceCompletion(GetCommandsSequenceDataDeviceIndex(ftHandle), FTC_SUCCESS);
+            else
+              pthread_cond_signal(&CommandSequenceSubmitted);
+          }
+        }
         else
-          Status = FTC_INVALID_TAP_CONTROLLER_STATE;
+          Status = FTC_INSUFFICIENT_RESOURCES;
       }
     }
-    else
-    {
-      if (pWriteDataBuffer == NULL)
-        Status = FTC_NULL_WRITE_DATA_BUFFER_POINTER;
-      else
-        Status = FTC_NULL_READ_DATA_BUFFER_POINTER;
-    }
+
+    if (Status == FTC_SUCCESS)
+      *piCompletionFd = pCmdSequenceData->iCompletionFd;
+#else
+    (void)pCmdSequenceData;
+
+    Status = FTC_COMPLETION_FD_NOT_SUPPORTED;
+#endif
   }
 
   LeaveCriticalSection(&threadAccess);
@@ -2310,48 +5060,37 @@ FTC_STATUS FT2232hMpsseJtag::JTAG_WriteReadDataToFromExternalDevice(FTC_HANDLE f
   return Status;
 }
 
-FTC_STATUS FT2232hMpsseJtag::JTAG_GenerateTCKClockPulses(FTC_HANDLE ftHandle, DWORD dwNumClockPulses)
+FTC_STATUS FT2232hMpsseJtag::JTAG_SetDeviceCommandSequenceOptimizer(FTC_HANDLE ftHandle, BOOL bOptimizerEnabled)
 {
   FTC_STATUS Status = FTC_SUCCESS;
 
   EnterCriticalSection(&threadAccess);
 
-  if ((Status = FTC_IsDeviceHandleValid(ftHandle)) == FTC_SUCCESS)
-  {
-    if ((dwNumClockPulses >= MIN_NUM_CLOCK_PULSES) && (dwNumClockPulses <= MAX_NUM_CLOCK_PULSES))
-      Status = GenerateTCKClockPulses(ftHandle, dwNumClockPulses);
-    else
-      Status = FTC_INVALID_NUMBER_CLOCK_PULSES;
-  }
+  Status = FTC_IsDeviceHandleValid(ftHandle);
+
+  if (Status == FTC_SUCCESS)
+    OpenedDevicesCommandsSequenceData[GetCommandsSequenceDataDeviceIndex(ftHandle)].bOptimizerEnabled = (bOptimizerEnabled != FALSE);
 
   LeaveCriticalSection(&threadAccess);
 
   return Status;
 }
 
-FTC_STATUS FT2232hMpsseJtag::JTAG_GenerateClockPulsesHiSpeedDevice(FTC_HANDLE ftHandle, BOOL bPulseClockTimesEightFactor, DWORD dwNumClockPulses, BOOL bControlLowInputOutputPin, BOOL bStopClockPulsesState)
+FTC_STATUS FT2232hMpsseJtag::JTAG_GetDeviceCommandSequenceOptimizer(FTC_HANDLE ftHandle, LPBOOL lpbOptimizerEnabled, LPDWORD lpdwNumBytesSaved)
 {
   FTC_STATUS Status = FTC_SUCCESS;
+  DWORD dwDeviceIndex = 0;
 
   EnterCriticalSection(&threadAccess);
 
-  if ((Status = FTC_IsHiSpeedDeviceHandleValid(ftHandle)) == FTC_SUCCESS)
-  {
-    if (bPulseClockTimesEightFactor)
-    {
-      if ((dwNumClockPulses < MIN_NUM_CLOCK_PULSES) || (dwNumClockPulses > MAX_NUM_TIMES_EIGHT_CLOCK_PULSES))
-        Status = FTC_INVALID_NUMBER_TIMES_EIGHT_CLOCK_PULSES;
-    }
-    else
-    {
-      if ((dwNumClockPulses < MIN_NUM_CLOCK_PULSES) || (dwNumClockPulses > MAX_NUM_SINGLE_CLOCK_PULSES))
-        Status = FTC_INVALID_NUMBER_SINGLE_CLOCK_PULSES;
-    }
-  }
+  Status = FTC_IsDeviceHandleValid(ftHandle);
 
   if (Status == FTC_SUCCESS)
   {
-    Status = GenerateClockPulsesHiSpeedDevice(ftHandle, bPulseClockTimesEightFactor, dwNumClockPulses, bControlLowInputOutputPin, bStopClockPulsesState);
+    dwDeviceIndex = GetCommandsSequenceDataDeviceIndex(ftHandle);
+
+    *lpbOptimizerEnabled = OpenedDevicesCommandsSequenceData[dwDeviceIndex].bOptimizerEnabled;
+    *lpdwNumBytesSaved = OpenedDevicesCommandsSequenceData[dwDeviceIndex].dwNumOptimizerBytesSaved;
   }
 
   LeaveCriticalSection(&threadAccess);
@@ -2359,23 +5098,36 @@ FTC_STATUS FT2232hMpsseJtag::JTAG_GenerateClockPulsesHiSpeedDevice(FTC_HANDLE ft
   return Status;
 }
 
-
-FTC_STATUS FT2232hMpsseJtag::JTAG_ClearCommandSequence(void)
+FTC_STATUS FT2232hMpsseJtag::JTAG_SetDeviceCommandSequenceStreaming(FTC_HANDLE ftHandle, BOOL bStreamingEnabled, PFTC_SCAN_DATA_SINK pDataSink,
+                                                                    LPVOID pContext)
 {
   FTC_STATUS Status = FTC_SUCCESS;
-  DWORD dwNumDevices;
-  FT2232CDeviceIndexes FT2232CIndexes;
+  DWORD dwDeviceIndex = 0;
 
   EnterCriticalSection(&threadAccess);
 
-  Status = FTC_GetNumDevices(&dwNumDevices, &FT2232CIndexes);
+  Status = FTC_IsDeviceHandleValid(ftHandle);
 
   if (Status == FTC_SUCCESS)
   {
-    if (dwNumDevices == 1)
-      ClearDeviceCommandSequenceData(0);
+    dwDeviceIndex = GetCommandsSequenceDataDeviceIndex(ftHandle);
+
+    if (OpenedDevicesCommandsSequenceData[dwDeviceIndex].bCommandSequenceSubmitted)
+      Status = FTC_COMMAND_SEQUENCE_SUBMITTED;
+    else if (bStreamingEnabled != FALSE)
+      Status = CreateStreamingCommandsSequenceBuffers(dwDeviceIndex);
     else
-      Status = FTC_TOO_MANY_DEVICES;
+      DeleteStreamingCommandsSequenceBuffers(dwDeviceIndex);
+
+    if (Status == FTC_SUCCESS)
+    {
+      // The sequence being built was built for the previous mode, so it is discarded
+      ClearDeviceCommandSequenceData(ftHandle);
+
+      OpenedDevicesCommandsSequenceData[dwDeviceIndex].bStreamingEnabled = (bStreamingEnabled != FALSE);
+      OpenedDevicesCommandsSequenceData[dwDeviceIndex].pStreamingDataSink = pDataSink;
+      OpenedDevicesCommandsSequenceData[dwDeviceIndex].pStreamingContext = pContext;
+    }
   }
 
   LeaveCriticalSection(&threadAccess);
@@ -2383,26 +5135,21 @@ FTC_STATUS FT2232hMpsseJtag::JTAG_ClearCommandSequence(void)
   return Status;
 }
 
-FTC_STATUS FT2232hMpsseJtag::JTAG_AddWriteCommand(BOOL bInstructionTestData, DWORD dwNumBitsToWrite,
-                                                  PWriteDataByteBuffer pWriteDataBuffer, DWORD dwNumBytesToWrite,
-                                                  DWORD dwTapControllerState)
+FTC_STATUS FT2232hMpsseJtag::JTAG_SetDeviceInstructionRegisterCache(FTC_HANDLE ftHandle, BOOL bCacheEnabled)
 {
   FTC_STATUS Status = FTC_SUCCESS;
-  DWORD dwNumCommandDataBytes = 0;
-  DWORD dwNumDevices;
-  FT2232CDeviceIndexes FT2232CIndexes;
+  DWORD dwDeviceIndex = 0;
 
   EnterCriticalSection(&threadAccess);
 
-  Status = FTC_GetNumDevices(&dwNumDevices, &FT2232CIndexes);
+  Status = FTC_IsDeviceHandleValid(ftHandle);
 
   if (Status == FTC_SUCCESS)
   {
-    if (dwNumDevices == 1)
-      // ftHandle parameter set to 0 to indicate only one device present in the system
-      Status = AddDeviceWriteCommand(0, bInstructionTestData, dwNumBitsToWrite, pWriteDataBuffer, dwNumBytesToWrite, dwTapControllerState);
-    else
-      Status = FTC_TOO_MANY_DEVICES;
+    dwDeviceIndex = GetCommandsSequenceDataDeviceIndex(ftHandle);
+
+    OpenedDevicesCommandsSequenceData[dwDeviceIndex].bInstructionRegisterCacheEnabled = (bCacheEnabled != FALSE);
+    OpenedDevicesCommandsSequenceData[dwDeviceIndex].bInstructionRegisterCacheValid = false;
   }
 
   LeaveCriticalSection(&threadAccess);
@@ -2410,24 +5157,21 @@ FTC_STATUS FT2232hMpsseJtag::JTAG_AddWriteCommand(BOOL bInstructionTestData, DWO
   return Status;
 }
 
-FTC_STATUS FT2232hMpsseJtag::JTAG_AddReadCommand(BOOL bInstructionTestData, DWORD dwNumBitsToRead, DWORD dwTapControllerState)
+FTC_STATUS FT2232hMpsseJtag::JTAG_GetDeviceInstructionRegisterCache(FTC_HANDLE ftHandle, LPBOOL lpbCacheEnabled, LPDWORD lpdwNumScansSkipped)
 {
   FTC_STATUS Status = FTC_SUCCESS;
-  DWORD dwNumTmsClocks = 0;
-  DWORD dwNumDevices;
-  FT2232CDeviceIndexes FT2232CIndexes;
+  DWORD dwDeviceIndex = 0;
 
   EnterCriticalSection(&threadAccess);
 
-  Status = FTC_GetNumDevices(&dwNumDevices, &FT2232CIndexes);
+  Status = FTC_IsDeviceHandleValid(ftHandle);
 
   if (Status == FTC_SUCCESS)
   {
-    if (dwNumDevices == 1)
-      // ftHandle parameter set to 0 to indicate only one device present in the system
-      Status = AddDeviceReadCommand(0, bInstructionTestData, dwNumBitsToRead, dwTapControllerState);
-    else
-      Status = FTC_TOO_MANY_DEVICES;
+    dwDeviceIndex = GetCommandsSequenceDataDeviceIndex(ftHandle);
+
+    *lpbCacheEnabled = OpenedDevicesCommandsSequenceData[dwDeviceIndex].bInstructionRegisterCacheEnabled;
+    *lpdwNumScansSkipped = OpenedDevicesCommandsSequenceData[dwDeviceIndex].dwNumInstructionRegisterScansSkipped;
   }
 
   LeaveCriticalSection(&threadAccess);
@@ -2435,27 +5179,48 @@ FTC_STATUS FT2232hMpsseJtag::JTAG_AddReadCommand(BOOL bInstructionTestData, DWOR
   return Status;
 }
 
-FTC_STATUS FT2232hMpsseJtag::JTAG_AddWriteReadCommand(BOOL bInstructionTestData, DWORD dwNumBitsToWriteRead,
-                                                      PWriteDataByteBuffer pWriteDataBuffer, DWORD dwNumBytesToWrite,
-                                                      DWORD dwTapControllerState)
+FTC_STATUS FT2232hMpsseJtag::JTAG_CreateScanTemplate(FTC_HANDLE ftHandle, PFTC_SCAN_TEMPLATE_SCAN pScans, DWORD dwNumScans,
+                                                     LPDWORD lpdwScanTemplate)
 {
   FTC_STATUS Status = FTC_SUCCESS;
-  DWORD dwNumCommandDataBytes = 0;
-  DWORD dwNumTmsClocks = 0;
-  DWORD dwNumDevices;
-  FT2232CDeviceIndexes FT2232CIndexes;
+  DWORD dwScanTemplateIndex = 0;
+  BOOL bScanTemplateFound = false;
 
   EnterCriticalSection(&threadAccess);
 
-  Status = FTC_GetNumDevices(&dwNumDevices, &FT2232CIndexes);
+  Status = FTC_IsDeviceHandleValid(ftHandle);
 
   if (Status == FTC_SUCCESS)
   {
-    if (dwNumDevices == 1)
-      // ftHandle parameter set to 0 to indicate only one device present in the system
-      Status = AddDeviceWriteReadCommand(0, bInstructionTestData, dwNumBitsToWriteRead, pWriteDataBuffer, dwNumBytesToWrite, dwTapControllerState);
+    if ((pScans != NULL) && (lpdwScanTemplate != NULL))
+    {
+      Status = CheckScanTemplateScans(pScans, dwNumScans);
+
+      if (Status == FTC_SUCCESS)
+      {
+        for (dwScanTemplateIndex = 0; ((dwScanTemplateIndex < MAX_NUM_SCAN_TEMPLATES) && !bScanTemplateFound); dwScanTemplateIndex++)
+        {
+          if (ScanTemplates[dwScanTemplateIndex].hDevice == 0)
+          {
+            bScanTemplateFound = true;
+
+            Status = CompileScanTemplate(&ScanTemplates[dwScanTemplateIndex], pScans, dwNumScans);
+
+            if (Status == FTC_SUCCESS)
+            {
+              ScanTemplates[dwScanTemplateIndex].hDevice = ftHandle;
+
+              *lpdwScanTemplate = (dwScanTemplateIndex + 1);
+            }
+          }
+        }
+
+        if (!bScanTemplateFound)
+          Status = FTC_TOO_MANY_SCAN_TEMPLATES;
+      }
+    }
     else
-      Status = FTC_TOO_MANY_DEVICES;
+      Status = FTC_NULL_SCAN_TEMPLATE_SCANS_POINTER;
   }
 
   LeaveCriticalSection(&threadAccess);
@@ -2463,83 +5228,126 @@ FTC_STATUS FT2232hMpsseJtag::JTAG_AddWriteReadCommand(BOOL bInstructionTestData,
   return Status;
 }
 
-FTC_STATUS FT2232hMpsseJtag::JTAG_ClearDeviceCommandSequence(FTC_HANDLE ftHandle)
+FTC_STATUS FT2232hMpsseJtag::JTAG_ExecuteScanTemplate(FTC_HANDLE ftHandle, DWORD dwScanTemplate, PScanTemplateWriteDataBuffers pWriteDataBuffers,
+                                                      PReadCmdSequenceDataByteBuffer pReadDataBuffer, LPDWORD lpdwNumBytesReturned)
 {
   FTC_STATUS Status = FTC_SUCCESS;
+  PFTC_SCAN_TEMPLATE_DATA pScanTemplate = NULL;
+  DWORD dwScanIndex = 0;
 
   EnterCriticalSection(&threadAccess);
 
   Status = FTC_IsDeviceHandleValid(ftHandle);
 
   if (Status == FTC_SUCCESS)
-    ClearDeviceCommandSequenceData(ftHandle);
+    Status = CheckCommandSequenceNotSubmitted(ftHandle);
+
+  if (Status == FTC_SUCCESS)
+  {
+    pScanTemplate = GetScanTemplate(ftHandle, dwScanTemplate);
+
+    if (pScanTemplate != NULL)
+    {
+      for (dwScanIndex = 0; ((dwScanIndex < pScanTemplate->dwNumScans) && (Status == FTC_SUCCESS)); dwScanIndex++)
+      {
+        if (pScanTemplate->Slots[dwScanIndex].dwScanType != SCAN_TEMPLATE_READ)
+        {
+          if ((pWriteDataBuffers == NULL) || ((*pWriteDataBuffers)[dwScanIndex] == NULL))
+            Status = FTC_NULL_WRITE_DATA_BUFFER_POINTER;
+        }
+      }
+
+      if ((Status == FTC_SUCCESS) && (pScanTemplate->dwNumReadDataBytes > 0) && (pReadDataBuffer == NULL))
+        Status = FTC_NULL_READ_DATA_BUFFER_POINTER;
+
+      if (Status == FTC_SUCCESS)
+        Status = ExecuteScanTemplate(ftHandle, pScanTemplate, pWriteDataBuffers, pReadDataBuffer, lpdwNumBytesReturned);
+    }
+    else
+      Status = FTC_INVALID_SCAN_TEMPLATE;
+  }
 
   LeaveCriticalSection(&threadAccess);
 
   return Status;
 }
 
-FTC_STATUS FT2232hMpsseJtag::JTAG_AddDeviceWriteCommand(FTC_HANDLE ftHandle, BOOL bInstructionTestData, DWORD dwNumBitsToWrite,
-                                                        PWriteDataByteBuffer pWriteDataBuffer, DWORD dwNumBytesToWrite,
-                                                        DWORD dwTapControllerState)
+FTC_STATUS FT2232hMpsseJtag::JTAG_DeleteScanTemplate(FTC_HANDLE ftHandle, DWORD dwScanTemplate)
 {
   FTC_STATUS Status = FTC_SUCCESS;
+  PFTC_SCAN_TEMPLATE_DATA pScanTemplate = NULL;
 
   EnterCriticalSection(&threadAccess);
 
   Status = FTC_IsDeviceHandleValid(ftHandle);
 
   if (Status == FTC_SUCCESS)
-    Status = AddDeviceWriteCommand(ftHandle, bInstructionTestData, dwNumBitsToWrite, pWriteDataBuffer, dwNumBytesToWrite, dwTapControllerState);
+  {
+    pScanTemplate = GetScanTemplate(ftHandle, dwScanTemplate);
+
+    if (pScanTemplate != NULL)
+      DeleteScanTemplate(pScanTemplate);
+    else
+      Status = FTC_INVALID_SCAN_TEMPLATE;
+  }
 
   LeaveCriticalSection(&threadAccess);
 
   return Status;
 }
 
-FTC_STATUS FT2232hMpsseJtag::JTAG_AddDeviceReadCommand(FTC_HANDLE ftHandle, BOOL bInstructionTestData, DWORD dwNumBitsToRead, DWORD dwTapControllerState)
+FTC_STATUS FT2232hMpsseJtag::JTAG_RecordCommandSequence(FTC_HANDLE ftHandle, LPDWORD lpdwRecordedCmdSequence)
 {
   FTC_STATUS Status = FTC_SUCCESS;
+  DWORD dwRecordedCmdSequenceIndex = 0;
+  BOOL bRecordedCmdSequenceFound = false;
 
   EnterCriticalSection(&threadAccess);
 
   Status = FTC_IsDeviceHandleValid(ftHandle);
 
   if (Status == FTC_SUCCESS)
-    Status = AddDeviceReadCommand(ftHandle, bInstructionTestData, dwNumBitsToRead, dwTapControllerState);
-
-  LeaveCriticalSection(&threadAccess);
+  {
+    iCommandsSequenceDataDeviceIndex = GetCommandsSequenceDataDeviceIndex(ftHandle);
 
-  return Status;
-}
+    if (OpenedDevicesCommandsSequenceData[iCommandsSequenceDataDeviceIndex].bStreamingEnabled)
+      Status = FTC_COMMAND_SEQUENCE_STREAMING;
+    else if (GetNumBytesInCommandsSequenceDataBuffer() > 0)
+    {
+      for (dwRecordedCmdSequenceIndex = 0; ((dwRecordedCmdSequenceIndex < MAX_NUM_RECORDED_CMD_SEQUENCES) && !bRecordedCmdSequenceFound); dwRecordedCmdSequenceIndex++)
+      {
+        if (!RecordedCommandSequences[dwRecordedCmdSequenceIndex].bRecorded)
+        {
+          bRecordedCmdSequenceFound = true;
 
-FTC_STATUS FT2232hMpsseJtag::JTAG_AddDeviceWriteReadCommand(FTC_HANDLE ftHandle, BOOL bInstructionTestData, DWORD dwNumBitsToWriteRead,
-                                                            PWriteDataByteBuffer pWriteDataBuffer, DWORD dwNumBytesToWrite,
-                                                            DWORD dwTapControllerState)
-{
-  FTC_STATUS Status = FTC_SUCCESS;
+          Status = RecordCommandsSequence(ftHandle, &RecordedCommandSequences[dwRecordedCmdSequenceIndex]);
 
-  EnterCriticalSection(&threadAccess);
+          if (Status == FTC_SUCCESS)
+            *lpdwRecordedCmdSequence = (dwRecordedCmdSequenceIndex + 1);
+        }
+      }
 
-  Status = FTC_IsDeviceHandleValid(ftHandle);
+      if (!bRecordedCmdSequenceFound)
+        Status = FTC_TOO_MANY_RECORDED_COMMAND_SEQUENCES;
+    }
+    else
+      Status = FTC_NO_COMMAND_SEQUENCE;
 
-  if (Status == FTC_SUCCESS)
-    Status = AddDeviceWriteReadCommand(ftHandle, bInstructionTestData, dwNumBitsToWriteRead, pWriteDataBuffer, dwNumBytesToWrite, dwTapControllerState);
+    iCommandsSequenceDataDeviceIndex = -1;
+  }
 
   LeaveCriticalSection(&threadAccess);
 
   return Status;
 }
 
-FTC_STATUS FT2232hMpsseJtag::JTAG_ExecuteCommandSequence(FTC_HANDLE ftHandle, PReadCmdSequenceDataByteBuffer pReadCmdSequenceDataBuffer,
-                                                         LPDWORD lpdwNumBytesReturned)
+FTC_STATUS FT2232hMpsseJtag::JTAG_ExecuteRecordedCommandSequence(FTC_HANDLE ftHandle, DWORD dwRecordedCmdSequence,
+                                                                 PReadCmdSequenceDataByteBuffer pReadCmdSequenceDataBuffer,
+                                                                 LPDWORD lpdwNumBytesReturned)
 {
   FTC_STATUS Status = FTC_SUCCESS;
-  DWORD dwNumCmdSequenceBytes = 0;
-  DWORD dwCmdSequenceByteIndex = 0;
-  InputByteBuffer InputBuffer;
-  DWORD dwTotalNumBytesToBeRead = 0;
-  DWORD dwNumBytesRead = 0;
+  PFTC_RECORDED_CMD_SEQUENCE_DATA pRecordedCmdSequence = NULL;
+  BOOL bHiSpeedDevice = false;
 
   EnterCriticalSection(&threadAccess);
 
@@ -2547,55 +5355,44 @@ FTC_STATUS FT2232hMpsseJtag::JTAG_ExecuteCommandSequence(FTC_HANDLE ftHandle, PR
 
   if (Status == FTC_SUCCESS)
   {
-    if (pReadCmdSequenceDataBuffer != NULL)
-    {
-      iCommandsSequenceDataDeviceIndex = GetCommandsSequenceDataDeviceIndex(ftHandle);
+    pRecordedCmdSequence = GetRecordedCommandsSequence(dwRecordedCmdSequence);
 
-      dwNumCmdSequenceBytes = GetNumBytesInCommandsSequenceDataBuffer();
-
-      if (dwNumCmdSequenceBytes > 0)
-      {
-        AddByteToOutputBuffer(SEND_ANSWER_BACK_IMMEDIATELY_CMD, false);
-
-        FTC_ClearOutputBuffer();
-
-        dwNumCmdSequenceBytes = GetNumBytesInCommandsSequenceDataBuffer();
-          
-        // Transfer sequence of commands for specified device to output buffer for transmission to device
-        for (dwCmdSequenceByteIndex = 0; (dwCmdSequenceByteIndex < dwNumCmdSequenceBytes); dwCmdSequenceByteIndex++)
-          FTC_AddByteToOutputBuffer((*OpenedDevicesCommandsSequenceData[iCommandsSequenceDataDeviceIndex].pCommandsSequenceDataOutPutBuffer)[dwCmdSequenceByteIndex], false);
+    if (pRecordedCmdSequence != NULL)
+    {
+      bHiSpeedDevice = (FTC_IsHiSpeedDeviceHandleValid(ftHandle) == FTC_SUCCESS);
+
+      // The bytes returned by a submitted sequence have to be read first
+      if (OpenedDevicesCommandsSequenceData[GetCommandsSequenceDataDeviceIndex(ftHandle)].bCommandSequenceSubmitted)
+        Status = FTC_COMMAND_SEQUENCE_SUBMITTED;
+      else if (pRecordedCmdSequence->bHiSpeedDevice != bHiSpeedDevice)
+        Status = FTC_INCOMPATIBLE_RECORDED_COMMAND_SEQUENCE;
+      else if ((pRecordedCmdSequence->dwNumReadCommandSequences > 0) && (pReadCmdSequenceDataBuffer == NULL))
+        Status = FTC_NULL_READ_CMDS_DATA_BUFFER_POINTER;
+      else
+        Status = ExecuteRecordedCommandsSequence(ftHandle, pRecordedCmdSequence, pReadCmdSequenceDataBuffer, lpdwNumBytesReturned);
+    }
+    else
+      Status = FTC_INVALID_RECORDED_COMMAND_SEQUENCE;
+  }
 
-        OpenedDevicesCommandsSequenceData[iCommandsSequenceDataDeviceIndex].dwNumBytesToSend = 0;
+  LeaveCriticalSection(&threadAccess);
 
-        Status = FTC_SendCommandsSequenceToDevice(ftHandle);
+  return Status;
+}
 
-        if (Status == FTC_SUCCESS)
-        {
-          if (OpenedDevicesCommandsSequenceData[iCommandsSequenceDataDeviceIndex].dwNumReadCommandSequences > 0)
-          {
-            // Calculate the total number of bytes to be read, as a result of a command sequence
-            dwTotalNumBytesToBeRead = GetTotalNumCommandsSequenceDataBytesToRead();
+FTC_STATUS FT2232hMpsseJtag::JTAG_DeleteRecordedCommandSequence(DWORD dwRecordedCmdSequence)
+{
+  FTC_STATUS Status = FTC_SUCCESS;
+  PFTC_RECORDED_CMD_SEQUENCE_DATA pRecordedCmdSequence = NULL;
 
-            Status = FTC_ReadCommandsSequenceBytesFromDevice(ftHandle, &InputBuffer, dwTotalNumBytesToBeRead, &dwNumBytesRead);
-        
-            if (Status == FTC_SUCCESS)
-            {
-              // Process all bytes received and return them in the read data buffer
-              ProcessReadCommandsSequenceBytes(&InputBuffer, dwNumBytesRead, pReadCmdSequenceDataBuffer, lpdwNumBytesReturned);
-            }
-          }
-        }
+  EnterCriticalSection(&threadAccess);
 
-        OpenedDevicesCommandsSequenceData[iCommandsSequenceDataDeviceIndex].dwNumReadCommandSequences = 0;
-      }
-      else
-        Status = FTC_NO_COMMAND_SEQUENCE;
+  pRecordedCmdSequence = GetRecordedCommandsSequence(dwRecordedCmdSequence);
 
-      iCommandsSequenceDataDeviceIndex = -1;
-    }
-    else
-      Status = FTC_NULL_READ_CMDS_DATA_BUFFER_POINTER;
-  }
+  if (pRecordedCmdSequence != NULL)
+    DeleteRecordedCommandsSequence(pRecordedCmdSequence);
+  else
+    Status = FTC_INVALID_RECORDED_COMMAND_SEQUENCE;
 
   LeaveCriticalSection(&threadAccess);
 
@@ -2638,12 +5435,15 @@ FTC_STATUS FT2232hMpsseJtag::JTAG_GetErrorCodeString(LPSTR lpLanguage, FTC_STATU
       szErrorMsg[iCharCntr] = '\0';
 
     if (((StatusCode >= FTC_SUCCESS) && (StatusCode <= FTC_INSUFFICIENT_RESOURCES)) ||
-        ((StatusCode >= FTC_FAILED_TO_COMPLETE_COMMAND) && (StatusCode <= FTC_INVALID_STATUS_CODE)))
+        ((StatusCode >= FTC_FAILED_TO_COMPLETE_COMMAND) && (StatusCode <= FTC_INVALID_STATUS_CODE)) ||
+        ((StatusCode >= FTC_FIRST_EXTENDED_STATUS_CODE) && (StatusCode <= FTC_LAST_EXTENDED_STATUS_CODE)))
     {
       if (strcmp(lpLanguage, ENGLISH) == 0)
       {
         if ((StatusCode >= FTC_SUCCESS) && (StatusCode <= FTC_INSUFFICIENT_RESOURCES))
           strcpy(szErrorMsg, EN_Common_Errors[StatusCode]);
+        else if (StatusCode >= FTC_FIRST_EXTENDED_STATUS_CODE)
+          strcpy(szErrorMsg, EN_Extended_Errors[(StatusCode - FTC_FIRST_EXTENDED_STATUS_CODE)]);
         else
           strcpy(szErrorMsg, EN_New_Errors[(StatusCode - FTC_FAILED_TO_COMPLETE_COMMAND)]);
       }
@@ -67,6 +67,9 @@ const BYTE FT_ERROR_VALUE = 0;
 #define MAX_NUM_TIMES_EIGHT_CLOCK_PULSES 250000000  // specifies the maximum number of clock pulses that a FT2232H hi-speed device or FT4232H hi-speed device can generate
 
 #define NUM_BYTE_CLOCK_PULSES_BLOCK_SIZE 32000 //4000
+#define MAX_NUM_TIMES_EIGHT_CLOCK_PULSES_CMD 65536  // specifies the maximum number of eight clock pulses generated by one clock for times eight clocks command
+
+#define MAX_NUM_IDLE_CYCLES 65536  // specifies the maximum number of Run-Test/Idle cycles that can follow a write, read or write/read
 
 #define PIN1_HIGH_VALUE  1
 #define PIN2_HIGH_VALUE  2
@@ -80,6 +83,7 @@ const BYTE FT_ERROR_VALUE = 0;
 #define NUM_WRITE_COMMAND_BYTES 18
 #define NUM_READ_COMMAND_BYTES 18
 #define NUM_WRITE_READ_COMMAND_BYTES 19
+#define NUM_IDLE_CYCLES_COMMAND_BYTES 6
 
 #define MAX_ERROR_MSG_SIZE 250
 
@@ -132,6 +136,35 @@ const char EN_New_Errors[(FTC_INVALID_STATUS_CODE - FTC_FAILED_TO_COMPLETE_COMMA
     "Unsupported language code.",
     "Unknown status code = "};
 
+#define FTC_FIRST_EXTENDED_STATUS_CODE FTC_INVALID_TRANSPORT_TYPE
+#define FTC_LAST_EXTENDED_STATUS_CODE FTC_INCOMPATIBLE_RECORDED_COMMAND_SEQUENCE
+
+const char EN_Extended_Errors[(FTC_LAST_EXTENDED_STATUS_CODE - FTC_FIRST_EXTENDED_STATUS_CODE) + 1][MAX_ERROR_MSG_SIZE] = {
+    "Invalid transport type. Valid values are 0 (D2XX), 1 (libusb) and 2 (MPSSE emulator).",
+    "Transport type not supported by this build of the library.",
+    "Invalid number of queued transfers. Valid range is 1 - 16.",
+    "Function not supported by the transport used by the device.",
+    "Invalid wait policy. Valid values are 0 (spin), 1 (block) and 2 (hybrid).",
+    "Invalid spin period. Valid range is 0 - 1000000 microseconds.",
+    "Invalid USB transfer chunk size. Valid values are 0 (automatic) and 64 - 65536.",
+    "Invalid command timeout. Valid range is 1 - 3600000 milliseconds.",
+    "A submitted command sequence has not been reaped.",
+    "The submitted command sequence has not completed yet.",
+    "Completion file descriptors are not supported on this platform.",
+    "Too many scan templates. Up to 64 scan templates can be created.",
+    "Invalid scan template.",
+    "Invalid number of scans. Valid range is 1 - 16.",
+    "Invalid scan type. Valid values are 0 (write), 1 (read) and 2 (write/read).",
+    "Pointer to scan template scans buffer is null.",
+    "The data read back does not match the expected data.",
+    "Pointer to expected data buffer is null.",
+    "Invalid number of idle cycles.",
+    "Command sequence is streamed, it can only be executed.",
+    "Invalid command sequence ticket.",
+    "Too many recorded command sequences. Maximum number is 64.",
+    "Invalid recorded command sequence.",
+    "Recorded command sequence was recorded for a different type of device."};
+
 const BYTE CLK_DATA_BYTES_OUT_ON_NEG_CLK_LSB_FIRST_CMD = '\x19';
 const BYTE CLK_DATA_BITS_OUT_ON_NEG_CLK_LSB_FIRST_CMD = '\x1B';
 const BYTE CLK_DATA_BYTES_IN_ON_POS_CLK_LSB_FIRST_CMD = '\x28';
@@ -154,48 +187,196 @@ const BYTE CLK_FOR_TIMES_EIGHT_CLOCKS_NO_DATA_BYTES_CMD = '\x8F';
 const BYTE CLK_FOR_TIMES_EIGHT_CLOCKS_GPIOL2_HIGH_NO_DATA_BYTES_CMD = '\x98';
 const BYTE CLK_FOR_TIMES_EIGHT_CLOCKS_GPIOL2_LOW_NO_DATA_BYTES_CMD = '\x99';
 
-
-enum JtagStates {TestLogicReset, RunTestIdle, PauseDataRegister, PauseInstructionRegister, ShiftDataRegister, ShiftInstructionRegister, Undefined};
-
-#define NUM_JTAG_TMS_STATES 6
-
-// go from current JTAG state to new JTAG state ->                    tlr     rti     pdr     pir     sdr     sir
-const BYTE TestLogicResetToNewJTAGState[NUM_JTAG_TMS_STATES]      = {'\x01', '\x00', '\x0A', '\x16', '\x02', '\x06'};
-const BYTE RunTestIdleToNewJTAGState[NUM_JTAG_TMS_STATES]         = {'\x07', '\x00', '\x05', '\x0B', '\x01', '\x03'};
-const BYTE PauseDataRegToNewJTAGState[NUM_JTAG_TMS_STATES]        = {'\x1F', '\x03', '\x17', '\x2F', '\x01', '\x0F'};
-const BYTE PauseInstructionRegToNewJTAGState[NUM_JTAG_TMS_STATES] = {'\x1F', '\x03', '\x17', '\x2F', '\x07', '\x01'};
-const BYTE ShiftDataRegToNewJTAGState[NUM_JTAG_TMS_STATES]        = {'\x1F', '\x03', '\x01', '\x2F', '\x00', '\x00'};
-const BYTE ShiftInstructionRegToNewJTAGState[NUM_JTAG_TMS_STATES] = {'\x1F', '\x03', '\x17', '\x01', '\x00', '\x00'};
-
-// number of TMS clocks to go from current JTAG state to new JTAG state ->       tlr rti pdr pir sdr sir
-const BYTE TestLogicResetToNewJTAGStateNumTMSClocks[NUM_JTAG_TMS_STATES]      = {1,  1,  5,  6,  4,  5};
-const BYTE RunTestIdleToNewJTAGStateNumTMSClocks[NUM_JTAG_TMS_STATES]         = {3,  5,  4,  5,  3,  4};
-const BYTE PauseDataRegToNewJTAGStateNumTMSClocks[NUM_JTAG_TMS_STATES]        = {5,  3,  6,  7,  2,  6};
-const BYTE PauseInstructionRegToNewJTAGStateNumTMSClocks[NUM_JTAG_TMS_STATES] = {5,  3,  6,  7,  5,  2};
-const BYTE ShiftDataRegToNewJTAGStateNumTMSClocks[NUM_JTAG_TMS_STATES]        = {5,  3,  2,  7,  0,  0};
-const BYTE ShiftInstructionRegToNewJTAGStateNumTMSClocks[NUM_JTAG_TMS_STATES] = {5,  4,  6,  2,  0,  0};
+#define MAX_NUM_TMS_CLOCKS 7                  // maximum number of TMS clocks in one TMS command
+#define NUM_TMS_CLOCKS_TO_TEST_LOGIC_RESET 5  // TMS high for this many clocks reaches test logic reset from any state
+#define MAX_NUM_BYTE_SHIFT_DATA_BYTES 65536   // maximum number of bytes clocked by one byte shift command
+
+// A streaming scan reads back one byte shift command of data bytes at a time, plus the remaining data bits byte and
+// the TMS read byte at the end of the scan
+#define STREAM_SCAN_READ_BUFFER_SIZE (MAX_NUM_BYTE_SHIFT_DATA_BYTES + 2)
+
+// A compared scan is sent in blocks of this many data bytes, each block is compared while the next one is clocked
+#define COMPARE_SCAN_BLOCK_NUM_DATA_BYTES 4096
+
+
+enum JtagStates {TestLogicReset, RunTestIdle, PauseDataRegister, PauseInstructionRegister, ShiftDataRegister, ShiftInstructionRegister,
+                 SelectDataRegisterScan, CaptureDataRegister, Exit1DataRegister, Exit2DataRegister, UpdateDataRegister,
+                 SelectInstructionRegisterScan, CaptureInstructionRegister, Exit1InstructionRegister, Exit2InstructionRegister,
+                 UpdateInstructionRegister, Undefined};
+
+#define NUM_JTAG_TMS_STATES 16
+
+// The longest of the shortest paths between two JTAG states, ie pause data register to exit2 instruction register
+#define MAX_NUM_JTAG_PATH_TMS_CLOCKS 8
+
+#define NO_JTAG_PATH 0xFF
+
+// JTAG state reached from the current JTAG state by one TMS clock ->           TMS low                     TMS high
+constexpr BYTE NextJTAGState[NUM_JTAG_TMS_STATES][2] = {/* tlr   */ {RunTestIdle,                TestLogicReset},
+                                                        /* rti   */ {RunTestIdle,                SelectDataRegisterScan},
+                                                        /* pdr   */ {PauseDataRegister,          Exit2DataRegister},
+                                                        /* pir   */ {PauseInstructionRegister,   Exit2InstructionRegister},
+                                                        /* sdr   */ {ShiftDataRegister,          Exit1DataRegister},
+                                                        /* sir   */ {ShiftInstructionRegister,   Exit1InstructionRegister},
+                                                        /* seldr */ {CaptureDataRegister,        SelectInstructionRegisterScan},
+                                                        /* cdr   */ {ShiftDataRegister,          Exit1DataRegister},
+                                                        /* e1dr  */ {PauseDataRegister,          UpdateDataRegister},
+                                                        /* e2dr  */ {ShiftDataRegister,          UpdateDataRegister},
+                                                        /* udr   */ {RunTestIdle,                SelectDataRegisterScan},
+                                                        /* selir */ {CaptureInstructionRegister, TestLogicReset},
+                                                        /* cir   */ {ShiftInstructionRegister,   Exit1InstructionRegister},
+                                                        /* e1ir  */ {PauseInstructionRegister,   UpdateInstructionRegister},
+                                                        /* e2ir  */ {ShiftInstructionRegister,   UpdateInstructionRegister},
+                                                        /* uir   */ {RunTestIdle,                SelectDataRegisterScan}};
+
+// Returns the number of TMS clocks on the shortest path from the current JTAG state to the new JTAG state, searching
+// no further than the specified number of TMS clocks, or NO_JTAG_PATH if there is no path that short
+constexpr DWORD GetJTAGPathNumTMSClocks(DWORD dwCurrentJtagState, DWORD dwNewJtagState, DWORD dwMaxNumTmsClocks)
+{
+  return (dwCurrentJtagState == dwNewJtagState) ? 0 :
+         (dwMaxNumTmsClocks == 0) ? NO_JTAG_PATH :
+         ((GetJTAGPathNumTMSClocks(NextJTAGState[dwCurrentJtagState][0], dwNewJtagState, (dwMaxNumTmsClocks - 1)) <=
+           GetJTAGPathNumTMSClocks(NextJTAGState[dwCurrentJtagState][1], dwNewJtagState, (dwMaxNumTmsClocks - 1))) ?
+          (GetJTAGPathNumTMSClocks(NextJTAGState[dwCurrentJtagState][0], dwNewJtagState, (dwMaxNumTmsClocks - 1)) + 1) :
+          (GetJTAGPathNumTMSClocks(NextJTAGState[dwCurrentJtagState][1], dwNewJtagState, (dwMaxNumTmsClocks - 1)) + 1));
+}
+
+// Returns the TMS bits, first clock in bit 0, of the shortest path from the current JTAG state to the new JTAG state,
+// taking TMS low where two paths are equally short
+constexpr DWORD GetJTAGPathTMSBits(DWORD dwCurrentJtagState, DWORD dwNewJtagState, DWORD dwMaxNumTmsClocks)
+{
+  return ((dwCurrentJtagState == dwNewJtagState) || (dwMaxNumTmsClocks == 0)) ? 0 :
+         (GetJTAGPathNumTMSClocks(NextJTAGState[dwCurrentJtagState][0], dwNewJtagState, (dwMaxNumTmsClocks - 1)) <=
+          GetJTAGPathNumTMSClocks(NextJTAGState[dwCurrentJtagState][1], dwNewJtagState, (dwMaxNumTmsClocks - 1))) ?
+         (GetJTAGPathTMSBits(NextJTAGState[dwCurrentJtagState][0], dwNewJtagState, (dwMaxNumTmsClocks - 1)) << 1) :
+         ((GetJTAGPathTMSBits(NextJTAGState[dwCurrentJtagState][1], dwNewJtagState, (dwMaxNumTmsClocks - 1)) << 1) | 1);
+}
+
+#define JTAG_PATH_TABLE_ROW(Function, CurrentJtagState) \
+  {Function(CurrentJtagState, 0, MAX_NUM_JTAG_PATH_TMS_CLOCKS),  Function(CurrentJtagState, 1, MAX_NUM_JTAG_PATH_TMS_CLOCKS),  \
+   Function(CurrentJtagState, 2, MAX_NUM_JTAG_PATH_TMS_CLOCKS),  Function(CurrentJtagState, 3, MAX_NUM_JTAG_PATH_TMS_CLOCKS),  \
+   Function(CurrentJtagState, 4, MAX_NUM_JTAG_PATH_TMS_CLOCKS),  Function(CurrentJtagState, 5, MAX_NUM_JTAG_PATH_TMS_CLOCKS),  \
+   Function(CurrentJtagState, 6, MAX_NUM_JTAG_PATH_TMS_CLOCKS),  Function(CurrentJtagState, 7, MAX_NUM_JTAG_PATH_TMS_CLOCKS),  \
+   Function(CurrentJtagState, 8, MAX_NUM_JTAG_PATH_TMS_CLOCKS),  Function(CurrentJtagState, 9, MAX_NUM_JTAG_PATH_TMS_CLOCKS),  \
+   Function(CurrentJtagState, 10, MAX_NUM_JTAG_PATH_TMS_CLOCKS), Function(CurrentJtagState, 11, MAX_NUM_JTAG_PATH_TMS_CLOCKS), \
+   Function(CurrentJtagState, 12, MAX_NUM_JTAG_PATH_TMS_CLOCKS), Function(CurrentJtagState, 13, MAX_NUM_JTAG_PATH_TMS_CLOCKS), \
+   Function(CurrentJtagState, 14, MAX_NUM_JTAG_PATH_TMS_CLOCKS), Function(CurrentJtagState, 15, MAX_NUM_JTAG_PATH_TMS_CLOCKS)}
+
+#define JTAG_PATH_TABLE(Function) \
+  {JTAG_PATH_TABLE_ROW(Function, 0),  JTAG_PATH_TABLE_ROW(Function, 1),  JTAG_PATH_TABLE_ROW(Function, 2),  \
+   JTAG_PATH_TABLE_ROW(Function, 3),  JTAG_PATH_TABLE_ROW(Function, 4),  JTAG_PATH_TABLE_ROW(Function, 5),  \
+   JTAG_PATH_TABLE_ROW(Function, 6),  JTAG_PATH_TABLE_ROW(Function, 7),  JTAG_PATH_TABLE_ROW(Function, 8),  \
+   JTAG_PATH_TABLE_ROW(Function, 9),  JTAG_PATH_TABLE_ROW(Function, 10), JTAG_PATH_TABLE_ROW(Function, 11), \
+   JTAG_PATH_TABLE_ROW(Function, 12), JTAG_PATH_TABLE_ROW(Function, 13), JTAG_PATH_TABLE_ROW(Function, 14), \
+   JTAG_PATH_TABLE_ROW(Function, 15)}
+
+// TMS bits and number of TMS clocks to go from the current JTAG state to the new JTAG state, indexed by the current
+// JTAG state then the new JTAG state
+constexpr BYTE CurrentToNewJTAGState[NUM_JTAG_TMS_STATES][NUM_JTAG_TMS_STATES] = JTAG_PATH_TABLE(GetJTAGPathTMSBits);
+constexpr BYTE CurrentToNewJTAGStateNumTMSClocks[NUM_JTAG_TMS_STATES][NUM_JTAG_TMS_STATES] = JTAG_PATH_TABLE(GetJTAGPathNumTMSClocks);
+
+static_assert(CurrentToNewJTAGStateNumTMSClocks[PauseDataRegister][Exit2InstructionRegister] == MAX_NUM_JTAG_PATH_TMS_CLOCKS,
+              "every JTAG state must be reachable from every other JTAG state");
 
 #define NO_LAST_DATA_BIT 0
 
-#define NUM_COMMAND_SEQUENCE_READ_DATA_BYTES 2
 #define INIT_COMMAND_SEQUENCE_READ_DATA_BUFFER_SIZE 100
-#define COMMAND_SEQUENCE_READ_DATA_BUFFER_SIZE_INCREMENT 10
 
-typedef DWORD ReadCommandSequenceData[NUM_COMMAND_SEQUENCE_READ_DATA_BYTES];
-typedef ReadCommandSequenceData *PReadCommandSequenceData;
+typedef struct Ft_Read_Cmd_Sequence_Data{
+  DWORD dwNumBitsToRead;
+  DWORD dwNumTmsClocks;
+  DWORD dwNumReadDataBytes;                         // number of bytes the read command returns from the device
+  DWORD dwReadDataByteOffset;                       // offset of those bytes in all the bytes the sequence returns
+  DWORD dwReturnedDataByteOffset;                   // offset of the data read in the caller's read data buffer
+}FTC_READ_CMD_SEQUENCE_DATA, *PFTC_READ_CMD_SEQUENCE_DATA;
+
+// Instruction registers up to this long are cached, longer ones are always written
+#define MAX_NUM_CACHED_INSTRUCTION_REGISTER_BITS 256
+#define MAX_NUM_CACHED_INSTRUCTION_REGISTER_BYTES (MAX_NUM_CACHED_INSTRUCTION_REGISTER_BITS / 8)
+
+// A streamed command sequence is sent once its commands or the bytes they read would exceed this
+#define STREAMING_CMD_SEQUENCE_SEGMENT_SIZE MAX_USB_TRANSFER_CHUNK_SIZE
 
-typedef PReadCommandSequenceData ReadCommandsSequenceData[1];
-typedef ReadCommandsSequenceData *PReadCommandsSequenceData;
+#define COMPLETION_WATCH_PERIOD 10  // 10 milliseconds, longest wait on one device while others have sequences submitted
+#define COMPLETION_POLL_PERIOD 1    // 1 millisecond, for transports that can not be waited on concurrently
 
 typedef struct Ft_Device_Cmd_Sequence_Data{
   DWORD hDevice;                                    // handle to the opened and initialized FT2232C dual type device
   DWORD dwNumBytesToSend;
   POutputByteBuffer pCommandsSequenceDataOutPutBuffer;
   DWORD dwSizeReadCommandsSequenceDataBuffer;
-  PReadCommandsSequenceData pReadCommandsSequenceDataBuffer;
+  PFTC_READ_CMD_SEQUENCE_DATA pReadCommandsSequenceDataBuffer;
   DWORD dwNumReadCommandSequences;
+  BOOL bCommandSequenceSubmitted;                   // sequence sent by JTAG_SubmitCmdSequence, not reaped yet
+  DWORD dwNumSubmittedReadBytes;                    // number of bytes the submitted sequence will return
+  DWORD dwSizeSubmittedReadCommandsSequenceDataBuffer;
+  PFTC_READ_CMD_SEQUENCE_DATA pSubmittedReadCommandsSequenceDataBuffer;  // read commands of the submitted sequence
+  DWORD dwNumSubmittedReadCommandSequences;
+  DWORD dwSubmittedCommandSequenceTicket;
+  DWORD dwNextCommandSequenceTicket;
+  FTC_STATUS CompletionStatus;                      // error found by the completion watcher, returned when reaped
+  INT iCompletionFd;                                // eventfd readable once the submitted sequence can be reaped, -1 if none
+  BOOL bCompletionSignalled;
+  BOOL bCompletionWatched;                          // the completion watcher is waiting on the device's transport
+  BOOL bOptimizerEnabled;                           // sequences are optimized before they are sent to the device
+  DWORD dwNumOptimizerBytesSaved;                   // total number of command bytes removed by the optimizer
+  BOOL bInstructionRegisterCacheEnabled;            // instruction register writes of the value already held are skipped
+  BOOL bInstructionRegisterCacheValid;              // the instruction register is known to hold the cached value
+  DWORD dwNumInstructionRegisterBits;
+  BYTE InstructionRegisterBytes[MAX_NUM_CACHED_INSTRUCTION_REGISTER_BYTES];
+  DWORD dwNumInstructionRegisterScansSkipped;       // total number of instruction register writes skipped
+  BOOL bStreamingEnabled;                           // sequence is sent in segments as it is built
+  PFTC_SCAN_DATA_SINK pStreamingDataSink;           // passed the bytes read by each segment of a streamed sequence
+  LPVOID pStreamingContext;
+  PInputByteBuffer pStreamingInputBuffer;           // bytes read by a segment, only allocated while streaming is enabled
+  PReadCmdSequenceDataByteBuffer pStreamingReadDataBuffer;  // realigned bytes of a segment passed to the sink
+  PInputByteBuffer pReplayInputBuffer;              // bytes read by recorded sequences, allocated by the first replay
+  DWORD dwNumStreamedReadBytes;                     // number of bytes passed to the sink by the sequence being built
+  JtagStates StartJtagState;                        // state the first command of the sequence being built starts from
 }FTC_DEVICE_CMD_SEQUENCE_DATA, *PFTC_DEVICE_CMD_SEQUENCE_DATA;
 
+#define MAX_NUM_SCAN_TEMPLATES 64
+
+#define NO_SCAN_TEMPLATE_SLOT 0xFFFFFFFF
+
+// Where the data of one scan goes in the commands of a scan template and where the data read by the scan comes back
+typedef struct Ft_Scan_Template_Slot{
+  DWORD dwScanType;
+  DWORD dwDataBytesIndex;                           // index of the template command the whole data bytes go in front of
+  DWORD dwNumDataBytes;                             // number of whole data bytes clocked by the byte shift command
+  DWORD dwDataBitsIndex;                            // index of the data byte of the bit shift command, or no slot
+  DWORD dwLastDataBitIndex;                         // index of the TMS command byte the last data bit goes out with, or no slot
+  DWORD dwLastDataBitShift;                         // position of the last data bit in the last write data byte
+  DWORD dwNumReadDataBytes;                         // number of bytes returned by the scan, including the TMS read byte
+  DWORD dwNumRemainingDataBits;
+  DWORD dwNumTmsClocks;
+}FTC_SCAN_TEMPLATE_SLOT, *PFTC_SCAN_TEMPLATE_SLOT;
+
+typedef struct Ft_Scan_Template_Data{
+  DWORD hDevice;                                    // handle of the device the template was created for, 0 if not used
+  LPBYTE pCommandBytes;                             // commands of every scan, without the whole data bytes
+  DWORD dwNumCommandBytes;
+  DWORD dwNumScans;
+  FTC_SCAN_TEMPLATE_SLOT Slots[MAX_NUM_SCAN_TEMPLATE_SCANS];
+  JtagStates StartJtagState;                        // shift state the first scan starts in
+  JtagStates EndJtagState;                          // state the last scan ends in
+  DWORD dwNumReadDataBytes;                         // total number of bytes returned by the scans
+}FTC_SCAN_TEMPLATE_DATA, *PFTC_SCAN_TEMPLATE_DATA;
+
+#define MAX_NUM_RECORDED_CMD_SEQUENCES 64
+
+typedef struct Ft_Recorded_Cmd_Sequence_Data{
+  BOOL bRecorded;                                   // false if not used
+  BOOL bHiSpeedDevice;                              // type of device the sequence was recorded for
+  LPBYTE pCommandBytes;                             // optimized commands of the sequence, ready to be sent
+  DWORD dwNumCommandBytes;
+  PFTC_READ_CMD_SEQUENCE_DATA pReadCommandsSequenceData;
+  DWORD dwNumReadCommandSequences;
+  DWORD dwNumReadDataBytes;                         // total number of bytes returned by the read commands
+  JtagStates StartJtagState;                        // state the sequence starts from, undefined if it resets the TAP controller
+  JtagStates EndJtagState;
+}FTC_RECORDED_CMD_SEQUENCE_DATA, *PFTC_RECORDED_CMD_SEQUENCE_DATA;
+
 
 //----------------------------------------------------------------------------
 class FT2232hMpsseJtag : private FT2232h
@@ -212,10 +393,27 @@ private:
   DWORD dwNumOpenedDevices;
   FTC_DEVICE_CMD_SEQUENCE_DATA OpenedDevicesCommandsSequenceData[MAX_NUM_DEVICES];
   INT iCommandsSequenceDataDeviceIndex;
+  FTC_SCAN_TEMPLATE_DATA ScanTemplates[MAX_NUM_SCAN_TEMPLATES];
+  FTC_RECORDED_CMD_SEQUENCE_DATA RecordedCommandSequences[MAX_NUM_RECORDED_CMD_SEQUENCES];
+
+#ifndef _WIN32
+  // One thread watches every device with a completion fd and a submitted command sequence. It sleeps in the
+  // transport of one device at a time without holding the threadAccess object, and waits on the
+  // CommandSequenceSubmitted condition when there is nothing to watch. A device is not closed or given another
+  // transport until the watcher has signalled the CompletionWatchEnded condition.
+  pthread_t CompletionWatcherThread;
+  pthread_cond_t CommandSequenceSubmitted;
+  pthread_cond_t CompletionWatchEnded;
+  BOOL bCompletionWatcherStarted;
+  BOOL bStopCompletionWatcher;
+#endif
 
   FTC_STATUS CheckWriteDataToExternalDeviceBitsBytesParameters(DWORD dwNumBitsToWrite, DWORD dwNumBytesToWrite);
 
   void       AddByteToOutputBuffer(DWORD dwOutputByte, BOOL bClearOutputBuffer);
+  void       AddDataBytesToOutputBuffer(LPBYTE pDataBytes, DWORD dwNumDataBytes);
+  LPBYTE     GetOutputBufferEnd(void);
+  void       CommitOutputBufferBytes(DWORD dwNumBytes);
 
   FTC_STATUS SetTCKTDITMSPinsCloseState(FTC_HANDLE ftHandle, PFTC_CLOSE_FINAL_STATE_PINS pCloseFinalStatePinsData);
   FTC_STATUS InitDevice(FTC_HANDLE ftHandle, DWORD dwClockDivisor);
@@ -244,51 +442,118 @@ private:
                                                            PFTC_LOW_HIGH_PINS pLowPinsInputData,
                                                            BOOL bControlHighInputOutputPins,
                                                            PFTH_LOW_HIGH_PINS pHighPinsInputData);
-  void       AddWriteCommandDataToOutPutBuffer(BOOL bInstructionTestData, DWORD dwNumBitsToWrite,
+  FTC_STATUS CheckIdleCyclesParameters(DWORD dwNumIdleCycles, DWORD dwTapControllerState);
+  DWORD      GetNumIdleCyclesCommandBytes(DWORD dwNumIdleCycles);
+  DWORD      AddIdleCyclesToOutputBuffer(FTC_HANDLE ftHandle, DWORD dwNumTmsClocks, DWORD dwNumIdleCycles);
+  DWORD      AddWriteCommandDataToOutPutBuffer(BOOL bInstructionTestData, DWORD dwNumBitsToWrite,
                                                PWriteDataByteBuffer pWriteDataBuffer, DWORD dwNumBytesToWrite,
                                                DWORD dwTapControllerState);
   FTC_STATUS WriteDataToExternalDevice(FTC_HANDLE ftHandle, BOOL bInstructionData, DWORD dwNumBitsToWrite,
                                        PWriteDataByteBuffer pWriteDataBuffer, DWORD dwNumBytesToWrite,
-                                       DWORD dwTapControllerState);
+                                       DWORD dwTapControllerState, DWORD dwNumIdleCycles);
   void       GetNumDataBytesToRead(DWORD dwNumBitsToRead, LPDWORD lpdwNumDataBytesToRead, LPDWORD lpdwNumRemainingDataBits);
   FTC_STATUS GetDataFromExternalDevice(FTC_HANDLE ftHandle, DWORD dwNumBitsToRead, DWORD dwNumTmsClocks,
                                        PReadDataByteBuffer pReadDataBuffer, LPDWORD lpdwNumBytesReturned);
+  DWORD      ExtractReadDataBits(LPBYTE pDestination, DWORD dwDestinationBitOffset, LPBYTE pReadDataBytes,
+                                 DWORD dwNumReadDataBytes, DWORD dwNumRemainingDataBits, DWORD dwNumTmsClocks);
+  DWORD      AdjustLastReadDataBytes(LPBYTE pReadDataBytes, DWORD dwNumReadDataBytes, DWORD dwNumRemainingDataBits,
+                                     DWORD dwNumTmsClocks);
   DWORD      AddReadCommandToOutputBuffer(BOOL bInstructionTestData, DWORD dwNumBitsToRead, DWORD dwTapControllerState);
   FTC_STATUS ReadDataFromExternalDevice(FTC_HANDLE ftHandle, BOOL bInstructionTestData, DWORD dwNumBitsToRead,
                                         PReadDataByteBuffer pReadDataBuffer, LPDWORD lpdwNumBytesReturned,
-                                        DWORD dwTapControllerState);
+                                        DWORD dwTapControllerState, DWORD dwNumIdleCycles);
   DWORD      AddWriteReadCommandDataToOutPutBuffer(BOOL bInstructionTestData, DWORD dwNumBitsToWriteRead,
                                                    PWriteDataByteBuffer pWriteDataBuffer,
                                                    DWORD dwNumBytesToWrite, DWORD dwTapControllerState);
   FTC_STATUS WriteReadDataToFromExternalDevice(FTC_HANDLE ftHandle, BOOL bInstructionTestData, DWORD dwNumBitsToWriteRead,
                                                PWriteDataByteBuffer pWriteDataBuffer, DWORD dwNumBytesToWrite,
                                                PReadDataByteBuffer pReadDataBuffer, LPDWORD lpdwNumBytesReturned,
+                                               DWORD dwTapControllerState, DWORD dwNumIdleCycles);
+  FTC_STATUS StreamScanDataToFromExternalDevice(FTC_HANDLE ftHandle, BOOL bInstructionTestData, ULONGLONG ulNumBitsToScan,
+                                                PFTC_SCAN_DATA_SOURCE pDataSource, PFTC_SCAN_DATA_SINK pDataSink,
+                                                LPVOID pContext, DWORD dwTapControllerState);
+  DWORD      AddCompareScanBlockToOutputBuffer(PWriteDataByteBuffer pWriteDataBuffer, DWORD dwNumDataBytes,
+                                               DWORD dwBlockIndex, DWORD dwNumBlocks, DWORD dwNumRemainingDataBits,
                                                DWORD dwTapControllerState);
+  FTC_STATUS WriteReadCompareDataToFromExternalDevice(FTC_HANDLE ftHandle, BOOL bInstructionTestData, DWORD dwNumBitsToWriteRead,
+                                                      PWriteDataByteBuffer pWriteDataBuffer, PWriteDataByteBuffer pExpectedDataBuffer,
+                                                      PWriteDataByteBuffer pMaskDataBuffer, LPDWORD lpdwMismatchBitOffset,
+                                                      DWORD dwTapControllerState);
   FTC_STATUS GenerateTCKClockPulses(FTC_HANDLE ftHandle, DWORD dwNumClockPulses);
+  FTC_STATUS GenerateTCKClockOnlyPulses(FTC_HANDLE ftHandle, DWORD dwNumClockPulses);
+  void       AddClockOnlyPulsesToOutputBuffer(DWORD dwNumClockPulses);
   FTC_STATUS GenerateClockPulsesHiSpeedDevice(FTC_HANDLE ftHandle, BOOL bPulseClockTimesEightFactor, DWORD dwNumClockPulses, BOOL bControlLowInputOutputPin, BOOL bStopClockPulsesState);
 
-  void       ProcessReadCommandsSequenceBytes(PInputByteBuffer pInputBuffer, DWORD dwNumBytesRead, PReadCmdSequenceDataByteBuffer pReadCmdSequenceDataBuffer,
-                                              LPDWORD lpdwNumBytesReturned);
+  FTC_STATUS ExecuteCommandsSequence(FTC_HANDLE ftHandle, PReadCmdSequenceDataByteBuffer pReadCmdSequenceDataBuffer,
+                                     LPDWORD lpdwNumBytesReturned);
+  FTC_STATUS SendStreamingCommandsSequenceSegment(FTC_HANDLE ftHandle);
+  FTC_STATUS FlushStreamingCommandsSequence(FTC_HANDLE ftHandle, DWORD dwNumCommandDataBytes, DWORD dwNumBitsToRead);
+  FTC_STATUS ExecuteStreamingCommandsSequence(FTC_HANDLE ftHandle, LPDWORD lpdwNumBytesReturned);
+  FTC_STATUS CreateStreamingCommandsSequenceBuffers(DWORD dwDeviceIndex);
+  void       DeleteStreamingCommandsSequenceBuffers(DWORD dwDeviceIndex);
+  void       ProcessReadCommandsSequenceBytes(PFTC_READ_CMD_SEQUENCE_DATA pReadCmdSequenceData, DWORD dwNumReadCommandSequences,
+                                              PInputByteBuffer pInputBuffer, DWORD dwNumBytesRead,
+                                              PReadCmdSequenceDataByteBuffer pReadCmdSequenceDataBuffer, LPDWORD lpdwNumBytesReturned);
+  FTC_STATUS SubmitCommandsSequence(FTC_HANDLE ftHandle);
+  FTC_STATUS ReapCommandsSequence(FTC_HANDLE ftHandle, BOOL bWaitForCompletion, PReadCmdSequenceDataByteBuffer pReadCmdSequenceDataBuffer,
+                                  LPDWORD lpdwNumBytesReturned);
   DWORD      GetTotalNumCommandsSequenceDataBytesToRead (void);
-  void       CopyReadCommandsSequenceDataBuffer(PReadCommandsSequenceData pDestinationBuffer, PReadCommandsSequenceData pSourceBuffer, DWORD dwSizeReadCommandsSequenceDataBuffer);
   FTC_STATUS AddReadCommandSequenceData(DWORD dwNumBitsToRead, DWORD dwNumTmsClocks);
   void       CreateReadCommandsSequenceDataBuffer(void);
-  PReadCommandsSequenceData CreateReadCommandsSequenceDataBuffer(DWORD dwSizeReadCmdsSequenceDataBuffer);
-  void       DeleteReadCommandsSequenceDataBuffer(PReadCommandsSequenceData pReadCmdsSequenceDataBuffer, DWORD dwSizeReadCommandsSequenceDataBuffer);
+  PFTC_READ_CMD_SEQUENCE_DATA CreateReadCommandsSequenceDataBuffer(DWORD dwSizeReadCmdsSequenceDataBuffer);
+  void       DeleteReadCommandsSequenceDataBuffer(PFTC_READ_CMD_SEQUENCE_DATA pReadCmdsSequenceDataBuffer);
 
   FTC_STATUS CreateDeviceCommandsSequenceDataBuffers(FTC_HANDLE ftHandle);
   void       ClearDeviceCommandSequenceData(FTC_HANDLE ftHandle);
   DWORD      GetNumBytesInCommandsSequenceDataBuffer(void);
+  BOOL       IsInstructionRegisterCached(FTC_HANDLE ftHandle, DWORD dwNumBitsToWrite, PWriteDataByteBuffer pWriteDataBuffer);
+  BOOL       IsInstructionRegisterKept(JtagStates StartJtagState, JtagStates NewJtagState);
+  void       UpdateInstructionRegisterCache(FTC_HANDLE ftHandle, BOOL bInstructionTestData, DWORD dwNumBits,
+                                            PWriteDataByteBuffer pWriteDataBuffer, DWORD dwTapControllerState);
+  void       InvalidateInstructionRegisterCache(FTC_HANDLE ftHandle);
   DWORD      GetCommandsSequenceDataDeviceIndex(FTC_HANDLE ftHandle);
   void       DeleteDeviceCommandsSequenceDataBuffers(FTC_HANDLE ftHandle);
+  DWORD      GetMPSSECommandLength(LPBYTE pCommandBytes, DWORD dwNumCommandBytes);
+  DWORD      WriteTMSCommand(LPBYTE pCommandBytes, DWORD dwNumTmsClocks, DWORD dwTmsBits, DWORD dwTdiBit);
+  DWORD      OptimizeCommandsSequence(LPBYTE pCommandBytes, DWORD dwNumCommandBytes);
+  DWORD      CompleteCommandsSequence(void);
+  void       TransferCommandsSequenceToOutputBuffer(void);
+  void       SetCommandsSequenceStartJtagState(void);
+  void       SignalCommandSequenceCompletion(DWORD dwDeviceIndex, FTC_STATUS CompletionStatus);
+  FTC_STATUS CheckCommandSequenceNotSubmitted(FTC_HANDLE ftHandle);
+  void       EndSubmittedCommandSequence(DWORD dwDeviceIndex);
+#ifndef _WIN32
+  static void *CompletionWatcherMain(void *pParameter);
+  void       WatchSubmittedCommandSequences(void);
+  BOOL       PollSubmittedCommandSequences(LPDWORD lpdwDeviceIndex);
+  void       WaitForCompletionWatcher(FTC_HANDLE ftHandle);
+  FTC_STATUS StartCompletionWatcher(void);
+  void       StopCompletionWatcher(void);
+#endif
+
+  FTC_STATUS CheckScanTemplateScans(PFTC_SCAN_TEMPLATE_SCAN pScans, DWORD dwNumScans);
+  FTC_STATUS CompileScanTemplate(PFTC_SCAN_TEMPLATE_DATA pScanTemplate, PFTC_SCAN_TEMPLATE_SCAN pScans, DWORD dwNumScans);
+  FTC_STATUS ExecuteScanTemplate(FTC_HANDLE ftHandle, PFTC_SCAN_TEMPLATE_DATA pScanTemplate,
+                                 PScanTemplateWriteDataBuffers pWriteDataBuffers,
+                                 PReadCmdSequenceDataByteBuffer pReadDataBuffer, LPDWORD lpdwNumBytesReturned);
+  PFTC_SCAN_TEMPLATE_DATA GetScanTemplate(FTC_HANDLE ftHandle, DWORD dwScanTemplate);
+  void       DeleteScanTemplate(PFTC_SCAN_TEMPLATE_DATA pScanTemplate);
+  void       DeleteDeviceScanTemplates(FTC_HANDLE ftHandle);
+
+  FTC_STATUS RecordCommandsSequence(FTC_HANDLE ftHandle, PFTC_RECORDED_CMD_SEQUENCE_DATA pRecordedCmdSequence);
+  FTC_STATUS ExecuteRecordedCommandsSequence(FTC_HANDLE ftHandle, PFTC_RECORDED_CMD_SEQUENCE_DATA pRecordedCmdSequence,
+                                             PReadCmdSequenceDataByteBuffer pReadCmdSequenceDataBuffer, LPDWORD lpdwNumBytesReturned);
+  PFTC_RECORDED_CMD_SEQUENCE_DATA GetRecordedCommandsSequence(DWORD dwRecordedCmdSequence);
+  void       DeleteRecordedCommandsSequence(PFTC_RECORDED_CMD_SEQUENCE_DATA pRecordedCmdSequence);
 
   FTC_STATUS AddDeviceWriteCommand(FTC_HANDLE ftHandle, BOOL bInstructionTestData, DWORD dwNumBitsToWrite,
                                    PWriteDataByteBuffer pWriteDataBuffer, DWORD dwNumBytesToWrite,
-                                   DWORD dwTapControllerState);
-  FTC_STATUS AddDeviceReadCommand(FTC_HANDLE ftHandle, BOOL bInstructionTestData, DWORD dwNumBitsToRead, DWORD dwTapControllerState);
+                                   DWORD dwTapControllerState, DWORD dwNumIdleCycles);
+  FTC_STATUS AddDeviceReadCommand(FTC_HANDLE ftHandle, BOOL bInstructionTestData, DWORD dwNumBitsToRead,
+                                  DWORD dwTapControllerState, DWORD dwNumIdleCycles);
   FTC_STATUS AddDeviceWriteReadCommand(FTC_HANDLE ftHandle, BOOL bInstructionTestData, DWORD dwNumBitsToWriteRead,
                                        PWriteDataByteBuffer pWriteDataBuffer, DWORD dwNumBytesToWrite,
-                                       DWORD dwTapControllerState);
+                                       DWORD dwTapControllerState, DWORD dwNumIdleCycles);
 
 public:
   FT2232hMpsseJtag(void);
@@ -302,6 +567,19 @@ public:
   FTC_STATUS WINAPI JTAG_OpenSpecifiedDevice(LPSTR lpDeviceName, DWORD dwLocationID, FTC_HANDLE *pftHandle);
   FTC_STATUS WINAPI JTAG_OpenSpecifiedHiSpeedDevice(LPSTR lpDeviceName, DWORD dwLocationID, LPSTR lpChannel, FTC_HANDLE *pftHandle);
   FTC_STATUS WINAPI JTAG_GetHiSpeedDeviceType(FTC_HANDLE ftHandle, LPDWORD lpdwHiSpeedDeviceType);
+  FTC_STATUS WINAPI JTAG_OpenTransportDevice(DWORD dwTransportType, DWORD dwDeviceIndex, FTC_HANDLE *pftHandle);
+  FTC_STATUS WINAPI JTAG_GetDeviceTransportType(FTC_HANDLE ftHandle, LPDWORD lpdwTransportType);
+  FTC_STATUS WINAPI JTAG_GetEmulatorState(FTC_HANDLE ftHandle, PFTC_EMULATOR_STATE pEmulatorState);
+  FTC_STATUS WINAPI JTAG_SetDeviceTransferQueueDepth(FTC_HANDLE ftHandle, DWORD dwNumWriteTransfers, DWORD dwNumReadTransfers);
+  FTC_STATUS WINAPI JTAG_GetDeviceTransferQueueDepth(FTC_HANDLE ftHandle, LPDWORD lpdwNumWriteTransfers, LPDWORD lpdwNumReadTransfers);
+  FTC_STATUS WINAPI JTAG_SetDeviceWaitPolicy(FTC_HANDLE ftHandle, DWORD dwWaitPolicy, DWORD dwSpinPeriodMicroSecs);
+  FTC_STATUS WINAPI JTAG_GetDeviceWaitPolicy(FTC_HANDLE ftHandle, LPDWORD lpdwWaitPolicy, LPDWORD lpdwSpinPeriodMicroSecs);
+  FTC_STATUS WINAPI JTAG_SetDeviceUSBTransferChunkSize(FTC_HANDLE ftHandle, DWORD dwUSBTransferChunkSize);
+  FTC_STATUS WINAPI JTAG_GetDeviceUSBTransferChunkSize(FTC_HANDLE ftHandle, LPDWORD lpdwUSBTransferChunkSize);
+  FTC_STATUS WINAPI JTAG_SetDeviceCommandTimeout(FTC_HANDLE ftHandle, DWORD dwCommandTimeoutmSec);
+  FTC_STATUS WINAPI JTAG_GetDeviceCommandTimeout(FTC_HANDLE ftHandle, LPDWORD lpdwCommandTimeoutmSec);
+  FTC_STATUS WINAPI JTAG_SetDeviceIOThread(FTC_HANDLE ftHandle, BOOL bIOThreadEnabled);
+  FTC_STATUS WINAPI JTAG_GetDeviceIOThread(FTC_HANDLE ftHandle, LPBOOL lpbIOThreadEnabled);
   FTC_STATUS WINAPI JTAG_CloseDevice(FTC_HANDLE ftHandle);
   FTC_STATUS WINAPI JTAG_CloseDevice(FTC_HANDLE ftHandle, PFTC_CLOSE_FINAL_STATE_PINS pCloseFinalStatePinsData);
   FTC_STATUS WINAPI JTAG_InitDevice(FTC_HANDLE ftHandle, DWORD dwClockDivisor);
@@ -333,14 +611,21 @@ public:
                                                                        PFTH_LOW_HIGH_PINS pHighPinsInputData);
   FTC_STATUS WINAPI JTAG_WriteDataToExternalDevice(FTC_HANDLE ftHandle, BOOL bInstructionTestData, DWORD dwNumBitsToWrite,
                                                    PWriteDataByteBuffer pWriteDataBuffer, DWORD dwNumBytesToWrite,
-                                                   DWORD dwTapControllerState);
+                                                   DWORD dwTapControllerState, DWORD dwNumIdleCycles);
   FTC_STATUS WINAPI JTAG_ReadDataFromExternalDevice(FTC_HANDLE ftHandle, BOOL bInstructionTestData, DWORD dwNumBitsToRead,
                                                     PReadDataByteBuffer pReadDataBuffer, LPDWORD lpdwNumBytesReturned,
-                                                    DWORD dwTapControllerState);
+                                                    DWORD dwTapControllerState, DWORD dwNumIdleCycles);
   FTC_STATUS WINAPI JTAG_WriteReadDataToFromExternalDevice(FTC_HANDLE ftHandle, BOOL bInstructionTestData, DWORD dwNumBitsToWriteRead,
                                                            PWriteDataByteBuffer pWriteDataBuffer, DWORD dwNumBytesToWrite,
                                                            PReadDataByteBuffer pReadDataBuffer, LPDWORD lpdwNumBytesReturned,
-                                                           DWORD dwTapControllerState);
+                                                           DWORD dwTapControllerState, DWORD dwNumIdleCycles);
+  FTC_STATUS WINAPI JTAG_WriteReadCompare(FTC_HANDLE ftHandle, BOOL bInstructionTestData, DWORD dwNumBitsToWriteRead,
+                                          PWriteDataByteBuffer pWriteDataBuffer, DWORD dwNumBytesToWrite,
+                                          PWriteDataByteBuffer pExpectedDataBuffer, PWriteDataByteBuffer pMaskDataBuffer,
+                                          LPDWORD lpdwMismatchBitOffset, DWORD dwTapControllerState);
+  FTC_STATUS WINAPI JTAG_StreamScan(FTC_HANDLE ftHandle, BOOL bInstructionTestData, ULONGLONG ulNumBitsToScan,
+                                    PFTC_SCAN_DATA_SOURCE pDataSource, PFTC_SCAN_DATA_SINK pDataSink,
+                                    LPVOID pContext, DWORD dwTapControllerState);
   FTC_STATUS WINAPI JTAG_GenerateTCKClockPulses(FTC_HANDLE ftHandle, DWORD dwNumClockPulses);
   FTC_STATUS WINAPI JTAG_GenerateClockPulsesHiSpeedDevice(FTC_HANDLE ftHandle, BOOL bPulseClockTimesEightFactor, DWORD dwNumClockPulses, BOOL bControlLowInputOutputPin, BOOL bStopClockPulsesState);
   FTC_STATUS WINAPI JTAG_ClearCommandSequence(void);
@@ -354,13 +639,42 @@ public:
   FTC_STATUS WINAPI JTAG_ClearDeviceCommandSequence(FTC_HANDLE ftHandle);
   FTC_STATUS WINAPI JTAG_AddDeviceWriteCommand(FTC_HANDLE ftHandle, BOOL bInstructionTestData, DWORD dwNumBitsToWrite,
                                                PWriteDataByteBuffer pWriteDataBuffer, DWORD dwNumBytesToWrite,
-                                               DWORD dwTapControllerState);
-  FTC_STATUS WINAPI JTAG_AddDeviceReadCommand(FTC_HANDLE ftHandle, BOOL bInstructionTestData, DWORD dwNumBitsToRead, DWORD dwTapControllerState);
+                                               DWORD dwTapControllerState, DWORD dwNumIdleCycles);
+  FTC_STATUS WINAPI JTAG_AddDeviceReadCommand(FTC_HANDLE ftHandle, BOOL bInstructionTestData, DWORD dwNumBitsToRead,
+                                              DWORD dwTapControllerState, DWORD dwNumIdleCycles);
   FTC_STATUS WINAPI JTAG_AddDeviceWriteReadCommand(FTC_HANDLE ftHandle, BOOL bInstructionTestData, DWORD dwNumBitsToWriteRead,
                                                    PWriteDataByteBuffer pWriteDataBuffer, DWORD dwNumBytesToWrite,
-                                                   DWORD dwTapControllerState);
+                                                   DWORD dwTapControllerState, DWORD dwNumIdleCycles);
   FTC_STATUS WINAPI JTAG_ExecuteCommandSequence(FTC_HANDLE ftHandle, PReadCmdSequenceDataByteBuffer pReadCmdSequenceDataBuffer,
                                                 LPDWORD lpdwNumBytesReturned);
+  FTC_STATUS WINAPI JTAG_SubmitCommandSequence(FTC_HANDLE ftHandle);
+  FTC_STATUS WINAPI JTAG_ExecuteCommandSequenceAsync(FTC_HANDLE ftHandle, LPDWORD lpdwTicket);
+  FTC_STATUS WINAPI JTAG_PollCommandSequence(FTC_HANDLE ftHandle, DWORD dwTicket, PReadCmdSequenceDataByteBuffer pReadCmdSequenceDataBuffer,
+                                             LPDWORD lpdwNumBytesReturned);
+  FTC_STATUS WINAPI JTAG_WaitCommandSequence(FTC_HANDLE ftHandle, DWORD dwTicket, PReadCmdSequenceDataByteBuffer pReadCmdSequenceDataBuffer,
+                                             LPDWORD lpdwNumBytesReturned);
+  FTC_STATUS WINAPI JTAG_ReapCommandSequence(FTC_HANDLE ftHandle, PReadCmdSequenceDataByteBuffer pReadCmdSequenceDataBuffer,
+                                             LPDWORD lpdwNumBytesReturned);
+  FTC_STATUS WINAPI JTAG_AbandonDeviceCommandSequence(FTC_HANDLE ftHandle);
+  FTC_STATUS WINAPI JTAG_ExecuteCommandSequenceCompare(FTC_HANDLE ftHandle, PReadCmdSequenceDataByteBuffer pExpectedDataBuffer,
+                                                       PReadCmdSequenceDataByteBuffer pMaskDataBuffer, LPDWORD lpdwMismatchBitOffset);
+  FTC_STATUS WINAPI JTAG_GetDeviceCompletionFd(FTC_HANDLE ftHandle, INT *piCompletionFd);
+  FTC_STATUS WINAPI JTAG_SetDeviceCommandSequenceOptimizer(FTC_HANDLE ftHandle, BOOL bOptimizerEnabled);
+  FTC_STATUS WINAPI JTAG_GetDeviceCommandSequenceOptimizer(FTC_HANDLE ftHandle, LPBOOL lpbOptimizerEnabled, LPDWORD lpdwNumBytesSaved);
+  FTC_STATUS WINAPI JTAG_SetDeviceCommandSequenceStreaming(FTC_HANDLE ftHandle, BOOL bStreamingEnabled, PFTC_SCAN_DATA_SINK pDataSink,
+                                                           LPVOID pContext);
+  FTC_STATUS WINAPI JTAG_SetDeviceInstructionRegisterCache(FTC_HANDLE ftHandle, BOOL bCacheEnabled);
+  FTC_STATUS WINAPI JTAG_GetDeviceInstructionRegisterCache(FTC_HANDLE ftHandle, LPBOOL lpbCacheEnabled, LPDWORD lpdwNumScansSkipped);
+  FTC_STATUS WINAPI JTAG_CreateScanTemplate(FTC_HANDLE ftHandle, PFTC_SCAN_TEMPLATE_SCAN pScans, DWORD dwNumScans,
+                                            LPDWORD lpdwScanTemplate);
+  FTC_STATUS WINAPI JTAG_ExecuteScanTemplate(FTC_HANDLE ftHandle, DWORD dwScanTemplate, PScanTemplateWriteDataBuffers pWriteDataBuffers,
+                                             PReadCmdSequenceDataByteBuffer pReadDataBuffer, LPDWORD lpdwNumBytesReturned);
+  FTC_STATUS WINAPI JTAG_DeleteScanTemplate(FTC_HANDLE ftHandle, DWORD dwScanTemplate);
+  FTC_STATUS WINAPI JTAG_RecordCommandSequence(FTC_HANDLE ftHandle, LPDWORD lpdwRecordedCmdSequence);
+  FTC_STATUS WINAPI JTAG_ExecuteRecordedCommandSequence(FTC_HANDLE ftHandle, DWORD dwRecordedCmdSequence,
+                                                        PReadCmdSequenceDataByteBuffer pReadCmdSequenceDataBuffer,
+                                                        LPDWORD lpdwNumBytesReturned);
+  FTC_STATUS WINAPI JTAG_DeleteRecordedCommandSequence(DWORD dwRecordedCmdSequence);
   FTC_STATUS WINAPI JTAG_GetDllVersion(LPSTR lpDllVersionBuffer, DWORD dwBufferSize);
   FTC_STATUS WINAPI JTAG_GetErrorCodeString(LPSTR lpLanguage, FTC_STATUS StatusCode,
                                             LPSTR lpErrorMessageBuffer, DWORD dwBufferSize);
@@ -109,6 +109,84 @@ FTC_STATUS WINAPI JTAG_GetHiSpeedDeviceType(FTC_HANDLE ftHandle, LPDWORD lpdwHiS
   return pFT2232hMpsseJtag->JTAG_GetHiSpeedDeviceType(ftHandle, lpdwHiSpeedDeviceType);
 }
 
+extern "C" FTCJTAG_API
+FTC_STATUS WINAPI JTAG_OpenTransportDevice(DWORD dwTransportType, DWORD dwDeviceIndex, FTC_HANDLE *pftHandle)
+{
+  return pFT2232hMpsseJtag->JTAG_OpenTransportDevice(dwTransportType, dwDeviceIndex, pftHandle);
+}
+
+extern "C" FTCJTAG_API
+FTC_STATUS WINAPI JTAG_GetDeviceTransportType(FTC_HANDLE ftHandle, LPDWORD lpdwTransportType)
+{
+  return pFT2232hMpsseJtag->JTAG_GetDeviceTransportType(ftHandle, lpdwTransportType);
+}
+
+extern "C" FTCJTAG_API
+FTC_STATUS WINAPI JTAG_GetEmulatorState(FTC_HANDLE ftHandle, PFTC_EMULATOR_STATE pEmulatorState)
+{
+  return pFT2232hMpsseJtag->JTAG_GetEmulatorState(ftHandle, pEmulatorState);
+}
+
+extern "C" FTCJTAG_API
+FTC_STATUS WINAPI JTAG_SetDeviceTransferQueueDepth(FTC_HANDLE ftHandle, DWORD dwNumWriteTransfers, DWORD dwNumReadTransfers)
+{
+  return pFT2232hMpsseJtag->JTAG_SetDeviceTransferQueueDepth(ftHandle, dwNumWriteTransfers, dwNumReadTransfers);
+}
+
+extern "C" FTCJTAG_API
+FTC_STATUS WINAPI JTAG_GetDeviceTransferQueueDepth(FTC_HANDLE ftHandle, LPDWORD lpdwNumWriteTransfers, LPDWORD lpdwNumReadTransfers)
+{
+  return pFT2232hMpsseJtag->JTAG_GetDeviceTransferQueueDepth(ftHandle, lpdwNumWriteTransfers, lpdwNumReadTransfers);
+}
+
+extern "C" FTCJTAG_API
+FTC_STATUS WINAPI JTAG_SetDeviceWaitPolicy(FTC_HANDLE ftHandle, DWORD dwWaitPolicy, DWORD dwSpinPeriodMicroSecs)
+{
+  return pFT2232hMpsseJtag->JTAG_SetDeviceWaitPolicy(ftHandle, dwWaitPolicy, dwSpinPeriodMicroSecs);
+}
+
+extern "C" FTCJTAG_API
+FTC_STATUS WINAPI JTAG_GetDeviceWaitPolicy(FTC_HANDLE ftHandle, LPDWORD lpdwWaitPolicy, LPDWORD lpdwSpinPeriodMicroSecs)
+{
+  return pFT2232hMpsseJtag->JTAG_GetDeviceWaitPolicy(ftHandle, lpdwWaitPolicy, lpdwSpinPeriodMicroSecs);
+}
+
+extern "C" FTCJTAG_API
+FTC_STATUS WINAPI JTAG_SetDeviceUSBTransferChunkSize(FTC_HANDLE ftHandle, DWORD dwUSBTransferChunkSize)
+{
+  return pFT2232hMpsseJtag->JTAG_SetDeviceUSBTransferChunkSize(ftHandle, dwUSBTransferChunkSize);
+}
+
+extern "C" FTCJTAG_API
+FTC_STATUS WINAPI JTAG_GetDeviceUSBTransferChunkSize(FTC_HANDLE ftHandle, LPDWORD lpdwUSBTransferChunkSize)
+{
+  return pFT2232hMpsseJtag->JTAG_GetDeviceUSBTransferChunkSize(ftHandle, lpdwUSBTransferChunkSize);
+}
+
+extern "C" FTCJTAG_API
+FTC_STATUS WINAPI JTAG_SetDeviceCommandTimeout(FTC_HANDLE ftHandle, DWORD dwCommandTimeoutmSec)
+{
+  return pFT2232hMpsseJtag->JTAG_SetDeviceCommandTimeout(ftHandle, dwCommandTimeoutmSec);
+}
+
+extern "C" FTCJTAG_API
+FTC_STATUS WINAPI JTAG_GetDeviceCommandTimeout(FTC_HANDLE ftHandle, LPDWORD lpdwCommandTimeoutmSec)
+{
+  return pFT2232hMpsseJtag->JTAG_GetDeviceCommandTimeout(ftHandle, lpdwCommandTimeoutmSec);
+}
+
+extern "C" FTCJTAG_API
+FTC_STATUS WINAPI JTAG_SetDeviceIOThread(FTC_HANDLE ftHandle, BOOL bIOThreadEnabled)
+{
+  return pFT2232hMpsseJtag->JTAG_SetDeviceIOThread(ftHandle, bIOThreadEnabled);
+}
+
+extern "C" FTCJTAG_API
+FTC_STATUS WINAPI JTAG_GetDeviceIOThread(FTC_HANDLE ftHandle, LPBOOL lpbIOThreadEnabled)
+{
+  return pFT2232hMpsseJtag->JTAG_GetDeviceIOThread(ftHandle, lpbIOThreadEnabled);
+}
+
 extern "C" FTCJTAG_API
 FTC_STATUS WINAPI JTAG_Close(FTC_HANDLE ftHandle)
 {
@@ -237,7 +315,7 @@ FTC_STATUS WINAPI JTAG_Write(FTC_HANDLE ftHandle, BOOL bInstructionTestData, DWO
                              DWORD dwTapControllerState)
 {
   return pFT2232hMpsseJtag->JTAG_WriteDataToExternalDevice(ftHandle, bInstructionTestData, dwNumBitsToWrite,
-                                                           pWriteDataBuffer, dwNumBytesToWrite, dwTapControllerState);
+                                                           pWriteDataBuffer, dwNumBytesToWrite, dwTapControllerState, 0);
 }
 
 extern "C" FTCJTAG_API
@@ -246,7 +324,7 @@ FTC_STATUS WINAPI JTAG_Read(FTC_HANDLE ftHandle, BOOL bInstructionTestData, DWOR
                             DWORD dwTapControllerState)
 {
   return pFT2232hMpsseJtag->JTAG_ReadDataFromExternalDevice(ftHandle, bInstructionTestData, dwNumBitsToRead,
-                                                            pReadDataBuffer, lpdwNumBytesReturned, dwTapControllerState);
+                                                            pReadDataBuffer, lpdwNumBytesReturned, dwTapControllerState, 0);
 }
 
 extern "C" FTCJTAG_API
@@ -257,7 +335,59 @@ FTC_STATUS WINAPI JTAG_WriteRead(FTC_HANDLE ftHandle, BOOL bInstructionData, DWO
 {
   return pFT2232hMpsseJtag->JTAG_WriteReadDataToFromExternalDevice(ftHandle, bInstructionData, dwNumBitsToWriteRead,
                                                                    pWriteDataBuffer,  dwNumBytesToWrite,
-                                                                   pReadDataBuffer, lpdwNumBytesReturned, dwTapControllerState);
+                                                                   pReadDataBuffer, lpdwNumBytesReturned, dwTapControllerState, 0);
+}
+
+extern "C" FTCJTAG_API
+FTC_STATUS WINAPI JTAG_WriteEx(FTC_HANDLE ftHandle, BOOL bInstructionTestData, DWORD dwNumBitsToWrite,
+                               PWriteDataByteBuffer pWriteDataBuffer, DWORD dwNumBytesToWrite,
+                               DWORD dwTapControllerState, DWORD dwNumIdleCycles)
+{
+  return pFT2232hMpsseJtag->JTAG_WriteDataToExternalDevice(ftHandle, bInstructionTestData, dwNumBitsToWrite,
+                                                           pWriteDataBuffer, dwNumBytesToWrite, dwTapControllerState,
+                                                           dwNumIdleCycles);
+}
+
+extern "C" FTCJTAG_API
+FTC_STATUS WINAPI JTAG_ReadEx(FTC_HANDLE ftHandle, BOOL bInstructionTestData, DWORD dwNumBitsToRead,
+                              PReadDataByteBuffer pReadDataBuffer, LPDWORD lpdwNumBytesReturned,
+                              DWORD dwTapControllerState, DWORD dwNumIdleCycles)
+{
+  return pFT2232hMpsseJtag->JTAG_ReadDataFromExternalDevice(ftHandle, bInstructionTestData, dwNumBitsToRead,
+                                                            pReadDataBuffer, lpdwNumBytesReturned, dwTapControllerState,
+                                                            dwNumIdleCycles);
+}
+
+extern "C" FTCJTAG_API
+FTC_STATUS WINAPI JTAG_WriteReadEx(FTC_HANDLE ftHandle, BOOL bInstructionData, DWORD dwNumBitsToWriteRead,
+                                   PWriteDataByteBuffer pWriteDataBuffer, DWORD dwNumBytesToWrite,
+                                   PReadDataByteBuffer pReadDataBuffer, LPDWORD lpdwNumBytesReturned,
+                                   DWORD dwTapControllerState, DWORD dwNumIdleCycles)
+{
+  return pFT2232hMpsseJtag->JTAG_WriteReadDataToFromExternalDevice(ftHandle, bInstructionData, dwNumBitsToWriteRead,
+                                                                   pWriteDataBuffer, dwNumBytesToWrite,
+                                                                   pReadDataBuffer, lpdwNumBytesReturned, dwTapControllerState,
+                                                                   dwNumIdleCycles);
+}
+
+extern "C" FTCJTAG_API
+FTC_STATUS WINAPI JTAG_WriteReadCompare(FTC_HANDLE ftHandle, BOOL bInstructionTestData, DWORD dwNumBitsToWriteRead,
+                                        PWriteDataByteBuffer pWriteDataBuffer, DWORD dwNumBytesToWrite,
+                                        PWriteDataByteBuffer pExpectedDataBuffer, PWriteDataByteBuffer pMaskDataBuffer,
+                                        LPDWORD lpdwMismatchBitOffset, DWORD dwTapControllerState)
+{
+  return pFT2232hMpsseJtag->JTAG_WriteReadCompare(ftHandle, bInstructionTestData, dwNumBitsToWriteRead, pWriteDataBuffer,
+                                                  dwNumBytesToWrite, pExpectedDataBuffer, pMaskDataBuffer,
+                                                  lpdwMismatchBitOffset, dwTapControllerState);
+}
+
+extern "C" FTCJTAG_API
+FTC_STATUS WINAPI JTAG_StreamScan(FTC_HANDLE ftHandle, BOOL bInstructionTestData, ULONGLONG ulNumBitsToScan,
+                                  PFTC_SCAN_DATA_SOURCE pDataSource, PFTC_SCAN_DATA_SINK pDataSink,
+                                  LPVOID pContext, DWORD dwTapControllerState)
+{
+  return pFT2232hMpsseJtag->JTAG_StreamScan(ftHandle, bInstructionTestData, ulNumBitsToScan, pDataSource, pDataSink,
+                                            pContext, dwTapControllerState);
 }
 
 extern "C" FTCJTAG_API
@@ -314,13 +444,13 @@ FTC_STATUS WINAPI JTAG_AddDeviceWriteCmd(FTC_HANDLE ftHandle, BOOL bInstructionT
                                          DWORD dwTapControllerState)
 {
   return pFT2232hMpsseJtag->JTAG_AddDeviceWriteCommand(ftHandle, bInstructionTestData, dwNumBitsToWrite,
-                                                       pWriteDataBuffer, dwNumBytesToWrite, dwTapControllerState);
+                                                       pWriteDataBuffer, dwNumBytesToWrite, dwTapControllerState, 0);
 }
 
 extern "C" FTCJTAG_API
 FTC_STATUS WINAPI JTAG_AddDeviceReadCmd(FTC_HANDLE ftHandle, BOOL bInstructionTestData, DWORD dwNumBitsToRead, DWORD dwTapControllerState)
 {
-  return pFT2232hMpsseJtag->JTAG_AddDeviceReadCommand(ftHandle, bInstructionTestData, dwNumBitsToRead, dwTapControllerState);
+  return pFT2232hMpsseJtag->JTAG_AddDeviceReadCommand(ftHandle, bInstructionTestData, dwNumBitsToRead, dwTapControllerState, 0);
 }
 
 extern "C" FTCJTAG_API
@@ -329,7 +459,34 @@ FTC_STATUS WINAPI JTAG_AddDeviceWriteReadCmd(FTC_HANDLE ftHandle, BOOL bInstruct
                                              DWORD dwTapControllerState)
 {
   return pFT2232hMpsseJtag->JTAG_AddDeviceWriteReadCommand(ftHandle, bInstructionTestData, dwNumBitsToWriteRead, pWriteDataBuffer,
-                                                           dwNumBytesToWrite, dwTapControllerState);
+                                                           dwNumBytesToWrite, dwTapControllerState, 0);
+}
+
+extern "C" FTCJTAG_API
+FTC_STATUS WINAPI JTAG_AddDeviceWriteCmdEx(FTC_HANDLE ftHandle, BOOL bInstructionTestData, DWORD dwNumBitsToWrite,
+                                           PWriteDataByteBuffer pWriteDataBuffer, DWORD dwNumBytesToWrite,
+                                           DWORD dwTapControllerState, DWORD dwNumIdleCycles)
+{
+  return pFT2232hMpsseJtag->JTAG_AddDeviceWriteCommand(ftHandle, bInstructionTestData, dwNumBitsToWrite,
+                                                       pWriteDataBuffer, dwNumBytesToWrite, dwTapControllerState,
+                                                       dwNumIdleCycles);
+}
+
+extern "C" FTCJTAG_API
+FTC_STATUS WINAPI JTAG_AddDeviceReadCmdEx(FTC_HANDLE ftHandle, BOOL bInstructionTestData, DWORD dwNumBitsToRead,
+                                          DWORD dwTapControllerState, DWORD dwNumIdleCycles)
+{
+  return pFT2232hMpsseJtag->JTAG_AddDeviceReadCommand(ftHandle, bInstructionTestData, dwNumBitsToRead, dwTapControllerState,
+                                                      dwNumIdleCycles);
+}
+
+extern "C" FTCJTAG_API
+FTC_STATUS WINAPI JTAG_AddDeviceWriteReadCmdEx(FTC_HANDLE ftHandle, BOOL bInstructionTestData, DWORD dwNumBitsToWriteRead,
+                                               PWriteDataByteBuffer pWriteDataBuffer, DWORD dwNumBytesToWrite,
+                                               DWORD dwTapControllerState, DWORD dwNumIdleCycles)
+{
+  return pFT2232hMpsseJtag->JTAG_AddDeviceWriteReadCommand(ftHandle, bInstructionTestData, dwNumBitsToWriteRead, pWriteDataBuffer,
+                                                           dwNumBytesToWrite, dwTapControllerState, dwNumIdleCycles);
 }
 
 extern "C" FTCJTAG_API
@@ -339,6 +496,131 @@ FTC_STATUS WINAPI JTAG_ExecuteCmdSequence(FTC_HANDLE ftHandle, PReadCmdSequenceD
   return pFT2232hMpsseJtag->JTAG_ExecuteCommandSequence(ftHandle, pReadCmdSequenceDataBuffer, lpdwNumBytesReturned);
 }
 
+extern "C" FTCJTAG_API
+FTC_STATUS WINAPI JTAG_SubmitCmdSequence(FTC_HANDLE ftHandle)
+{
+  return pFT2232hMpsseJtag->JTAG_SubmitCommandSequence(ftHandle);
+}
+
+extern "C" FTCJTAG_API
+FTC_STATUS WINAPI JTAG_ReapCmdSequence(FTC_HANDLE ftHandle, PReadCmdSequenceDataByteBuffer pReadCmdSequenceDataBuffer,
+                                       LPDWORD lpdwNumBytesReturned)
+{
+  return pFT2232hMpsseJtag->JTAG_ReapCommandSequence(ftHandle, pReadCmdSequenceDataBuffer, lpdwNumBytesReturned);
+}
+
+extern "C" FTCJTAG_API
+FTC_STATUS WINAPI JTAG_ExecuteCmdSequenceAsync(FTC_HANDLE ftHandle, LPDWORD lpdwTicket)
+{
+  return pFT2232hMpsseJtag->JTAG_ExecuteCommandSequenceAsync(ftHandle, lpdwTicket);
+}
+
+extern "C" FTCJTAG_API
+FTC_STATUS WINAPI JTAG_PollCmdSequence(FTC_HANDLE ftHandle, DWORD dwTicket, PReadCmdSequenceDataByteBuffer pReadCmdSequenceDataBuffer,
+                                       LPDWORD lpdwNumBytesReturned)
+{
+  return pFT2232hMpsseJtag->JTAG_PollCommandSequence(ftHandle, dwTicket, pReadCmdSequenceDataBuffer, lpdwNumBytesReturned);
+}
+
+extern "C" FTCJTAG_API
+FTC_STATUS WINAPI JTAG_WaitCmdSequence(FTC_HANDLE ftHandle, DWORD dwTicket, PReadCmdSequenceDataByteBuffer pReadCmdSequenceDataBuffer,
+                                       LPDWORD lpdwNumBytesReturned)
+{
+  return pFT2232hMpsseJtag->JTAG_WaitCommandSequence(ftHandle, dwTicket, pReadCmdSequenceDataBuffer, lpdwNumBytesReturned);
+}
+
+extern "C" FTCJTAG_API
+FTC_STATUS WINAPI JTAG_AbandonDeviceCmdSequence(FTC_HANDLE ftHandle)
+{
+  return pFT2232hMpsseJtag->JTAG_AbandonDeviceCommandSequence(ftHandle);
+}
+
+extern "C" FTCJTAG_API
+FTC_STATUS WINAPI JTAG_ExecuteCmdSequenceCompare(FTC_HANDLE ftHandle, PReadCmdSequenceDataByteBuffer pExpectedDataBuffer,
+                                                 PReadCmdSequenceDataByteBuffer pMaskDataBuffer, LPDWORD lpdwMismatchBitOffset)
+{
+  return pFT2232hMpsseJtag->JTAG_ExecuteCommandSequenceCompare(ftHandle, pExpectedDataBuffer, pMaskDataBuffer, lpdwMismatchBitOffset);
+}
+
+extern "C" FTCJTAG_API
+FTC_STATUS WINAPI JTAG_GetDeviceCompletionFd(FTC_HANDLE ftHandle, INT *piCompletionFd)
+{
+  return pFT2232hMpsseJtag->JTAG_GetDeviceCompletionFd(ftHandle, piCompletionFd);
+}
+
+extern "C" FTCJTAG_API
+FTC_STATUS WINAPI JTAG_SetDeviceCmdSequenceOptimizer(FTC_HANDLE ftHandle, BOOL bOptimizerEnabled)
+{
+  return pFT2232hMpsseJtag->JTAG_SetDeviceCommandSequenceOptimizer(ftHandle, bOptimizerEnabled);
+}
+
+extern "C" FTCJTAG_API
+FTC_STATUS WINAPI JTAG_GetDeviceCmdSequenceOptimizer(FTC_HANDLE ftHandle, LPBOOL lpbOptimizerEnabled, LPDWORD lpdwNumBytesSaved)
+{
+  return pFT2232hMpsseJtag->JTAG_GetDeviceCommandSequenceOptimizer(ftHandle, lpbOptimizerEnabled, lpdwNumBytesSaved);
+}
+
+extern "C" FTCJTAG_API
+FTC_STATUS WINAPI JTAG_SetDeviceCmdSequenceStreaming(FTC_HANDLE ftHandle, BOOL bStreamingEnabled, PFTC_SCAN_DATA_SINK pDataSink,
+                                                     LPVOID pContext)
+{
+  return pFT2232hMpsseJtag->JTAG_SetDeviceCommandSequenceStreaming(ftHandle, bStreamingEnabled, pDataSink, pContext);
+}
+
+extern "C" FTCJTAG_API
+FTC_STATUS WINAPI JTAG_SetDeviceIRCache(FTC_HANDLE ftHandle, BOOL bCacheEnabled)
+{
+  return pFT2232hMpsseJtag->JTAG_SetDeviceInstructionRegisterCache(ftHandle, bCacheEnabled);
+}
+
+extern "C" FTCJTAG_API
+FTC_STATUS WINAPI JTAG_GetDeviceIRCache(FTC_HANDLE ftHandle, LPBOOL lpbCacheEnabled, LPDWORD lpdwNumScansSkipped)
+{
+  return pFT2232hMpsseJtag->JTAG_GetDeviceInstructionRegisterCache(ftHandle, lpbCacheEnabled, lpdwNumScansSkipped);
+}
+
+extern "C" FTCJTAG_API
+FTC_STATUS WINAPI JTAG_CreateScanTemplate(FTC_HANDLE ftHandle, PFTC_SCAN_TEMPLATE_SCAN pScans, DWORD dwNumScans,
+                                          LPDWORD lpdwScanTemplate)
+{
+  return pFT2232hMpsseJtag->JTAG_CreateScanTemplate(ftHandle, pScans, dwNumScans, lpdwScanTemplate);
+}
+
+extern "C" FTCJTAG_API
+FTC_STATUS WINAPI JTAG_ExecuteScanTemplate(FTC_HANDLE ftHandle, DWORD dwScanTemplate, PScanTemplateWriteDataBuffers pWriteDataBuffers,
+                                           PReadCmdSequenceDataByteBuffer pReadDataBuffer, LPDWORD lpdwNumBytesReturned)
+{
+  return pFT2232hMpsseJtag->JTAG_ExecuteScanTemplate(ftHandle, dwScanTemplate, pWriteDataBuffers, pReadDataBuffer,
+                                                     lpdwNumBytesReturned);
+}
+
+extern "C" FTCJTAG_API
+FTC_STATUS WINAPI JTAG_DeleteScanTemplate(FTC_HANDLE ftHandle, DWORD dwScanTemplate)
+{
+  return pFT2232hMpsseJtag->JTAG_DeleteScanTemplate(ftHandle, dwScanTemplate);
+}
+
+extern "C" FTCJTAG_API
+FTC_STATUS WINAPI JTAG_RecordCmdSequence(FTC_HANDLE ftHandle, LPDWORD lpdwRecordedCmdSequence)
+{
+  return pFT2232hMpsseJtag->JTAG_RecordCommandSequence(ftHandle, lpdwRecordedCmdSequence);
+}
+
+extern "C" FTCJTAG_API
+FTC_STATUS WINAPI JTAG_ExecuteRecordedCmdSequence(FTC_HANDLE ftHandle, DWORD dwRecordedCmdSequence,
+                                                  PReadCmdSequenceDataByteBuffer pReadCmdSequenceDataBuffer,
+                                                  LPDWORD lpdwNumBytesReturned)
+{
+  return pFT2232hMpsseJtag->JTAG_ExecuteRecordedCommandSequence(ftHandle, dwRecordedCmdSequence, pReadCmdSequenceDataBuffer,
+                                                                lpdwNumBytesReturned);
+}
+
+extern "C" FTCJTAG_API
+FTC_STATUS WINAPI JTAG_DeleteRecordedCmdSequence(DWORD dwRecordedCmdSequence)
+{
+  return pFT2232hMpsseJtag->JTAG_DeleteRecordedCommandSequence(dwRecordedCmdSequence);
+}
+
 extern "C" FTCJTAG_API
 FTC_STATUS WINAPI JTAG_GetDllVersion(LPSTR lpDllVersionBuffer, DWORD dwBufferSize)
 {
@@ -0,0 +1,359 @@
+/*++
+
+Module Name:
+
+    FtcBitKernels.cpp
+
+Abstract:
+
+    Bit realignment and compare kernels. Every copy is split into the bits up to the first whole destination byte,
+    the whole destination bytes and the bits after the last whole destination byte. Only the whole destination
+    bytes go through a vector kernel, each one of them is built from the top bits of one source byte and the bottom
+    bits of the next. Compares look for the first byte with a masked difference a vector at a time, then find the
+    bit within that byte.
+
+Environment:
+
+    kernel & user mode
+
+--*/
+
+#include "FtcBitKernels.h"
+
+#include <string.h>
+
+#if defined(__GNUC__) && (defined(__x86_64__) || defined(__i386__))
+#include <immintrin.h>
+#define FTC_X86_BIT_KERNELS
+#endif
+
+typedef void (*PShiftBytesKernel)(LPBYTE pDestination, const BYTE *pSource, DWORD dwNumBytes, DWORD dwBitShift);
+typedef DWORD (*PFindMismatchByteKernel)(const BYTE *pData, const BYTE *pExpected, const BYTE *pMask, DWORD dwNumBytes);
+
+// Returns up to 8 bits, starting dwBitOffset bits into pSource, only reading the source bytes that hold them
+static BYTE GetSourceBits(const BYTE *pSource, DWORD dwBitOffset, DWORD dwNumBits)
+{
+  DWORD dwByteIndex = (dwBitOffset / 8);
+  DWORD dwBitShift = (dwBitOffset % 8);
+  DWORD dwBits = 0;
+
+  dwBits = (pSource[dwByteIndex] >> dwBitShift);
+
+  if ((dwBitShift + dwNumBits) > 8)
+    dwBits = (dwBits | (pSource[(dwByteIndex + 1)] << (8 - dwBitShift)));
+
+  return BYTE(dwBits & ((1 << dwNumBits) - 1));
+}
+
+// Builds dwNumBytes whole destination bytes from the source bytes shifted right by dwBitShift (1 - 7) bits, which
+// reads the source bytes up to and including pSource[dwNumBytes]
+static void ShiftBytesScalar(LPBYTE pDestination, const BYTE *pSource, DWORD dwNumBytes, DWORD dwBitShift)
+{
+  DWORD dwByteIndex = 0;
+
+#if defined(__BYTE_ORDER__) && (__BYTE_ORDER__ == __ORDER_LITTLE_ENDIAN__)
+  ULONGLONG ulSourceWord = 0;
+
+  for (dwByteIndex = 0; ((dwByteIndex + 8) <= dwNumBytes); dwByteIndex += 8)
+  {
+    memcpy(&ulSourceWord, &pSource[dwByteIndex], sizeof(ulSourceWord));
+
+    ulSourceWord = ((ulSourceWord >> dwBitShift) | (ULONGLONG(pSource[(dwByteIndex + 8)]) << (64 - dwBitShift)));
+
+    memcpy(&pDestination[dwByteIndex], &ulSourceWord, sizeof(ulSourceWord));
+  }
+#endif
+
+  for (; (dwByteIndex < dwNumBytes); dwByteIndex++)
+    pDestination[dwByteIndex] = BYTE((pSource[dwByteIndex] >> dwBitShift) | (pSource[(dwByteIndex + 1)] << (8 - dwBitShift)));
+}
+
+// Returns the index of the first of dwNumBytes bytes with a masked difference, or dwNumBytes if there is none
+static DWORD FindMismatchByteScalar(const BYTE *pData, const BYTE *pExpected, const BYTE *pMask, DWORD dwNumBytes)
+{
+  DWORD dwByteIndex = 0;
+  ULONGLONG ulDataWord = 0;
+  ULONGLONG ulExpectedWord = 0;
+  ULONGLONG ulMaskWord = 0xFFFFFFFFFFFFFFFFULL;
+  BOOL bMismatch = false;
+
+  for (dwByteIndex = 0; (((dwByteIndex + 8) <= dwNumBytes) && !bMismatch); dwByteIndex += 8)
+  {
+    memcpy(&ulDataWord, &pData[dwByteIndex], sizeof(ulDataWord));
+    memcpy(&ulExpectedWord, &pExpected[dwByteIndex], sizeof(ulExpectedWord));
+
+    if (pMask != NULL)
+      memcpy(&ulMaskWord, &pMask[dwByteIndex], sizeof(ulMaskWord));
+
+    bMismatch = (((ulDataWord ^ ulExpectedWord) & ulMaskWord) != 0);
+  }
+
+  // the word with the difference, or the bytes after the last whole word, are searched a byte at a time
+  if (bMismatch)
+    dwByteIndex = (dwByteIndex - 8);
+
+  while ((dwByteIndex < dwNumBytes) &&
+         (((pData[dwByteIndex] ^ pExpected[dwByteIndex]) & ((pMask != NULL) ? pMask[dwByteIndex] : '\xFF')) == 0))
+    dwByteIndex++;
+
+  return dwByteIndex;
+}
+
+#ifdef FTC_X86_BIT_KERNELS
+// There are no byte shifts, so the bytes are shifted as 16 bit words and the bits shifted in from the
+// neighbouring byte of each word are masked off
+__attribute__((target("sse2")))
+static void ShiftBytesSSE2(LPBYTE pDestination, const BYTE *pSource, DWORD dwNumBytes, DWORD dwBitShift)
+{
+  DWORD dwByteIndex = 0;
+  __m128i LowBitsMask = _mm_set1_epi8(char(0xFF >> dwBitShift));
+  __m128i HighBitsMask = _mm_set1_epi8(char(0xFF << (8 - dwBitShift)));
+  __m128i RightShift = _mm_cvtsi32_si128(int(dwBitShift));
+  __m128i LeftShift = _mm_cvtsi32_si128(int(8 - dwBitShift));
+  __m128i LowBits;
+  __m128i HighBits;
+
+  for (dwByteIndex = 0; ((dwByteIndex + 16) <= dwNumBytes); dwByteIndex += 16)
+  {
+    LowBits = _mm_loadu_si128((const __m128i *)&pSource[dwByteIndex]);
+    HighBits = _mm_loadu_si128((const __m128i *)&pSource[(dwByteIndex + 1)]);
+
+    LowBits = _mm_and_si128(_mm_srl_epi16(LowBits, RightShift), LowBitsMask);
+    HighBits = _mm_and_si128(_mm_sll_epi16(HighBits, LeftShift), HighBitsMask);
+
+    _mm_storeu_si128((__m128i *)&pDestination[dwByteIndex], _mm_or_si128(LowBits, HighBits));
+  }
+
+  if (dwByteIndex < dwNumBytes)
+    ShiftBytesScalar(&pDestination[dwByteIndex], &pSource[dwByteIndex], (dwNumBytes - dwByteIndex), dwBitShift);
+}
+
+__attribute__((target("avx2")))
+static void ShiftBytesAVX2(LPBYTE pDestination, const BYTE *pSource, DWORD dwNumBytes, DWORD dwBitShift)
+{
+  DWORD dwByteIndex = 0;
+  __m256i LowBitsMask = _mm256_set1_epi8(char(0xFF >> dwBitShift));
+  __m256i HighBitsMask = _mm256_set1_epi8(char(0xFF << (8 - dwBitShift)));
+  __m128i RightShift = _mm_cvtsi32_si128(int(dwBitShift));
+  __m128i LeftShift = _mm_cvtsi32_si128(int(8 - dwBitShift));
+  __m256i LowBits;
+  __m256i HighBits;
+
+  for (dwByteIndex = 0; ((dwByteIndex + 32) <= dwNumBytes); dwByteIndex += 32)
+  {
+    LowBits = _mm256_loadu_si256((const __m256i *)&pSource[dwByteIndex]);
+    HighBits = _mm256_loadu_si256((const __m256i *)&pSource[(dwByteIndex + 1)]);
+
+    LowBits = _mm256_and_si256(_mm256_srl_epi16(LowBits, RightShift), LowBitsMask);
+    HighBits = _mm256_and_si256(_mm256_sll_epi16(HighBits, LeftShift), HighBitsMask);
+
+    _mm256_storeu_si256((__m256i *)&pDestination[dwByteIndex], _mm256_or_si256(LowBits, HighBits));
+  }
+
+  if (dwByteIndex < dwNumBytes)
+    ShiftBytesSSE2(&pDestination[dwByteIndex], &pSource[dwByteIndex], (dwNumBytes - dwByteIndex), dwBitShift);
+}
+
+__attribute__((target("sse2")))
+static DWORD FindMismatchByteSSE2(const BYTE *pData, const BYTE *pExpected, const BYTE *pMask, DWORD dwNumBytes)
+{
+  DWORD dwByteIndex = 0;
+  __m128i Mask = _mm_set1_epi8(char(0xFF));
+  __m128i Difference;
+  BOOL bMismatch = false;
+
+  for (dwByteIndex = 0; (((dwByteIndex + 16) <= dwNumBytes) && !bMismatch); dwByteIndex += 16)
+  {
+    Difference = _mm_xor_si128(_mm_loadu_si128((const __m128i *)&pData[dwByteIndex]),
+                               _mm_loadu_si128((const __m128i *)&pExpected[dwByteIndex]));
+
+    if (pMask != NULL)
+      Mask = _mm_loadu_si128((const __m128i *)&pMask[dwByteIndex]);
+
+    Difference = _mm_and_si128(Difference, Mask);
+
+    bMismatch = (_mm_movemask_epi8(_mm_cmpeq_epi8(Difference, _mm_setzero_si128())) != 0xFFFF);
+  }
+
+  if (bMismatch)
+    dwByteIndex = (dwByteIndex - 16);
+
+  return (dwByteIndex + FindMismatchByteScalar(&pData[dwByteIndex], &pExpected[dwByteIndex],
+                                               ((pMask != NULL) ? &pMask[dwByteIndex] : NULL), (dwNumBytes - dwByteIndex)));
+}
+
+__attribute__((target("avx2")))
+static DWORD FindMismatchByteAVX2(const BYTE *pData, const BYTE *pExpected, const BYTE *pMask, DWORD dwNumBytes)
+{
+  DWORD dwByteIndex = 0;
+  __m256i Mask = _mm256_set1_epi8(char(0xFF));
+  __m256i Difference;
+  BOOL bMismatch = false;
+
+  for (dwByteIndex = 0; (((dwByteIndex + 32) <= dwNumBytes) && !bMismatch); dwByteIndex += 32)
+  {
+    Difference = _mm256_xor_si256(_mm256_loadu_si256((const __m256i *)&pData[dwByteIndex]),
+                                  _mm256_loadu_si256((const __m256i *)&pExpected[dwByteIndex]));
+
+    if (pMask != NULL)
+      Mask = _mm256_loadu_si256((const __m256i *)&pMask[dwByteIndex]);
+
+    bMismatch = !_mm256_testz_si256(Difference, Mask);
+  }
+
+  if (bMismatch)
+    dwByteIndex = (dwByteIndex - 32);
+
+  return (dwByteIndex + FindMismatchByteSSE2(&pData[dwByteIndex], &pExpected[dwByteIndex],
+                                             ((pMask != NULL) ? &pMask[dwByteIndex] : NULL), (dwNumBytes - dwByteIndex)));
+}
+#endif
+
+// Returns the kernels the processor supports that are closest to the ones asked for, FTC_BIT_KERNELS_AUTO being the
+// fastest ones
+static DWORD GetSupportedBitKernels(DWORD dwBitKernels)
+{
+  DWORD dwSupportedBitKernels = FTC_BIT_KERNELS_SCALAR;
+
+#ifdef FTC_X86_BIT_KERNELS
+  __builtin_cpu_init();
+
+  if (((dwBitKernels == FTC_BIT_KERNELS_AUTO) || (dwBitKernels == FTC_BIT_KERNELS_AVX2)) && __builtin_cpu_supports("avx2"))
+    dwSupportedBitKernels = FTC_BIT_KERNELS_AVX2;
+  else if ((dwBitKernels != FTC_BIT_KERNELS_SCALAR) && __builtin_cpu_supports("sse2"))
+    dwSupportedBitKernels = FTC_BIT_KERNELS_SSE2;
+#else
+  (void)dwBitKernels;
+#endif
+
+  return dwSupportedBitKernels;
+}
+
+static PShiftBytesKernel SelectShiftBytesKernel(DWORD dwBitKernels)
+{
+  PShiftBytesKernel pShiftBytesKernel = ShiftBytesScalar;
+
+#ifdef FTC_X86_BIT_KERNELS
+  if (dwBitKernels == FTC_BIT_KERNELS_AVX2)
+    pShiftBytesKernel = ShiftBytesAVX2;
+  else if (dwBitKernels == FTC_BIT_KERNELS_SSE2)
+    pShiftBytesKernel = ShiftBytesSSE2;
+#else
+  (void)dwBitKernels;
+#endif
+
+  return pShiftBytesKernel;
+}
+
+static PFindMismatchByteKernel SelectFindMismatchByteKernel(DWORD dwBitKernels)
+{
+  PFindMismatchByteKernel pFindMismatchByteKernel = FindMismatchByteScalar;
+
+#ifdef FTC_X86_BIT_KERNELS
+  if (dwBitKernels == FTC_BIT_KERNELS_AVX2)
+    pFindMismatchByteKernel = FindMismatchByteAVX2;
+  else if (dwBitKernels == FTC_BIT_KERNELS_SSE2)
+    pFindMismatchByteKernel = FindMismatchByteSSE2;
+#else
+  (void)dwBitKernels;
+#endif
+
+  return pFindMismatchByteKernel;
+}
+
+// The kernels are selected once, when the library is loaded, before any device can be opened
+static PShiftBytesKernel pShiftBytesKernel = SelectShiftBytesKernel(GetSupportedBitKernels(FTC_BIT_KERNELS_AUTO));
+static PFindMismatchByteKernel pFindMismatchByteKernel = SelectFindMismatchByteKernel(GetSupportedBitKernels(FTC_BIT_KERNELS_AUTO));
+
+BOOL FTC_SelectBitKernels(DWORD dwBitKernels)
+{
+  BOOL bBitKernelsSelected = FALSE;
+
+  if ((dwBitKernels == FTC_BIT_KERNELS_AUTO) || (GetSupportedBitKernels(dwBitKernels) == dwBitKernels))
+  {
+    pShiftBytesKernel = SelectShiftBytesKernel(GetSupportedBitKernels(dwBitKernels));
+    pFindMismatchByteKernel = SelectFindMismatchByteKernel(GetSupportedBitKernels(dwBitKernels));
+
+    bBitKernelsSelected = TRUE;
+  }
+
+  return bBitKernelsSelected;
+}
+
+void FTC_CopyBits(LPBYTE pDestination, DWORD dwDestinationBitOffset, const BYTE *pSource, DWORD dwSourceBitOffset,
+                  DWORD dwNumBits)
+{
+  DWORD dwDestinationByteIndex = (dwDestinationBitOffset / 8);
+  DWORD dwDestinationBitShift = (dwDestinationBitOffset % 8);
+  DWORD dwNumHeadBits = 0;
+  DWORD dwNumWholeBytes = 0;
+  BYTE  SourceBits = 0;
+
+  // bits up to the first whole destination byte
+  if ((dwDestinationBitShift > 0) && (dwNumBits > 0))
+  {
+    dwNumHeadBits = (8 - dwDestinationBitShift);
+
+    if (dwNumHeadBits > dwNumBits)
+      dwNumHeadBits = dwNumBits;
+
+    SourceBits = GetSourceBits(pSource, dwSourceBitOffset, dwNumHeadBits);
+
+    pDestination[dwDestinationByteIndex] = BYTE((pDestination[dwDestinationByteIndex] & ((1 << dwDestinationBitShift) - 1)) |
+                                                (SourceBits << dwDestinationBitShift));
+
+    dwDestinationByteIndex = (dwDestinationByteIndex + 1);
+    dwSourceBitOffset = (dwSourceBitOffset + dwNumHeadBits);
+    dwNumBits = (dwNumBits - dwNumHeadBits);
+  }
+
+  dwNumWholeBytes = (dwNumBits / 8);
+
+  if (dwNumWholeBytes > 0)
+  {
+    if ((dwSourceBitOffset % 8) == 0)
+      memmove(&pDestination[dwDestinationByteIndex], &pSource[(dwSourceBitOffset / 8)], dwNumWholeBytes);
+    else
+      pShiftBytesKernel(&pDestination[dwDestinationByteIndex], &pSource[(dwSourceBitOffset / 8)], dwNumWholeBytes,
+                        (dwSourceBitOffset % 8));
+
+    dwDestinationByteIndex = (dwDestinationByteIndex + dwNumWholeBytes);
+    dwSourceBitOffset = (dwSourceBitOffset + (dwNumWholeBytes * 8));
+    dwNumBits = (dwNumBits % 8);
+  }
+
+  // bits after the last whole destination byte
+  if (dwNumBits > 0)
+    pDestination[dwDestinationByteIndex] = GetSourceBits(pSource, dwSourceBitOffset, dwNumBits);
+}
+
+DWORD FTC_FindFirstMismatchBit(const BYTE *pData, const BYTE *pExpected, const BYTE *pMask, DWORD dwNumBits)
+{
+  DWORD dwMismatchBitOffset = FTC_NO_BIT_MISMATCH;
+  DWORD dwNumWholeBytes = (dwNumBits / 8);
+  DWORD dwByteIndex = 0;
+  DWORD dwDifference = 0;
+
+  dwByteIndex = pFindMismatchByteKernel(pData, pExpected, pMask, dwNumWholeBytes);
+
+  if (dwByteIndex < dwNumWholeBytes)
+    dwDifference = (pData[dwByteIndex] ^ pExpected[dwByteIndex]);
+  else if ((dwNumBits % 8) > 0)
+    dwDifference = ((pData[dwByteIndex] ^ pExpected[dwByteIndex]) & ((1 << (dwNumBits % 8)) - 1));
+
+  if ((dwDifference != 0) && (pMask != NULL))
+    dwDifference = (dwDifference & pMask[dwByteIndex]);
+
+  if (dwDifference != 0)
+  {
+    dwMismatchBitOffset = (dwByteIndex * 8);
+
+    while ((dwDifference & 1) == 0)
+    {
+      dwDifference = (dwDifference >> 1);
+      dwMismatchBitOffset = (dwMismatchBitOffset + 1);
+    }
+  }
+
+  return dwMismatchBitOffset;
+}
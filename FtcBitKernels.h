@@ -0,0 +1,51 @@
+/*++
+
+Module Name:
+
+    FtcBitKernels.h
+
+Abstract:
+
+    Bit realignment kernels used to turn the bytes read back from a device into the data bits of a scan. The
+    MPSSE returns the whole data bytes of a scan aligned, but the bits of the last partial byte arrive in its top
+    bits and the last data bit arrives in the TMS read byte, so the bits of a scan have to be moved to the bit
+    offset they belong at in the caller's buffer. The kernels use AVX2 or SSE2 when the processor supports them and
+    a word wide scalar loop otherwise. The same applies to the kernel that compares the data read back with the
+    data expected.
+
+Environment:
+
+    kernel & user mode
+
+--*/
+
+#ifndef FtcBitKernels_H
+#define FtcBitKernels_H
+
+#include "ftcjtag.h"
+
+// Copies dwNumBits bits, starting dwSourceBitOffset bits into pSource, to pDestination starting
+// dwDestinationBitOffset bits in. Bits are numbered from the least significant bit of the first byte. The bits of
+// the first destination byte below the first bit copied are kept and the bits of the last destination byte above
+// the last bit copied are cleared. The destination may overlap the source, as long as the first destination bit
+// does not come after the first source bit.
+void FTC_CopyBits(LPBYTE pDestination, DWORD dwDestinationBitOffset, const BYTE *pSource, DWORD dwSourceBitOffset,
+                  DWORD dwNumBits);
+
+#define FTC_NO_BIT_MISMATCH 0xFFFFFFFF
+
+// Returns the offset of the first of dwNumBits bits of pData that differs from the same bit of pExpected and is set
+// in pMask, or FTC_NO_BIT_MISMATCH if there is none. Every bit is compared when pMask is NULL.
+DWORD FTC_FindFirstMismatchBit(const BYTE *pData, const BYTE *pExpected, const BYTE *pMask, DWORD dwNumBits);
+
+#define FTC_BIT_KERNELS_AUTO 0
+#define FTC_BIT_KERNELS_SCALAR 1
+#define FTC_BIT_KERNELS_SSE2 2
+#define FTC_BIT_KERNELS_AVX2 3
+
+// Selects the kernels used by FTC_CopyBits and FTC_FindFirstMismatchBit, so the kernels can be tested against each
+// other. FALSE is returned and the kernels are left as they are if the processor does not support the ones asked
+// for. It must not be called while another thread is using the kernels.
+BOOL FTC_SelectBitKernels(DWORD dwBitKernels);
+
+#endif  /* FtcBitKernels_H */
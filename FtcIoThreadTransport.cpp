@@ -0,0 +1,546 @@
+/*++
+
+Module Name:
+
+    FtcIoThreadTransport.cpp
+
+Abstract:
+
+    I/O thread transport implementation.
+
+Environment:
+
+    kernel & user mode
+
+--*/
+
+#define WIO_DEFINED
+
+#include "FtcJtagInternal.h"
+#include "FT2232c.h"
+#include "FtcIoThreadTransport.h"
+
+#include <cstring>
+
+FtcIoThreadTransport::FtcIoThreadTransport(FtcTransport *pTransport)
+{
+  DWORD dwSlotCntr = 0;
+
+  pDeviceTransport = pTransport;
+
+  bIoThreadStarted = FALSE;
+  bStopIoThread = FALSE;
+  bDiscardBatches = FALSE;
+
+  for (dwSlotCntr = 0; (dwSlotCntr < IO_THREAD_NUM_BATCH_SLOTS); dwSlotCntr++)
+  {
+    Batches[dwSlotCntr].pBuffer = new BYTE[IO_THREAD_BATCH_SLOT_SIZE];
+    Batches[dwSlotCntr].dwNumBytes = 0;
+
+    Completions[dwSlotCntr].Status = FTC_SUCCESS;
+  }
+
+  dwBatchHead = 0;
+  dwBatchTail = 0;
+  dwCompletionHead = 0;
+  dwCompletionTail = 0;
+
+  InitEvent(&BatchSubmitted);
+  InitEvent(&BatchCompleted);
+
+  WriteStatus = FTC_SUCCESS;
+}
+
+FtcIoThreadTransport::~FtcIoThreadTransport(void)
+{
+  DWORD dwSlotCntr = 0;
+
+  if (bIoThreadStarted)
+    Detach();
+
+  if (pDeviceTransport != NULL)
+    delete pDeviceTransport;
+
+  for (dwSlotCntr = 0; (dwSlotCntr < IO_THREAD_NUM_BATCH_SLOTS); dwSlotCntr++)
+  {
+    if (Batches[dwSlotCntr].pBuffer != NULL)
+      delete [] Batches[dwSlotCntr].pBuffer;
+  }
+
+  DeleteEvent(&BatchSubmitted);
+  DeleteEvent(&BatchCompleted);
+}
+
+void FtcIoThreadTransport::InitEvent(PFTC_IO_THREAD_EVENT pEvent)
+{
+#ifdef _WIN32
+  pEvent->hEvent = CreateEvent(NULL, FALSE, FALSE, NULL);
+#else
+  pthread_mutex_init(&pEvent->eMutex, NULL);
+  pthread_cond_init(&pEvent->eCondVar, NULL);
+  pEvent->bSignalled = FALSE;
+#endif
+}
+
+void FtcIoThreadTransport::DeleteEvent(PFTC_IO_THREAD_EVENT pEvent)
+{
+#ifdef _WIN32
+  CloseHandle(pEvent->hEvent);
+#else
+  pthread_cond_destroy(&pEvent->eCondVar);
+  pthread_mutex_destroy(&pEvent->eMutex);
+#endif
+}
+
+void FtcIoThreadTransport::SignalEvent(PFTC_IO_THREAD_EVENT pEvent)
+{
+#ifdef _WIN32
+  SetEvent(pEvent->hEvent);
+#else
+  pthread_mutex_lock(&pEvent->eMutex);
+  pEvent->bSignalled = TRUE;
+  pthread_cond_signal(&pEvent->eCondVar);
+  pthread_mutex_unlock(&pEvent->eMutex);
+#endif
+}
+
+void FtcIoThreadTransport::WaitForEvent(PFTC_IO_THREAD_EVENT pEvent)
+{
+  // The event stays signalled until it has been waited for, so a signal given just before the wait is never lost
+#ifdef _WIN32
+  WaitForSingleObject(pEvent->hEvent, INFINITE);
+#else
+  pthread_mutex_lock(&pEvent->eMutex);
+
+  while (!pEvent->bSignalled)
+    pthread_cond_wait(&pEvent->eCondVar, &pEvent->eMutex);
+
+  pEvent->bSignalled = FALSE;
+
+  pthread_mutex_unlock(&pEvent->eMutex);
+#endif
+}
+
+#ifdef _WIN32
+DWORD WINAPI FtcIoThreadTransport::IoThreadMain(LPVOID lpParameter)
+{
+  ((FtcIoThreadTransport *)lpParameter)->ProcessBatches();
+
+  return 0;
+}
+#else
+void *FtcIoThreadTransport::IoThreadMain(void *pParameter)
+{
+  ((FtcIoThreadTransport *)pParameter)->ProcessBatches();
+
+  return NULL;
+}
+#endif
+
+FTC_STATUS FtcIoThreadTransport::Start(void)
+{
+  FTC_STATUS Status = FTC_SUCCESS;
+
+  bStopIoThread = FALSE;
+
+#ifdef _WIN32
+  if ((hIoThread = CreateThread(NULL, 0, IoThreadMain, this, 0, NULL)) != NULL)
+    bIoThreadStarted = TRUE;
+#else
+  if (pthread_create(&IoThread, NULL, IoThreadMain, this) == 0)
+    bIoThreadStarted = TRUE;
+#endif
+  else
+    Status = FTC_INSUFFICIENT_RESOURCES;
+
+  return Status;
+}
+
+FtcTransport *FtcIoThreadTransport::Detach(void)
+{
+  FtcTransport *pTransport = pDeviceTransport;
+
+  if (bIoThreadStarted)
+  {
+    WaitForBatches();
+
+    bStopIoThread = TRUE;
+    SignalEvent(&BatchSubmitted);
+
+#ifdef _WIN32
+    WaitForSingleObject(hIoThread, INFINITE);
+    CloseHandle(hIoThread);
+#else
+    pthread_join(IoThread, NULL);
+#endif
+
+    bIoThreadStarted = FALSE;
+  }
+
+  pDeviceTransport = NULL;
+
+  return pTransport;
+}
+
+void FtcIoThreadTransport::ProcessBatches(void)
+{
+  FTC_STATUS Status = FTC_SUCCESS;
+  DWORD dwBatchIndex = 0;
+  DWORD dwCompletionIndex = 0;
+
+  while (!bStopIoThread)
+  {
+    dwBatchIndex = dwBatchTail.load(std::memory_order_relaxed);
+
+    if (dwBatchIndex != dwBatchHead.load(std::memory_order_acquire))
+    {
+      // Batches submitted before a purge are dropped rather than written to a device that has stopped responding
+      if (!bDiscardBatches)
+        Status = WriteBatch(&Batches[(dwBatchIndex & (IO_THREAD_NUM_BATCH_SLOTS - 1))]);
+      else
+        Status = FTC_SUCCESS;
+
+      dwBatchTail.store((dwBatchIndex + 1), std::memory_order_release);
+
+      // There is always room for the completion, as the caller never has more batches outstanding than there are
+      // completion slots
+      dwCompletionIndex = dwCompletionHead.load(std::memory_order_relaxed);
+
+      Completions[(dwCompletionIndex & (IO_THREAD_NUM_BATCH_SLOTS - 1))].Status = Status;
+
+      dwCompletionHead.store((dwCompletionIndex + 1), std::memory_order_release);
+
+      SignalEvent(&BatchCompleted);
+    }
+    else
+      WaitForEvent(&BatchSubmitted);
+  }
+}
+
+FTC_STATUS FtcIoThreadTransport::WriteBatch(PFTC_IO_THREAD_BATCH pBatch)
+{
+  FTC_STATUS Status = FTC_SUCCESS;
+  DWORD dwTotalNumBytesWritten = 0;
+  DWORD dwNumBytesWritten = 0;
+
+  // A write that times out part way through is carried on with, the same as FT2232c does when it writes directly
+  while ((dwTotalNumBytesWritten < pBatch->dwNumBytes) && (Status == FTC_SUCCESS))
+  {
+    Status = pDeviceTransport->Write(&pBatch->pBuffer[dwTotalNumBytesWritten], (pBatch->dwNumBytes - dwTotalNumBytesWritten),
+                                     &dwNumBytesWritten);
+
+    if ((Status == FTC_SUCCESS) && (dwNumBytesWritten == 0))
+      Status = FTC_FAILED_TO_COMPLETE_COMMAND;
+
+    dwTotalNumBytesWritten = (dwTotalNumBytesWritten + dwNumBytesWritten);
+  }
+
+  return Status;
+}
+
+void FtcIoThreadTransport::ReapCompletions(void)
+{
+  DWORD dwCompletionIndex = dwCompletionTail.load(std::memory_order_relaxed);
+
+  while (dwCompletionIndex != dwCompletionHead.load(std::memory_order_acquire))
+  {
+    // Only the first failure is kept, later batches are likely to have failed because of it
+    if (WriteStatus == FTC_SUCCESS)
+      WriteStatus = Completions[(dwCompletionIndex & (IO_THREAD_NUM_BATCH_SLOTS - 1))].Status;
+
+    dwCompletionIndex = (dwCompletionIndex + 1);
+
+    dwCompletionTail.store(dwCompletionIndex, std::memory_order_release);
+  }
+}
+
+FTC_STATUS FtcIoThreadTransport::WaitForBatches(void)
+{
+  FTC_STATUS Status = FTC_SUCCESS;
+
+  // Every batch has been written once its completion has been reaped, after which the I/O thread no longer touches
+  // the wrapped transport until the next batch is submitted
+  ReapCompletions();
+
+  while (dwCompletionTail.load(std::memory_order_relaxed) != dwBatchHead.load(std::memory_order_relaxed))
+  {
+    WaitForEvent(&BatchCompleted);
+
+    ReapCompletions();
+  }
+
+  // A failed write is reported by the next request made after it
+  Status = WriteStatus;
+  WriteStatus = FTC_SUCCESS;
+
+  return Status;
+}
+
+DWORD FtcIoThreadTransport::GetTransportType(void)
+{
+  return pDeviceTransport->GetTransportType();
+}
+
+FTC_STATUS FtcIoThreadTransport::GetDeviceType(LPDWORD lpdwDeviceType)
+{
+  return pDeviceTransport->GetDeviceType(lpdwDeviceType);
+}
+
+FTC_STATUS FtcIoThreadTransport::Write(LPBYTE pBuffer, DWORD dwNumBytesToWrite, LPDWORD lpdwNumBytesWritten)
+{
+  FTC_WRITE_SEGMENT WriteSegment;
+
+  WriteSegment.pBuffer = pBuffer;
+  WriteSegment.dwNumBytes = dwNumBytesToWrite;
+
+  return WriteSegments(&WriteSegment, 1, lpdwNumBytesWritten);
+}
+
+FTC_STATUS FtcIoThreadTransport::WriteSegments(PFTC_WRITE_SEGMENT pSegments, DWORD dwNumSegments, LPDWORD lpdwNumBytesWritten)
+{
+  FTC_STATUS Status = FTC_SUCCESS;
+  PFTC_IO_THREAD_BATCH pBatch = NULL;
+  DWORD dwBatchIndex = 0;
+  DWORD dwSegmentIndex = 0;
+  DWORD dwSegmentByteIndex = 0;
+  DWORD dwNumSegmentBytes = 0;
+  DWORD dwNumBytesWritten = 0;
+
+  ReapCompletions();
+
+  Status = WriteStatus;
+  WriteStatus = FTC_SUCCESS;
+
+  // The segments are copied into batch slots, as the caller reuses its buffers as soon as the write returns, and
+  // each slot is handed to the I/O thread as soon as it is full
+  while ((dwSegmentIndex < dwNumSegments) && (Status == FTC_SUCCESS))
+  {
+    dwBatchIndex = dwBatchHead.load(std::memory_order_relaxed);
+
+    // Wait for a slot to be freed if every slot holds a batch whose completion has not been reaped yet
+    while ((dwBatchIndex - dwCompletionTail.load(std::memory_order_relaxed)) >= IO_THREAD_NUM_BATCH_SLOTS)
+    {
+      WaitForEvent(&BatchCompleted);
+
+      ReapCompletions();
+    }
+
+    pBatch = &Batches[(dwBatchIndex & (IO_THREAD_NUM_BATCH_SLOTS - 1))];
+    pBatch->dwNumBytes = 0;
+
+    while ((dwSegmentIndex < dwNumSegments) && (pBatch->dwNumBytes < IO_THREAD_BATCH_SLOT_SIZE))
+    {
+      dwNumSegmentBytes = (pSegments[dwSegmentIndex].dwNumBytes - dwSegmentByteIndex);
+
+      if (dwNumSegmentBytes > (IO_THREAD_BATCH_SLOT_SIZE - pBatch->dwNumBytes))
+        dwNumSegmentBytes = (IO_THREAD_BATCH_SLOT_SIZE - pBatch->dwNumBytes);
+
+      memcpy(&pBatch->pBuffer[pBatch->dwNumBytes], &pSegments[dwSegmentIndex].pBuffer[dwSegmentByteIndex], dwNumSegmentBytes);
+
+      pBatch->dwNumBytes = (pBatch->dwNumBytes + dwNumSegmentBytes);
+      dwSegmentByteIndex = (dwSegmentByteIndex + dwNumSegmentBytes);
+
+      if (dwSegmentByteIndex == pSegments[dwSegmentIndex].dwNumBytes)
+      {
+        dwSegmentIndex = (dwSegmentIndex + 1);
+        dwSegmentByteIndex = 0;
+      }
+    }
+
+    if (pBatch->dwNumBytes > 0)
+    {
+      dwBatchHead.store((dwBatchIndex + 1), std::memory_order_release);
+
+      SignalEvent(&BatchSubmitted);
+
+      dwNumBytesWritten = (dwNumBytesWritten + pBatch->dwNumBytes);
+    }
+  }
+
+  *lpdwNumBytesWritten = dwNumBytesWritten;
+
+  return Status;
+}
+
+FTC_STATUS FtcIoThreadTransport::Read(LPBYTE pBuffer, DWORD dwNumBytesToRead, LPDWORD lpdwNumBytesRead)
+{
+  FTC_STATUS Status = FTC_SUCCESS;
+
+  *lpdwNumBytesRead = 0;
+
+  if ((Status = WaitForBatches()) == FTC_SUCCESS)
+    Status = pDeviceTransport->Read(pBuffer, dwNumBytesToRead, lpdwNumBytesRead);
+
+  return Status;
+}
+
+FTC_STATUS FtcIoThreadTransport::GetQueueStatus(LPDWORD lpdwNumBytesInQueue)
+{
+  FTC_STATUS Status = FTC_SUCCESS;
+
+  *lpdwNumBytesInQueue = 0;
+
+  if ((Status = WaitForBatches()) == FTC_SUCCESS)
+    Status = pDeviceTransport->GetQueueStatus(lpdwNumBytesInQueue);
+
+  return Status;
+}
+
+FTC_STATUS FtcIoThreadTransport::WaitForBytes(DWORD dwNumBytesExpected, DWORD dwTimeoutmSec, LPDWORD lpdwNumBytesInQueue)
+{
+  FTC_STATUS Status = FTC_SUCCESS;
+
+  *lpdwNumBytesInQueue = 0;
+
+  if ((Status = WaitForBatches()) == FTC_SUCCESS)
+    Status = pDeviceTransport->WaitForBytes(dwNumBytesExpected, dwTimeoutmSec, lpdwNumBytesInQueue);
+
+  return Status;
+}
+
+FTC_STATUS FtcIoThreadTransport::WaitForBytesConcurrently(DWORD dwNumBytesExpected, DWORD dwTimeoutmSec, LPDWORD lpdwNumBytesInQueue)
+{
+  // The batches are not waited for, the bytes they return are received by the device transport whichever thread
+  // writes them
+  return pDeviceTransport->WaitForBytesConcurrently(dwNumBytesExpected, dwTimeoutmSec, lpdwNumBytesInQueue);
+}
+
+FTC_STATUS FtcIoThreadTransport::ResetDevice(void)
+{
+  FTC_STATUS Status = FTC_SUCCESS;
+
+  if ((Status = WaitForBatches()) == FTC_SUCCESS)
+    Status = pDeviceTransport->ResetDevice();
+
+  return Status;
+}
+
+FTC_STATUS FtcIoThreadTransport::SetUSBParameters(DWORD dwInTransferSize, DWORD dwOutTransferSize)
+{
+  FTC_STATUS Status = FTC_SUCCESS;
+
+  if ((Status = WaitForBatches()) == FTC_SUCCESS)
+    Status = pDeviceTransport->SetUSBParameters(dwInTransferSize, dwOutTransferSize);
+
+  return Status;
+}
+
+FTC_STATUS FtcIoThreadTransport::SetChars(UCHAR EventCharacter, UCHAR EventCharEnabled, UCHAR ErrorCharacter, UCHAR ErrorCharEnabled)
+{
+  FTC_STATUS Status = FTC_SUCCESS;
+
+  if ((Status = WaitForBatches()) == FTC_SUCCESS)
+    Status = pDeviceTransport->SetChars(EventCharacter, EventCharEnabled, ErrorCharacter, ErrorCharEnabled);
+
+  return Status;
+}
+
+FTC_STATUS FtcIoThreadTransport::SetTimeouts(DWORD dwReadTimeoutmSec, DWORD dwWriteTimeoutmSec)
+{
+  FTC_STATUS Status = FTC_SUCCESS;
+
+  if ((Status = WaitForBatches()) == FTC_SUCCESS)
+    Status = pDeviceTransport->SetTimeouts(dwReadTimeoutmSec, dwWriteTimeoutmSec);
+
+  return Status;
+}
+
+FTC_STATUS FtcIoThreadTransport::SetLatencyTimer(BYTE LatencyTimermSec)
+{
+  FTC_STATUS Status = FTC_SUCCESS;
+
+  if ((Status = WaitForBatches()) == FTC_SUCCESS)
+    Status = pDeviceTransport->SetLatencyTimer(LatencyTimermSec);
+
+  return Status;
+}
+
+FTC_STATUS FtcIoThreadTransport::GetLatencyTimer(LPBYTE lpLatencyTimermSec)
+{
+  FTC_STATUS Status = FTC_SUCCESS;
+
+  if ((Status = WaitForBatches()) == FTC_SUCCESS)
+    Status = pDeviceTransport->GetLatencyTimer(lpLatencyTimermSec);
+
+  return Status;
+}
+
+FTC_STATUS FtcIoThreadTransport::SetBitMode(BYTE PinDirectionMask, BYTE BitMode)
+{
+  FTC_STATUS Status = FTC_SUCCESS;
+
+  if ((Status = WaitForBatches()) == FTC_SUCCESS)
+    Status = pDeviceTransport->SetBitMode(PinDirectionMask, BitMode);
+
+  return Status;
+}
+
+FTC_STATUS FtcIoThreadTransport::Purge(void)
+{
+  // The batches still waiting to be written are dropped and any write failure is forgotten, as the purge discards
+  // everything sent to the device anyway
+  bDiscardBatches = TRUE;
+
+  WaitForBatches();
+
+  bDiscardBatches = FALSE;
+
+  return pDeviceTransport->Purge();
+}
+
+FTC_STATUS FtcIoThreadTransport::SetTransferQueueDepth(DWORD dwNumWriteTransfers, DWORD dwNumReadTransfers)
+{
+  FTC_STATUS Status = FTC_SUCCESS;
+
+  if ((Status = WaitForBatches()) == FTC_SUCCESS)
+    Status = pDeviceTransport->SetTransferQueueDepth(dwNumWriteTransfers, dwNumReadTransfers);
+
+  return Status;
+}
+
+FTC_STATUS FtcIoThreadTransport::GetTransferQueueDepth(LPDWORD lpdwNumWriteTransfers, LPDWORD lpdwNumReadTransfers)
+{
+  FTC_STATUS Status = FTC_SUCCESS;
+
+  if ((Status = WaitForBatches()) == FTC_SUCCESS)
+    Status = pDeviceTransport->GetTransferQueueDepth(lpdwNumWriteTransfers, lpdwNumReadTransfers);
+
+  return Status;
+}
+
+FTC_STATUS FtcIoThreadTransport::GetEmulatorState(PFTC_EMULATOR_STATE pEmulatorState)
+{
+  FTC_STATUS Status = FTC_SUCCESS;
+
+  if ((Status = WaitForBatches()) == FTC_SUCCESS)
+    Status = pDeviceTransport->GetEmulatorState(pEmulatorState);
+
+  return Status;
+}
+
+DWORD FtcIoThreadTransport::GetMaxWriteTransferSize(void)
+{
+  DWORD dwMaxWriteTransferSize = pDeviceTransport->GetMaxWriteTransferSize();
+
+  if (dwMaxWriteTransferSize > IO_THREAD_BATCH_SLOT_SIZE)
+    dwMaxWriteTransferSize = IO_THREAD_BATCH_SLOT_SIZE;
+
+  return dwMaxWriteTransferSize;
+}
+
+FTC_STATUS FtcIoThreadTransport::Close(void)
+{
+  FtcTransport *pTransport = NULL;
+  FTC_STATUS Status = FTC_SUCCESS;
+
+  // The wrapped transport is closed once the I/O thread has written every batch submitted and stopped, it is
+  // deleted along with this transport
+  pTransport = Detach();
+
+  pDeviceTransport = pTransport;
+
+  if (pDeviceTransport != NULL)
+    Status = pDeviceTransport->Close();
+
+  return Status;
+}
@@ -0,0 +1,133 @@
+/*++
+
+Module Name:
+
+    FtcIoThreadTransport.h
+
+Abstract:
+
+    I/O thread transport, which wraps the transport of an opened device and hands every write to a thread owned
+    by the device handle. Encoded MPSSE command batches are passed to the thread through a single producer/single
+    consumer lock free ring and the result of every batch is passed back through a completion ring, so the caller
+    can encode the next batch while the previous one is on the wire. Every other request waits for the batches
+    already submitted to be written, then goes straight to the wrapped transport.
+
+Environment:
+
+    kernel & user mode
+
+--*/
+
+#ifndef FtcIoThreadTransport_H
+#define FtcIoThreadTransport_H
+
+#include "FtcTransport.h"
+
+#include <atomic>
+
+#define IO_THREAD_NUM_BATCH_SLOTS 8                          // must be a power of two
+#define IO_THREAD_BATCH_SLOT_SIZE MAX_USB_TRANSFER_CHUNK_SIZE
+
+typedef struct Ft_Io_Thread_Batch{
+  LPBYTE pBuffer;                                   // encoded MPSSE command bytes to be written to the device
+  DWORD  dwNumBytes;                                // number of bytes in the batch
+}FTC_IO_THREAD_BATCH, *PFTC_IO_THREAD_BATCH;
+
+typedef struct Ft_Io_Thread_Completion{
+  FTC_STATUS Status;                                // result of writing a batch to the device
+}FTC_IO_THREAD_COMPLETION, *PFTC_IO_THREAD_COMPLETION;
+
+typedef struct Ft_Io_Thread_Event{
+#ifdef _WIN32
+  HANDLE hEvent;
+#else
+  pthread_mutex_t eMutex;
+  pthread_cond_t eCondVar;
+  BOOL bSignalled;
+#endif
+}FTC_IO_THREAD_EVENT, *PFTC_IO_THREAD_EVENT;
+
+class FtcIoThreadTransport : public FtcTransport
+{
+private:
+  FtcTransport *pDeviceTransport;   // transport of the opened device, only written to by the I/O thread
+
+#ifdef _WIN32
+  HANDLE hIoThread;
+#else
+  pthread_t IoThread;
+#endif
+  BOOL bIoThreadStarted;
+  std::atomic<BOOL> bStopIoThread;
+  std::atomic<BOOL> bDiscardBatches;
+
+  // Submission ring, filled by the caller and emptied by the I/O thread
+  FTC_IO_THREAD_BATCH Batches[IO_THREAD_NUM_BATCH_SLOTS];
+  std::atomic<DWORD> dwBatchHead;
+  std::atomic<DWORD> dwBatchTail;
+
+  // Completion ring, filled by the I/O thread and emptied by the caller
+  FTC_IO_THREAD_COMPLETION Completions[IO_THREAD_NUM_BATCH_SLOTS];
+  std::atomic<DWORD> dwCompletionHead;
+  std::atomic<DWORD> dwCompletionTail;
+
+  FTC_IO_THREAD_EVENT BatchSubmitted;
+  FTC_IO_THREAD_EVENT BatchCompleted;
+
+  FTC_STATUS WriteStatus;           // first failed batch result not yet returned to the caller
+
+#ifdef _WIN32
+  static DWORD WINAPI IoThreadMain(LPVOID lpParameter);
+#else
+  static void *IoThreadMain(void *pParameter);
+#endif
+  void       ProcessBatches(void);
+  FTC_STATUS WriteBatch(PFTC_IO_THREAD_BATCH pBatch);
+
+  void       ReapCompletions(void);
+  FTC_STATUS WaitForBatches(void);
+
+  static void InitEvent(PFTC_IO_THREAD_EVENT pEvent);
+  static void DeleteEvent(PFTC_IO_THREAD_EVENT pEvent);
+  static void SignalEvent(PFTC_IO_THREAD_EVENT pEvent);
+  static void WaitForEvent(PFTC_IO_THREAD_EVENT pEvent);
+
+public:
+  FtcIoThreadTransport(FtcTransport *pTransport);
+  ~FtcIoThreadTransport(void);
+
+  FTC_STATUS Start(void);
+
+  // Stops the I/O thread once every submitted batch has been written and returns the wrapped transport, which is
+  // then owned by the caller again
+  FtcTransport *Detach(void);
+
+  DWORD GetTransportType(void);
+  FTC_STATUS GetDeviceType(LPDWORD lpdwDeviceType);
+
+  FTC_STATUS Write(LPBYTE pBuffer, DWORD dwNumBytesToWrite, LPDWORD lpdwNumBytesWritten);
+  FTC_STATUS WriteSegments(PFTC_WRITE_SEGMENT pSegments, DWORD dwNumSegments, LPDWORD lpdwNumBytesWritten);
+  FTC_STATUS Read(LPBYTE pBuffer, DWORD dwNumBytesToRead, LPDWORD lpdwNumBytesRead);
+  FTC_STATUS GetQueueStatus(LPDWORD lpdwNumBytesInQueue);
+  FTC_STATUS WaitForBytes(DWORD dwNumBytesExpected, DWORD dwTimeoutmSec, LPDWORD lpdwNumBytesInQueue);
+  FTC_STATUS WaitForBytesConcurrently(DWORD dwNumBytesExpected, DWORD dwTimeoutmSec, LPDWORD lpdwNumBytesInQueue);
+
+  FTC_STATUS ResetDevice(void);
+  FTC_STATUS SetUSBParameters(DWORD dwInTransferSize, DWORD dwOutTransferSize);
+  FTC_STATUS SetChars(UCHAR EventCharacter, UCHAR EventCharEnabled, UCHAR ErrorCharacter, UCHAR ErrorCharEnabled);
+  FTC_STATUS SetTimeouts(DWORD dwReadTimeoutmSec, DWORD dwWriteTimeoutmSec);
+  FTC_STATUS SetLatencyTimer(BYTE LatencyTimermSec);
+  FTC_STATUS GetLatencyTimer(LPBYTE lpLatencyTimermSec);
+  FTC_STATUS SetBitMode(BYTE PinDirectionMask, BYTE BitMode);
+  FTC_STATUS Purge(void);
+
+  FTC_STATUS SetTransferQueueDepth(DWORD dwNumWriteTransfers, DWORD dwNumReadTransfers);
+  FTC_STATUS GetTransferQueueDepth(LPDWORD lpdwNumWriteTransfers, LPDWORD lpdwNumReadTransfers);
+  FTC_STATUS GetEmulatorState(PFTC_EMULATOR_STATE pEmulatorState);
+
+  DWORD GetMaxWriteTransferSize(void);
+
+  FTC_STATUS Close(void);
+};
+
+#endif  /* FtcIoThreadTransport_H */
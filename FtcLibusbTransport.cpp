@@ -0,0 +1,801 @@
+/*++
+
+Module Name:
+
+    FtcLibusbTransport.cpp
+
+Abstract:
+
+    libusb-1.0 transport backend implementation.
+
+Environment:
+
+    kernel & user mode
+
+--*/
+
+#define WIO_DEFINED
+
+#include "FtcJtagInternal.h"
+#include "FT2232c.h"
+#include "FtcLibusbTransport.h"
+
+#ifdef FTCJTAG_LIBUSB
+
+#include <cstring>
+
+// FTDI vendor requests, the index of every request is the number of the interface plus one
+const BYTE SIO_RESET_REQUEST = '\x00';
+const BYTE SIO_SET_EVENT_CHAR_REQUEST = '\x06';
+const BYTE SIO_SET_ERROR_CHAR_REQUEST = '\x07';
+const BYTE SIO_SET_LATENCY_TIMER_REQUEST = '\x09';
+const BYTE SIO_GET_LATENCY_TIMER_REQUEST = '\x0A';
+const BYTE SIO_SET_BITMODE_REQUEST = '\x0B';
+
+const WORD SIO_RESET_SIO = 0;
+const WORD SIO_RESET_PURGE_RX = 1;
+const WORD SIO_RESET_PURGE_TX = 2;
+
+const BYTE FTDI_DEVICE_OUT_REQUEST_TYPE = (LIBUSB_REQUEST_TYPE_VENDOR | LIBUSB_RECIPIENT_DEVICE | LIBUSB_ENDPOINT_OUT);
+const BYTE FTDI_DEVICE_IN_REQUEST_TYPE = (LIBUSB_REQUEST_TYPE_VENDOR | LIBUSB_RECIPIENT_DEVICE | LIBUSB_ENDPOINT_IN);
+
+FtcLibusbTransport::FtcLibusbTransport(void)
+{
+  DWORD dwTransferCntr = 0;
+
+  pContext = NULL;
+  pDeviceHandle = NULL;
+  iInterface = 0;
+  WriteEndpoint = 0;
+  ReadEndpoint = 0;
+  dwMaxPacketSize = 64;
+  dwDeviceType = FT_DEVICE_UNKNOWN;
+  dwReadTimeoutmSec = 0;
+  dwWriteTimeoutmSec = LIBUSB_CONTROL_TIMEOUT;
+  dwInTransferSize = LIBUSB_DEFAULT_IN_TRANSFER_SIZE;
+
+  for (dwTransferCntr = 0; (dwTransferCntr < MAX_NUM_QUEUED_TRANSFERS); dwTransferCntr++)
+  {
+    WriteTransfers[dwTransferCntr].pTransport = this;
+    WriteTransfers[dwTransferCntr].pTransfer = NULL;
+    WriteTransfers[dwTransferCntr].pBuffer = NULL;
+    WriteTransfers[dwTransferCntr].bInFlight = FALSE;
+
+    ReadTransfers[dwTransferCntr].pTransport = this;
+    ReadTransfers[dwTransferCntr].pTransfer = NULL;
+    ReadTransfers[dwTransferCntr].pBuffer = NULL;
+    ReadTransfers[dwTransferCntr].bInFlight = FALSE;
+  }
+
+  dwNumWriteTransfers = DEFAULT_NUM_QUEUED_TRANSFERS;
+  dwNumReadTransfers = DEFAULT_NUM_QUEUED_TRANSFERS;
+  dwNextWriteTransfer = 0;
+  dwNumTransfersInFlight = 0;
+  bCancellingTransfers = FALSE;
+  TransferStatus = FTC_SUCCESS;
+
+  pReceiveBuffer = new BYTE[LIBUSB_INITIAL_RECEIVE_BUFFER_SIZE];
+  dwReceiveBufferSize = LIBUSB_INITIAL_RECEIVE_BUFFER_SIZE;
+  dwReceiveHead = 0;
+  dwReceiveTail = 0;
+}
+
+FtcLibusbTransport::~FtcLibusbTransport(void)
+{
+  if (pDeviceHandle != NULL)
+    Close();
+
+  if (pReceiveBuffer != NULL)
+    delete [] pReceiveBuffer;
+}
+
+FTC_STATUS FtcLibusbTransport::Open(DWORD dwDeviceIndex)
+{
+  FTC_STATUS Status = FTC_DEVICE_NOT_FOUND;
+  libusb_device **ppDeviceList = NULL;
+  struct libusb_device_descriptor DeviceDescriptor;
+  struct libusb_config_descriptor *pConfigDescriptor = NULL;
+  ssize_t iNumDevices = 0;
+  ssize_t iDeviceCntr = 0;
+  INT iNumChannels = 0;
+  DWORD dwChannelIndex = 0;
+  BOOL bDeviceFound = FALSE;
+
+  if (libusb_init(&pContext) != LIBUSB_SUCCESS)
+    return FTC_IO_ERROR;
+
+  if ((iNumDevices = libusb_get_device_list(pContext, &ppDeviceList)) >= 0)
+  {
+    // Every MPSSE capable channel of every FTDI dual or quad device is counted, channel A of a FT2232D device and
+    // channels A and B of a FT2232H or FT4232H device
+    for (iDeviceCntr = 0; ((iDeviceCntr < iNumDevices) && !bDeviceFound); iDeviceCntr++)
+    {
+      if (libusb_get_device_descriptor(ppDeviceList[iDeviceCntr], &DeviceDescriptor) == LIBUSB_SUCCESS)
+      {
+        if ((DeviceDescriptor.idVendor == FTDI_VENDOR_ID) &&
+            ((DeviceDescriptor.idProduct == FT2232_PRODUCT_ID) || (DeviceDescriptor.idProduct == FT4232H_PRODUCT_ID)))
+        {
+          if (DeviceDescriptor.bcdDevice == FT2232C_BCD_DEVICE)
+            iNumChannels = 1;
+          else
+            iNumChannels = 2;
+
+          if (dwDeviceIndex < (dwChannelIndex + iNumChannels))
+          {
+            bDeviceFound = TRUE;
+
+            iInterface = (dwDeviceIndex - dwChannelIndex);
+
+            if (DeviceDescriptor.bcdDevice == FT2232C_BCD_DEVICE)
+              dwDeviceType = FT_DEVICE_2232C;
+            else if (DeviceDescriptor.bcdDevice == FT4232H_BCD_DEVICE)
+              dwDeviceType = FT_DEVICE_4232H;
+            else
+              dwDeviceType = FT_DEVICE_2232H;
+
+            if (libusb_open(ppDeviceList[iDeviceCntr], &pDeviceHandle) == LIBUSB_SUCCESS)
+            {
+              if (libusb_get_active_config_descriptor(ppDeviceList[iDeviceCntr], &pConfigDescriptor) == LIBUSB_SUCCESS)
+              {
+                dwMaxPacketSize = pConfigDescriptor->interface[iInterface].altsetting[0].endpoint[0].wMaxPacketSize;
+
+                libusb_free_config_descriptor(pConfigDescriptor);
+              }
+
+              // Detach the ftdi_sio kernel driver from the channel if it is bound to it
+              if (libusb_kernel_driver_active(pDeviceHandle, iInterface) == 1)
+                libusb_detach_kernel_driver(pDeviceHandle, iInterface);
+
+              if (libusb_claim_interface(pDeviceHandle, iInterface) == LIBUSB_SUCCESS)
+              {
+                WriteEndpoint = (LIBUSB_ENDPOINT_OUT | (2 + (iInterface * 2)));
+                ReadEndpoint = (LIBUSB_ENDPOINT_IN | (1 + (iInterface * 2)));
+
+                if ((Status = AllocateTransfers()) == FTC_SUCCESS)
+                  Status = SubmitReadTransfers();
+
+                if (Status != FTC_SUCCESS)
+                {
+                  CancelTransfers();
+                  FreeTransfers();
+
+                  libusb_release_interface(pDeviceHandle, iInterface);
+                  libusb_close(pDeviceHandle);
+
+                  pDeviceHandle = NULL;
+                }
+              }
+              else
+              {
+                libusb_close(pDeviceHandle);
+
+                pDeviceHandle = NULL;
+
+                Status = FTC_DEVICE_IN_USE;
+              }
+            }
+            else
+              Status = FTC_DEVICE_NOT_OPENED;
+          }
+
+          dwChannelIndex = (dwChannelIndex + iNumChannels);
+        }
+      }
+    }
+
+    libusb_free_device_list(ppDeviceList, 1);
+  }
+  else
+    Status = FTC_IO_ERROR;
+
+  if (Status != FTC_SUCCESS)
+  {
+    libusb_exit(pContext);
+
+    pContext = NULL;
+  }
+
+  return Status;
+}
+
+void LIBUSB_CALL FtcLibusbTransport::WriteTransferComplete(struct libusb_transfer *pTransfer)
+{
+  PFTC_LIBUSB_TRANSFER_DATA pWriteTransfer = (PFTC_LIBUSB_TRANSFER_DATA)pTransfer->user_data;
+  FtcLibusbTransport *pTransport = pWriteTransfer->pTransport;
+
+  pWriteTransfer->bInFlight = FALSE;
+  pTransport->dwNumTransfersInFlight = (pTransport->dwNumTransfersInFlight - 1);
+
+  if ((pTransfer->status != LIBUSB_TRANSFER_COMPLETED) || (pTransfer->actual_length != pTransfer->length))
+  {
+    if (pTransport->TransferStatus == FTC_SUCCESS)
+      pTransport->TransferStatus = FTC_IO_ERROR;
+  }
+}
+
+void LIBUSB_CALL FtcLibusbTransport::ReadTransferComplete(struct libusb_transfer *pTransfer)
+{
+  PFTC_LIBUSB_TRANSFER_DATA pReadTransfer = (PFTC_LIBUSB_TRANSFER_DATA)pTransfer->user_data;
+  FtcLibusbTransport *pTransport = pReadTransfer->pTransport;
+  FTC_STATUS Status = FTC_SUCCESS;
+  INT iPacketOffset = 0;
+  INT iNumPacketBytes = 0;
+
+  pReadTransfer->bInFlight = FALSE;
+  pTransport->dwNumTransfersInFlight = (pTransport->dwNumTransfersInFlight - 1);
+
+  if (pTransfer->status == LIBUSB_TRANSFER_COMPLETED)
+  {
+    // Strip the two modem status bytes from the start of every packet
+    for (iPacketOffset = 0; ((iPacketOffset < pTransfer->actual_length) && (Status == FTC_SUCCESS)); iPacketOffset += pTransport->dwMaxPacketSize)
+    {
+      iNumPacketBytes = (pTransfer->actual_length - iPacketOffset);
+
+      if (iNumPacketBytes > (INT)pTransport->dwMaxPacketSize)
+        iNumPacketBytes = pTransport->dwMaxPacketSize;
+
+      if (iNumPacketBytes > FTDI_NUM_MODEM_STATUS_BYTES)
+        Status = pTransport->AddReceivedBytes(&pTransfer->buffer[(iPacketOffset + FTDI_NUM_MODEM_STATUS_BYTES)],
+                                              (iNumPacketBytes - FTDI_NUM_MODEM_STATUS_BYTES));
+    }
+
+    // Put the transfer straight back on the read endpoint, so there is always a read request waiting for the device
+    if ((Status == FTC_SUCCESS) && !pTransport->bCancellingTransfers)
+      Status = pTransport->SubmitReadTransfer(pReadTransfer);
+  }
+  else if (pTransfer->status != LIBUSB_TRANSFER_CANCELLED)
+    Status = FTC_IO_ERROR;
+
+  if ((Status != FTC_SUCCESS) && (pTransport->TransferStatus == FTC_SUCCESS))
+    pTransport->TransferStatus = Status;
+}
+
+FTC_STATUS FtcLibusbTransport::AllocateTransfers(void)
+{
+  FTC_STATUS Status = FTC_SUCCESS;
+  DWORD dwTransferCntr = 0;
+
+  for (dwTransferCntr = 0; ((dwTransferCntr < dwNumWriteTransfers) && (Status == FTC_SUCCESS)); dwTransferCntr++)
+  {
+    WriteTransfers[dwTransferCntr].pTransfer = libusb_alloc_transfer(0);
+    WriteTransfers[dwTransferCntr].pBuffer = new BYTE[LIBUSB_MAX_OUT_TRANSFER_SIZE];
+    WriteTransfers[dwTransferCntr].bInFlight = FALSE;
+
+    if ((WriteTransfers[dwTransferCntr].pTransfer == NULL) || (WriteTransfers[dwTransferCntr].pBuffer == NULL))
+      Status = FTC_INSUFFICIENT_RESOURCES;
+  }
+
+  for (dwTransferCntr = 0; ((dwTransferCntr < dwNumReadTransfers) && (Status == FTC_SUCCESS)); dwTransferCntr++)
+  {
+    ReadTransfers[dwTransferCntr].pTransfer = libusb_alloc_transfer(0);
+    ReadTransfers[dwTransferCntr].pBuffer = new BYTE[LIBUSB_MAX_IN_TRANSFER_SIZE];
+    ReadTransfers[dwTransferCntr].bInFlight = FALSE;
+
+    if ((ReadTransfers[dwTransferCntr].pTransfer == NULL) || (ReadTransfers[dwTransferCntr].pBuffer == NULL))
+      Status = FTC_INSUFFICIENT_RESOURCES;
+  }
+
+  dwNextWriteTransfer = 0;
+  bCancellingTransfers = FALSE;
+  TransferStatus = FTC_SUCCESS;
+
+  return Status;
+}
+
+void FtcLibusbTransport::FreeTransfers(void)
+{
+  DWORD dwTransferCntr = 0;
+
+  // Must only be called when no transfers are in flight
+  for (dwTransferCntr = 0; (dwTransferCntr < MAX_NUM_QUEUED_TRANSFERS); dwTransferCntr++)
+  {
+    if (WriteTransfers[dwTransferCntr].pTransfer != NULL)
+      libusb_free_transfer(WriteTransfers[dwTransferCntr].pTransfer);
+
+    if (WriteTransfers[dwTransferCntr].pBuffer != NULL)
+      delete [] WriteTransfers[dwTransferCntr].pBuffer;
+
+    WriteTransfers[dwTransferCntr].pTransfer = NULL;
+    WriteTransfers[dwTransferCntr].pBuffer = NULL;
+
+    if (ReadTransfers[dwTransferCntr].pTransfer != NULL)
+      libusb_free_transfer(ReadTransfers[dwTransferCntr].pTransfer);
+
+    if (ReadTransfers[dwTransferCntr].pBuffer != NULL)
+      delete [] ReadTransfers[dwTransferCntr].pBuffer;
+
+    ReadTransfers[dwTransferCntr].pTransfer = NULL;
+    ReadTransfers[dwTransferCntr].pBuffer = NULL;
+  }
+}
+
+FTC_STATUS FtcLibusbTransport::SubmitReadTransfer(PFTC_LIBUSB_TRANSFER_DATA pReadTransfer)
+{
+  FTC_STATUS Status = FTC_SUCCESS;
+
+  // A timeout of zero ie no timeout, the device returns a packet containing only the modem status bytes every time
+  // the latency timer expires
+  libusb_fill_bulk_transfer(pReadTransfer->pTransfer, pDeviceHandle, ReadEndpoint, pReadTransfer->pBuffer,
+                            dwInTransferSize, ReadTransferComplete, pReadTransfer, 0);
+
+  if (libusb_submit_transfer(pReadTransfer->pTransfer) == LIBUSB_SUCCESS)
+  {
+    pReadTransfer->bInFlight = TRUE;
+    dwNumTransfersInFlight = (dwNumTransfersInFlight + 1);
+  }
+  else
+    Status = FTC_IO_ERROR;
+
+  return Status;
+}
+
+FTC_STATUS FtcLibusbTransport::SubmitReadTransfers(void)
+{
+  FTC_STATUS Status = FTC_SUCCESS;
+  DWORD dwTransferCntr = 0;
+
+  for (dwTransferCntr = 0; ((dwTransferCntr < dwNumReadTransfers) && (Status == FTC_SUCCESS)); dwTransferCntr++)
+  {
+    if (!ReadTransfers[dwTransferCntr].bInFlight)
+      Status = SubmitReadTransfer(&ReadTransfers[dwTransferCntr]);
+  }
+
+  return Status;
+}
+
+FTC_STATUS FtcLibusbTransport::WaitForWriteTransfers(void)
+{
+  FTC_STATUS Status = FTC_SUCCESS;
+  DWORD dwTransferCntr = 0;
+
+  // Every write transfer is submitted with the write timeout, so this wait is bounded
+  for (dwTransferCntr = 0; ((dwTransferCntr < dwNumWriteTransfers) && (Status == FTC_SUCCESS)); dwTransferCntr++)
+  {
+    while (WriteTransfers[dwTransferCntr].bInFlight && (Status == FTC_SUCCESS))
+      Status = HandleEvents(LIBUSB_EVENTS_TIMEOUT);
+  }
+
+  return Status;
+}
+
+void FtcLibusbTransport::CancelTransfers(void)
+{
+  DWORD dwTransferCntr = 0;
+
+  bCancellingTransfers = TRUE;
+
+  for (dwTransferCntr = 0; (dwTransferCntr < MAX_NUM_QUEUED_TRANSFERS); dwTransferCntr++)
+  {
+    if (WriteTransfers[dwTransferCntr].bInFlight)
+      libusb_cancel_transfer(WriteTransfers[dwTransferCntr].pTransfer);
+
+    if (ReadTransfers[dwTransferCntr].bInFlight)
+      libusb_cancel_transfer(ReadTransfers[dwTransferCntr].pTransfer);
+  }
+
+  // Every cancelled transfer still completes, with a cancelled status, before it can be freed
+  while (dwNumTransfersInFlight > 0)
+  {
+    if (HandleEvents(LIBUSB_EVENTS_TIMEOUT) != FTC_SUCCESS)
+      break;
+  }
+}
+
+FTC_STATUS FtcLibusbTransport::HandleEvents(DWORD dwTimeoutmSec)
+{
+  FTC_STATUS Status = FTC_SUCCESS;
+  struct timeval Timeout;
+  INT iResult = 0;
+
+  Timeout.tv_sec = (dwTimeoutmSec / 1000);
+  Timeout.tv_usec = ((dwTimeoutmSec % 1000) * 1000);
+
+  iResult = libusb_handle_events_timeout_completed(pContext, &Timeout, NULL);
+
+  if ((iResult != LIBUSB_SUCCESS) && (iResult != LIBUSB_ERROR_INTERRUPTED))
+    Status = FTC_IO_ERROR;
+
+  return Status;
+}
+
+FTC_STATUS FtcLibusbTransport::GetTransferStatus(void)
+{
+  FTC_STATUS Status = TransferStatus;
+
+  TransferStatus = FTC_SUCCESS;
+
+  return Status;
+}
+
+FTC_STATUS FtcLibusbTransport::ControlTransfer(BYTE Request, WORD wValue)
+{
+  FTC_STATUS Status = FTC_SUCCESS;
+
+  // Vendor requests must not overtake data bytes that have already been written
+  if ((Status = WaitForWriteTransfers()) == FTC_SUCCESS)
+  {
+    if (libusb_control_transfer(pDeviceHandle, FTDI_DEVICE_OUT_REQUEST_TYPE, Request, wValue, (iInterface + 1),
+                                NULL, 0, LIBUSB_CONTROL_TIMEOUT) < 0)
+      Status = FTC_IO_ERROR;
+  }
+
+  return Status;
+}
+
+FTC_STATUS FtcLibusbTransport::AddReceivedBytes(LPBYTE pPacket, DWORD dwNumBytes)
+{
+  FTC_STATUS Status = FTC_SUCCESS;
+  LPBYTE pNewReceiveBuffer = NULL;
+
+  if ((dwReceiveTail + dwNumBytes) > dwReceiveBufferSize)
+  {
+    if (dwReceiveHead > 0)
+    {
+      memmove(pReceiveBuffer, &pReceiveBuffer[dwReceiveHead], (dwReceiveTail - dwReceiveHead));
+
+      dwReceiveTail = (dwReceiveTail - dwReceiveHead);
+      dwReceiveHead = 0;
+    }
+
+    if ((dwReceiveTail + dwNumBytes) > dwReceiveBufferSize)
+    {
+      if ((pNewReceiveBuffer = new BYTE[((dwReceiveBufferSize * 2) + dwNumBytes)]) != NULL)
+      {
+        memcpy(pNewReceiveBuffer, pReceiveBuffer, dwReceiveTail);
+
+        delete [] pReceiveBuffer;
+
+        pReceiveBuffer = pNewReceiveBuffer;
+        dwReceiveBufferSize = ((dwReceiveBufferSize * 2) + dwNumBytes);
+      }
+      else
+        Status = FTC_INSUFFICIENT_RESOURCES;
+    }
+  }
+
+  if (Status == FTC_SUCCESS)
+  {
+    memcpy(&pReceiveBuffer[dwReceiveTail], pPacket, dwNumBytes);
+
+    dwReceiveTail = (dwReceiveTail + dwNumBytes);
+  }
+
+  return Status;
+}
+
+DWORD FtcLibusbTransport::GetTransportType(void)
+{
+  return FTC_TRANSPORT_LIBUSB;
+}
+
+FTC_STATUS FtcLibusbTransport::GetDeviceType(LPDWORD lpdwDeviceType)
+{
+  *lpdwDeviceType = dwDeviceType;
+
+  return FTC_SUCCESS;
+}
+
+FTC_STATUS FtcLibusbTransport::Write(LPBYTE pBuffer, DWORD dwNumBytesToWrite, LPDWORD lpdwNumBytesWritten)
+{
+  FTC_WRITE_SEGMENT WriteSegment;
+
+  WriteSegment.pBuffer = pBuffer;
+  WriteSegment.dwNumBytes = dwNumBytesToWrite;
+
+  return WriteSegments(&WriteSegment, 1, lpdwNumBytesWritten);
+}
+
+FTC_STATUS FtcLibusbTransport::WriteSegments(PFTC_WRITE_SEGMENT pSegments, DWORD dwNumSegments, LPDWORD lpdwNumBytesWritten)
+{
+  FTC_STATUS Status = FTC_SUCCESS;
+  PFTC_LIBUSB_TRANSFER_DATA pWriteTransfer = NULL;
+  DWORD dwSegmentIndex = 0;
+  DWORD dwSegmentByteIndex = 0;
+  DWORD dwNumSegmentBytes = 0;
+  DWORD dwNumBytesWritten = 0;
+  DWORD dwNumTransferBytes = 0;
+
+  Status = GetTransferStatus();
+
+  // The segments are gathered into the next free write transfer, filling each transfer before the next one is used,
+  // so the write returns as soon as the last of the data has been queued and the caller can reuse its buffers
+  // straight away
+  while ((dwSegmentIndex < dwNumSegments) && (Status == FTC_SUCCESS))
+  {
+    pWriteTransfer = &WriteTransfers[dwNextWriteTransfer];
+
+    while (pWriteTransfer->bInFlight && (Status == FTC_SUCCESS))
+      Status = HandleEvents(LIBUSB_EVENTS_TIMEOUT);
+
+    if (Status == FTC_SUCCESS)
+      Status = GetTransferStatus();
+
+    if (Status == FTC_SUCCESS)
+    {
+      dwNumTransferBytes = 0;
+
+      while ((dwSegmentIndex < dwNumSegments) && (dwNumTransferBytes < LIBUSB_MAX_OUT_TRANSFER_SIZE))
+      {
+        dwNumSegmentBytes = (pSegments[dwSegmentIndex].dwNumBytes - dwSegmentByteIndex);
+
+        if (dwNumSegmentBytes > (LIBUSB_MAX_OUT_TRANSFER_SIZE - dwNumTransferBytes))
+          dwNumSegmentBytes = (LIBUSB_MAX_OUT_TRANSFER_SIZE - dwNumTransferBytes);
+
+        memcpy(&pWriteTransfer->pBuffer[dwNumTransferBytes], &pSegments[dwSegmentIndex].pBuffer[dwSegmentByteIndex], dwNumSegmentBytes);
+
+        dwNumTransferBytes = (dwNumTransferBytes + dwNumSegmentBytes);
+        dwSegmentByteIndex = (dwSegmentByteIndex + dwNumSegmentBytes);
+
+        if (dwSegmentByteIndex == pSegments[dwSegmentIndex].dwNumBytes)
+        {
+          dwSegmentIndex = (dwSegmentIndex + 1);
+          dwSegmentByteIndex = 0;
+        }
+      }
+    }
+
+    if ((Status == FTC_SUCCESS) && (dwNumTransferBytes > 0))
+    {
+      libusb_fill_bulk_transfer(pWriteTransfer->pTransfer, pDeviceHandle, WriteEndpoint, pWriteTransfer->pBuffer,
+                                dwNumTransferBytes, WriteTransferComplete, pWriteTransfer, dwWriteTimeoutmSec);
+
+      if (libusb_submit_transfer(pWriteTransfer->pTransfer) == LIBUSB_SUCCESS)
+      {
+        pWriteTransfer->bInFlight = TRUE;
+        dwNumTransfersInFlight = (dwNumTransfersInFlight + 1);
+
+        dwNumBytesWritten = (dwNumBytesWritten + dwNumTransferBytes);
+
+        dwNextWriteTransfer = ((dwNextWriteTransfer + 1) % dwNumWriteTransfers);
+      }
+      else
+        Status = FTC_IO_ERROR;
+    }
+  }
+
+  *lpdwNumBytesWritten = dwNumBytesWritten;
+
+  return Status;
+}
+
+FTC_STATUS FtcLibusbTransport::Read(LPBYTE pBuffer, DWORD dwNumBytesToRead, LPDWORD lpdwNumBytesRead)
+{
+  FTC_STATUS Status = FTC_SUCCESS;
+  ULONGLONG ulStartMicroSecs = FTC_GetMonotonicMicroSecs();
+  DWORD dwNumBytesRead = 0;
+
+  Status = GetTransferStatus();
+
+  // The read transfers are always queued, so handling events blocks until the next one completes. A read timeout of
+  // zero waits until all the requested bytes have been received, as the D2XX driver does
+  while (((dwReceiveTail - dwReceiveHead) < dwNumBytesToRead) && (Status == FTC_SUCCESS))
+  {
+    if ((Status = HandleEvents(LIBUSB_EVENTS_TIMEOUT)) == FTC_SUCCESS)
+      Status = GetTransferStatus();
+
+    if ((Status == FTC_SUCCESS) && (dwReadTimeoutmSec > 0))
+    {
+      if ((FTC_GetMonotonicMicroSecs() - ulStartMicroSecs) > (((ULONGLONG)dwReadTimeoutmSec) * 1000))
+        break;
+    }
+  }
+
+  dwNumBytesRead = (dwReceiveTail - dwReceiveHead);
+
+  if (dwNumBytesRead > dwNumBytesToRead)
+    dwNumBytesRead = dwNumBytesToRead;
+
+  memcpy(pBuffer, &pReceiveBuffer[dwReceiveHead], dwNumBytesRead);
+
+  dwReceiveHead = (dwReceiveHead + dwNumBytesRead);
+
+  if (dwReceiveHead == dwReceiveTail)
+  {
+    dwReceiveHead = 0;
+    dwReceiveTail = 0;
+  }
+
+  *lpdwNumBytesRead = dwNumBytesRead;
+
+  return Status;
+}
+
+FTC_STATUS FtcLibusbTransport::GetQueueStatus(LPDWORD lpdwNumBytesInQueue)
+{
+  FTC_STATUS Status = FTC_SUCCESS;
+
+  // Only collect the read transfers that have already completed, do not wait for any more
+  if ((Status = HandleEvents(0)) == FTC_SUCCESS)
+    Status = GetTransferStatus();
+
+  *lpdwNumBytesInQueue = (dwReceiveTail - dwReceiveHead);
+
+  return Status;
+}
+
+FTC_STATUS FtcLibusbTransport::WaitForBytes(DWORD dwNumBytesExpected, DWORD dwTimeoutmSec, LPDWORD lpdwNumBytesInQueue)
+{
+  FTC_STATUS Status = FTC_SUCCESS;
+  ULONGLONG ulStartMicroSecs = FTC_GetMonotonicMicroSecs();
+  DWORD dwElapsedmSec = 0;
+  DWORD dwEventsTimeoutmSec = 0;
+
+  Status = GetTransferStatus();
+
+  // Handling events sleeps in libusb until the next read transfer completes, so the wait ends as soon as the
+  // completion callback has added the last of the expected bytes to the receive buffer
+  while (((dwReceiveTail - dwReceiveHead) < dwNumBytesExpected) && (Status == FTC_SUCCESS))
+  {
+    dwElapsedmSec = (DWORD)((FTC_GetMonotonicMicroSecs() - ulStartMicroSecs) / 1000);
+
+    if (dwElapsedmSec >= dwTimeoutmSec)
+      break;
+
+    dwEventsTimeoutmSec = (dwTimeoutmSec - dwElapsedmSec);
+
+    if (dwEventsTimeoutmSec > LIBUSB_EVENTS_TIMEOUT)
+      dwEventsTimeoutmSec = LIBUSB_EVENTS_TIMEOUT;
+
+    if ((Status = HandleEvents(dwEventsTimeoutmSec)) == FTC_SUCCESS)
+      Status = GetTransferStatus();
+  }
+
+  *lpdwNumBytesInQueue = (dwReceiveTail - dwReceiveHead);
+
+  return Status;
+}
+
+FTC_STATUS FtcLibusbTransport::ResetDevice(void)
+{
+  FTC_STATUS Status = FTC_SUCCESS;
+
+  Status = ControlTransfer(SIO_RESET_REQUEST, SIO_RESET_SIO);
+
+  dwReceiveHead = 0;
+  dwReceiveTail = 0;
+
+  TransferStatus = FTC_SUCCESS;
+
+  return Status;
+}
+
+FTC_STATUS FtcLibusbTransport::Purge(void)
+{
+  FTC_STATUS Status = FTC_SUCCESS;
+
+  // Cancel the queued writes rather than waiting for a stalled device to accept them, then flush the device buffers
+  CancelTransfers();
+
+  bCancellingTransfers = FALSE;
+
+  dwReceiveHead = 0;
+  dwReceiveTail = 0;
+
+  TransferStatus = FTC_SUCCESS;
+
+  if ((Status = ControlTransfer(SIO_RESET_REQUEST, SIO_RESET_PURGE_RX)) == FTC_SUCCESS)
+  {
+    if ((Status = ControlTransfer(SIO_RESET_REQUEST, SIO_RESET_PURGE_TX)) == FTC_SUCCESS)
+      Status = SubmitReadTransfers();
+  }
+
+  return Status;
+}
+
+FTC_STATUS FtcLibusbTransport::SetUSBParameters(DWORD dwInTransferSize, DWORD /* dwOutTransferSize */)
+{
+  // The in transfer size must be a multiple of the maximum packet size, so every packet has its own modem status bytes
+  dwInTransferSize = ((dwInTransferSize / dwMaxPacketSize) * dwMaxPacketSize);
+
+  if (dwInTransferSize < dwMaxPacketSize)
+    dwInTransferSize = dwMaxPacketSize;
+
+  if (dwInTransferSize > LIBUSB_MAX_IN_TRANSFER_SIZE)
+    dwInTransferSize = LIBUSB_MAX_IN_TRANSFER_SIZE;
+
+  this->dwInTransferSize = dwInTransferSize;
+
+  return FTC_SUCCESS;
+}
+
+FTC_STATUS FtcLibusbTransport::SetChars(UCHAR EventCharacter, UCHAR EventCharEnabled, UCHAR ErrorCharacter, UCHAR ErrorCharEnabled)
+{
+  FTC_STATUS Status = FTC_SUCCESS;
+
+  if ((Status = ControlTransfer(SIO_SET_EVENT_CHAR_REQUEST, (EventCharacter | (EventCharEnabled << 8)))) == FTC_SUCCESS)
+    Status = ControlTransfer(SIO_SET_ERROR_CHAR_REQUEST, (ErrorCharacter | (ErrorCharEnabled << 8)));
+
+  return Status;
+}
+
+FTC_STATUS FtcLibusbTransport::SetTimeouts(DWORD dwReadTimeoutmSec, DWORD dwWriteTimeoutmSec)
+{
+  this->dwReadTimeoutmSec = dwReadTimeoutmSec;
+  this->dwWriteTimeoutmSec = dwWriteTimeoutmSec;
+
+  return FTC_SUCCESS;
+}
+
+FTC_STATUS FtcLibusbTransport::SetLatencyTimer(BYTE LatencyTimermSec)
+{
+  return ControlTransfer(SIO_SET_LATENCY_TIMER_REQUEST, LatencyTimermSec);
+}
+
+FTC_STATUS FtcLibusbTransport::GetLatencyTimer(LPBYTE lpLatencyTimermSec)
+{
+  FTC_STATUS Status = FTC_SUCCESS;
+
+  if ((Status = WaitForWriteTransfers()) == FTC_SUCCESS)
+  {
+    if (libusb_control_transfer(pDeviceHandle, FTDI_DEVICE_IN_REQUEST_TYPE, SIO_GET_LATENCY_TIMER_REQUEST, 0, (iInterface + 1),
+                                lpLatencyTimermSec, 1, LIBUSB_CONTROL_TIMEOUT) != 1)
+      Status = FTC_IO_ERROR;
+  }
+
+  return Status;
+}
+
+FTC_STATUS FtcLibusbTransport::SetBitMode(BYTE PinDirectionMask, BYTE BitMode)
+{
+  return ControlTransfer(SIO_SET_BITMODE_REQUEST, (PinDirectionMask | (BitMode << 8)));
+}
+
+FTC_STATUS FtcLibusbTransport::SetTransferQueueDepth(DWORD dwNumWriteTransfers, DWORD dwNumReadTransfers)
+{
+  FTC_STATUS Status = FTC_SUCCESS;
+
+  if ((Status = WaitForWriteTransfers()) == FTC_SUCCESS)
+  {
+    // Any bytes already received stay in the receive buffer, only the transfers themselves are replaced
+    CancelTransfers();
+    FreeTransfers();
+
+    this->dwNumWriteTransfers = dwNumWriteTransfers;
+    this->dwNumReadTransfers = dwNumReadTransfers;
+
+    if ((Status = AllocateTransfers()) == FTC_SUCCESS)
+      Status = SubmitReadTransfers();
+  }
+
+  return Status;
+}
+
+FTC_STATUS FtcLibusbTransport::GetTransferQueueDepth(LPDWORD lpdwNumWriteTransfers, LPDWORD lpdwNumReadTransfers)
+{
+  *lpdwNumWriteTransfers = dwNumWriteTransfers;
+  *lpdwNumReadTransfers = dwNumReadTransfers;
+
+  return FTC_SUCCESS;
+}
+
+DWORD FtcLibusbTransport::GetMaxWriteTransferSize(void)
+{
+  // Larger writes are split across several bulk out transfers, so limit a write to what fits in one transfer
+  return LIBUSB_MAX_OUT_TRANSFER_SIZE;
+}
+
+FTC_STATUS FtcLibusbTransport::Close(void)
+{
+  if (pDeviceHandle != NULL)
+  {
+    WaitForWriteTransfers();
+    CancelTransfers();
+    FreeTransfers();
+
+    libusb_release_interface(pDeviceHandle, iInterface);
+    libusb_close(pDeviceHandle);
+
+    pDeviceHandle = NULL;
+  }
+
+  if (pContext != NULL)
+  {
+    libusb_exit(pContext);
+
+    pContext = NULL;
+  }
+
+  return FTC_SUCCESS;
+}
+
+#endif  /* FTCJTAG_LIBUSB */
@@ -0,0 +1,136 @@
+/*++
+
+Module Name:
+
+    FtcLibusbTransport.h
+
+Abstract:
+
+    libusb-1.0 transport backend. Talks to the MPSSE channel of a FT2232D, FT2232H or FT4232H device directly
+    through its bulk endpoints and FTDI vendor requests, without the D2XX driver. Only built when the library
+    is configured with FTCJTAG_WITH_LIBUSB ie when FTCJTAG_LIBUSB is defined.
+
+    Uses the libusb asynchronous interface. A configurable number of bulk out transfers can be queued on the
+    write endpoint, so a write returns as soon as its data has been queued rather than when it has reached the
+    device, and a configurable number of bulk in transfers are kept queued on the read endpoint at all times,
+    so the device never has to wait for the next read request before it can return more data.
+
+Environment:
+
+    kernel & user mode
+
+--*/
+
+#ifndef FtcLibusbTransport_H
+#define FtcLibusbTransport_H
+
+#ifdef FTCJTAG_LIBUSB
+
+#include "FtcTransport.h"
+#include <libusb.h>
+
+#define FTDI_VENDOR_ID 0x0403
+#define FT2232_PRODUCT_ID 0x6010
+#define FT4232H_PRODUCT_ID 0x6011
+
+#define FT2232C_BCD_DEVICE 0x0500
+#define FT2232H_BCD_DEVICE 0x0700
+#define FT4232H_BCD_DEVICE 0x0800
+
+#define LIBUSB_DEVICE_NAME "FTCJTAG libusb device"
+
+#define LIBUSB_CONTROL_TIMEOUT 5000       // 5 seconds
+#define LIBUSB_EVENTS_TIMEOUT 100         // 100 milliseconds
+#define LIBUSB_DEFAULT_IN_TRANSFER_SIZE 4096
+#define LIBUSB_MAX_IN_TRANSFER_SIZE 65536 // 64K
+#define LIBUSB_MAX_OUT_TRANSFER_SIZE 65536 // 64K
+#define LIBUSB_INITIAL_RECEIVE_BUFFER_SIZE 131072
+
+#define FTDI_NUM_MODEM_STATUS_BYTES 2     // every bulk in packet starts with two modem status bytes
+
+class FtcLibusbTransport;
+
+typedef struct Ftc_Libusb_Transfer_Data{
+  FtcLibusbTransport *pTransport;                   // transport that owns the transfer
+  struct libusb_transfer *pTransfer;
+  LPBYTE pBuffer;
+  BOOL   bInFlight;                                 // the transfer has been submitted and has not yet completed
+}FTC_LIBUSB_TRANSFER_DATA, *PFTC_LIBUSB_TRANSFER_DATA;
+
+class FtcLibusbTransport : public FtcTransport
+{
+private:
+  libusb_context *pContext;
+  libusb_device_handle *pDeviceHandle;
+  INT    iInterface;
+  BYTE   WriteEndpoint;
+  BYTE   ReadEndpoint;
+  DWORD  dwMaxPacketSize;
+  DWORD  dwDeviceType;
+  DWORD  dwReadTimeoutmSec;
+  DWORD  dwWriteTimeoutmSec;
+  DWORD  dwInTransferSize;
+
+  FTC_LIBUSB_TRANSFER_DATA WriteTransfers[MAX_NUM_QUEUED_TRANSFERS];
+  FTC_LIBUSB_TRANSFER_DATA ReadTransfers[MAX_NUM_QUEUED_TRANSFERS];
+  DWORD  dwNumWriteTransfers;
+  DWORD  dwNumReadTransfers;
+  DWORD  dwNextWriteTransfer;
+  DWORD  dwNumTransfersInFlight;
+  BOOL   bCancellingTransfers;
+  FTC_STATUS TransferStatus;      // first error reported by a completed transfer, returned by the next call
+
+  LPBYTE pReceiveBuffer;          // received data bytes with the modem status bytes removed
+  DWORD  dwReceiveBufferSize;
+  DWORD  dwReceiveHead;
+  DWORD  dwReceiveTail;
+
+  static void LIBUSB_CALL WriteTransferComplete(struct libusb_transfer *pTransfer);
+  static void LIBUSB_CALL ReadTransferComplete(struct libusb_transfer *pTransfer);
+
+  FTC_STATUS AllocateTransfers(void);
+  void       FreeTransfers(void);
+  FTC_STATUS SubmitReadTransfer(PFTC_LIBUSB_TRANSFER_DATA pReadTransfer);
+  FTC_STATUS SubmitReadTransfers(void);
+  FTC_STATUS WaitForWriteTransfers(void);
+  void       CancelTransfers(void);
+  FTC_STATUS HandleEvents(DWORD dwTimeoutmSec);
+  FTC_STATUS GetTransferStatus(void);
+  FTC_STATUS ControlTransfer(BYTE Request, WORD wValue);
+  FTC_STATUS AddReceivedBytes(LPBYTE pPacket, DWORD dwNumBytes);
+
+public:
+  FtcLibusbTransport(void);
+  ~FtcLibusbTransport(void);
+
+  FTC_STATUS Open(DWORD dwDeviceIndex);
+
+  DWORD GetTransportType(void);
+  FTC_STATUS GetDeviceType(LPDWORD lpdwDeviceType);
+
+  FTC_STATUS Write(LPBYTE pBuffer, DWORD dwNumBytesToWrite, LPDWORD lpdwNumBytesWritten);
+  FTC_STATUS WriteSegments(PFTC_WRITE_SEGMENT pSegments, DWORD dwNumSegments, LPDWORD lpdwNumBytesWritten);
+  FTC_STATUS Read(LPBYTE pBuffer, DWORD dwNumBytesToRead, LPDWORD lpdwNumBytesRead);
+  FTC_STATUS GetQueueStatus(LPDWORD lpdwNumBytesInQueue);
+  FTC_STATUS WaitForBytes(DWORD dwNumBytesExpected, DWORD dwTimeoutmSec, LPDWORD lpdwNumBytesInQueue);
+
+  FTC_STATUS ResetDevice(void);
+  FTC_STATUS SetUSBParameters(DWORD dwInTransferSize, DWORD dwOutTransferSize);
+  FTC_STATUS SetChars(UCHAR EventCharacter, UCHAR EventCharEnabled, UCHAR ErrorCharacter, UCHAR ErrorCharEnabled);
+  FTC_STATUS SetTimeouts(DWORD dwReadTimeoutmSec, DWORD dwWriteTimeoutmSec);
+  FTC_STATUS SetLatencyTimer(BYTE LatencyTimermSec);
+  FTC_STATUS GetLatencyTimer(LPBYTE lpLatencyTimermSec);
+  FTC_STATUS SetBitMode(BYTE PinDirectionMask, BYTE BitMode);
+  FTC_STATUS Purge(void);
+
+  FTC_STATUS SetTransferQueueDepth(DWORD dwNumWriteTransfers, DWORD dwNumReadTransfers);
+  FTC_STATUS GetTransferQueueDepth(LPDWORD lpdwNumWriteTransfers, LPDWORD lpdwNumReadTransfers);
+
+  DWORD GetMaxWriteTransferSize(void);
+
+  FTC_STATUS Close(void);
+};
+
+#endif  /* FTCJTAG_LIBUSB */
+
+#endif  /* FtcLibusbTransport_H */
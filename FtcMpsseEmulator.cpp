@@ -0,0 +1,663 @@
+/*++
+
+Module Name:
+
+    FtcMpsseEmulator.cpp
+
+Abstract:
+
+    In-process MPSSE emulator transport backend implementation.
+
+Environment:
+
+    kernel & user mode
+
+--*/
+
+#define WIO_DEFINED
+
+#include "FtcJtagInternal.h"
+#include "FT2232c.h"
+#include "FtcMpsseEmulator.h"
+
+#include <cstring>
+
+// MPSSE data shifting command bits, see FTDI application note AN_108
+const BYTE MPSSE_BIT_MODE_CMD_BIT = '\x02';
+const BYTE MPSSE_LSB_FIRST_CMD_BIT = '\x08';
+const BYTE MPSSE_WRITE_TDI_CMD_BIT = '\x10';
+const BYTE MPSSE_READ_TDO_CMD_BIT = '\x20';
+const BYTE MPSSE_WRITE_TMS_CMD_BIT = '\x40';
+const BYTE MPSSE_DATA_SHIFTING_CMD_MASK = '\x80';
+
+const BYTE SET_LOW_BYTE_DATA_BITS_CMD = '\x80';
+const BYTE GET_LOW_BYTE_DATA_BITS_CMD = '\x81';
+const BYTE SET_HIGH_BYTE_DATA_BITS_CMD = '\x82';
+const BYTE GET_HIGH_BYTE_DATA_BITS_CMD = '\x83';
+
+const DWORD NUM_BITS_IN_BYTE = 8;
+
+// The pins of the MPSSE interface used for JTAG are TCK ADBUS0, TDI ADBUS1, TDO ADBUS2 and TMS ADBUS3
+const BYTE MPSSE_TDI_PIN = '\x02';
+const BYTE MPSSE_TMS_PIN = '\x08';
+
+#define NUM_TAP_CONTROLLER_STATES 16
+
+// TAP controller state reached from each TAP controller state by one TCK clock, see IEEE 1149.1, indexed by the state
+// less one then by the level of TMS
+const BYTE NextTapControllerState[NUM_TAP_CONTROLLER_STATES][2] = {
+  /* test logic reset */  {RUN_TEST_IDLE_STATE,                 TEST_LOGIC_STATE},
+  /* run test idle */     {RUN_TEST_IDLE_STATE,                 SELECT_TEST_DATA_REGISTER_SCAN_STATE},
+  /* pause dr */          {PAUSE_TEST_DATA_REGISTER_STATE,      EXIT2_TEST_DATA_REGISTER_STATE},
+  /* pause ir */          {PAUSE_INSTRUCTION_REGISTER_STATE,    EXIT2_INSTRUCTION_REGISTER_STATE},
+  /* shift dr */          {SHIFT_TEST_DATA_REGISTER_STATE,      EXIT1_TEST_DATA_REGISTER_STATE},
+  /* shift ir */          {SHIFT_INSTRUCTION_REGISTER_STATE,    EXIT1_INSTRUCTION_REGISTER_STATE},
+  /* select dr scan */    {CAPTURE_TEST_DATA_REGISTER_STATE,    SELECT_INSTRUCTION_REGISTER_SCAN_STATE},
+  /* capture dr */        {SHIFT_TEST_DATA_REGISTER_STATE,      EXIT1_TEST_DATA_REGISTER_STATE},
+  /* exit1 dr */          {PAUSE_TEST_DATA_REGISTER_STATE,      UPDATE_TEST_DATA_REGISTER_STATE},
+  /* exit2 dr */          {SHIFT_TEST_DATA_REGISTER_STATE,      UPDATE_TEST_DATA_REGISTER_STATE},
+  /* update dr */         {RUN_TEST_IDLE_STATE,                 SELECT_TEST_DATA_REGISTER_SCAN_STATE},
+  /* select ir scan */    {CAPTURE_INSTRUCTION_REGISTER_STATE,  TEST_LOGIC_STATE},
+  /* capture ir */        {SHIFT_INSTRUCTION_REGISTER_STATE,    EXIT1_INSTRUCTION_REGISTER_STATE},
+  /* exit1 ir */          {PAUSE_INSTRUCTION_REGISTER_STATE,    UPDATE_INSTRUCTION_REGISTER_STATE},
+  /* exit2 ir */          {SHIFT_INSTRUCTION_REGISTER_STATE,    UPDATE_INSTRUCTION_REGISTER_STATE},
+  /* update ir */         {RUN_TEST_IDLE_STATE,                 SELECT_TEST_DATA_REGISTER_SCAN_STATE}};
+
+FtcMpsseEmulator::FtcMpsseEmulator(DWORD dwEmulatedDeviceType)
+{
+  dwDeviceType = dwEmulatedDeviceType;
+  CurrentBitMode = 0;
+  LatencyTimer = DEVICE_LATENCY_TIMER_VALUE;
+  LowPinsValue = 0;
+  HighPinsValue = 0;
+  bTDIState = FALSE;
+
+  pCommandBuffer = new BYTE[EMULATOR_MAX_COMMAND_SIZE];
+  dwNumCommandBytes = 0;
+  ShiftingCommandByte = 0;
+  dwNumShiftingDataBytes = 0;
+
+  pResponseBuffer = new BYTE[EMULATOR_INITIAL_RESPONSE_BUFFER_SIZE];
+  dwResponseBufferSize = EMULATOR_INITIAL_RESPONSE_BUFFER_SIZE;
+  dwResponseHead = 0;
+  dwResponseTail = 0;
+
+  // The device under test is powered up in the test logic reset state
+  bTMSState = TRUE;
+  memset(&EmulatorState, 0, sizeof(EmulatorState));
+  EmulatorState.dwTapControllerState = TEST_LOGIC_STATE;
+  dwNumShiftedInstructionRegisterBits = 0;
+  memset(ShiftedInstructionRegisterBytes, 0, sizeof(ShiftedInstructionRegisterBytes));
+}
+
+FtcMpsseEmulator::~FtcMpsseEmulator(void)
+{
+  if (pCommandBuffer != NULL)
+    delete [] pCommandBuffer;
+
+  if (pResponseBuffer != NULL)
+    delete [] pResponseBuffer;
+}
+
+DWORD FtcMpsseEmulator::GetCommandLength(LPBYTE pCommand, DWORD dwNumBytesAvailable)
+{
+  DWORD dwCommandLength = 1;
+  BYTE CommandByte = pCommand[0];
+
+  if ((CommandByte & MPSSE_DATA_SHIFTING_CMD_MASK) == 0)
+  {
+    if ((CommandByte & MPSSE_WRITE_TMS_CMD_BIT) != 0)
+      dwCommandLength = 3;
+    else
+    {
+      if ((CommandByte & MPSSE_BIT_MODE_CMD_BIT) != 0)
+      {
+        dwCommandLength = 2;
+
+        if ((CommandByte & MPSSE_WRITE_TDI_CMD_BIT) != 0)
+          dwCommandLength = 3;
+      }
+      else
+      {
+        dwCommandLength = 3;
+
+        // The number of data bytes that follow the command is only known once the length bytes have arrived
+        if (((CommandByte & MPSSE_WRITE_TDI_CMD_BIT) != 0) && (dwNumBytesAvailable >= 3))
+          dwCommandLength = (3 + ((pCommand[1] | (pCommand[2] << 8)) + 1));
+      }
+    }
+  }
+  else
+  {
+    switch (CommandByte)
+    {
+      case SET_LOW_BYTE_DATA_BITS_CMD:
+      case SET_HIGH_BYTE_DATA_BITS_CMD:
+      case 0x86:  // set clock divisor
+      case 0x8F:  // clock for n x 8 bits with no data transfer
+      case 0x98:  // clock until GPIOL1 high/low, sent with a two byte length
+      case 0x99:
+      case 0x9C:
+      case 0x9D:
+      case 0x9E:
+        dwCommandLength = 3;
+      break;
+      case 0x8E:  // clock for n bits with no data transfer
+        dwCommandLength = 2;
+      break;
+      default:
+        dwCommandLength = 1;
+      break;
+    }
+  }
+
+  return dwCommandLength;
+}
+
+BYTE FtcMpsseEmulator::GetReadBitsResponseByte(BYTE DataByte, DWORD dwNumBits, BOOL bLSBFirst)
+{
+  // TDO is wired to TDI, so the bits clocked in are the bits clocked out. LSB first bits are shifted in from the
+  // top of the response byte, MSB first bits are shifted in from the bottom of the response byte
+  if (bLSBFirst)
+    return ((DataByte & ((1 << dwNumBits) - 1)) << (NUM_BITS_IN_BYTE - dwNumBits));
+  else
+    return (DataByte >> (NUM_BITS_IN_BYTE - dwNumBits));
+}
+
+void FtcMpsseEmulator::ClockTapControllerState(BOOL bTMS, BOOL bTDI)
+{
+  DWORD dwBitIndex = dwNumShiftedInstructionRegisterBits;
+
+  if (EmulatorState.dwTapControllerState == SHIFT_INSTRUCTION_REGISTER_STATE)
+  {
+    if (dwBitIndex < (MAX_NUM_EMULATOR_INSTRUCTION_REGISTER_BYTES * NUM_BITS_IN_BYTE))
+    {
+      if (bTDI)
+        ShiftedInstructionRegisterBytes[(dwBitIndex / NUM_BITS_IN_BYTE)] |= (1 << (dwBitIndex % NUM_BITS_IN_BYTE));
+      else
+        ShiftedInstructionRegisterBytes[(dwBitIndex / NUM_BITS_IN_BYTE)] &= ~(1 << (dwBitIndex % NUM_BITS_IN_BYTE));
+    }
+
+    dwNumShiftedInstructionRegisterBits = (dwNumShiftedInstructionRegisterBits + 1);
+  }
+
+  EmulatorState.dwTapControllerState = NextTapControllerState[(EmulatorState.dwTapControllerState - 1)][(bTMS ? 1 : 0)];
+
+  switch (EmulatorState.dwTapControllerState)
+  {
+    case TEST_LOGIC_STATE:
+      EmulatorState.dwNumInstructionRegisterBits = 0;
+    break;
+    case CAPTURE_INSTRUCTION_REGISTER_STATE:
+      dwNumShiftedInstructionRegisterBits = 0;
+    break;
+    case UPDATE_INSTRUCTION_REGISTER_STATE:
+      EmulatorState.dwNumInstructionRegisterUpdates = (EmulatorState.dwNumInstructionRegisterUpdates + 1);
+      EmulatorState.dwNumInstructionRegisterBits = dwNumShiftedInstructionRegisterBits;
+
+      memcpy(EmulatorState.InstructionRegisterBytes, ShiftedInstructionRegisterBytes, sizeof(ShiftedInstructionRegisterBytes));
+    break;
+  }
+}
+
+// Clocks the TAP controller with TMS held at its current level, pTDIBits holds the level of TDI for each clock or is
+// NULL if TDI is held at its current level
+void FtcMpsseEmulator::ClockTapController(DWORD dwNumClocks, LPBYTE pTDIBits, BOOL bLSBFirst)
+{
+  DWORD dwClockIndex = 0;
+  DWORD dwBitIndex = 0;
+  BOOL bTDI = bTDIState;
+
+  EmulatorState.dwNumTckClocks = (EmulatorState.dwNumTckClocks + dwNumClocks);
+
+  // Only the clocks that change the state or shift the instruction register are followed one at a time, the rest
+  // of a long data shift leaves the TAP controller where it is
+  while ((dwClockIndex < dwNumClocks) &&
+         ((EmulatorState.dwTapControllerState == SHIFT_INSTRUCTION_REGISTER_STATE) ||
+          (NextTapControllerState[(EmulatorState.dwTapControllerState - 1)][(bTMSState ? 1 : 0)] != EmulatorState.dwTapControllerState)))
+  {
+    if (pTDIBits != NULL)
+    {
+      if (bLSBFirst)
+        dwBitIndex = (dwClockIndex % NUM_BITS_IN_BYTE);
+      else
+        dwBitIndex = ((NUM_BITS_IN_BYTE - 1) - (dwClockIndex % NUM_BITS_IN_BYTE));
+
+      bTDI = (((pTDIBits[(dwClockIndex / NUM_BITS_IN_BYTE)] >> dwBitIndex) & '\x01') != 0);
+    }
+
+    ClockTapControllerState(bTMSState, bTDI);
+
+    dwClockIndex = (dwClockIndex + 1);
+  }
+}
+
+FTC_STATUS FtcMpsseEmulator::AddResponseByte(BYTE ResponseByte)
+{
+  FTC_STATUS Status = FTC_SUCCESS;
+  LPBYTE pNewResponseBuffer = NULL;
+
+  if (dwResponseTail == dwResponseBufferSize)
+  {
+    if (dwResponseHead > 0)
+    {
+      memmove(pResponseBuffer, &pResponseBuffer[dwResponseHead], (dwResponseTail - dwResponseHead));
+
+      dwResponseTail = (dwResponseTail - dwResponseHead);
+      dwResponseHead = 0;
+    }
+    else
+    {
+      if ((pNewResponseBuffer = new BYTE[(dwResponseBufferSize * 2)]) != NULL)
+      {
+        memcpy(pNewResponseBuffer, pResponseBuffer, dwResponseTail);
+
+        delete [] pResponseBuffer;
+
+        pResponseBuffer = pNewResponseBuffer;
+        dwResponseBufferSize = (dwResponseBufferSize * 2);
+      }
+      else
+        Status = FTC_INSUFFICIENT_RESOURCES;
+    }
+  }
+
+  if (Status == FTC_SUCCESS)
+  {
+    pResponseBuffer[dwResponseTail] = ResponseByte;
+    dwResponseTail = dwResponseTail + 1;
+  }
+
+  return Status;
+}
+
+FTC_STATUS FtcMpsseEmulator::ExecuteCommand(LPBYTE pCommand)
+{
+  FTC_STATUS Status = FTC_SUCCESS;
+  BYTE CommandByte = pCommand[0];
+  BOOL bLSBFirst = ((CommandByte & MPSSE_LSB_FIRST_CMD_BIT) != 0);
+  BOOL bWriteTDI = ((CommandByte & MPSSE_WRITE_TDI_CMD_BIT) != 0);
+  BOOL bReadTDO = ((CommandByte & MPSSE_READ_TDO_CMD_BIT) != 0);
+  BYTE TDIFillByte = 0;
+  BYTE TDOBits = 0;
+  DWORD dwNumBits = 0;
+  DWORD dwNumBytes = 0;
+  DWORD dwByteIndex = 0;
+  DWORD dwBitIndex = 0;
+
+  EmulatorState.dwNumCommands = (EmulatorState.dwNumCommands + 1);
+
+  if ((CommandByte & MPSSE_DATA_SHIFTING_CMD_MASK) == 0)
+  {
+    if (bTDIState)
+      TDIFillByte = '\xFF';
+
+    if ((CommandByte & MPSSE_WRITE_TMS_CMD_BIT) != 0)
+    {
+      // TMS commands hold TDI at the level of bit 7 of the data byte for every clock, so only bits 0 to 6 are clocked
+      // out on TMS whatever the length
+      dwNumBits = ((pCommand[1] & '\x07') + 1);
+
+      if (dwNumBits > 7)
+        dwNumBits = 7;
+      bTDIState = ((pCommand[2] & '\x80') != 0);
+
+      for (dwBitIndex = 0; (dwBitIndex < dwNumBits); dwBitIndex++)
+      {
+        // TDO is only driven in the shift states, in every other state it is pulled high. The bits read are shifted
+        // in from the top of the response byte.
+        if (((EmulatorState.dwTapControllerState != SHIFT_TEST_DATA_REGISTER_STATE) &&
+             (EmulatorState.dwTapControllerState != SHIFT_INSTRUCTION_REGISTER_STATE)) || bTDIState)
+          TDOBits = BYTE(TDOBits | (1 << dwBitIndex));
+
+        bTMSState = (((pCommand[2] >> dwBitIndex) & '\x01') != 0);
+
+        ClockTapControllerState(bTMSState, bTDIState);
+      }
+
+      if (bReadTDO)
+        Status = AddResponseByte(GetReadBitsResponseByte(TDOBits, dwNumBits, TRUE));
+
+      EmulatorState.dwNumTmsClocks = (EmulatorState.dwNumTmsClocks + dwNumBits);
+      EmulatorState.dwNumTckClocks = (EmulatorState.dwNumTckClocks + dwNumBits);
+    }
+    else if ((!bWriteTDI) && (!bReadTDO))
+    {
+      Status = AddResponseByte(BAD_COMMAND_RESPONSE);
+
+      if (Status == FTC_SUCCESS)
+        Status = AddResponseByte(CommandByte);
+    }
+    else if ((CommandByte & MPSSE_BIT_MODE_CMD_BIT) != 0)
+    {
+      dwNumBits = ((pCommand[1] & '\x07') + 1);
+
+      if (bWriteTDI)
+      {
+        ClockTapController(dwNumBits, &pCommand[2], bLSBFirst);
+
+        if (bReadTDO)
+          Status = AddResponseByte(GetReadBitsResponseByte(pCommand[2], dwNumBits, bLSBFirst));
+
+        if (bLSBFirst)
+          bTDIState = (((pCommand[2] >> (dwNumBits - 1)) & '\x01') != 0);
+        else
+          bTDIState = (((pCommand[2] >> (NUM_BITS_IN_BYTE - dwNumBits)) & '\x01') != 0);
+      }
+      else
+      {
+        ClockTapController(dwNumBits, NULL, bLSBFirst);
+
+        Status = AddResponseByte(GetReadBitsResponseByte(TDIFillByte, dwNumBits, bLSBFirst));
+      }
+    }
+    else
+    {
+      dwNumBytes = ((pCommand[1] | (pCommand[2] << 8)) + 1);
+
+      if (bWriteTDI)
+        Status = ShiftDataBytes(CommandByte, &pCommand[3], dwNumBytes);
+      else
+      {
+        ClockTapController((dwNumBytes * NUM_BITS_IN_BYTE), NULL, bLSBFirst);
+
+        for (dwByteIndex = 0; ((dwByteIndex < dwNumBytes) && (Status == FTC_SUCCESS)); dwByteIndex++)
+          Status = AddResponseByte(TDIFillByte);
+      }
+    }
+  }
+  else
+  {
+    switch (CommandByte)
+    {
+      case SET_LOW_BYTE_DATA_BITS_CMD:
+        LowPinsValue = pCommand[1];
+        bTDIState = ((LowPinsValue & MPSSE_TDI_PIN) != 0);
+        bTMSState = ((LowPinsValue & MPSSE_TMS_PIN) != 0);
+      break;
+      case GET_LOW_BYTE_DATA_BITS_CMD:
+        Status = AddResponseByte(LowPinsValue);
+      break;
+      case SET_HIGH_BYTE_DATA_BITS_CMD:
+        HighPinsValue = pCommand[1];
+      break;
+      case GET_HIGH_BYTE_DATA_BITS_CMD:
+        Status = AddResponseByte(HighPinsValue);
+      break;
+      case TURN_ON_LOOPBACK_CMD:
+      case TURN_OFF_LOOPBACK_CMD:
+      case 0x86:  // set clock divisor
+      case 0x87:  // send immediate
+      case 0x88:  // wait on GPIOL1 high/low
+      case 0x89:
+      case 0x8A:  // divide by five clocking off/on
+      case 0x8B:
+      case 0x8C:  // three phase data clocking on/off
+      case 0x8D:
+      case 0x94:  // clock until GPIOL1 high/low
+      case 0x95:
+      case 0x96:  // adaptive clocking on/off
+      case 0x97:
+      case 0x9E:  // drive zero only
+      break;
+      case 0x8E:  // clock for n bits with no data transfer
+        EmulatorState.dwNumClockOnlyCommands = (EmulatorState.dwNumClockOnlyCommands + 1);
+
+        ClockTapController(((pCommand[1] & '\x07') + 1), NULL, TRUE);
+      break;
+      case 0x8F:  // clock for n x 8 bits with no data transfer
+      case 0x98:  // clock for n x 8 bits or until GPIOL1 high/low, which never changes on the emulator
+      case 0x99:
+      case 0x9C:
+      case 0x9D:
+        EmulatorState.dwNumClockOnlyCommands = (EmulatorState.dwNumClockOnlyCommands + 1);
+
+        ClockTapController((((pCommand[1] | (pCommand[2] << 8)) + 1) * NUM_BITS_IN_BYTE), NULL, TRUE);
+      break;
+      default:
+        Status = AddResponseByte(BAD_COMMAND_RESPONSE);
+
+        if (Status == FTC_SUCCESS)
+          Status = AddResponseByte(CommandByte);
+      break;
+    }
+  }
+
+  return Status;
+}
+
+FTC_STATUS FtcMpsseEmulator::ShiftDataBytes(BYTE CommandByte, LPBYTE pDataBytes, DWORD dwNumBytes)
+{
+  FTC_STATUS Status = FTC_SUCCESS;
+  DWORD dwByteIndex = 0;
+
+  ClockTapController((dwNumBytes * NUM_BITS_IN_BYTE), pDataBytes, ((CommandByte & MPSSE_LSB_FIRST_CMD_BIT) != 0));
+
+  if ((CommandByte & MPSSE_READ_TDO_CMD_BIT) != 0)
+  {
+    for (dwByteIndex = 0; ((dwByteIndex < dwNumBytes) && (Status == FTC_SUCCESS)); dwByteIndex++)
+      Status = AddResponseByte(pDataBytes[dwByteIndex]);
+  }
+
+  if (dwNumBytes > 0)
+  {
+    if ((CommandByte & MPSSE_LSB_FIRST_CMD_BIT) != 0)
+      bTDIState = ((pDataBytes[(dwNumBytes - 1)] & '\x80') != 0);
+    else
+      bTDIState = ((pDataBytes[(dwNumBytes - 1)] & '\x01') != 0);
+  }
+
+  return Status;
+}
+
+DWORD FtcMpsseEmulator::GetTransportType(void)
+{
+  return FTC_TRANSPORT_MPSSE_EMULATOR;
+}
+
+FTC_STATUS FtcMpsseEmulator::GetDeviceType(LPDWORD lpdwDeviceType)
+{
+  *lpdwDeviceType = dwDeviceType;
+
+  return FTC_SUCCESS;
+}
+
+FTC_STATUS FtcMpsseEmulator::Write(LPBYTE pBuffer, DWORD dwNumBytesToWrite, LPDWORD lpdwNumBytesWritten)
+{
+  FTC_STATUS Status = FTC_SUCCESS;
+  DWORD dwByteIndex = 0;
+  DWORD dwCommandLength = 0;
+  DWORD dwNumBytesToCopy = 0;
+
+  // Bytes written while the MPSSE interface is not enabled are discarded, as they are by the device
+  if (CurrentBitMode == ENABLE_MPSSE_INTERFACE)
+  {
+    while ((dwByteIndex < dwNumBytesToWrite) && (Status == FTC_SUCCESS))
+    {
+      if (dwNumShiftingDataBytes > 0)
+      {
+        // Like the device, shift out the data bytes of a byte shifting command as they arrive, rather than waiting
+        // for the rest of the command to be written
+        dwNumBytesToCopy = dwNumShiftingDataBytes;
+
+        if (dwNumBytesToCopy > (dwNumBytesToWrite - dwByteIndex))
+          dwNumBytesToCopy = (dwNumBytesToWrite - dwByteIndex);
+
+        Status = ShiftDataBytes(ShiftingCommandByte, &pBuffer[dwByteIndex], dwNumBytesToCopy);
+
+        dwNumShiftingDataBytes = (dwNumShiftingDataBytes - dwNumBytesToCopy);
+        dwByteIndex = (dwByteIndex + dwNumBytesToCopy);
+      }
+      else if (dwNumCommandBytes > 0)
+      {
+        // Complete a command that was split across two writes
+        dwCommandLength = GetCommandLength(pCommandBuffer, dwNumCommandBytes);
+
+        dwNumBytesToCopy = (dwCommandLength - dwNumCommandBytes);
+
+        if (dwNumBytesToCopy > (dwNumBytesToWrite - dwByteIndex))
+          dwNumBytesToCopy = (dwNumBytesToWrite - dwByteIndex);
+
+        memcpy(&pCommandBuffer[dwNumCommandBytes], &pBuffer[dwByteIndex], dwNumBytesToCopy);
+
+        dwNumCommandBytes = (dwNumCommandBytes + dwNumBytesToCopy);
+        dwByteIndex = (dwByteIndex + dwNumBytesToCopy);
+
+        if (GetCommandLength(pCommandBuffer, dwNumCommandBytes) == dwNumCommandBytes)
+        {
+          Status = ExecuteCommand(pCommandBuffer);
+
+          dwNumCommandBytes = 0;
+        }
+      }
+      else
+      {
+        dwCommandLength = GetCommandLength(&pBuffer[dwByteIndex], (dwNumBytesToWrite - dwByteIndex));
+
+        if (dwCommandLength <= (dwNumBytesToWrite - dwByteIndex))
+        {
+          Status = ExecuteCommand(&pBuffer[dwByteIndex]);
+
+          dwByteIndex = (dwByteIndex + dwCommandLength);
+        }
+        else if (((pBuffer[dwByteIndex] & (MPSSE_DATA_SHIFTING_CMD_MASK | MPSSE_WRITE_TMS_CMD_BIT | MPSSE_BIT_MODE_CMD_BIT)) == 0) &&
+                 ((pBuffer[dwByteIndex] & MPSSE_WRITE_TDI_CMD_BIT) != 0) && ((dwNumBytesToWrite - dwByteIndex) >= 3))
+        {
+          ShiftingCommandByte = pBuffer[dwByteIndex];
+          dwNumShiftingDataBytes = (dwCommandLength - 3);
+
+          EmulatorState.dwNumCommands = (EmulatorState.dwNumCommands + 1);
+
+          dwByteIndex = (dwByteIndex + 3);
+        }
+        else
+        {
+          dwNumCommandBytes = (dwNumBytesToWrite - dwByteIndex);
+
+          memcpy(pCommandBuffer, &pBuffer[dwByteIndex], dwNumCommandBytes);
+
+          dwByteIndex = dwNumBytesToWrite;
+        }
+      }
+    }
+  }
+
+  if (Status == FTC_SUCCESS)
+    *lpdwNumBytesWritten = dwNumBytesToWrite;
+  else
+    *lpdwNumBytesWritten = dwByteIndex;
+
+  return Status;
+}
+
+FTC_STATUS FtcMpsseEmulator::Read(LPBYTE pBuffer, DWORD dwNumBytesToRead, LPDWORD lpdwNumBytesRead)
+{
+  DWORD dwNumBytesRead = (dwResponseTail - dwResponseHead);
+
+  if (dwNumBytesRead > dwNumBytesToRead)
+    dwNumBytesRead = dwNumBytesToRead;
+
+  memcpy(pBuffer, &pResponseBuffer[dwResponseHead], dwNumBytesRead);
+
+  dwResponseHead = (dwResponseHead + dwNumBytesRead);
+
+  if (dwResponseHead == dwResponseTail)
+  {
+    dwResponseHead = 0;
+    dwResponseTail = 0;
+  }
+
+  *lpdwNumBytesRead = dwNumBytesRead;
+
+  return FTC_SUCCESS;
+}
+
+FTC_STATUS FtcMpsseEmulator::GetQueueStatus(LPDWORD lpdwNumBytesInQueue)
+{
+  *lpdwNumBytesInQueue = (dwResponseTail - dwResponseHead);
+
+  return FTC_SUCCESS;
+}
+
+FTC_STATUS FtcMpsseEmulator::WaitForBytes(DWORD /* dwNumBytesExpected */, DWORD /* dwTimeoutmSec */, LPDWORD lpdwNumBytesInQueue)
+{
+  // Every response is produced as soon as its command is written, so there is never anything more to wait for
+  return GetQueueStatus(lpdwNumBytesInQueue);
+}
+
+FTC_STATUS FtcMpsseEmulator::ResetDevice(void)
+{
+  dwNumCommandBytes = 0;
+  ShiftingCommandByte = 0;
+  dwNumShiftingDataBytes = 0;
+  dwResponseHead = 0;
+  dwResponseTail = 0;
+
+  return FTC_SUCCESS;
+}
+
+FTC_STATUS FtcMpsseEmulator::Purge(void)
+{
+  // Commands are executed as they are written, so only a partially written command and unread responses are left
+  dwNumCommandBytes = 0;
+  ShiftingCommandByte = 0;
+  dwNumShiftingDataBytes = 0;
+  dwResponseHead = 0;
+  dwResponseTail = 0;
+
+  return FTC_SUCCESS;
+}
+
+FTC_STATUS FtcMpsseEmulator::SetUSBParameters(DWORD /* dwInTransferSize */, DWORD /* dwOutTransferSize */)
+{
+  return FTC_SUCCESS;
+}
+
+FTC_STATUS FtcMpsseEmulator::SetChars(UCHAR /* EventCharacter */, UCHAR /* EventCharEnabled */, UCHAR /* ErrorCharacter */,
+                                      UCHAR /* ErrorCharEnabled */)
+{
+  return FTC_SUCCESS;
+}
+
+FTC_STATUS FtcMpsseEmulator::SetTimeouts(DWORD /* dwReadTimeoutmSec */, DWORD /* dwWriteTimeoutmSec */)
+{
+  return FTC_SUCCESS;
+}
+
+FTC_STATUS FtcMpsseEmulator::SetLatencyTimer(BYTE LatencyTimermSec)
+{
+  LatencyTimer = LatencyTimermSec;
+
+  return FTC_SUCCESS;
+}
+
+FTC_STATUS FtcMpsseEmulator::GetLatencyTimer(LPBYTE lpLatencyTimermSec)
+{
+  *lpLatencyTimermSec = LatencyTimer;
+
+  return FTC_SUCCESS;
+}
+
+FTC_STATUS FtcMpsseEmulator::SetBitMode(BYTE /* PinDirectionMask */, BYTE BitMode)
+{
+  CurrentBitMode = BitMode;
+
+  // Resetting the MPSSE interface discards any partially received command
+  dwNumCommandBytes = 0;
+  ShiftingCommandByte = 0;
+  dwNumShiftingDataBytes = 0;
+
+  return FTC_SUCCESS;
+}
+
+FTC_STATUS FtcMpsseEmulator::GetEmulatorState(PFTC_EMULATOR_STATE pEmulatorState)
+{
+  *pEmulatorState = EmulatorState;
+
+  return FTC_SUCCESS;
+}
+
+FTC_STATUS FtcMpsseEmulator::Close(void)
+{
+  return FTC_SUCCESS;
+}
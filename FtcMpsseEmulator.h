@@ -0,0 +1,92 @@
+/*++
+
+Module Name:
+
+    FtcMpsseEmulator.h
+
+Abstract:
+
+    In-process MPSSE emulator transport backend. Decodes the MPSSE command stream written by the JTAG classes
+    and produces the response bytes a FT2232H hi-speed device would return, with TDO wired to TDI ie every
+    bit shifted out on TDI is captured back on TDO. Allows the complete command encoding and response
+    processing path to be exercised and timed without any hardware attached. The emulator also follows
+    the TAP controller of the device under test through every TCK clock and keeps the instruction register
+    value it is left holding, so tests can check the TMS clocks that are sent. Like a real device, TDO is only
+    driven in the shift states, so TMS commands that leave a shift state read TDO pulled high after the first clock.
+
+Environment:
+
+    kernel & user mode
+
+--*/
+
+#ifndef FtcMpsseEmulator_H
+#define FtcMpsseEmulator_H
+
+#include "FtcTransport.h"
+
+#define EMULATOR_DEVICE_NAME "FTCJTAG MPSSE Emulator"
+
+#define EMULATOR_INITIAL_RESPONSE_BUFFER_SIZE 65536  // 64K
+#define EMULATOR_MAX_COMMAND_SIZE 65539             // largest MPSSE command ie 3 byte header plus 64K data bytes
+
+class FtcMpsseEmulator : public FtcTransport
+{
+private:
+  DWORD  dwDeviceType;
+  BYTE   CurrentBitMode;
+  BYTE   LatencyTimer;
+  BYTE   LowPinsValue;
+  BYTE   HighPinsValue;
+  BOOL   bTDIState;
+
+  LPBYTE pCommandBuffer;         // holds a command that has been split across two writes
+  DWORD  dwNumCommandBytes;
+  BYTE   ShiftingCommandByte;    // byte shifting command whose data bytes are still being written
+  DWORD  dwNumShiftingDataBytes; // number of data bytes still to be written for the byte shifting command
+
+  LPBYTE pResponseBuffer;
+  DWORD  dwResponseBufferSize;
+  DWORD  dwResponseHead;
+  DWORD  dwResponseTail;
+
+  BOOL   bTMSState;
+  FTC_EMULATOR_STATE EmulatorState;
+  DWORD  dwNumShiftedInstructionRegisterBits;  // bits shifted into the instruction register since it was captured
+  BYTE   ShiftedInstructionRegisterBytes[MAX_NUM_EMULATOR_INSTRUCTION_REGISTER_BYTES];
+
+  DWORD      GetCommandLength(LPBYTE pCommand, DWORD dwNumBytesAvailable);
+  FTC_STATUS ExecuteCommand(LPBYTE pCommand);
+  FTC_STATUS ShiftDataBytes(BYTE CommandByte, LPBYTE pDataBytes, DWORD dwNumBytes);
+  FTC_STATUS AddResponseByte(BYTE ResponseByte);
+  BYTE       GetReadBitsResponseByte(BYTE DataByte, DWORD dwNumBits, BOOL bLSBFirst);
+  void       ClockTapControllerState(BOOL bTMS, BOOL bTDI);
+  void       ClockTapController(DWORD dwNumClocks, LPBYTE pTDIBits, BOOL bLSBFirst);
+
+public:
+  FtcMpsseEmulator(DWORD dwEmulatedDeviceType);
+  ~FtcMpsseEmulator(void);
+
+  DWORD GetTransportType(void);
+  FTC_STATUS GetDeviceType(LPDWORD lpdwDeviceType);
+
+  FTC_STATUS Write(LPBYTE pBuffer, DWORD dwNumBytesToWrite, LPDWORD lpdwNumBytesWritten);
+  FTC_STATUS Read(LPBYTE pBuffer, DWORD dwNumBytesToRead, LPDWORD lpdwNumBytesRead);
+  FTC_STATUS GetQueueStatus(LPDWORD lpdwNumBytesInQueue);
+  FTC_STATUS WaitForBytes(DWORD dwNumBytesExpected, DWORD dwTimeoutmSec, LPDWORD lpdwNumBytesInQueue);
+
+  FTC_STATUS ResetDevice(void);
+  FTC_STATUS SetUSBParameters(DWORD dwInTransferSize, DWORD dwOutTransferSize);
+  FTC_STATUS SetChars(UCHAR EventCharacter, UCHAR EventCharEnabled, UCHAR ErrorCharacter, UCHAR ErrorCharEnabled);
+  FTC_STATUS SetTimeouts(DWORD dwReadTimeoutmSec, DWORD dwWriteTimeoutmSec);
+  FTC_STATUS SetLatencyTimer(BYTE LatencyTimermSec);
+  FTC_STATUS GetLatencyTimer(LPBYTE lpLatencyTimermSec);
+  FTC_STATUS SetBitMode(BYTE PinDirectionMask, BYTE BitMode);
+  FTC_STATUS Purge(void);
+
+  FTC_STATUS GetEmulatorState(PFTC_EMULATOR_STATE pEmulatorState);
+
+  FTC_STATUS Close(void);
+};
+
+#endif  /* FtcMpsseEmulator_H */
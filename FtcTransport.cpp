@@ -0,0 +1,288 @@
+/*++
+
+Module Name:
+
+    FtcTransport.cpp
+
+Abstract:
+
+    Transport backend interface default methods and the FTDI D2XX driver transport backend. The D2XX backend
+    forwards every request straight to the D2XX driver, this is the transport used for all devices opened through
+    the JTAG_Open, JTAG_OpenEx and JTAG_OpenHiSpeedDevice functions.
+
+Environment:
+
+    kernel & user mode
+
+--*/
+
+#define WIO_DEFINED
+
+#include "FtcJtagInternal.h"
+#include "FT2232c.h"
+
+#ifndef _WIN32
+#include <errno.h>
+#include <time.h>
+#endif
+
+ULONGLONG FTC_GetMonotonicMicroSecs(void)
+{
+#ifdef _WIN32
+  LARGE_INTEGER Counter;
+  LARGE_INTEGER Frequency;
+
+  QueryPerformanceCounter(&Counter);
+  QueryPerformanceFrequency(&Frequency);
+
+  return (((Counter.QuadPart / Frequency.QuadPart) * 1000000) + (((Counter.QuadPart % Frequency.QuadPart) * 1000000) / Frequency.QuadPart));
+#else
+  struct timespec CurrentTime;
+
+  clock_gettime(CLOCK_MONOTONIC, &CurrentTime);
+
+  return ((((ULONGLONG)CurrentTime.tv_sec) * 1000000) + (CurrentTime.tv_nsec / 1000));
+#endif
+}
+
+FTC_STATUS FtcTransport::WriteSegments(PFTC_WRITE_SEGMENT pSegments, DWORD dwNumSegments, LPDWORD lpdwNumBytesWritten)
+{
+  FTC_STATUS Status = FTC_SUCCESS;
+  DWORD dwSegmentCntr = 0;
+  DWORD dwNumBytesWritten = 0;
+  BOOL bSegmentWritten = TRUE;
+
+  *lpdwNumBytesWritten = 0;
+
+  // Transports that cannot gather the segments into their own transfers write each segment in turn, stopping at
+  // the first segment that is not written in full
+  for (dwSegmentCntr = 0; ((dwSegmentCntr < dwNumSegments) && bSegmentWritten && (Status == FTC_SUCCESS)); dwSegmentCntr++)
+  {
+    Status = Write(pSegments[dwSegmentCntr].pBuffer, pSegments[dwSegmentCntr].dwNumBytes, &dwNumBytesWritten);
+
+    *lpdwNumBytesWritten = (*lpdwNumBytesWritten + dwNumBytesWritten);
+
+    bSegmentWritten = (dwNumBytesWritten == pSegments[dwSegmentCntr].dwNumBytes);
+  }
+
+  return Status;
+}
+
+FTC_STATUS FtcTransport::WaitForBytesConcurrently(DWORD /* dwNumBytesExpected */, DWORD /* dwTimeoutmSec */,
+                                                  LPDWORD /* lpdwNumBytesInQueue */)
+{
+  return FTC_NOT_SUPPORTED_BY_TRANSPORT;
+}
+
+FTC_STATUS FtcTransport::SetTransferQueueDepth(DWORD /* dwNumWriteTransfers */, DWORD /* dwNumReadTransfers */)
+{
+  return FTC_NOT_SUPPORTED_BY_TRANSPORT;
+}
+
+FTC_STATUS FtcTransport::GetTransferQueueDepth(LPDWORD /* lpdwNumWriteTransfers */, LPDWORD /* lpdwNumReadTransfers */)
+{
+  return FTC_NOT_SUPPORTED_BY_TRANSPORT;
+}
+
+DWORD FtcTransport::GetMaxWriteTransferSize(void)
+{
+  // The D2XX driver and the emulator accept writes of any size, so the largest transfer size that can be
+  // negotiated with a device is the limit
+  return MAX_USB_TRANSFER_CHUNK_SIZE;
+}
+
+FTC_STATUS FtcTransport::GetEmulatorState(PFTC_EMULATOR_STATE /* pEmulatorState */)
+{
+  return FTC_NOT_SUPPORTED_BY_TRANSPORT;
+}
+
+FtcD2xxTransport::FtcD2xxTransport(FT_HANDLE ftDeviceHandle)
+{
+  ftHandle = ftDeviceHandle;
+
+#ifndef _WIN32
+  pthread_condattr_t CondAttr;
+#endif
+
+#ifdef _WIN32
+  RxEvent = CreateEvent(NULL, FALSE, FALSE, NULL);
+#else
+  // The driver only signals the condition variable, so it can time its waits against the monotonic clock
+  pthread_condattr_init(&CondAttr);
+  pthread_condattr_setclock(&CondAttr, CLOCK_MONOTONIC);
+
+  pthread_mutex_init(&RxEvent.eMutex, NULL);
+  pthread_cond_init(&RxEvent.eCondVar, &CondAttr);
+
+  pthread_condattr_destroy(&CondAttr);
+#endif
+
+  bRxEventNotificationSet = FALSE;
+}
+
+FtcD2xxTransport::~FtcD2xxTransport(void)
+{
+#ifdef _WIN32
+  CloseHandle(RxEvent);
+#else
+  pthread_cond_destroy(&RxEvent.eCondVar);
+  pthread_mutex_destroy(&RxEvent.eMutex);
+#endif
+}
+
+DWORD FtcD2xxTransport::GetTransportType(void)
+{
+  return FTC_TRANSPORT_D2XX;
+}
+
+FTC_STATUS FtcD2xxTransport::GetDeviceType(LPDWORD lpdwDeviceType)
+{
+  DWORD dwDeviceID = 0;
+  char szSerialNumber[MAX_NUM_SERIAL_NUMBER_CHARS];
+  char szDeviceNameBuffer[DEVICE_STRING_BUFF_SIZE + 1];
+  PVOID pvDummy = NULL;
+
+  return FT_GetDeviceInfo(ftHandle, lpdwDeviceType, &dwDeviceID, szSerialNumber, szDeviceNameBuffer, pvDummy);
+}
+
+FTC_STATUS FtcD2xxTransport::Write(LPBYTE pBuffer, DWORD dwNumBytesToWrite, LPDWORD lpdwNumBytesWritten)
+{
+  return FT_Write(ftHandle, pBuffer, dwNumBytesToWrite, lpdwNumBytesWritten);
+}
+
+FTC_STATUS FtcD2xxTransport::Read(LPBYTE pBuffer, DWORD dwNumBytesToRead, LPDWORD lpdwNumBytesRead)
+{
+  return FT_Read(ftHandle, pBuffer, dwNumBytesToRead, lpdwNumBytesRead);
+}
+
+FTC_STATUS FtcD2xxTransport::GetQueueStatus(LPDWORD lpdwNumBytesInQueue)
+{
+  return FT_GetQueueStatus(ftHandle, lpdwNumBytesInQueue);
+}
+
+FTC_STATUS FtcD2xxTransport::WaitForBytes(DWORD dwNumBytesExpected, DWORD dwTimeoutmSec, LPDWORD lpdwNumBytesInQueue)
+{
+  FTC_STATUS Status = FTC_SUCCESS;
+#ifndef _WIN32
+  struct timespec WaitUntil;
+#endif
+
+  // The driver is only asked to signal the receive event once a handle actually blocks
+  if (!bRxEventNotificationSet)
+  {
+    if ((Status = FT_SetEventNotification(ftHandle, FT_EVENT_RXCHAR, (PVOID)&RxEvent)) == FTC_SUCCESS)
+      bRxEventNotificationSet = TRUE;
+  }
+
+  if (Status == FTC_SUCCESS)
+  {
+#ifdef _WIN32
+    while (((Status = FT_GetQueueStatus(ftHandle, lpdwNumBytesInQueue)) == FTC_SUCCESS) && (*lpdwNumBytesInQueue < dwNumBytesExpected))
+    {
+      if (WaitForSingleObject(RxEvent, dwTimeoutmSec) == WAIT_TIMEOUT)
+      {
+        Status = FT_GetQueueStatus(ftHandle, lpdwNumBytesInQueue);
+        break;
+      }
+    }
+#else
+    clock_gettime(CLOCK_MONOTONIC, &WaitUntil);
+
+    WaitUntil.tv_sec = (WaitUntil.tv_sec + (dwTimeoutmSec / 1000));
+    WaitUntil.tv_nsec = (WaitUntil.tv_nsec + ((dwTimeoutmSec % 1000) * 1000000));
+
+    if (WaitUntil.tv_nsec >= 1000000000)
+    {
+      WaitUntil.tv_sec = (WaitUntil.tv_sec + 1);
+      WaitUntil.tv_nsec = (WaitUntil.tv_nsec - 1000000000);
+    }
+
+    // The queue is checked with the event mutex held, so a signal sent between the check and the wait is not lost
+    pthread_mutex_lock(&RxEvent.eMutex);
+
+    while (((Status = FT_GetQueueStatus(ftHandle, lpdwNumBytesInQueue)) == FTC_SUCCESS) && (*lpdwNumBytesInQueue < dwNumBytesExpected))
+    {
+      if (pthread_cond_timedwait(&RxEvent.eCondVar, &RxEvent.eMutex, &WaitUntil) == ETIMEDOUT)
+      {
+        Status = FT_GetQueueStatus(ftHandle, lpdwNumBytesInQueue);
+        break;
+      }
+    }
+
+    pthread_mutex_unlock(&RxEvent.eMutex);
+#endif
+  }
+
+  return Status;
+}
+
+FTC_STATUS FtcD2xxTransport::WaitForBytesConcurrently(DWORD dwNumBytesExpected, DWORD dwTimeoutmSec, LPDWORD lpdwNumBytesInQueue)
+{
+  FTC_STATUS Status = FTC_SUCCESS;
+
+  // The driver serialises the calls made on a handle from different threads, so only asking it to signal the receive
+  // event has to be left to WaitForBytes
+  if (bRxEventNotificationSet)
+  {
+    Status = WaitForBytes(dwNumBytesExpected, dwTimeoutmSec, lpdwNumBytesInQueue);
+
+    // A thread waiting on the receive event at the same time may have missed the signal taken by this wait, so the
+    // event is signalled again to make that thread check the queue
+#ifdef _WIN32
+    SetEvent(RxEvent);
+#else
+    pthread_mutex_lock(&RxEvent.eMutex);
+    pthread_cond_signal(&RxEvent.eCondVar);
+    pthread_mutex_unlock(&RxEvent.eMutex);
+#endif
+  }
+  else
+    Status = FTC_NOT_SUPPORTED_BY_TRANSPORT;
+
+  return Status;
+}
+
+FTC_STATUS FtcD2xxTransport::ResetDevice(void)
+{
+  return FT_ResetDevice(ftHandle);
+}
+
+FTC_STATUS FtcD2xxTransport::SetUSBParameters(DWORD dwInTransferSize, DWORD dwOutTransferSize)
+{
+  return FT_SetUSBParameters(ftHandle, dwInTransferSize, dwOutTransferSize);
+}
+
+FTC_STATUS FtcD2xxTransport::SetChars(UCHAR EventCharacter, UCHAR EventCharEnabled, UCHAR ErrorCharacter, UCHAR ErrorCharEnabled)
+{
+  return FT_SetChars(ftHandle, EventCharacter, EventCharEnabled, ErrorCharacter, ErrorCharEnabled);
+}
+
+FTC_STATUS FtcD2xxTransport::SetTimeouts(DWORD dwReadTimeoutmSec, DWORD dwWriteTimeoutmSec)
+{
+  return FT_SetTimeouts(ftHandle, dwReadTimeoutmSec, dwWriteTimeoutmSec);
+}
+
+FTC_STATUS FtcD2xxTransport::SetLatencyTimer(BYTE LatencyTimermSec)
+{
+  return FT_SetLatencyTimer(ftHandle, LatencyTimermSec);
+}
+
+FTC_STATUS FtcD2xxTransport::GetLatencyTimer(LPBYTE lpLatencyTimermSec)
+{
+  return FT_GetLatencyTimer(ftHandle, lpLatencyTimermSec);
+}
+
+FTC_STATUS FtcD2xxTransport::SetBitMode(BYTE PinDirectionMask, BYTE BitMode)
+{
+  return FT_SetBitMode(ftHandle, PinDirectionMask, BitMode);
+}
+
+FTC_STATUS FtcD2xxTransport::Purge(void)
+{
+  return FT_Purge(ftHandle, (FT_PURGE_RX | FT_PURGE_TX));
+}
+
+FTC_STATUS FtcD2xxTransport::Close(void)
+{
+  return FT_Close(ftHandle);
+}
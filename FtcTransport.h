@@ -0,0 +1,129 @@
+/*++
+
+Module Name:
+
+    FtcTransport.h
+
+Abstract:
+
+    Transport backend interface used by the FT2232C and FT2232H base classes to move MPSSE command and
+    response bytes to and from a device, and the FTDI D2XX driver implementation of that interface.
+    Every opened device handle owns exactly one transport object, see FT2232c::FTC_GetDeviceTransport.
+
+Environment:
+
+    kernel & user mode
+
+--*/
+
+#ifndef FtcTransport_H
+#define FtcTransport_H
+
+#include "ftcjtag.h"
+#include <ftd2xx.h>
+#include "FtcJtagInternal.h"
+
+typedef DWORD FTC_HANDLE;
+typedef ULONG FTC_STATUS;
+
+#define MIN_NUM_QUEUED_TRANSFERS 1
+#define MAX_NUM_QUEUED_TRANSFERS 16
+#define DEFAULT_NUM_QUEUED_TRANSFERS 2   // double buffering
+
+// Monotonic time in microseconds, used for every timeout so that a change to the wall clock can neither cut a
+// timeout short nor stretch it
+ULONGLONG FTC_GetMonotonicMicroSecs(void);
+
+typedef struct Ft_Write_Segment{
+  LPBYTE pBuffer;                                   // first byte of the segment
+  DWORD  dwNumBytes;                                // number of bytes in the segment
+}FTC_WRITE_SEGMENT, *PFTC_WRITE_SEGMENT;
+
+class FtcTransport
+{
+public:
+  virtual ~FtcTransport(void) {}
+
+  // Returns one of the FTC_TRANSPORT_XXX values defined in ftcjtag.h
+  virtual DWORD GetTransportType(void) = 0;
+
+  // Returns one of the FT_DEVICE_XXX values defined in ftd2xx.h
+  virtual FTC_STATUS GetDeviceType(LPDWORD lpdwDeviceType) = 0;
+
+  virtual FTC_STATUS Write(LPBYTE pBuffer, DWORD dwNumBytesToWrite, LPDWORD lpdwNumBytesWritten) = 0;
+
+  // Writes the segments one after another, as if they were a single buffer holding all of their bytes
+  virtual FTC_STATUS WriteSegments(PFTC_WRITE_SEGMENT pSegments, DWORD dwNumSegments, LPDWORD lpdwNumBytesWritten);
+
+  virtual FTC_STATUS Read(LPBYTE pBuffer, DWORD dwNumBytesToRead, LPDWORD lpdwNumBytesRead) = 0;
+  virtual FTC_STATUS GetQueueStatus(LPDWORD lpdwNumBytesInQueue) = 0;
+
+  // Sleeps until at least the expected number of bytes are in the queue or the timeout expires, whichever is first
+  virtual FTC_STATUS WaitForBytes(DWORD dwNumBytesExpected, DWORD dwTimeoutmSec, LPDWORD lpdwNumBytesInQueue) = 0;
+
+  // Same as WaitForBytes, but may be called by one thread while another thread is using the transport, once
+  // WaitForBytes has been called. Only supported by transports whose driver signals an event when bytes are received
+  virtual FTC_STATUS WaitForBytesConcurrently(DWORD dwNumBytesExpected, DWORD dwTimeoutmSec, LPDWORD lpdwNumBytesInQueue);
+
+  virtual FTC_STATUS ResetDevice(void) = 0;
+  virtual FTC_STATUS SetUSBParameters(DWORD dwInTransferSize, DWORD dwOutTransferSize) = 0;
+  virtual FTC_STATUS SetChars(UCHAR EventCharacter, UCHAR EventCharEnabled, UCHAR ErrorCharacter, UCHAR ErrorCharEnabled) = 0;
+  virtual FTC_STATUS SetTimeouts(DWORD dwReadTimeoutmSec, DWORD dwWriteTimeoutmSec) = 0;
+  virtual FTC_STATUS SetLatencyTimer(BYTE LatencyTimermSec) = 0;
+  virtual FTC_STATUS GetLatencyTimer(LPBYTE lpLatencyTimermSec) = 0;
+  virtual FTC_STATUS SetBitMode(BYTE PinDirectionMask, BYTE BitMode) = 0;
+
+  // Abandons any transfers still in progress and discards the bytes waiting to be sent to or read from the device
+  virtual FTC_STATUS Purge(void) = 0;
+
+  // Number of bulk out and bulk in transfers the transport keeps queued, only supported by transports that
+  // manage their own USB transfers
+  virtual FTC_STATUS SetTransferQueueDepth(DWORD dwNumWriteTransfers, DWORD dwNumReadTransfers);
+  virtual FTC_STATUS GetTransferQueueDepth(LPDWORD lpdwNumWriteTransfers, LPDWORD lpdwNumReadTransfers);
+
+  // Largest number of bytes the transport can pass on to the device in a single write
+  virtual DWORD GetMaxWriteTransferSize(void);
+
+  // State of the device modelled by the transport, only supported by the MPSSE emulator
+  virtual FTC_STATUS GetEmulatorState(PFTC_EMULATOR_STATE pEmulatorState);
+
+  virtual FTC_STATUS Close(void) = 0;
+};
+
+class FtcD2xxTransport : public FtcTransport
+{
+private:
+  FT_HANDLE ftHandle;
+#ifdef _WIN32
+  HANDLE RxEvent;
+#else
+  EVENT_HANDLE RxEvent;               // signalled by the D2XX driver every time bytes are received
+#endif
+  BOOL bRxEventNotificationSet;
+
+public:
+  FtcD2xxTransport(FT_HANDLE ftDeviceHandle);
+  ~FtcD2xxTransport(void);
+
+  DWORD GetTransportType(void);
+  FTC_STATUS GetDeviceType(LPDWORD lpdwDeviceType);
+
+  FTC_STATUS Write(LPBYTE pBuffer, DWORD dwNumBytesToWrite, LPDWORD lpdwNumBytesWritten);
+  FTC_STATUS Read(LPBYTE pBuffer, DWORD dwNumBytesToRead, LPDWORD lpdwNumBytesRead);
+  FTC_STATUS GetQueueStatus(LPDWORD lpdwNumBytesInQueue);
+  FTC_STATUS WaitForBytes(DWORD dwNumBytesExpected, DWORD dwTimeoutmSec, LPDWORD lpdwNumBytesInQueue);
+  FTC_STATUS WaitForBytesConcurrently(DWORD dwNumBytesExpected, DWORD dwTimeoutmSec, LPDWORD lpdwNumBytesInQueue);
+
+  FTC_STATUS ResetDevice(void);
+  FTC_STATUS SetUSBParameters(DWORD dwInTransferSize, DWORD dwOutTransferSize);
+  FTC_STATUS SetChars(UCHAR EventCharacter, UCHAR EventCharEnabled, UCHAR ErrorCharacter, UCHAR ErrorCharEnabled);
+  FTC_STATUS SetTimeouts(DWORD dwReadTimeoutmSec, DWORD dwWriteTimeoutmSec);
+  FTC_STATUS SetLatencyTimer(BYTE LatencyTimermSec);
+  FTC_STATUS GetLatencyTimer(LPBYTE lpLatencyTimermSec);
+  FTC_STATUS SetBitMode(BYTE PinDirectionMask, BYTE BitMode);
+  FTC_STATUS Purge(void);
+
+  FTC_STATUS Close(void);
+};
+
+#endif  /* FtcTransport_H */
@@ -0,0 +1,459 @@
+/*++
+
+Module Name:
+
+    FtcBench.cpp
+
+Abstract:
+
+    Benchmarks run against the MPSSE emulator transport. The emulator answers in process, so the figures measure the
+    cost of the library itself, ie building MPSSE commands, splitting them into USB transfers and realigning the
+    bits read back, not the speed of a device. The emulator queues no transfers, so the transfer queue depths are
+    benchmarked against the first device opened with the libusb transport and skipped when there is none.
+
+Environment:
+
+    user mode
+
+--*/
+
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <time.h>
+
+#include "ftcjtag.h"
+#include "FtcBitKernels.h"
+
+#define MAX_SCAN_NUM_BITS 524279  // the most bits that fit in a write data buffer
+#define NUM_THROUGHPUT_SCANS 200
+#define NUM_LATENCY_SCANS 20000
+#define NUM_CHUNK_SIZE_SCANS 50
+#define NUM_QUEUE_DEPTH_SCANS 50
+#define NUM_ENCODED_SCANS 2000
+#define NUM_SEQUENCE_BUILD_ENTRIES 1600000  // read commands added for each sequence length
+#define MAX_NUM_SEQUENCE_BUILD_ENTRIES 16000  // read commands that fit in a sequence that is not streamed
+#define NUM_SCAN_LENGTH_BYTES 26214400  // 25M bytes written and read back for each scan length
+#define LATENCY_SPIN_PERIOD 100  // 100 microseconds
+
+static WriteDataByteBuffer WriteDataBuffer;
+static ReadDataByteBuffer ReadDataBuffer;
+
+static double GetMicroSecs(void)
+{
+  struct timespec Time;
+
+  clock_gettime(CLOCK_MONOTONIC, &Time);
+
+  return ((double(Time.tv_sec) * 1000000.0) + (double(Time.tv_nsec) / 1000.0));
+}
+
+static double GetCpuMicroSecs(void)
+{
+  struct timespec Time;
+
+  clock_gettime(CLOCK_PROCESS_CPUTIME_ID, &Time);
+
+  return ((double(Time.tv_sec) * 1000000.0) + (double(Time.tv_nsec) / 1000.0));
+}
+
+static int CompareMicroSecs(const void *pMicroSecs1, const void *pMicroSecs2)
+{
+  double dMicroSecs1 = *((const double *)pMicroSecs1);
+  double dMicroSecs2 = *((const double *)pMicroSecs2);
+
+  return ((dMicroSecs1 < dMicroSecs2) ? -1 : ((dMicroSecs1 > dMicroSecs2) ? 1 : 0));
+}
+
+static double GetMegaBytesPerSec(double dNumBytes, double dMicroSecs)
+{
+  return ((dMicroSecs > 0.0) ? (dNumBytes / dMicroSecs) : 0.0);
+}
+
+static FTC_STATUS OpenBenchDevice(FTC_HANDLE *pftHandle)
+{
+  FTC_STATUS Status = FTC_SUCCESS;
+
+  if ((Status = JTAG_OpenTransportDevice(FTC_TRANSPORT_MPSSE_EMULATOR, 0, pftHandle)) == FTC_SUCCESS)
+    Status = JTAG_InitDevice(*pftHandle, 0);
+
+  return Status;
+}
+
+// Scan throughput, the rate data is written to and read back from the device by the largest scans
+static FTC_STATUS BenchThroughput(FTC_HANDLE ftHandle)
+{
+  FTC_STATUS Status = FTC_SUCCESS;
+  DWORD dwScanIndex = 0;
+  DWORD dwNumBytesReturned = 0;
+  double dNumBytes = (double(NUM_THROUGHPUT_SCANS) * double((MAX_SCAN_NUM_BITS + 7) / 8));
+  double dStartMicroSecs = 0.0;
+
+  dStartMicroSecs = GetMicroSecs();
+
+  for (dwScanIndex = 0; ((dwScanIndex < NUM_THROUGHPUT_SCANS) && (Status == FTC_SUCCESS)); dwScanIndex++)
+    Status = JTAG_Write(ftHandle, FALSE, MAX_SCAN_NUM_BITS, &WriteDataBuffer, ((MAX_SCAN_NUM_BITS + 7) / 8), RUN_TEST_IDLE_STATE);
+
+  if (Status == FTC_SUCCESS)
+  {
+    printf("throughput  write        %8.1f MB/s\n", GetMegaBytesPerSec(dNumBytes, (GetMicroSecs() - dStartMicroSecs)));
+
+    dStartMicroSecs = GetMicroSecs();
+
+    for (dwScanIndex = 0; ((dwScanIndex < NUM_THROUGHPUT_SCANS) && (Status == FTC_SUCCESS)); dwScanIndex++)
+      Status = JTAG_Read(ftHandle, FALSE, MAX_SCAN_NUM_BITS, &ReadDataBuffer, &dwNumBytesReturned, RUN_TEST_IDLE_STATE);
+  }
+
+  if (Status == FTC_SUCCESS)
+  {
+    printf("throughput  read         %8.1f MB/s\n", GetMegaBytesPerSec(dNumBytes, (GetMicroSecs() - dStartMicroSecs)));
+
+    dStartMicroSecs = GetMicroSecs();
+
+    for (dwScanIndex = 0; ((dwScanIndex < NUM_THROUGHPUT_SCANS) && (Status == FTC_SUCCESS)); dwScanIndex++)
+      Status = JTAG_WriteRead(ftHandle, FALSE, MAX_SCAN_NUM_BITS, &WriteDataBuffer, ((MAX_SCAN_NUM_BITS + 7) / 8),
+                              &ReadDataBuffer, &dwNumBytesReturned, RUN_TEST_IDLE_STATE);
+  }
+
+  if (Status == FTC_SUCCESS)
+    printf("throughput  write read   %8.1f MB/s\n", GetMegaBytesPerSec(dNumBytes, (GetMicroSecs() - dStartMicroSecs)));
+
+  return Status;
+}
+
+// Round trip latency of a one byte write/read under each wait policy, and the processor time spent waiting. With the
+// I/O thread the bytes read back arrive from another thread, as they do from a device
+static FTC_STATUS BenchLatency(FTC_HANDLE ftHandle, BOOL bIOThreadEnabled)
+{
+  static const DWORD WaitPolicies[] = {FTC_WAIT_POLICY_SPIN, FTC_WAIT_POLICY_BLOCK, FTC_WAIT_POLICY_HYBRID};
+  static const LPCSTR WaitPolicyNames[] = {"spin", "block", "hybrid"};
+  static double ScanMicroSecs[NUM_LATENCY_SCANS];
+  FTC_STATUS Status = FTC_SUCCESS;
+  DWORD dwPolicyIndex = 0;
+  DWORD dwScanIndex = 0;
+  DWORD dwNumBytesReturned = 0;
+  double dStartMicroSecs = 0.0;
+  double dStartCpuMicroSecs = 0.0;
+  double dTotalMicroSecs = 0.0;
+
+  Status = JTAG_SetDeviceIOThread(ftHandle, bIOThreadEnabled);
+
+  for (dwPolicyIndex = 0; ((dwPolicyIndex < (sizeof(WaitPolicies) / sizeof(WaitPolicies[0]))) && (Status == FTC_SUCCESS)); dwPolicyIndex++)
+  {
+    Status = JTAG_SetDeviceWaitPolicy(ftHandle, WaitPolicies[dwPolicyIndex], LATENCY_SPIN_PERIOD);
+
+    dTotalMicroSecs = 0.0;
+    dStartCpuMicroSecs = GetCpuMicroSecs();
+
+    for (dwScanIndex = 0; ((dwScanIndex < NUM_LATENCY_SCANS) && (Status == FTC_SUCCESS)); dwScanIndex++)
+    {
+      dStartMicroSecs = GetMicroSecs();
+
+      Status = JTAG_WriteRead(ftHandle, FALSE, 8, &WriteDataBuffer, 1, &ReadDataBuffer, &dwNumBytesReturned, RUN_TEST_IDLE_STATE);
+
+      ScanMicroSecs[dwScanIndex] = (GetMicroSecs() - dStartMicroSecs);
+      dTotalMicroSecs = (dTotalMicroSecs + ScanMicroSecs[dwScanIndex]);
+    }
+
+    if (Status == FTC_SUCCESS)
+    {
+      qsort(ScanMicroSecs, NUM_LATENCY_SCANS, sizeof(ScanMicroSecs[0]), CompareMicroSecs);
+
+      printf("latency     %-6s %-6s mean %7.2f us  median %7.2f us  99%% %7.2f us  cpu %7.2f us\n", ((bIOThreadEnabled == TRUE) ? "thread" : "direct"),
+             WaitPolicyNames[dwPolicyIndex], (dTotalMicroSecs / NUM_LATENCY_SCANS), ScanMicroSecs[(NUM_LATENCY_SCANS / 2)],
+             ScanMicroSecs[((NUM_LATENCY_SCANS * 99) / 100)], ((GetCpuMicroSecs() - dStartCpuMicroSecs) / NUM_LATENCY_SCANS));
+    }
+  }
+
+  if (Status == FTC_SUCCESS)
+    Status = JTAG_SetDeviceWaitPolicy(ftHandle, FTC_WAIT_POLICY_HYBRID, LATENCY_SPIN_PERIOD);
+
+  if (Status == FTC_SUCCESS)
+    Status = JTAG_SetDeviceIOThread(ftHandle, FALSE);
+
+  return Status;
+}
+
+// Write/read throughput of the largest scans against the maximum number of bytes written to the device at a time
+static FTC_STATUS BenchUSBTransferChunkSizes(FTC_HANDLE ftHandle)
+{
+  static const DWORD USBTransferChunkSizes[] = {MIN_USB_TRANSFER_CHUNK_SIZE, 512, 1024, 4096, 16384, MAX_USB_TRANSFER_CHUNK_SIZE,
+                                                FTC_USB_TRANSFER_CHUNK_SIZE_AUTO};
+  FTC_STATUS Status = FTC_SUCCESS;
+  DWORD dwChunkSizeIndex = 0;
+  DWORD dwScanIndex = 0;
+  DWORD dwNumBytesReturned = 0;
+  DWORD dwUSBTransferChunkSize = 0;
+  double dNumBytes = (double(NUM_CHUNK_SIZE_SCANS) * double((MAX_SCAN_NUM_BITS + 7) / 8));
+  double dStartMicroSecs = 0.0;
+
+  for (dwChunkSizeIndex = 0; ((dwChunkSizeIndex < (sizeof(USBTransferChunkSizes) / sizeof(USBTransferChunkSizes[0]))) && (Status == FTC_SUCCESS)); dwChunkSizeIndex++)
+  {
+    Status = JTAG_SetDeviceUSBTransferChunkSize(ftHandle, USBTransferChunkSizes[dwChunkSizeIndex]);
+
+    dStartMicroSecs = GetMicroSecs();
+
+    for (dwScanIndex = 0; ((dwScanIndex < NUM_CHUNK_SIZE_SCANS) && (Status == FTC_SUCCESS)); dwScanIndex++)
+      Status = JTAG_WriteRead(ftHandle, FALSE, MAX_SCAN_NUM_BITS, &WriteDataBuffer, ((MAX_SCAN_NUM_BITS + 7) / 8),
+                              &ReadDataBuffer, &dwNumBytesReturned, RUN_TEST_IDLE_STATE);
+
+    if (Status == FTC_SUCCESS)
+    {
+      dwUSBTransferChunkSize = USBTransferChunkSizes[dwChunkSizeIndex];
+
+      if (dwUSBTransferChunkSize == FTC_USB_TRANSFER_CHUNK_SIZE_AUTO)
+        printf("chunk size  auto         %8.1f MB/s\n", GetMegaBytesPerSec(dNumBytes, (GetMicroSecs() - dStartMicroSecs)));
+      else
+        printf("chunk size  %-12u %8.1f MB/s\n", dwUSBTransferChunkSize, GetMegaBytesPerSec(dNumBytes, (GetMicroSecs() - dStartMicroSecs)));
+    }
+  }
+
+  return Status;
+}
+
+// Write/read throughput of the largest scans against the number of USB transfers kept queued in each direction, on a
+// device opened with the libusb transport
+static FTC_STATUS BenchTransferQueueDepths(void)
+{
+  static const DWORD NumQueuedTransfers[] = {1, 2, 4, 8, 16};
+  FTC_STATUS Status = FTC_SUCCESS;
+  FTC_HANDLE ftHandle = 0;
+  DWORD dwDepthIndex = 0;
+  DWORD dwScanIndex = 0;
+  DWORD dwNumBytesReturned = 0;
+  double dNumBytes = (double(NUM_QUEUE_DEPTH_SCANS) * double((MAX_SCAN_NUM_BITS + 7) / 8));
+  double dStartMicroSecs = 0.0;
+
+  // without libusb support or a device the sweep is skipped rather than failed
+  if (JTAG_OpenTransportDevice(FTC_TRANSPORT_LIBUSB, 0, &ftHandle) != FTC_SUCCESS)
+    printf("queue depth no libusb device, skipped\n");
+  else
+  {
+    Status = JTAG_InitDevice(ftHandle, 0);
+
+    for (dwDepthIndex = 0; ((dwDepthIndex < (sizeof(NumQueuedTransfers) / sizeof(NumQueuedTransfers[0]))) && (Status == FTC_SUCCESS)); dwDepthIndex++)
+    {
+      Status = JTAG_SetDeviceTransferQueueDepth(ftHandle, NumQueuedTransfers[dwDepthIndex], NumQueuedTransfers[dwDepthIndex]);
+
+      dStartMicroSecs = GetMicroSecs();
+
+      for (dwScanIndex = 0; ((dwScanIndex < NUM_QUEUE_DEPTH_SCANS) && (Status == FTC_SUCCESS)); dwScanIndex++)
+        Status = JTAG_WriteRead(ftHandle, FALSE, MAX_SCAN_NUM_BITS, &WriteDataBuffer, ((MAX_SCAN_NUM_BITS + 7) / 8),
+                                &ReadDataBuffer, &dwNumBytesReturned, RUN_TEST_IDLE_STATE);
+
+      if (Status == FTC_SUCCESS)
+        printf("queue depth %-12u %8.1f MB/s\n", NumQueuedTransfers[dwDepthIndex],
+               GetMegaBytesPerSec(dNumBytes, (GetMicroSecs() - dStartMicroSecs)));
+    }
+
+    JTAG_Close(ftHandle);
+  }
+
+  return Status;
+}
+
+// Write/read throughput against the scan length, a scan longer than a USB transfer is written while the bytes it
+// returns are read
+static FTC_STATUS BenchScanLengths(FTC_HANDLE ftHandle)
+{
+  static const DWORD ScanNumBytes[] = {64, 512, 4096, 4097, 16384, 32768, ((MAX_SCAN_NUM_BITS + 7) / 8)};
+  FTC_STATUS Status = FTC_SUCCESS;
+  DWORD dwLengthIndex = 0;
+  DWORD dwNumScans = 0;
+  DWORD dwScanIndex = 0;
+  DWORD dwNumBytesReturned = 0;
+  double dStartMicroSecs = 0.0;
+
+  for (dwLengthIndex = 0; ((dwLengthIndex < (sizeof(ScanNumBytes) / sizeof(ScanNumBytes[0]))) && (Status == FTC_SUCCESS)); dwLengthIndex++)
+  {
+    dwNumScans = (NUM_SCAN_LENGTH_BYTES / ScanNumBytes[dwLengthIndex]);
+
+    dStartMicroSecs = GetMicroSecs();
+
+    for (dwScanIndex = 0; ((dwScanIndex < dwNumScans) && (Status == FTC_SUCCESS)); dwScanIndex++)
+      Status = JTAG_WriteRead(ftHandle, FALSE, ((ScanNumBytes[dwLengthIndex] * 8) - 1), &WriteDataBuffer, ScanNumBytes[dwLengthIndex],
+                              &ReadDataBuffer, &dwNumBytesReturned, RUN_TEST_IDLE_STATE);
+
+    if (Status == FTC_SUCCESS)
+      printf("scan length %-12u %8.1f MB/s\n", ScanNumBytes[dwLengthIndex],
+             GetMegaBytesPerSec((double(dwNumScans) * double(ScanNumBytes[dwLengthIndex])), (GetMicroSecs() - dStartMicroSecs)));
+  }
+
+  return Status;
+}
+
+// Rate the MPSSE commands of 64K byte scans are built, the scans are added to a command sequence that is cleared
+// rather than executed, so only the encoding is timed. The bits read back by write read scans are realigned by the
+// bit kernels, so the encoding and the write read scans are timed with the scalar kernels, which give the figures
+// before the kernels, and with the kernels picked for the processor
+static FTC_STATUS BenchEncodeRate(FTC_HANDLE ftHandle)
+{
+  static const DWORD BitKernels[] = {FTC_BIT_KERNELS_SCALAR, FTC_BIT_KERNELS_AUTO};
+  static const LPCSTR BitKernelsNames[] = {"scalar", "auto"};
+  FTC_STATUS Status = FTC_SUCCESS;
+  DWORD dwKernelsIndex = 0;
+  DWORD dwScanIndex = 0;
+  DWORD dwNumBytesReturned = 0;
+  double dNumBytes = (double(NUM_ENCODED_SCANS) * double((MAX_SCAN_NUM_BITS + 7) / 8));
+  double dStartMicroSecs = 0.0;
+
+  for (dwKernelsIndex = 0; ((dwKernelsIndex < (sizeof(BitKernels) / sizeof(BitKernels[0]))) && (Status == FTC_SUCCESS)); dwKernelsIndex++)
+  {
+    FTC_SelectBitKernels(BitKernels[dwKernelsIndex]);
+
+    dStartMicroSecs = GetMicroSecs();
+
+    for (dwScanIndex = 0; ((dwScanIndex < NUM_ENCODED_SCANS) && (Status == FTC_SUCCESS)); dwScanIndex++)
+    {
+      if ((Status = JTAG_AddDeviceWriteCmd(ftHandle, FALSE, MAX_SCAN_NUM_BITS, &WriteDataBuffer, ((MAX_SCAN_NUM_BITS + 7) / 8),
+                                           RUN_TEST_IDLE_STATE)) == FTC_SUCCESS)
+        Status = JTAG_ClearDeviceCmdSequence(ftHandle);
+    }
+
+    if (Status == FTC_SUCCESS)
+    {
+      printf("encode      write        %8.1f MB/s  %s kernels\n", GetMegaBytesPerSec(dNumBytes, (GetMicroSecs() - dStartMicroSecs)),
+             BitKernelsNames[dwKernelsIndex]);
+
+      dStartMicroSecs = GetMicroSecs();
+
+      for (dwScanIndex = 0; ((dwScanIndex < NUM_ENCODED_SCANS) && (Status == FTC_SUCCESS)); dwScanIndex++)
+      {
+        if ((Status = JTAG_AddDeviceWriteReadCmd(ftHandle, FALSE, MAX_SCAN_NUM_BITS, &WriteDataBuffer, ((MAX_SCAN_NUM_BITS + 7) / 8),
+                                                 RUN_TEST_IDLE_STATE)) == FTC_SUCCESS)
+          Status = JTAG_ClearDeviceCmdSequence(ftHandle);
+      }
+    }
+
+    if (Status == FTC_SUCCESS)
+    {
+      printf("encode      write read   %8.1f MB/s  %s kernels\n", GetMegaBytesPerSec(dNumBytes, (GetMicroSecs() - dStartMicroSecs)),
+             BitKernelsNames[dwKernelsIndex]);
+
+      dStartMicroSecs = GetMicroSecs();
+
+      for (dwScanIndex = 0; ((dwScanIndex < NUM_THROUGHPUT_SCANS) && (Status == FTC_SUCCESS)); dwScanIndex++)
+        Status = JTAG_WriteRead(ftHandle, FALSE, MAX_SCAN_NUM_BITS, &WriteDataBuffer, ((MAX_SCAN_NUM_BITS + 7) / 8), &ReadDataBuffer,
+                                &dwNumBytesReturned, RUN_TEST_IDLE_STATE);
+    }
+
+    if (Status == FTC_SUCCESS)
+      printf("scan        write read   %8.1f MB/s  %s kernels\n",
+             GetMegaBytesPerSec((double(NUM_THROUGHPUT_SCANS) * double((MAX_SCAN_NUM_BITS + 7) / 8)), (GetMicroSecs() - dStartMicroSecs)),
+             BitKernelsNames[dwKernelsIndex]);
+  }
+
+  FTC_SelectBitKernels(FTC_BIT_KERNELS_AUTO);
+
+  return Status;
+}
+
+static FTC_STATUS WINAPI DiscardStreamedData(LPVOID pContext, LPBYTE pDataBytes, DWORD dwNumBytes)
+{
+  return FTC_SUCCESS;
+}
+
+// Time taken to build command sequences against the number of read commands in them, which stays the same per command
+// as long as adding a read command takes constant time. Sequences longer than the sequence buffer are streamed, so
+// their figures also include sending each segment to the emulator
+static FTC_STATUS BenchSequenceBuildTime(FTC_HANDLE ftHandle)
+{
+  static const DWORD SequenceNumEntries[] = {10, 100, 1000, 4000, 16000, 128000, 800000};
+  FTC_STATUS Status = FTC_SUCCESS;
+  BOOL bStreamingEnabled = FALSE;
+  DWORD dwLengthIndex = 0;
+  DWORD dwNumSequences = 0;
+  DWORD dwSequenceIndex = 0;
+  DWORD dwEntryIndex = 0;
+  double dStartMicroSecs = 0.0;
+  double dMicroSecs = 0.0;
+
+  for (dwLengthIndex = 0; ((dwLengthIndex < (sizeof(SequenceNumEntries) / sizeof(SequenceNumEntries[0]))) && (Status == FTC_SUCCESS)); dwLengthIndex++)
+  {
+    dwNumSequences = (NUM_SEQUENCE_BUILD_ENTRIES / SequenceNumEntries[dwLengthIndex]);
+
+    if ((SequenceNumEntries[dwLengthIndex] > MAX_NUM_SEQUENCE_BUILD_ENTRIES) && (!bStreamingEnabled))
+    {
+      Status = JTAG_SetDeviceCmdSequenceStreaming(ftHandle, TRUE, DiscardStreamedData, NULL);
+
+      bStreamingEnabled = (Status == FTC_SUCCESS);
+    }
+
+    dStartMicroSecs = GetMicroSecs();
+
+    for (dwSequenceIndex = 0; ((dwSequenceIndex < dwNumSequences) && (Status == FTC_SUCCESS)); dwSequenceIndex++)
+    {
+      for (dwEntryIndex = 0; ((dwEntryIndex < SequenceNumEntries[dwLengthIndex]) && (Status == FTC_SUCCESS)); dwEntryIndex++)
+        Status = JTAG_AddDeviceReadCmd(ftHandle, FALSE, 8, RUN_TEST_IDLE_STATE);
+
+      if (Status == FTC_SUCCESS)
+        Status = JTAG_ClearDeviceCmdSequence(ftHandle);
+    }
+
+    if (Status == FTC_SUCCESS)
+    {
+      dMicroSecs = ((GetMicroSecs() - dStartMicroSecs) / dwNumSequences);
+
+      printf("build       %-12u %8.1f us  %6.3f us per entry%s\n", SequenceNumEntries[dwLengthIndex], dMicroSecs,
+             (dMicroSecs / SequenceNumEntries[dwLengthIndex]), (bStreamingEnabled ? ", streamed" : ""));
+    }
+  }
+
+  if (bStreamingEnabled)
+  {
+    if (Status == FTC_SUCCESS)
+      Status = JTAG_SetDeviceCmdSequenceStreaming(ftHandle, FALSE, NULL, NULL);
+    else
+      JTAG_SetDeviceCmdSequenceStreaming(ftHandle, FALSE, NULL, NULL);
+  }
+
+  return Status;
+}
+
+int main(void)
+{
+  FTC_STATUS Status = FTC_SUCCESS;
+  FTC_HANDLE ftHandle = 0;
+  DWORD dwByteIndex = 0;
+  char szErrorMessage[256] = "";
+
+  for (dwByteIndex = 0; (dwByteIndex < sizeof(WriteDataBuffer)); dwByteIndex++)
+    WriteDataBuffer[dwByteIndex] = BYTE((dwByteIndex * 37) + (dwByteIndex >> 8));
+
+  if ((Status = OpenBenchDevice(&ftHandle)) == FTC_SUCCESS)
+  {
+    Status = BenchThroughput(ftHandle);
+
+    if (Status == FTC_SUCCESS)
+      Status = BenchLatency(ftHandle, FALSE);
+
+    if (Status == FTC_SUCCESS)
+      Status = BenchLatency(ftHandle, TRUE);
+
+    if (Status == FTC_SUCCESS)
+      Status = BenchUSBTransferChunkSizes(ftHandle);
+
+    if (Status == FTC_SUCCESS)
+      Status = BenchTransferQueueDepths();
+
+    if (Status == FTC_SUCCESS)
+      Status = BenchScanLengths(ftHandle);
+
+    if (Status == FTC_SUCCESS)
+      Status = BenchEncodeRate(ftHandle);
+
+    if (Status == FTC_SUCCESS)
+      Status = BenchSequenceBuildTime(ftHandle);
+
+    JTAG_Close(ftHandle);
+  }
+
+  if (Status != FTC_SUCCESS)
+  {
+    JTAG_GetErrorCodeString((LPSTR)"EN", Status, szErrorMessage, sizeof(szErrorMessage));
+
+    printf("benchmark failed, status %u: %s\n", Status, szErrorMessage);
+  }
+
+  return ((Status == FTC_SUCCESS) ? 0 : 1);
+}
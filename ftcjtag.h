@@ -68,6 +68,16 @@ enum {
 #define PAUSE_INSTRUCTION_REGISTER_STATE 4
 #define SHIFT_TEST_DATA_REGISTER_STATE 5
 #define SHIFT_INSTRUCTION_REGISTER_STATE 6
+#define SELECT_TEST_DATA_REGISTER_SCAN_STATE 7
+#define CAPTURE_TEST_DATA_REGISTER_STATE 8
+#define EXIT1_TEST_DATA_REGISTER_STATE 9
+#define EXIT2_TEST_DATA_REGISTER_STATE 10
+#define UPDATE_TEST_DATA_REGISTER_STATE 11
+#define SELECT_INSTRUCTION_REGISTER_SCAN_STATE 12
+#define CAPTURE_INSTRUCTION_REGISTER_STATE 13
+#define EXIT1_INSTRUCTION_REGISTER_STATE 14
+#define EXIT2_INSTRUCTION_REGISTER_STATE 15
+#define UPDATE_INSTRUCTION_REGISTER_STATE 16
 
 #define FTC_SUCCESS 0 // FTC_OK
 #define FTC_INVALID_HANDLE 1 // FTC_INVALID_HANDLE
@@ -114,6 +124,67 @@ enum {
 #define FTC_INVALID_LANGUAGE_CODE 53
 #define FTC_INVALID_STATUS_CODE 54
 
+#define FTC_INVALID_TRANSPORT_TYPE 55
+#define FTC_TRANSPORT_NOT_SUPPORTED 56
+#define FTC_INVALID_TRANSFER_QUEUE_DEPTH 57
+#define FTC_NOT_SUPPORTED_BY_TRANSPORT 58
+#define FTC_INVALID_WAIT_POLICY 59
+#define FTC_INVALID_SPIN_PERIOD 60
+#define FTC_INVALID_USB_TRANSFER_CHUNK_SIZE 61
+#define FTC_INVALID_COMMAND_TIMEOUT 62
+#define FTC_COMMAND_SEQUENCE_SUBMITTED 63
+#define FTC_COMMAND_SEQUENCE_NOT_COMPLETE 64
+#define FTC_COMPLETION_FD_NOT_SUPPORTED 65
+#define FTC_TOO_MANY_SCAN_TEMPLATES 66
+#define FTC_INVALID_SCAN_TEMPLATE 67
+#define FTC_INVALID_NUMBER_SCANS 68
+#define FTC_INVALID_SCAN_TYPE 69
+#define FTC_NULL_SCAN_TEMPLATE_SCANS_POINTER 70
+#define FTC_TDO_DATA_MISMATCH 71
+#define FTC_NULL_EXPECTED_DATA_BUFFER_POINTER 72
+#define FTC_INVALID_NUMBER_IDLE_CYCLES 73
+#define FTC_COMMAND_SEQUENCE_STREAMING 74
+#define FTC_INVALID_COMMAND_SEQUENCE_TICKET 75
+#define FTC_TOO_MANY_RECORDED_COMMAND_SEQUENCES 76
+#define FTC_INVALID_RECORDED_COMMAND_SEQUENCE 77
+#define FTC_INCOMPATIBLE_RECORDED_COMMAND_SEQUENCE 78
+
+// Transport backends
+#define FTC_TRANSPORT_D2XX 0             // FTDI D2XX driver
+#define FTC_TRANSPORT_LIBUSB 1           // libusb-1.0, only available when built with FTCJTAG_WITH_LIBUSB
+#define FTC_TRANSPORT_MPSSE_EMULATOR 2   // in-process MPSSE emulator, TDO wired to TDI
+
+// Device indexes of the MPSSE emulator transport, which select the type of device emulated
+#define FTC_EMULATOR_HI_SPEED_DEVICE_INDEX 0   // FT2232H hi-speed device
+#define FTC_EMULATOR_DUAL_DEVICE_INDEX 1       // FT2232D dual device
+
+// State of the device under test modelled by the MPSSE emulator, for tests of the commands sent to a device. The
+// emulator follows the TAP controller through every TCK clock. The instruction register holds the bits shifted in
+// between the last pass through the capture and update instruction register states, up to the first 256 bits, and
+// holds no bits after the test logic reset state or when none were shifted in ie the captured bits were written.
+#define MAX_NUM_EMULATOR_INSTRUCTION_REGISTER_BYTES 32
+
+typedef struct Ft_Emulator_State{
+  DWORD dwTapControllerState;                       // TAP controller state, one of the XXX_STATE values above
+  DWORD dwNumCommands;                              // number of MPSSE commands executed
+  DWORD dwNumTmsClocks;                             // number of TCK clocks sent by TMS commands
+  DWORD dwNumTckClocks;                             // number of TCK clocks sent by every command
+  DWORD dwNumClockOnlyCommands;                     // number of clock commands with no data transfer executed
+  DWORD dwNumInstructionRegisterUpdates;            // number of passes through the update instruction register state
+  DWORD dwNumInstructionRegisterBits;               // number of bits the instruction register holds
+  BYTE  InstructionRegisterBytes[MAX_NUM_EMULATOR_INSTRUCTION_REGISTER_BYTES];
+}FTC_EMULATOR_STATE, *PFTC_EMULATOR_STATE;
+
+// Wait policies, how a device handle waits for the bytes returned by a device
+#define FTC_WAIT_POLICY_SPIN 0           // poll the device input queue, giving up the timeslice between polls
+#define FTC_WAIT_POLICY_BLOCK 1          // sleep until the expected number of bytes has been received
+#define FTC_WAIT_POLICY_HYBRID 2         // poll for the spin period, then sleep, default wait policy
+
+// USB transfer chunk sizes, the maximum number of bytes passed to a transport in a single write
+#define FTC_USB_TRANSFER_CHUNK_SIZE_AUTO 0   // use the transfer size negotiated with the device, default
+#define MIN_USB_TRANSFER_CHUNK_SIZE 64
+#define MAX_USB_TRANSFER_CHUNK_SIZE 65536
+
 #ifdef __cplusplus
 extern "C" {
 #endif
@@ -142,6 +213,48 @@ FTC_STATUS WINAPI JTAG_OpenHiSpeedDevice(LPSTR lpDeviceName, DWORD dwLocationID,
 FTCJTAG_API
 FTC_STATUS WINAPI JTAG_GetHiSpeedDeviceType(FTC_HANDLE ftHandle, LPDWORD lpdwHiSpeedDeviceType);
 
+FTCJTAG_API
+FTC_STATUS WINAPI JTAG_OpenTransportDevice(DWORD dwTransportType, DWORD dwDeviceIndex, FTC_HANDLE *pftHandle);
+
+FTCJTAG_API
+FTC_STATUS WINAPI JTAG_GetDeviceTransportType(FTC_HANDLE ftHandle, LPDWORD lpdwTransportType);
+
+// Only supported by devices opened with the FTC_TRANSPORT_MPSSE_EMULATOR transport
+FTCJTAG_API
+FTC_STATUS WINAPI JTAG_GetEmulatorState(FTC_HANDLE ftHandle, PFTC_EMULATOR_STATE pEmulatorState);
+
+FTCJTAG_API
+FTC_STATUS WINAPI JTAG_SetDeviceTransferQueueDepth(FTC_HANDLE ftHandle, DWORD dwNumWriteTransfers, DWORD dwNumReadTransfers);
+
+FTCJTAG_API
+FTC_STATUS WINAPI JTAG_GetDeviceTransferQueueDepth(FTC_HANDLE ftHandle, LPDWORD lpdwNumWriteTransfers, LPDWORD lpdwNumReadTransfers);
+
+FTCJTAG_API
+FTC_STATUS WINAPI JTAG_SetDeviceWaitPolicy(FTC_HANDLE ftHandle, DWORD dwWaitPolicy, DWORD dwSpinPeriodMicroSecs);
+
+FTCJTAG_API
+FTC_STATUS WINAPI JTAG_GetDeviceWaitPolicy(FTC_HANDLE ftHandle, LPDWORD lpdwWaitPolicy, LPDWORD lpdwSpinPeriodMicroSecs);
+
+FTCJTAG_API
+FTC_STATUS WINAPI JTAG_SetDeviceUSBTransferChunkSize(FTC_HANDLE ftHandle, DWORD dwUSBTransferChunkSize);
+
+FTCJTAG_API
+FTC_STATUS WINAPI JTAG_GetDeviceUSBTransferChunkSize(FTC_HANDLE ftHandle, LPDWORD lpdwUSBTransferChunkSize);
+
+// The command timeout is how long a function that waits for the device to reply is given to complete, from 1
+// millisecond to 1 hour. A submitted command sequence is given it from when it is submitted until it is collected.
+FTCJTAG_API
+FTC_STATUS WINAPI JTAG_SetDeviceCommandTimeout(FTC_HANDLE ftHandle, DWORD dwCommandTimeoutmSec);
+
+FTCJTAG_API
+FTC_STATUS WINAPI JTAG_GetDeviceCommandTimeout(FTC_HANDLE ftHandle, LPDWORD lpdwCommandTimeoutmSec);
+
+FTCJTAG_API
+FTC_STATUS WINAPI JTAG_SetDeviceIOThread(FTC_HANDLE ftHandle, BOOL bIOThreadEnabled);
+
+FTCJTAG_API
+FTC_STATUS WINAPI JTAG_GetDeviceIOThread(FTC_HANDLE ftHandle, LPBOOL lpbIOThreadEnabled);
+
 FTCJTAG_API
 FTC_STATUS WINAPI JTAG_Close(FTC_HANDLE ftHandle);
 
@@ -288,6 +401,55 @@ FTC_STATUS WINAPI JTAG_WriteRead(FTC_HANDLE ftHandle, BOOL bInstructionTestData,
                                  PReadDataByteBuffer pReadDataBuffer, LPDWORD lpdwNumBytesReturned,
                                  DWORD dwTapControllerState);
 
+// The Ex functions clock the TAP controller dwNumIdleCycles times in the Run-Test/Idle state after the scan, the state
+// passed in must then be RUN_TEST_IDLE_STATE. Up to 65536 idle cycles can follow a scan, a few of them are clocked by
+// the TMS command that ends the scan and the scan and its idle cycles are sent to the device in one write
+FTCJTAG_API
+FTC_STATUS WINAPI JTAG_WriteEx(FTC_HANDLE ftHandle, BOOL bInstructionTestData, DWORD dwNumBitsToWrite,
+                               PWriteDataByteBuffer pWriteDataBuffer, DWORD dwNumBytesToWrite,
+                               DWORD dwTapControllerState, DWORD dwNumIdleCycles);
+
+FTCJTAG_API
+FTC_STATUS WINAPI JTAG_ReadEx(FTC_HANDLE ftHandle, BOOL bInstructionTestData, DWORD dwNumBitsToRead,
+                              PReadDataByteBuffer pReadDataBuffer, LPDWORD lpdwNumBytesReturned,
+                              DWORD dwTapControllerState, DWORD dwNumIdleCycles);
+
+FTCJTAG_API
+FTC_STATUS WINAPI JTAG_WriteReadEx(FTC_HANDLE ftHandle, BOOL bInstructionTestData, DWORD dwNumBitsToWriteRead,
+                                   PWriteDataByteBuffer pWriteDataBuffer, DWORD dwNumBytesToWrite,
+                                   PReadDataByteBuffer pReadDataBuffer, LPDWORD lpdwNumBytesReturned,
+                                   DWORD dwTapControllerState, DWORD dwNumIdleCycles);
+
+#define NO_TDO_DATA_MISMATCH 0xFFFFFFFF
+
+// Writes data to an external device and compares the data read back with the expected data, only the bits set in
+// the mask are compared and every bit is compared if pMaskDataBuffer is NULL. FTC_TDO_DATA_MISMATCH is returned at
+// the first bit that does not match and lpdwMismatchBitOffset is set to the offset of that bit, otherwise it is set
+// to NO_TDO_DATA_MISMATCH. A scan with a mismatch is not clocked any further than the data already sent. If the scan
+// was stopped before all the bits were shifted, the TAP controller is left in PAUSE_TEST_DATA_REGISTER_STATE or
+// PAUSE_INSTRUCTION_REGISTER_STATE instead of the state passed in, so the partly shifted data is never updated into
+// the register, otherwise the TAP controller is moved to the state passed in.
+FTCJTAG_API
+FTC_STATUS WINAPI JTAG_WriteReadCompare(FTC_HANDLE ftHandle, BOOL bInstructionTestData, DWORD dwNumBitsToWriteRead,
+                                        PWriteDataByteBuffer pWriteDataBuffer, DWORD dwNumBytesToWrite,
+                                        PWriteDataByteBuffer pExpectedDataBuffer, PWriteDataByteBuffer pMaskDataBuffer,
+                                        LPDWORD lpdwMismatchBitOffset, DWORD dwTapControllerState);
+
+// Streaming scan callbacks. A data source fills pDataBytes with the next dwNumBytes bytes to be clocked out, a data
+// sink is passed the next dwNumBytes bytes clocked in. Returning anything other than FTC_SUCCESS stops the scan and
+// the status returned is passed back to the caller of JTAG_StreamScan. The callbacks are made while the library is
+// locked, so they must not call any JTAG_ function.
+typedef FTC_STATUS (WINAPI *PFTC_SCAN_DATA_SOURCE)(LPVOID pContext, LPBYTE pDataBytes, DWORD dwNumBytes);
+typedef FTC_STATUS (WINAPI *PFTC_SCAN_DATA_SINK)(LPVOID pContext, LPBYTE pDataBytes, DWORD dwNumBytes);
+
+// Scans any number of bits without leaving the shift state. The data is fetched from pDataSource and/or passed to
+// pDataSink in blocks of up to 64k bytes, either one may be NULL for a write only or read only scan. A scan stopped
+// after part of it was clocked leaves the TAP controller in a state that is not known, so the next scan resets it.
+FTCJTAG_API
+FTC_STATUS WINAPI JTAG_StreamScan(FTC_HANDLE ftHandle, BOOL bInstructionTestData, ULONGLONG ulNumBitsToScan,
+                                  PFTC_SCAN_DATA_SOURCE pDataSource, PFTC_SCAN_DATA_SINK pDataSink,
+                                  LPVOID pContext, DWORD dwTapControllerState);
+
 FTCJTAG_API
 FTC_STATUS WINAPI JTAG_GenerateClockPulses(FTC_HANDLE ftHandle, DWORD dwNumClockPulses);
 
@@ -331,10 +493,140 @@ FTC_STATUS WINAPI JTAG_AddDeviceWriteReadCmd(FTC_HANDLE ftHandle, BOOL bInstruct
                                              PWriteDataByteBuffer pWriteDataBuffer, DWORD dwNumBytesToWrite,
                                              DWORD dwTapControllerState);
 
+// Idle cycles are added to a command sequence the same way as by JTAG_WriteEx, JTAG_ReadEx and JTAG_WriteReadEx
+FTCJTAG_API
+FTC_STATUS WINAPI JTAG_AddDeviceWriteCmdEx(FTC_HANDLE ftHandle, BOOL bInstructionTestData, DWORD dwNumBitsToWrite,
+                                           PWriteDataByteBuffer pWriteDataBuffer, DWORD dwNumBytesToWrite,
+                                           DWORD dwTapControllerState, DWORD dwNumIdleCycles);
+
+FTCJTAG_API
+FTC_STATUS WINAPI JTAG_AddDeviceReadCmdEx(FTC_HANDLE ftHandle, BOOL bInstructionTestData, DWORD dwNumBitsToRead,
+                                          DWORD dwTapControllerState, DWORD dwNumIdleCycles);
+
+FTCJTAG_API
+FTC_STATUS WINAPI JTAG_AddDeviceWriteReadCmdEx(FTC_HANDLE ftHandle, BOOL bInstructionTestData, DWORD dwNumBitsToWriteRead,
+                                               PWriteDataByteBuffer pWriteDataBuffer, DWORD dwNumBytesToWrite,
+                                               DWORD dwTapControllerState, DWORD dwNumIdleCycles);
+
 FTCJTAG_API
 FTC_STATUS WINAPI JTAG_ExecuteCmdSequence(FTC_HANDLE ftHandle, PReadCmdSequenceDataByteBuffer pReadCmdSequenceDataBuffer,
                                           LPDWORD lpdwNumBytesReturned);
 
+FTCJTAG_API
+FTC_STATUS WINAPI JTAG_SubmitCmdSequence(FTC_HANDLE ftHandle);
+
+FTCJTAG_API
+FTC_STATUS WINAPI JTAG_ReapCmdSequence(FTC_HANDLE ftHandle, PReadCmdSequenceDataByteBuffer pReadCmdSequenceDataBuffer,
+                                       LPDWORD lpdwNumBytesReturned);
+
+// Sends a command sequence like JTAG_SubmitCmdSequence and returns a ticket for it. The next command sequence can be
+// built while the submitted one is being executed, JTAG_ClearDeviceCmdSequence only clears the sequence being built.
+// The next sequence can be executed once the submitted one has been collected with JTAG_PollCmdSequence, which returns
+// FTC_COMMAND_SEQUENCE_NOT_COMPLETE until the device has returned all the bytes of the sequence, or
+// JTAG_WaitCmdSequence, which waits for them. JTAG_AbandonDeviceCmdSequence discards the submitted sequence instead.
+// Until then the scan, clock pulse, scan template and input pin functions return FTC_COMMAND_SEQUENCE_SUBMITTED.
+FTCJTAG_API
+FTC_STATUS WINAPI JTAG_ExecuteCmdSequenceAsync(FTC_HANDLE ftHandle, LPDWORD lpdwTicket);
+
+FTCJTAG_API
+FTC_STATUS WINAPI JTAG_PollCmdSequence(FTC_HANDLE ftHandle, DWORD dwTicket, PReadCmdSequenceDataByteBuffer pReadCmdSequenceDataBuffer,
+                                       LPDWORD lpdwNumBytesReturned);
+
+FTCJTAG_API
+FTC_STATUS WINAPI JTAG_WaitCmdSequence(FTC_HANDLE ftHandle, DWORD dwTicket, PReadCmdSequenceDataByteBuffer pReadCmdSequenceDataBuffer,
+                                       LPDWORD lpdwNumBytesReturned);
+
+FTCJTAG_API
+FTC_STATUS WINAPI JTAG_AbandonDeviceCmdSequence(FTC_HANDLE ftHandle);
+
+// Executes a command sequence and compares the data returned with the expected data, which is laid out the same as
+// the read data returned by JTAG_ExecuteCmdSequence. The unused bits at the end of the data of each read command are
+// returned as 0. The mask and mismatch offset are used the same way as by JTAG_WriteReadCompare, the sequence is
+// always executed to the end.
+FTCJTAG_API
+FTC_STATUS WINAPI JTAG_ExecuteCmdSequenceCompare(FTC_HANDLE ftHandle, PReadCmdSequenceDataByteBuffer pExpectedDataBuffer,
+                                                 PReadCmdSequenceDataByteBuffer pMaskDataBuffer, LPDWORD lpdwMismatchBitOffset);
+
+FTCJTAG_API
+FTC_STATUS WINAPI JTAG_GetDeviceCompletionFd(FTC_HANDLE ftHandle, INT *piCompletionFd);
+
+// The optimizer rewrites the commands of each command sequence before it is sent, it fuses TMS commands, drops TMS
+// clocks given once the TAP controller has been reset and merges adjacent byte shifts. The data read back and the
+// state the TAP controller is left in are unchanged. It is disabled when a device is opened.
+FTCJTAG_API
+FTC_STATUS WINAPI JTAG_SetDeviceCmdSequenceOptimizer(FTC_HANDLE ftHandle, BOOL bOptimizerEnabled);
+
+FTCJTAG_API
+FTC_STATUS WINAPI JTAG_GetDeviceCmdSequenceOptimizer(FTC_HANDLE ftHandle, LPBOOL lpbOptimizerEnabled, LPDWORD lpdwNumBytesSaved);
+
+// In streaming mode the command sequence of a device is sent in segments of up to 64k bytes as it is built, so it
+// is never full, and the bytes read by each segment are passed to pDataSink instead of being returned by
+// JTAG_ExecuteCmdSequence, which then sends the last segment and returns the total number of bytes passed to the
+// sink. The read data buffer passed to JTAG_ExecuteCmdSequence may be NULL. Changing the mode discards the command
+// sequence being built, a streaming sequence can not be submitted or compared. The buffers the segments are read into
+// are allocated once when streaming is enabled and freed when it is disabled or the device is closed.
+FTCJTAG_API
+FTC_STATUS WINAPI JTAG_SetDeviceCmdSequenceStreaming(FTC_HANDLE ftHandle, BOOL bStreamingEnabled, PFTC_SCAN_DATA_SINK pDataSink,
+                                                     LPVOID pContext);
+
+// The value last written to the instruction register of each device is remembered and a JTAG_Write to the instruction
+// register with the same value only moves the TAP controller to the end state. Only a write that ends in a state
+// reached through the update instruction register state, ie any state but the test logic reset state and the select,
+// capture, shift, exit and pause instruction register states, is remembered or skipped. The cache is enabled when a
+// device is opened and is dropped whenever the value of the instruction register is not known, ie after a read of the
+// instruction register, a scan that ends in any other state, a command sequence, a scan template or the test logic
+// reset state.
+FTCJTAG_API
+FTC_STATUS WINAPI JTAG_SetDeviceIRCache(FTC_HANDLE ftHandle, BOOL bCacheEnabled);
+
+FTCJTAG_API
+FTC_STATUS WINAPI JTAG_GetDeviceIRCache(FTC_HANDLE ftHandle, LPBOOL lpbCacheEnabled, LPDWORD lpdwNumScansSkipped);
+
+// Scan templates, the commands for a series of scans are built once when the template is created and only the data
+// is changed each time the template is executed
+#define MAX_NUM_SCAN_TEMPLATE_SCANS 16
+
+#define SCAN_TEMPLATE_WRITE 0
+#define SCAN_TEMPLATE_READ 1
+#define SCAN_TEMPLATE_WRITE_READ 2
+
+typedef struct Ft_Scan_Template_Scan{
+  DWORD dwScanType;
+  BOOL  bInstructionTestData;
+  DWORD dwNumBits;
+  DWORD dwTapControllerState;
+}FTC_SCAN_TEMPLATE_SCAN, *PFTC_SCAN_TEMPLATE_SCAN;
+
+// One write data buffer for each scan, the entries of read scans are not used
+typedef PWriteDataByteBuffer ScanTemplateWriteDataBuffers[MAX_NUM_SCAN_TEMPLATE_SCANS];
+typedef ScanTemplateWriteDataBuffers *PScanTemplateWriteDataBuffers;
+
+FTCJTAG_API
+FTC_STATUS WINAPI JTAG_CreateScanTemplate(FTC_HANDLE ftHandle, PFTC_SCAN_TEMPLATE_SCAN pScans, DWORD dwNumScans,
+                                          LPDWORD lpdwScanTemplate);
+
+FTCJTAG_API
+FTC_STATUS WINAPI JTAG_ExecuteScanTemplate(FTC_HANDLE ftHandle, DWORD dwScanTemplate, PScanTemplateWriteDataBuffers pWriteDataBuffers,
+                                           PReadCmdSequenceDataByteBuffer pReadDataBuffer, LPDWORD lpdwNumBytesReturned);
+
+FTCJTAG_API
+FTC_STATUS WINAPI JTAG_DeleteScanTemplate(FTC_HANDLE ftHandle, DWORD dwScanTemplate);
+
+// Recorded command sequences, the command sequence built for a device is frozen with the bytes it reads already laid
+// out, so it can be executed again and again without being rebuilt. A recorded sequence is not tied to the device it
+// was built for, it can be executed with any device of the same type, ie FT2232D or hi-speed, and is kept until it
+// is deleted. It is replayed from the TAP controller state it was built from.
+FTCJTAG_API
+FTC_STATUS WINAPI JTAG_RecordCmdSequence(FTC_HANDLE ftHandle, LPDWORD lpdwRecordedCmdSequence);
+
+FTCJTAG_API
+FTC_STATUS WINAPI JTAG_ExecuteRecordedCmdSequence(FTC_HANDLE ftHandle, DWORD dwRecordedCmdSequence,
+                                                  PReadCmdSequenceDataByteBuffer pReadCmdSequenceDataBuffer,
+                                                  LPDWORD lpdwNumBytesReturned);
+
+FTCJTAG_API
+FTC_STATUS WINAPI JTAG_DeleteRecordedCmdSequence(DWORD dwRecordedCmdSequence);
+
 FTCJTAG_API
 FTC_STATUS WINAPI JTAG_GetDllVersion(LPSTR lpDllVersionBuffer, DWORD dwBufferSize);
 
@@ -0,0 +1,280 @@
+/*++
+
+Module Name:
+
+    FtcBitKernelsTest.cpp
+
+Abstract:
+
+    Compares FTC_CopyBits and FTC_FindFirstMismatchBit with a bit at a time reference, for every kernel the
+    processor supports. Copies use random source and destination bit offsets, in place copies and buffers that end
+    at the last byte holding a copied bit, so a kernel that reads or writes past the end of a buffer shows up under a
+    memory checker. Compares are made with and without a mask.
+
+Environment:
+
+    user mode
+
+--*/
+
+#include <stdio.h>
+#include <string.h>
+
+#include "FtcBitKernels.h"
+
+#define NUM_COPY_TESTS 20000
+#define NUM_COMPARE_TESTS 20000
+#define MAX_NUM_TEST_BITS 4096
+#define MAX_TEST_BIT_OFFSET 256
+
+static DWORD dwRandomState = 0x2545F491;
+
+static DWORD GetRandomNumber(DWORD dwLimit)
+{
+  // xorshift32, so every run tests the same buffers
+  dwRandomState = (dwRandomState ^ (dwRandomState << 13));
+  dwRandomState = (dwRandomState ^ (dwRandomState >> 17));
+  dwRandomState = (dwRandomState ^ (dwRandomState << 5));
+
+  return (dwRandomState % dwLimit);
+}
+
+static void FillRandomBytes(LPBYTE pBuffer, DWORD dwNumBytes)
+{
+  DWORD dwByteIndex = 0;
+
+  for (dwByteIndex = 0; (dwByteIndex < dwNumBytes); dwByteIndex++)
+    pBuffer[dwByteIndex] = BYTE(GetRandomNumber(256));
+}
+
+static DWORD GetNumBitBytes(DWORD dwBitOffset, DWORD dwNumBits)
+{
+  return (((dwBitOffset + dwNumBits) + 7) / 8);
+}
+
+static BYTE GetBit(const BYTE *pBuffer, DWORD dwBitOffset)
+{
+  return BYTE((pBuffer[(dwBitOffset / 8)] >> (dwBitOffset % 8)) & 1);
+}
+
+static void SetBit(LPBYTE pBuffer, DWORD dwBitOffset, BYTE Bit)
+{
+  pBuffer[(dwBitOffset / 8)] = BYTE((pBuffer[(dwBitOffset / 8)] & ~(1 << (dwBitOffset % 8))) | (Bit << (dwBitOffset % 8)));
+}
+
+static void ReferenceCopyBits(LPBYTE pDestination, DWORD dwDestinationBitOffset, const BYTE *pSource, DWORD dwSourceBitOffset,
+                              DWORD dwNumBits)
+{
+  DWORD dwBitIndex = 0;
+  DWORD dwLastBitOffset = (dwDestinationBitOffset + dwNumBits);
+
+  for (dwBitIndex = 0; (dwBitIndex < dwNumBits); dwBitIndex++)
+    SetBit(pDestination, (dwDestinationBitOffset + dwBitIndex), GetBit(pSource, (dwSourceBitOffset + dwBitIndex)));
+
+  // the bits of the last destination byte above the last bit copied are cleared
+  if ((dwNumBits > 0) && ((dwLastBitOffset % 8) > 0))
+    pDestination[(dwLastBitOffset / 8)] = BYTE(pDestination[(dwLastBitOffset / 8)] & ((1 << (dwLastBitOffset % 8)) - 1));
+}
+
+static DWORD ReferenceFindFirstMismatchBit(const BYTE *pData, const BYTE *pExpected, const BYTE *pMask, DWORD dwNumBits)
+{
+  DWORD dwMismatchBitOffset = FTC_NO_BIT_MISMATCH;
+  DWORD dwBitIndex = 0;
+
+  for (dwBitIndex = 0; ((dwBitIndex < dwNumBits) && (dwMismatchBitOffset == FTC_NO_BIT_MISMATCH)); dwBitIndex++)
+  {
+    if ((GetBit(pData, dwBitIndex) != GetBit(pExpected, dwBitIndex)) && ((pMask == NULL) || (GetBit(pMask, dwBitIndex) == 1)))
+      dwMismatchBitOffset = dwBitIndex;
+  }
+
+  return dwMismatchBitOffset;
+}
+
+static DWORD TestCopyBits(LPCSTR lpKernelsName)
+{
+  DWORD dwNumFailures = 0;
+  DWORD dwTestIndex = 0;
+  DWORD dwNumBits = 0;
+  DWORD dwSourceBitOffset = 0;
+  DWORD dwDestinationBitOffset = 0;
+  DWORD dwNumSourceBytes = 0;
+  DWORD dwNumDestinationBytes = 0;
+  BOOL  bInPlace = FALSE;
+  LPBYTE pSource = NULL;
+  LPBYTE pDestination = NULL;
+  LPBYTE pExpected = NULL;
+
+  for (dwTestIndex = 0; (dwTestIndex < NUM_COPY_TESTS); dwTestIndex++)
+  {
+    // short copies are picked more often, so the head and tail bits are tested on their own as well
+    if ((dwTestIndex % 4) == 0)
+      dwNumBits = GetRandomNumber(MAX_NUM_TEST_BITS + 1);
+    else
+      dwNumBits = GetRandomNumber(200);
+
+    dwSourceBitOffset = GetRandomNumber(MAX_TEST_BIT_OFFSET);
+    bInPlace = ((dwTestIndex % 3) == 0);
+
+    // an in place copy must not start after the first source bit
+    if (bInPlace)
+      dwDestinationBitOffset = GetRandomNumber(dwSourceBitOffset + 1);
+    else
+      dwDestinationBitOffset = GetRandomNumber(MAX_TEST_BIT_OFFSET);
+
+    dwNumSourceBytes = GetNumBitBytes(dwSourceBitOffset, dwNumBits);
+    dwNumDestinationBytes = GetNumBitBytes(dwDestinationBitOffset, dwNumBits);
+
+    // both buffers end at the last byte holding a copied bit
+    pSource = new BYTE[dwNumSourceBytes];
+    pExpected = new BYTE[((dwNumSourceBytes > dwNumDestinationBytes) ? dwNumSourceBytes : dwNumDestinationBytes)];
+
+    FillRandomBytes(pSource, dwNumSourceBytes);
+
+    if (bInPlace)
+    {
+      memcpy(pExpected, pSource, dwNumSourceBytes);
+
+      ReferenceCopyBits(pExpected, dwDestinationBitOffset, pSource, dwSourceBitOffset, dwNumBits);
+
+      FTC_CopyBits(pSource, dwDestinationBitOffset, pSource, dwSourceBitOffset, dwNumBits);
+
+      if (memcmp(pSource, pExpected, dwNumSourceBytes) != 0)
+      {
+        printf("%s: in place copy of %u bits from bit %u to bit %u failed\n", lpKernelsName, dwNumBits, dwSourceBitOffset,
+               dwDestinationBitOffset);
+
+        dwNumFailures = (dwNumFailures + 1);
+      }
+    }
+    else
+    {
+      pDestination = new BYTE[dwNumDestinationBytes];
+
+      FillRandomBytes(pDestination, dwNumDestinationBytes);
+      memcpy(pExpected, pDestination, dwNumDestinationBytes);
+
+      ReferenceCopyBits(pExpected, dwDestinationBitOffset, pSource, dwSourceBitOffset, dwNumBits);
+
+      FTC_CopyBits(pDestination, dwDestinationBitOffset, pSource, dwSourceBitOffset, dwNumBits);
+
+      if (memcmp(pDestination, pExpected, dwNumDestinationBytes) != 0)
+      {
+        printf("%s: copy of %u bits from bit %u to bit %u failed\n", lpKernelsName, dwNumBits, dwSourceBitOffset,
+               dwDestinationBitOffset);
+
+        dwNumFailures = (dwNumFailures + 1);
+      }
+
+      delete [] pDestination;
+    }
+
+    delete [] pExpected;
+    delete [] pSource;
+  }
+
+  return dwNumFailures;
+}
+
+static DWORD TestFindFirstMismatchBit(LPCSTR lpKernelsName)
+{
+  DWORD dwNumFailures = 0;
+  DWORD dwTestIndex = 0;
+  DWORD dwNumBits = 0;
+  DWORD dwNumBytes = 0;
+  DWORD dwByteIndex = 0;
+  DWORD dwNumFlippedBits = 0;
+  DWORD dwFlippedBitIndex = 0;
+  DWORD dwBitOffset = 0;
+  DWORD dwMismatchBitOffset = 0;
+  DWORD dwExpectedMismatchBitOffset = 0;
+  LPBYTE pData = NULL;
+  LPBYTE pExpected = NULL;
+  LPBYTE pMask = NULL;
+
+  for (dwTestIndex = 0; (dwTestIndex < NUM_COMPARE_TESTS); dwTestIndex++)
+  {
+    if ((dwTestIndex % 4) == 0)
+      dwNumBits = GetRandomNumber(MAX_NUM_TEST_BITS + 1);
+    else
+      dwNumBits = GetRandomNumber(300);
+
+    dwNumBytes = GetNumBitBytes(0, dwNumBits);
+
+    pData = new BYTE[dwNumBytes];
+    pExpected = new BYTE[dwNumBytes];
+
+    FillRandomBytes(pData, dwNumBytes);
+    memcpy(pExpected, pData, dwNumBytes);
+
+    // the bits after the last bit compared differ too, so they must be ignored
+    if ((dwNumBits % 8) > 0)
+      pExpected[(dwNumBytes - 1)] = BYTE(pExpected[(dwNumBytes - 1)] ^ (0xFF << (dwNumBits % 8)));
+
+    if (dwNumBits > 0)
+    {
+      dwNumFlippedBits = GetRandomNumber(4);
+
+      for (dwFlippedBitIndex = 0; (dwFlippedBitIndex < dwNumFlippedBits); dwFlippedBitIndex++)
+      {
+        dwBitOffset = GetRandomNumber(dwNumBits);
+
+        SetBit(pExpected, dwBitOffset, BYTE(GetBit(pExpected, dwBitOffset) ^ 1));
+      }
+    }
+
+    if ((dwTestIndex % 2) == 0)
+    {
+      pMask = new BYTE[dwNumBytes];
+
+      // mostly set bits, so a flipped bit is sometimes masked off and sometimes not
+      for (dwByteIndex = 0; (dwByteIndex < dwNumBytes); dwByteIndex++)
+        pMask[dwByteIndex] = BYTE(GetRandomNumber(256) | GetRandomNumber(256) | GetRandomNumber(256));
+    }
+
+    dwExpectedMismatchBitOffset = ReferenceFindFirstMismatchBit(pData, pExpected, pMask, dwNumBits);
+    dwMismatchBitOffset = FTC_FindFirstMismatchBit(pData, pExpected, pMask, dwNumBits);
+
+    if (dwMismatchBitOffset != dwExpectedMismatchBitOffset)
+    {
+      printf("%s: compare of %u bits %s mask returned %u instead of %u\n", lpKernelsName, dwNumBits,
+             ((pMask != NULL) ? "with" : "without"), dwMismatchBitOffset, dwExpectedMismatchBitOffset);
+
+      dwNumFailures = (dwNumFailures + 1);
+    }
+
+    if (pMask != NULL)
+    {
+      delete [] pMask;
+
+      pMask = NULL;
+    }
+
+    delete [] pExpected;
+    delete [] pData;
+  }
+
+  return dwNumFailures;
+}
+
+int main(void)
+{
+  static const DWORD BitKernels[] = {FTC_BIT_KERNELS_SCALAR, FTC_BIT_KERNELS_SSE2, FTC_BIT_KERNELS_AVX2, FTC_BIT_KERNELS_AUTO};
+  static const LPCSTR BitKernelsNames[] = {"scalar", "sse2", "avx2", "auto"};
+  DWORD dwNumFailures = 0;
+  DWORD dwKernelsIndex = 0;
+
+  for (dwKernelsIndex = 0; (dwKernelsIndex < (sizeof(BitKernels) / sizeof(BitKernels[0]))); dwKernelsIndex++)
+  {
+    if (FTC_SelectBitKernels(BitKernels[dwKernelsIndex]))
+    {
+      dwNumFailures = (dwNumFailures + TestCopyBits(BitKernelsNames[dwKernelsIndex]));
+      dwNumFailures = (dwNumFailures + TestFindFirstMismatchBit(BitKernelsNames[dwKernelsIndex]));
+
+      printf("%s kernels tested\n", BitKernelsNames[dwKernelsIndex]);
+    }
+    else
+      printf("%s kernels not supported, skipped\n", BitKernelsNames[dwKernelsIndex]);
+  }
+
+  return ((dwNumFailures == 0) ? 0 : 1);
+}
@@ -0,0 +1,1373 @@
+/*++
+
+Module Name:
+
+    FtcEmulatorLoopbackTest.cpp
+
+Abstract:
+
+    Loopback regression test run against the MPSSE emulator transport, which wires TDO to TDI, so every bit read
+    back from a scan is the bit written. Data register writes are run between every pair of TAP controller states,
+    then scans of many lengths with every wait policy and with small and automatic USB transfer chunk sizes, then
+    clock pulses, idle cycles after scans and sequence commands, streaming scans, scan templates, command sequences,
+    streamed command sequences, command sequences with and without the optimizer, asynchronous command sequences
+    with the next sequence built while one is executing, compare scans and recorded command sequences replayed with
+    the device they were built for, another hi-speed device and a FT2232D dual device.
+
+Environment:
+
+    user mode
+
+--*/
+
+#include <stdio.h>
+#include <string.h>
+#ifndef _WIN32
+#include <poll.h>
+#endif
+
+#include "ftcjtag.h"
+
+#define TEST_SPIN_PERIOD 100  // 100 microseconds
+#define NUM_TEST_SEQUENCE_COMMANDS 200
+#define TEST_SEQUENCE_COMMAND_NUM_BYTES 8
+#define TEST_STREAM_SCAN_BLOCK_NUM_BYTES 65536
+#define NUM_TEST_STREAMING_SEQUENCE_COMMANDS 48
+#define TEST_STREAMING_SEQUENCE_COMMAND_NUM_BYTES 4096
+
+typedef struct Stream_Scan_Test_Data{
+  ULONGLONG ulNumScanBits;                          // number of bits scanned
+  ULONGLONG ulNumSourceBytes;                       // number of bytes fetched from the data source so far
+  ULONGLONG ulNumSinkBytes;                         // number of bytes passed to the data sink so far
+  DWORD dwNumSourceCalls;                           // number of times the data source has been called
+  DWORD dwFailingSourceCall;                        // data source call that fails, 0 if none does
+  DWORD dwNumMismatchedBytes;                       // number of bytes passed to the data sink that were not written
+}STREAM_SCAN_TEST_DATA, *PSTREAM_SCAN_TEST_DATA;
+
+typedef struct Streaming_Sequence_Test_Data{
+  PWriteDataByteBuffer pWriteDataBuffer;            // data written by every write read command of the sequence
+  BOOL bReadCommands;                               // a read command follows every write read command
+  DWORD dwNumSinkBytes;                             // number of bytes passed to the data sink so far
+  DWORD dwNumSinkCalls;                             // number of times the data sink has been called
+  DWORD dwFailingSinkCall;                          // data sink call that fails, 0 if none does
+  DWORD dwNumMismatchedBytes;                       // number of bytes passed to the data sink that were not written
+}STREAMING_SEQUENCE_TEST_DATA, *PSTREAMING_SEQUENCE_TEST_DATA;
+
+static DWORD CheckStatus(FTC_STATUS Status, LPCSTR lpOperation)
+{
+  char szErrorMessage[256] = "";
+  DWORD dwNumFailures = 0;
+
+  if (Status != FTC_SUCCESS)
+  {
+    JTAG_GetErrorCodeString((LPSTR)"EN", Status, szErrorMessage, sizeof(szErrorMessage));
+
+    printf("%s failed, status %u: %s\n", lpOperation, Status, szErrorMessage);
+
+    dwNumFailures = 1;
+  }
+
+  return dwNumFailures;
+}
+
+static DWORD CompareBits(const BYTE *pWriteData, const BYTE *pReadData, DWORD dwNumBits, LPCSTR lpOperation)
+{
+  DWORD dwNumFailures = 0;
+  DWORD dwBitIndex = 0;
+
+  for (dwBitIndex = 0; ((dwBitIndex < dwNumBits) && (dwNumFailures == 0)); dwBitIndex++)
+  {
+    if (((pWriteData[(dwBitIndex / 8)] ^ pReadData[(dwBitIndex / 8)]) & (1 << (dwBitIndex % 8))) != 0)
+    {
+      printf("%s of %u bits read back bit %u wrong\n", lpOperation, dwNumBits, dwBitIndex);
+
+      dwNumFailures = 1;
+    }
+  }
+
+  return dwNumFailures;
+}
+
+static DWORD GetEmulatorState(FTC_HANDLE ftHandle, PFTC_EMULATOR_STATE pEmulatorState)
+{
+  memset(pEmulatorState, 0, sizeof(FTC_EMULATOR_STATE));
+
+  return CheckStatus(JTAG_GetEmulatorState(ftHandle, pEmulatorState), "get emulator state");
+}
+
+static DWORD CheckInstructionRegister(FTC_HANDLE ftHandle, const BYTE *pInstructionBytes, DWORD dwNumInstructionBits, LPCSTR lpOperation)
+{
+  FTC_EMULATOR_STATE EmulatorState;
+  DWORD dwNumFailures = GetEmulatorState(ftHandle, &EmulatorState);
+
+  if (EmulatorState.dwNumInstructionRegisterBits != dwNumInstructionBits)
+  {
+    printf("%s left %u bits in the instruction register instead of %u\n", lpOperation, EmulatorState.dwNumInstructionRegisterBits,
+           dwNumInstructionBits);
+
+    dwNumFailures = (dwNumFailures + 1);
+  }
+  else
+    dwNumFailures = (dwNumFailures + CompareBits(pInstructionBytes, EmulatorState.InstructionRegisterBytes, dwNumInstructionBits, lpOperation));
+
+  return dwNumFailures;
+}
+
+static DWORD TestDeviceHandles(void)
+{
+  DWORD dwNumFailures = 0;
+  FTC_HANDLE ftHandle1 = 0;
+  FTC_HANDLE ftHandle2 = 0;
+
+  dwNumFailures = (dwNumFailures + CheckStatus(JTAG_OpenTransportDevice(FTC_TRANSPORT_MPSSE_EMULATOR, 0, &ftHandle1), "open"));
+  dwNumFailures = (dwNumFailures + CheckStatus(JTAG_OpenTransportDevice(FTC_TRANSPORT_MPSSE_EMULATOR, 0, &ftHandle2), "open"));
+
+  // zero is the single device handle, so an opened device must never be given it
+  if ((ftHandle1 == 0) || (ftHandle2 == 0) || (ftHandle1 == ftHandle2))
+  {
+    printf("emulator devices opened with handles %u and %u\n", ftHandle1, ftHandle2);
+
+    dwNumFailures = (dwNumFailures + 1);
+  }
+
+  dwNumFailures = (dwNumFailures + CheckStatus(JTAG_Close(ftHandle1), "close"));
+  dwNumFailures = (dwNumFailures + CheckStatus(JTAG_Close(ftHandle2), "close"));
+
+  return dwNumFailures;
+}
+
+// The emulator follows the TAP controller through the commands sent to it, so a write to the instruction register
+// must leave the emulated instruction register holding the bits written
+static DWORD TestEmulatorTapController(FTC_HANDLE ftHandle)
+{
+  static const BYTE InstructionBytes[] = {0xA5, 0x03};
+  WriteDataByteBuffer WriteDataBuffer;
+  FTC_EMULATOR_STATE EmulatorState;
+  DWORD dwNumFailures = 0;
+
+  memcpy(WriteDataBuffer, InstructionBytes, sizeof(InstructionBytes));
+
+  dwNumFailures = (dwNumFailures + CheckStatus(JTAG_Write(ftHandle, TRUE, 10, &WriteDataBuffer, sizeof(InstructionBytes), RUN_TEST_IDLE_STATE),
+                                               "write instruction register"));
+  dwNumFailures = (dwNumFailures + CheckInstructionRegister(ftHandle, InstructionBytes, 10, "write instruction register"));
+  dwNumFailures = (dwNumFailures + GetEmulatorState(ftHandle, &EmulatorState));
+
+  if (EmulatorState.dwTapControllerState != RUN_TEST_IDLE_STATE)
+  {
+    printf("write instruction register left the emulator in state %u\n", EmulatorState.dwTapControllerState);
+
+    dwNumFailures = (dwNumFailures + 1);
+  }
+
+  return dwNumFailures;
+}
+
+// Works out the fewest TCK clocks that move the TAP controller from one state to another, from the IEEE 1149.1 state
+// diagram rather than the library tables
+static DWORD GetNumTapControllerStateClocks(DWORD dwStartState, DWORD dwEndState)
+{
+  static const DWORD NextTapControllerState[UPDATE_INSTRUCTION_REGISTER_STATE][2] = {
+    /* test logic reset */  {RUN_TEST_IDLE_STATE,                 TEST_LOGIC_STATE},
+    /* run test idle */     {RUN_TEST_IDLE_STATE,                 SELECT_TEST_DATA_REGISTER_SCAN_STATE},
+    /* pause dr */          {PAUSE_TEST_DATA_REGISTER_STATE,      EXIT2_TEST_DATA_REGISTER_STATE},
+    /* pause ir */          {PAUSE_INSTRUCTION_REGISTER_STATE,    EXIT2_INSTRUCTION_REGISTER_STATE},
+    /* shift dr */          {SHIFT_TEST_DATA_REGISTER_STATE,      EXIT1_TEST_DATA_REGISTER_STATE},
+    /* shift ir */          {SHIFT_INSTRUCTION_REGISTER_STATE,    EXIT1_INSTRUCTION_REGISTER_STATE},
+    /* select dr scan */    {CAPTURE_TEST_DATA_REGISTER_STATE,    SELECT_INSTRUCTION_REGISTER_SCAN_STATE},
+    /* capture dr */        {SHIFT_TEST_DATA_REGISTER_STATE,      EXIT1_TEST_DATA_REGISTER_STATE},
+    /* exit1 dr */          {PAUSE_TEST_DATA_REGISTER_STATE,      UPDATE_TEST_DATA_REGISTER_STATE},
+    /* exit2 dr */          {SHIFT_TEST_DATA_REGISTER_STATE,      UPDATE_TEST_DATA_REGISTER_STATE},
+    /* update dr */         {RUN_TEST_IDLE_STATE,                 SELECT_TEST_DATA_REGISTER_SCAN_STATE},
+    /* select ir scan */    {CAPTURE_INSTRUCTION_REGISTER_STATE,  TEST_LOGIC_STATE},
+    /* capture ir */        {SHIFT_INSTRUCTION_REGISTER_STATE,    EXIT1_INSTRUCTION_REGISTER_STATE},
+    /* exit1 ir */          {PAUSE_INSTRUCTION_REGISTER_STATE,    UPDATE_INSTRUCTION_REGISTER_STATE},
+    /* exit2 ir */          {SHIFT_INSTRUCTION_REGISTER_STATE,    UPDATE_INSTRUCTION_REGISTER_STATE},
+    /* update ir */         {RUN_TEST_IDLE_STATE,                 SELECT_TEST_DATA_REGISTER_SCAN_STATE}};
+  DWORD NumStateClocks[UPDATE_INSTRUCTION_REGISTER_STATE];
+  DWORD dwNumClocks = 0;
+  DWORD dwStateIndex = 0;
+  DWORD dwNextState = 0;
+  BOOL bStateReached = FALSE;
+
+  for (dwStateIndex = 0; (dwStateIndex < UPDATE_INSTRUCTION_REGISTER_STATE); dwStateIndex++)
+    NumStateClocks[dwStateIndex] = UPDATE_INSTRUCTION_REGISTER_STATE;
+
+  NumStateClocks[(dwStartState - 1)] = 0;
+
+  // every state reached in one more clock is marked until nothing new is reached, every state is reached within 16
+  do
+  {
+    bStateReached = FALSE;
+
+    for (dwStateIndex = 0; (dwStateIndex < UPDATE_INSTRUCTION_REGISTER_STATE); dwStateIndex++)
+    {
+      if (NumStateClocks[dwStateIndex] == dwNumClocks)
+      {
+        for (dwNextState = 0; (dwNextState < 2); dwNextState++)
+        {
+          if (NumStateClocks[(NextTapControllerState[dwStateIndex][dwNextState] - 1)] > (dwNumClocks + 1))
+          {
+            NumStateClocks[(NextTapControllerState[dwStateIndex][dwNextState] - 1)] = (dwNumClocks + 1);
+
+            bStateReached = TRUE;
+          }
+        }
+      }
+    }
+
+    dwNumClocks = (dwNumClocks + 1);
+  }
+  while (bStateReached);
+
+  return NumStateClocks[(dwEndState - 1)];
+}
+
+// A data register write from every one of the 16 TAP controller states to every other must end in the end state,
+// moving there and back to the shift data register state along the shortest paths
+static DWORD TestTapControllerStates(FTC_HANDLE ftHandle, PWriteDataByteBuffer pWriteDataBuffer)
+{
+  FTC_EMULATOR_STATE StartEmulatorState;
+  FTC_EMULATOR_STATE EndEmulatorState;
+  DWORD dwNumFailures = 0;
+  DWORD dwStartState = 0;
+  DWORD dwEndState = 0;
+  DWORD dwNumTmsClocks = 0;
+  DWORD dwNumExpectedTmsClocks = 0;
+
+  for (dwStartState = TEST_LOGIC_STATE; (dwStartState <= UPDATE_INSTRUCTION_REGISTER_STATE); dwStartState++)
+  {
+    for (dwEndState = TEST_LOGIC_STATE; (dwEndState <= UPDATE_INSTRUCTION_REGISTER_STATE); dwEndState++)
+    {
+      dwNumFailures = (dwNumFailures + CheckStatus(JTAG_Write(ftHandle, FALSE, 8, pWriteDataBuffer, 1, dwStartState), "write DR"));
+      dwNumFailures = (dwNumFailures + GetEmulatorState(ftHandle, &StartEmulatorState));
+      dwNumFailures = (dwNumFailures + CheckStatus(JTAG_Write(ftHandle, FALSE, 8, pWriteDataBuffer, 1, dwEndState), "write DR"));
+      dwNumFailures = (dwNumFailures + GetEmulatorState(ftHandle, &EndEmulatorState));
+
+      dwNumTmsClocks = (EndEmulatorState.dwNumTmsClocks - StartEmulatorState.dwNumTmsClocks);
+      dwNumExpectedTmsClocks = (GetNumTapControllerStateClocks(dwStartState, SHIFT_TEST_DATA_REGISTER_STATE) +
+                                GetNumTapControllerStateClocks(SHIFT_TEST_DATA_REGISTER_STATE, dwEndState));
+
+      if ((StartEmulatorState.dwTapControllerState != dwStartState) || (EndEmulatorState.dwTapControllerState != dwEndState) ||
+          (dwNumTmsClocks != dwNumExpectedTmsClocks))
+      {
+        printf("write DR from state %u to state %u ended in state %u after %u TMS clocks instead of %u\n",
+               StartEmulatorState.dwTapControllerState, dwEndState, EndEmulatorState.dwTapControllerState, dwNumTmsClocks,
+               dwNumExpectedTmsClocks);
+
+        dwNumFailures = (dwNumFailures + 1);
+      }
+    }
+  }
+
+  return dwNumFailures;
+}
+
+// Writes the instruction register and checks the write was skipped or not, the emulated instruction register holds
+// the expected bits and the emulator ended in the end state. The number of TMS clocks the write took is returned.
+static DWORD CheckInstructionRegisterWrite(FTC_HANDLE ftHandle, const BYTE *pInstructionBytes, DWORD dwTapControllerState,
+                                           BOOL bScanSkipped, const BYTE *pExpectedInstructionBytes, LPDWORD lpdwNumTmsClocks,
+                                           LPCSTR lpOperation)
+{
+  WriteDataByteBuffer WriteDataBuffer;
+  FTC_EMULATOR_STATE StartEmulatorState;
+  FTC_EMULATOR_STATE EndEmulatorState;
+  BOOL bCacheEnabled = FALSE;
+  DWORD dwStartNumScansSkipped = 0;
+  DWORD dwEndNumScansSkipped = 0;
+  DWORD dwNumFailures = 0;
+
+  memcpy(WriteDataBuffer, pInstructionBytes, 2);
+
+  dwNumFailures = (dwNumFailures + GetEmulatorState(ftHandle, &StartEmulatorState));
+  dwNumFailures = (dwNumFailures + CheckStatus(JTAG_GetDeviceIRCache(ftHandle, &bCacheEnabled, &dwStartNumScansSkipped), "get IR cache"));
+  dwNumFailures = (dwNumFailures + CheckStatus(JTAG_Write(ftHandle, TRUE, 10, &WriteDataBuffer, 2, dwTapControllerState), lpOperation));
+  dwNumFailures = (dwNumFailures + CheckStatus(JTAG_GetDeviceIRCache(ftHandle, &bCacheEnabled, &dwEndNumScansSkipped), "get IR cache"));
+  dwNumFailures = (dwNumFailures + GetEmulatorState(ftHandle, &EndEmulatorState));
+
+  if ((dwEndNumScansSkipped - dwStartNumScansSkipped) != (bScanSkipped ? 1 : 0))
+  {
+    printf("%s was %sskipped\n", lpOperation, (bScanSkipped ? "not " : ""));
+
+    dwNumFailures = (dwNumFailures + 1);
+  }
+
+  if (EndEmulatorState.dwTapControllerState != dwTapControllerState)
+  {
+    printf("%s left the emulator in state %u instead of %u\n", lpOperation, EndEmulatorState.dwTapControllerState, dwTapControllerState);
+
+    dwNumFailures = (dwNumFailures + 1);
+  }
+
+  dwNumFailures = (dwNumFailures + CheckInstructionRegister(ftHandle, pExpectedInstructionBytes, 10, lpOperation));
+
+  *lpdwNumTmsClocks = (EndEmulatorState.dwNumTmsClocks - StartEmulatorState.dwNumTmsClocks);
+
+  return dwNumFailures;
+}
+
+// A write to the instruction register that does not end through the update IR state leaves the instruction register
+// as it was, so it must neither be cached nor be skipped
+static DWORD TestInstructionRegisterCache(FTC_HANDLE ftHandle)
+{
+  static const BYTE InstructionBytes1[] = {0x5A, 0x01};
+  static const BYTE InstructionBytes2[] = {0xC3, 0x02};
+  WriteDataByteBuffer WriteDataBuffer;
+  DWORD dwNumTmsClocks = 0;
+  DWORD dwNumFailures = 0;
+
+  dwNumFailures = (dwNumFailures + CheckStatus(JTAG_SetDeviceIRCache(ftHandle, TRUE), "enable IR cache"));
+
+  dwNumFailures = (dwNumFailures + CheckInstructionRegisterWrite(ftHandle, InstructionBytes1, RUN_TEST_IDLE_STATE, FALSE,
+                                                                 InstructionBytes1, &dwNumTmsClocks, "write IR"));
+  dwNumFailures = (dwNumFailures + CheckInstructionRegisterWrite(ftHandle, InstructionBytes1, RUN_TEST_IDLE_STATE, TRUE,
+                                                                 InstructionBytes1, &dwNumTmsClocks, "write cached IR"));
+
+  if (dwNumTmsClocks != 0)
+  {
+    printf("write cached IR to the state it started in clocked TMS %u times\n", dwNumTmsClocks);
+
+    dwNumFailures = (dwNumFailures + 1);
+  }
+
+  // the shifted bits are not latched in the pause IR state, they are latched by the move to run test idle before the
+  // clock is pulsed
+  dwNumFailures = (dwNumFailures + CheckInstructionRegisterWrite(ftHandle, InstructionBytes2, PAUSE_INSTRUCTION_REGISTER_STATE, FALSE,
+                                                                 InstructionBytes1, &dwNumTmsClocks, "write IR to pause IR"));
+  dwNumFailures = (dwNumFailures + CheckStatus(JTAG_GenerateClockPulses(ftHandle, 1), "pulse clock after pause IR"));
+  dwNumFailures = (dwNumFailures + CheckInstructionRegisterWrite(ftHandle, InstructionBytes2, RUN_TEST_IDLE_STATE, FALSE,
+                                                                 InstructionBytes2, &dwNumTmsClocks, "write IR after pause IR"));
+  dwNumFailures = (dwNumFailures + CheckInstructionRegisterWrite(ftHandle, InstructionBytes2, PAUSE_INSTRUCTION_REGISTER_STATE, FALSE,
+                                                                 InstructionBytes2, &dwNumTmsClocks, "write cached IR to pause IR"));
+  dwNumFailures = (dwNumFailures + CheckStatus(JTAG_GenerateClockPulses(ftHandle, 1), "pulse clock after cached IR to pause IR"));
+  dwNumFailures = (dwNumFailures + CheckInstructionRegisterWrite(ftHandle, InstructionBytes2, RUN_TEST_IDLE_STATE, FALSE,
+                                                                 InstructionBytes2, &dwNumTmsClocks, "write IR after cached IR to pause IR"));
+
+  // a hit only clocks the path from run test idle to pause DR, select DR, capture DR, exit1 DR and pause DR
+  dwNumFailures = (dwNumFailures + CheckInstructionRegisterWrite(ftHandle, InstructionBytes2, PAUSE_TEST_DATA_REGISTER_STATE, TRUE,
+                                                                 InstructionBytes2, &dwNumTmsClocks, "write cached IR to pause DR"));
+
+  if (dwNumTmsClocks != 4)
+  {
+    printf("write cached IR to pause DR clocked TMS %u times instead of 4\n", dwNumTmsClocks);
+
+    dwNumFailures = (dwNumFailures + 1);
+  }
+
+  // the instruction register is reset by a data register scan that ends in the test logic reset state
+  memset(WriteDataBuffer, 0, 2);
+
+  dwNumFailures = (dwNumFailures + CheckStatus(JTAG_Write(ftHandle, FALSE, 16, &WriteDataBuffer, 2, TEST_LOGIC_STATE), "write DR to reset"));
+  dwNumFailures = (dwNumFailures + CheckInstructionRegisterWrite(ftHandle, InstructionBytes2, RUN_TEST_IDLE_STATE, FALSE,
+                                                                 InstructionBytes2, &dwNumTmsClocks, "write IR after reset"));
+
+  return dwNumFailures;
+}
+
+static DWORD TestScans(FTC_HANDLE ftHandle, PWriteDataByteBuffer pWriteDataBuffer, PReadDataByteBuffer pReadDataBuffer)
+{
+  static const DWORD NumScanBits[] = {2, 3, 7, 8, 9, 15, 16, 17, 63, 64, 65, 511, 4095, 4096, 4097, 32767, 32768, 32769,
+                                      40001, 131072, 524279};
+  static const DWORD WaitPolicies[] = {FTC_WAIT_POLICY_SPIN, FTC_WAIT_POLICY_BLOCK, FTC_WAIT_POLICY_HYBRID};
+  static const DWORD USBTransferChunkSizes[] = {MIN_USB_TRANSFER_CHUNK_SIZE, 4096, FTC_USB_TRANSFER_CHUNK_SIZE_AUTO};
+  DWORD dwNumFailures = 0;
+  DWORD dwPolicyIndex = 0;
+  DWORD dwChunkSizeIndex = 0;
+  DWORD dwScanIndex = 0;
+  DWORD dwNumBytesReturned = 0;
+
+  for (dwPolicyIndex = 0; (dwPolicyIndex < (sizeof(WaitPolicies) / sizeof(WaitPolicies[0]))); dwPolicyIndex++)
+  {
+    dwNumFailures = (dwNumFailures + CheckStatus(JTAG_SetDeviceWaitPolicy(ftHandle, WaitPolicies[dwPolicyIndex], TEST_SPIN_PERIOD),
+                                                 "set wait policy"));
+
+    for (dwChunkSizeIndex = 0; (dwChunkSizeIndex < (sizeof(USBTransferChunkSizes) / sizeof(USBTransferChunkSizes[0]))); dwChunkSizeIndex++)
+    {
+      dwNumFailures = (dwNumFailures + CheckStatus(JTAG_SetDeviceUSBTransferChunkSize(ftHandle, USBTransferChunkSizes[dwChunkSizeIndex]),
+                                                   "set chunk size"));
+
+      for (dwScanIndex = 0; (dwScanIndex < (sizeof(NumScanBits) / sizeof(NumScanBits[0]))); dwScanIndex++)
+      {
+        memset(pReadDataBuffer, 0, sizeof(ReadDataByteBuffer));
+
+        dwNumFailures = (dwNumFailures + CheckStatus(JTAG_WriteRead(ftHandle, FALSE, NumScanBits[dwScanIndex], pWriteDataBuffer,
+                                                                    ((NumScanBits[dwScanIndex] + 7) / 8), pReadDataBuffer,
+                                                                    &dwNumBytesReturned, RUN_TEST_IDLE_STATE),
+                                                     "write read"));
+
+        dwNumFailures = (dwNumFailures + CompareBits(*pWriteDataBuffer, *pReadDataBuffer, NumScanBits[dwScanIndex], "write read"));
+      }
+    }
+  }
+
+  return dwNumFailures;
+}
+
+// A hi-speed device pulses the clock with clock only commands, one clock for times eight clocks command for every
+// 65536 bytes worth of clocks and one clock for bits command for the rest, so no data byte is sent for the clocks
+static DWORD TestClockPulses(FTC_HANDLE ftHandle, PWriteDataByteBuffer pWriteDataBuffer)
+{
+  static const DWORD NumClockPulses[] = {1, 7, 8, 9, 15, 16, 524288, 524289, 524295, 524296, 1048583, 2000000000};
+  FTC_EMULATOR_STATE StartEmulatorState;
+  FTC_EMULATOR_STATE EndEmulatorState;
+  DWORD dwNumFailures = 0;
+  DWORD dwPulsesIndex = 0;
+  DWORD dwNumClockPulses = 0;
+  DWORD dwNumExpectedCommands = 0;
+  DWORD dwNumCommands = 0;
+  DWORD dwNumClocks = 0;
+
+  for (dwPulsesIndex = 0; (dwPulsesIndex < (sizeof(NumClockPulses) / sizeof(NumClockPulses[0]))); dwPulsesIndex++)
+  {
+    dwNumClockPulses = NumClockPulses[dwPulsesIndex];
+    dwNumExpectedCommands = ((((dwNumClockPulses / 8) + 65535) / 65536) + (((dwNumClockPulses % 8) > 0) ? 1 : 0));
+
+    // the clock is pulsed in the run test idle state, so no TMS command is needed to get there
+    dwNumFailures = (dwNumFailures + CheckStatus(JTAG_Write(ftHandle, FALSE, 8, pWriteDataBuffer, 1, RUN_TEST_IDLE_STATE),
+                                                 "write DR to run test idle"));
+    dwNumFailures = (dwNumFailures + GetEmulatorState(ftHandle, &StartEmulatorState));
+    dwNumFailures = (dwNumFailures + CheckStatus(JTAG_GenerateClockPulses(ftHandle, dwNumClockPulses), "generate clock pulses"));
+    dwNumFailures = (dwNumFailures + GetEmulatorState(ftHandle, &EndEmulatorState));
+
+    dwNumCommands = (EndEmulatorState.dwNumClockOnlyCommands - StartEmulatorState.dwNumClockOnlyCommands);
+    dwNumClocks = (EndEmulatorState.dwNumTckClocks - StartEmulatorState.dwNumTckClocks);
+
+    if ((dwNumCommands != dwNumExpectedCommands) || ((EndEmulatorState.dwNumCommands - StartEmulatorState.dwNumCommands) != dwNumCommands))
+    {
+      printf("%u clock pulses sent %u commands, %u clock only, instead of %u clock only commands\n", dwNumClockPulses,
+             (EndEmulatorState.dwNumCommands - StartEmulatorState.dwNumCommands), dwNumCommands, dwNumExpectedCommands);
+
+      dwNumFailures = (dwNumFailures + 1);
+    }
+
+    if ((dwNumClocks != dwNumClockPulses) || (EndEmulatorState.dwTapControllerState != RUN_TEST_IDLE_STATE))
+    {
+      printf("%u clock pulses sent %u clocks and left the TAP controller in state %u\n", dwNumClockPulses, dwNumClocks,
+             EndEmulatorState.dwTapControllerState);
+
+      dwNumFailures = (dwNumFailures + 1);
+    }
+  }
+
+  return dwNumFailures;
+}
+
+// Runs a 13 bit data register write, read or write/read from run test idle back to run test idle followed by idle
+// cycles, and returns the number of TCK clocks and commands the emulator saw
+static DWORD RunIdleCyclesScan(FTC_HANDLE ftHandle, DWORD dwScanType, PWriteDataByteBuffer pWriteDataBuffer,
+                               PReadDataByteBuffer pReadDataBuffer, DWORD dwNumIdleCycles, LPDWORD lpdwNumTckClocks,
+                               LPDWORD lpdwNumCommands)
+{
+  FTC_EMULATOR_STATE StartEmulatorState;
+  FTC_EMULATOR_STATE EndEmulatorState;
+  DWORD dwNumFailures = 0;
+  DWORD dwNumBytesReturned = 0;
+
+  memset(pReadDataBuffer, 0, 2);
+
+  dwNumFailures = (dwNumFailures + GetEmulatorState(ftHandle, &StartEmulatorState));
+
+  switch (dwScanType)
+  {
+    case SCAN_TEMPLATE_WRITE:
+      dwNumFailures = (dwNumFailures + CheckStatus(JTAG_WriteEx(ftHandle, FALSE, 13, pWriteDataBuffer, 2, RUN_TEST_IDLE_STATE,
+                                                                dwNumIdleCycles), "write with idle cycles"));
+    break;
+    case SCAN_TEMPLATE_READ:
+      dwNumFailures = (dwNumFailures + CheckStatus(JTAG_ReadEx(ftHandle, FALSE, 13, pReadDataBuffer, &dwNumBytesReturned,
+                                                               RUN_TEST_IDLE_STATE, dwNumIdleCycles), "read with idle cycles"));
+    break;
+    default:
+      dwNumFailures = (dwNumFailures + CheckStatus(JTAG_WriteReadEx(ftHandle, FALSE, 13, pWriteDataBuffer, 2, pReadDataBuffer,
+                                                                    &dwNumBytesReturned, RUN_TEST_IDLE_STATE, dwNumIdleCycles),
+                                                   "write read with idle cycles"));
+      dwNumFailures = (dwNumFailures + CompareBits(*pWriteDataBuffer, *pReadDataBuffer, 13, "write read with idle cycles"));
+    break;
+  }
+
+  dwNumFailures = (dwNumFailures + GetEmulatorState(ftHandle, &EndEmulatorState));
+
+  if (EndEmulatorState.dwTapControllerState != RUN_TEST_IDLE_STATE)
+  {
+    printf("scan with %u idle cycles left the emulator in state %u\n", dwNumIdleCycles, EndEmulatorState.dwTapControllerState);
+
+    dwNumFailures = (dwNumFailures + 1);
+  }
+
+  *lpdwNumTckClocks = (EndEmulatorState.dwNumTckClocks - StartEmulatorState.dwNumTckClocks);
+  *lpdwNumCommands = (EndEmulatorState.dwNumCommands - StartEmulatorState.dwNumCommands);
+
+  return dwNumFailures;
+}
+
+// Idle cycles after a scan must clock the TAP controller exactly that many more times. The first four fit in the 3
+// clock TMS command that ends the scan, so add no command, the rest are clocked by clock only commands.
+static DWORD TestIdleCycles(FTC_HANDLE ftHandle, PWriteDataByteBuffer pWriteDataBuffer, PReadDataByteBuffer pReadDataBuffer,
+                            PReadCmdSequenceDataByteBuffer pReadCmdSequenceDataBuffer)
+{
+  FTC_EMULATOR_STATE StartEmulatorState;
+  FTC_EMULATOR_STATE EndEmulatorState;
+  static const DWORD NumIdleCycles[] = {1, 3, 4, 5, 11, 12, 13, 65536};
+  static const DWORD ScanTypes[] = {SCAN_TEMPLATE_WRITE, SCAN_TEMPLATE_READ, SCAN_TEMPLATE_WRITE_READ};
+  DWORD dwNumFailures = 0;
+  DWORD dwTypeIndex = 0;
+  DWORD dwIdleIndex = 0;
+  DWORD dwNumClockedIdleCycles = 0;
+  DWORD dwNumExpectedCommands = 0;
+  DWORD dwNumScanTckClocks = 0;
+  DWORD dwNumScanCommands = 0;
+  DWORD dwNumTckClocks = 0;
+  DWORD dwNumCommands = 0;
+  DWORD dwNumBytesReturned = 0;
+
+  dwNumFailures = (dwNumFailures + CheckStatus(JTAG_Write(ftHandle, FALSE, 8, pWriteDataBuffer, 1, RUN_TEST_IDLE_STATE),
+                                               "write DR to run test idle"));
+
+  for (dwTypeIndex = 0; (dwTypeIndex < (sizeof(ScanTypes) / sizeof(ScanTypes[0]))); dwTypeIndex++)
+  {
+    dwNumFailures = (dwNumFailures + RunIdleCyclesScan(ftHandle, ScanTypes[dwTypeIndex], pWriteDataBuffer, pReadDataBuffer, 0,
+                                                       &dwNumScanTckClocks, &dwNumScanCommands));
+
+    for (dwIdleIndex = 0; (dwIdleIndex < (sizeof(NumIdleCycles) / sizeof(NumIdleCycles[0]))); dwIdleIndex++)
+    {
+      dwNumFailures = (dwNumFailures + RunIdleCyclesScan(ftHandle, ScanTypes[dwTypeIndex], pWriteDataBuffer, pReadDataBuffer,
+                                                         NumIdleCycles[dwIdleIndex], &dwNumTckClocks, &dwNumCommands));
+
+      dwNumClockedIdleCycles = ((NumIdleCycles[dwIdleIndex] > 4) ? (NumIdleCycles[dwIdleIndex] - 4) : 0);
+      dwNumExpectedCommands = (dwNumScanCommands + (((dwNumClockedIdleCycles / 8) + 65535) / 65536) +
+                               (((dwNumClockedIdleCycles % 8) > 0) ? 1 : 0));
+
+      if ((dwNumTckClocks != (dwNumScanTckClocks + NumIdleCycles[dwIdleIndex])) || (dwNumCommands != dwNumExpectedCommands))
+      {
+        printf("scan type %u with %u idle cycles sent %u clocks in %u commands instead of %u clocks in %u commands\n",
+               ScanTypes[dwTypeIndex], NumIdleCycles[dwIdleIndex], dwNumTckClocks, dwNumCommands,
+               (dwNumScanTckClocks + NumIdleCycles[dwIdleIndex]), dwNumExpectedCommands);
+
+        dwNumFailures = (dwNumFailures + 1);
+      }
+    }
+  }
+
+  // the read data of a sequence command followed by idle cycles must not be shifted by the idle cycles folded into
+  // the TMS command that reads its last bit, the command after it must not be clocked by them
+  dwNumFailures = (dwNumFailures + GetEmulatorState(ftHandle, &StartEmulatorState));
+  dwNumFailures = (dwNumFailures + CheckStatus(JTAG_ClearDeviceCmdSequence(ftHandle), "clear sequence"));
+  dwNumFailures = (dwNumFailures + CheckStatus(JTAG_AddDeviceWriteReadCmdEx(ftHandle, FALSE, 13, pWriteDataBuffer, 2,
+                                                                            RUN_TEST_IDLE_STATE, 3),
+                                               "add write read with idle cycles"));
+  dwNumFailures = (dwNumFailures + CheckStatus(JTAG_AddDeviceWriteReadCmdEx(ftHandle, FALSE, 13, pWriteDataBuffer, 2,
+                                                                            RUN_TEST_IDLE_STATE, 0),
+                                               "add write read"));
+  dwNumFailures = (dwNumFailures + CheckStatus(JTAG_ExecuteCmdSequence(ftHandle, pReadCmdSequenceDataBuffer, &dwNumBytesReturned),
+                                               "execute sequence with idle cycles"));
+  dwNumFailures = (dwNumFailures + GetEmulatorState(ftHandle, &EndEmulatorState));
+  dwNumFailures = (dwNumFailures + CompareBits(*pWriteDataBuffer, *pReadCmdSequenceDataBuffer, 13, "sequence write read with idle cycles"));
+  dwNumFailures = (dwNumFailures + CompareBits(*pWriteDataBuffer, &(*pReadCmdSequenceDataBuffer)[2], 13, "sequence write read"));
+
+  dwNumTckClocks = (EndEmulatorState.dwNumTckClocks - StartEmulatorState.dwNumTckClocks);
+
+  // the write read scan clocks were counted by the last scan of the loop above
+  if (dwNumTckClocks != ((dwNumScanTckClocks * 2) + 3))
+  {
+    printf("sequence with idle cycles sent %u clocks instead of %u\n", dwNumTckClocks, ((dwNumScanTckClocks * 2) + 3));
+
+    dwNumFailures = (dwNumFailures + 1);
+  }
+
+  if (JTAG_WriteEx(ftHandle, FALSE, 13, pWriteDataBuffer, 2, RUN_TEST_IDLE_STATE, 65537) != FTC_INVALID_NUMBER_IDLE_CYCLES)
+  {
+    printf("write with 65537 idle cycles was not refused\n");
+
+    dwNumFailures = (dwNumFailures + 1);
+  }
+
+  if (JTAG_WriteEx(ftHandle, FALSE, 13, pWriteDataBuffer, 2, PAUSE_TEST_DATA_REGISTER_STATE, 1) != FTC_INVALID_TAP_CONTROLLER_STATE)
+  {
+    printf("write with idle cycles ending in pause DR was not refused\n");
+
+    dwNumFailures = (dwNumFailures + 1);
+  }
+
+  return dwNumFailures;
+}
+
+static FTC_STATUS WINAPI ZeroScanDataSource(LPVOID /* pContext */, LPBYTE pDataBytes, DWORD dwNumBytes)
+{
+  memset(pDataBytes, 0, dwNumBytes);
+
+  return FTC_SUCCESS;
+}
+
+static BYTE GetStreamScanDataByte(ULONGLONG ulByteIndex)
+{
+  return BYTE((ulByteIndex * 37) + (ulByteIndex >> 8));
+}
+
+static FTC_STATUS WINAPI StreamScanDataSource(LPVOID pContext, LPBYTE pDataBytes, DWORD dwNumBytes)
+{
+  PSTREAM_SCAN_TEST_DATA pStreamScanData = (PSTREAM_SCAN_TEST_DATA)pContext;
+  FTC_STATUS Status = FTC_SUCCESS;
+  DWORD dwByteIndex = 0;
+
+  pStreamScanData->dwNumSourceCalls = (pStreamScanData->dwNumSourceCalls + 1);
+
+  if (pStreamScanData->dwNumSourceCalls == pStreamScanData->dwFailingSourceCall)
+    Status = FTC_INSUFFICIENT_RESOURCES;
+  else
+  {
+    for (dwByteIndex = 0; (dwByteIndex < dwNumBytes); dwByteIndex++)
+      pDataBytes[dwByteIndex] = GetStreamScanDataByte((pStreamScanData->ulNumSourceBytes + dwByteIndex));
+
+    pStreamScanData->ulNumSourceBytes = (pStreamScanData->ulNumSourceBytes + dwNumBytes);
+  }
+
+  return Status;
+}
+
+static FTC_STATUS WINAPI StreamScanDataSink(LPVOID pContext, LPBYTE pDataBytes, DWORD dwNumBytes)
+{
+  PSTREAM_SCAN_TEST_DATA pStreamScanData = (PSTREAM_SCAN_TEST_DATA)pContext;
+  ULONGLONG ulNumRemainingBits = 0;
+  DWORD dwByteIndex = 0;
+  BYTE BitMask = 0xFF;
+
+  for (dwByteIndex = 0; (dwByteIndex < dwNumBytes); dwByteIndex++)
+  {
+    // only the bits of the last byte that were scanned are compared
+    ulNumRemainingBits = (pStreamScanData->ulNumScanBits - ((pStreamScanData->ulNumSinkBytes + dwByteIndex) * 8));
+
+    if (ulNumRemainingBits < 8)
+      BitMask = BYTE((1 << ulNumRemainingBits) - 1);
+
+    if (((pDataBytes[dwByteIndex] ^ GetStreamScanDataByte((pStreamScanData->ulNumSinkBytes + dwByteIndex))) & BitMask) != 0)
+      pStreamScanData->dwNumMismatchedBytes = (pStreamScanData->dwNumMismatchedBytes + 1);
+  }
+
+  pStreamScanData->ulNumSinkBytes = (pStreamScanData->ulNumSinkBytes + dwNumBytes);
+
+  return FTC_SUCCESS;
+}
+
+// Streaming scans of several blocks must read back every bit written, and a scan stopped after its first block was
+// sent must not leave the library believing it knows where the TAP controller is
+static DWORD TestStreamScans(FTC_HANDLE ftHandle)
+{
+  static const ULONGLONG NumScanBits[] = {2, 9, 65536, ((TEST_STREAM_SCAN_BLOCK_NUM_BYTES * 8) + 1),
+                                          ((3 * TEST_STREAM_SCAN_BLOCK_NUM_BYTES * 8) + 13)};
+  static const BYTE InstructionBytes[] = {0x96, 0x02};
+  STREAM_SCAN_TEST_DATA StreamScanData;
+  DWORD dwScanIndex = 0;
+  DWORD dwNumTmsClocks = 0;
+  DWORD dwNumFailures = 0;
+  FTC_STATUS Status = FTC_SUCCESS;
+
+  for (dwScanIndex = 0; (dwScanIndex < (sizeof(NumScanBits) / sizeof(NumScanBits[0]))); dwScanIndex++)
+  {
+    memset(&StreamScanData, 0, sizeof(StreamScanData));
+    StreamScanData.ulNumScanBits = NumScanBits[dwScanIndex];
+
+    dwNumFailures = (dwNumFailures + CheckStatus(JTAG_StreamScan(ftHandle, FALSE, NumScanBits[dwScanIndex], StreamScanDataSource,
+                                                                 StreamScanDataSink, &StreamScanData, RUN_TEST_IDLE_STATE),
+                                                 "stream scan"));
+
+    if ((StreamScanData.ulNumSinkBytes != ((NumScanBits[dwScanIndex] + 7) / 8)) || (StreamScanData.dwNumMismatchedBytes != 0))
+    {
+      printf("stream scan of %u bits read back %u bytes, %u of them wrong\n", DWORD(NumScanBits[dwScanIndex]),
+             DWORD(StreamScanData.ulNumSinkBytes), StreamScanData.dwNumMismatchedBytes);
+
+      dwNumFailures = (dwNumFailures + 1);
+    }
+  }
+
+  // the second block is never fetched, so the TAP controller is left in the shift DR state with the first block sent
+  memset(&StreamScanData, 0, sizeof(StreamScanData));
+  StreamScanData.ulNumScanBits = ((2 * TEST_STREAM_SCAN_BLOCK_NUM_BYTES * 8) + 8);
+  StreamScanData.dwFailingSourceCall = 2;
+
+  Status = JTAG_StreamScan(ftHandle, FALSE, StreamScanData.ulNumScanBits, StreamScanDataSource, NULL, &StreamScanData,
+                           RUN_TEST_IDLE_STATE);
+
+  if (Status != FTC_INSUFFICIENT_RESOURCES)
+  {
+    printf("stream scan with a failing data source returned status %u\n", Status);
+
+    dwNumFailures = (dwNumFailures + 1);
+  }
+
+  // the next scan resets the TAP controller with 7 TMS clocks before the 5 to shift IR and the 3 to run test idle
+  dwNumFailures = (dwNumFailures + CheckInstructionRegisterWrite(ftHandle, InstructionBytes, RUN_TEST_IDLE_STATE, FALSE,
+                                                                 InstructionBytes, &dwNumTmsClocks, "write IR after stopped stream scan"));
+
+  if (dwNumTmsClocks != 15)
+  {
+    printf("write IR after stopped stream scan clocked TMS %u times instead of 15\n", dwNumTmsClocks);
+
+    dwNumFailures = (dwNumFailures + 1);
+  }
+
+  return dwNumFailures;
+}
+
+// A scan template is executed twice with different data from different TAP controller states, so the data patched
+// into the template commands and the move into the first scan are both tested. Each read scan returns its bits
+// starting on a byte boundary, after the bytes of the read scans before it.
+static DWORD TestScanTemplates(FTC_HANDLE ftHandle, PReadCmdSequenceDataByteBuffer pReadCmdSequenceDataBuffer)
+{
+  static FTC_SCAN_TEMPLATE_SCAN Scans[] = {{SCAN_TEMPLATE_WRITE, TRUE, 10, PAUSE_INSTRUCTION_REGISTER_STATE},
+                                           {SCAN_TEMPLATE_WRITE_READ, FALSE, 13, PAUSE_TEST_DATA_REGISTER_STATE},
+                                           {SCAN_TEMPLATE_READ, FALSE, 16, EXIT1_TEST_DATA_REGISTER_STATE},
+                                           {SCAN_TEMPLATE_WRITE_READ, FALSE, 67, RUN_TEST_IDLE_STATE}};
+  static const DWORD StartStates[] = {TEST_LOGIC_STATE, PAUSE_TEST_DATA_REGISTER_STATE};
+  static WriteDataByteBuffer WriteDataBuffers[(sizeof(Scans) / sizeof(Scans[0]))];
+  ScanTemplateWriteDataBuffers TemplateWriteDataBuffers;
+  FTC_EMULATOR_STATE EmulatorState;
+  DWORD dwNumFailures = 0;
+  DWORD dwScanTemplate = 0;
+  DWORD dwRunIndex = 0;
+  DWORD dwScanIndex = 0;
+  DWORD dwByteIndex = 0;
+  DWORD dwNumBytesReturned = 0;
+
+  memset(TemplateWriteDataBuffers, 0, sizeof(TemplateWriteDataBuffers));
+
+  for (dwScanIndex = 0; (dwScanIndex < (sizeof(Scans) / sizeof(Scans[0]))); dwScanIndex++)
+    TemplateWriteDataBuffers[dwScanIndex] = &WriteDataBuffers[dwScanIndex];
+
+  dwNumFailures = (dwNumFailures + CheckStatus(JTAG_CreateScanTemplate(ftHandle, Scans, (sizeof(Scans) / sizeof(Scans[0])),
+                                                                       &dwScanTemplate), "create scan template"));
+
+  for (dwRunIndex = 0; ((dwRunIndex < (sizeof(StartStates) / sizeof(StartStates[0]))) && (dwNumFailures == 0)); dwRunIndex++)
+  {
+    for (dwScanIndex = 0; (dwScanIndex < (sizeof(Scans) / sizeof(Scans[0]))); dwScanIndex++)
+    {
+      for (dwByteIndex = 0; (dwByteIndex < 16); dwByteIndex++)
+        WriteDataBuffers[dwScanIndex][dwByteIndex] = BYTE((dwByteIndex * 29) + (dwScanIndex * 71) + (dwRunIndex * 113));
+    }
+
+    memset(pReadCmdSequenceDataBuffer, 0, sizeof(ReadCmdSequenceDataByteBuffer));
+
+    dwNumFailures = (dwNumFailures + CheckStatus(JTAG_Write(ftHandle, FALSE, 8, TemplateWriteDataBuffers[0], 1, StartStates[dwRunIndex]),
+                                                 "write DR"));
+    dwNumFailures = (dwNumFailures + CheckStatus(JTAG_ExecuteScanTemplate(ftHandle, dwScanTemplate, &TemplateWriteDataBuffers,
+                                                                          pReadCmdSequenceDataBuffer, &dwNumBytesReturned),
+                                                 "execute scan template"));
+
+    if (dwNumBytesReturned != (2 + 2 + 9))
+    {
+      printf("scan template returned %u bytes instead of %u\n", dwNumBytesReturned, (2 + 2 + 9));
+
+      dwNumFailures = (dwNumFailures + 1);
+    }
+
+    dwNumFailures = (dwNumFailures + CompareBits(WriteDataBuffers[1], *pReadCmdSequenceDataBuffer, 13, "scan template write read"));
+    dwNumFailures = (dwNumFailures + CompareBits(WriteDataBuffers[3], &(*pReadCmdSequenceDataBuffer)[4], 67, "scan template write read"));
+    dwNumFailures = (dwNumFailures + CheckInstructionRegister(ftHandle, WriteDataBuffers[0], 10, "scan template write IR"));
+    dwNumFailures = (dwNumFailures + GetEmulatorState(ftHandle, &EmulatorState));
+
+    if (EmulatorState.dwTapControllerState != RUN_TEST_IDLE_STATE)
+    {
+      printf("scan template left the emulator in state %u\n", EmulatorState.dwTapControllerState);
+
+      dwNumFailures = (dwNumFailures + 1);
+    }
+  }
+
+  dwNumFailures = (dwNumFailures + CheckStatus(JTAG_DeleteScanTemplate(ftHandle, dwScanTemplate), "delete scan template"));
+
+  if (JTAG_ExecuteScanTemplate(ftHandle, dwScanTemplate, &TemplateWriteDataBuffers, pReadCmdSequenceDataBuffer,
+                               &dwNumBytesReturned) != FTC_INVALID_SCAN_TEMPLATE)
+  {
+    printf("deleted scan template was executed\n");
+
+    dwNumFailures = (dwNumFailures + 1);
+  }
+
+  return dwNumFailures;
+}
+
+static DWORD CheckSubmittedStatus(FTC_STATUS Status, LPCSTR lpOperation)
+{
+  DWORD dwNumFailures = 0;
+
+  if (Status != FTC_COMMAND_SEQUENCE_SUBMITTED)
+  {
+    printf("%s while a sequence was submitted returned status %u\n", lpOperation, Status);
+
+    dwNumFailures = 1;
+  }
+
+  return dwNumFailures;
+}
+
+// Nothing that clocks the TAP controller or reads the device may be sent while a submitted sequence has not been
+// collected, its bytes would be read back in place of the submitted sequence's bytes
+static DWORD TestSubmittedCommandSequenceRule(FTC_HANDLE ftHandle, PWriteDataByteBuffer pWriteDataBuffer)
+{
+  static ReadDataByteBuffer ReadDataBuffer;
+  FTC_LOW_HIGH_PINS LowPinsInputData;
+  FTH_LOW_HIGH_PINS HighPinsInputData;
+  DWORD dwNumBytesReturned = 0;
+  DWORD dwMismatchBitOffset = 0;
+  DWORD dwNumFailures = 0;
+
+  dwNumFailures = (dwNumFailures + CheckSubmittedStatus(JTAG_Write(ftHandle, FALSE, 8, pWriteDataBuffer, 1, RUN_TEST_IDLE_STATE), "write"));
+  dwNumFailures = (dwNumFailures + CheckSubmittedStatus(JTAG_Read(ftHandle, FALSE, 8, &ReadDataBuffer, &dwNumBytesReturned,
+                                                                  RUN_TEST_IDLE_STATE), "read"));
+  dwNumFailures = (dwNumFailures + CheckSubmittedStatus(JTAG_WriteRead(ftHandle, FALSE, 8, pWriteDataBuffer, 1, &ReadDataBuffer,
+                                                                       &dwNumBytesReturned, RUN_TEST_IDLE_STATE), "write read"));
+  dwNumFailures = (dwNumFailures + CheckSubmittedStatus(JTAG_WriteReadCompare(ftHandle, FALSE, 8, pWriteDataBuffer, 1, pWriteDataBuffer,
+                                                                              NULL, &dwMismatchBitOffset, RUN_TEST_IDLE_STATE),
+                                                        "write read compare"));
+  dwNumFailures = (dwNumFailures + CheckSubmittedStatus(JTAG_StreamScan(ftHandle, FALSE, 8, ZeroScanDataSource, NULL, NULL,
+                                                                        RUN_TEST_IDLE_STATE), "stream scan"));
+  dwNumFailures = (dwNumFailures + CheckSubmittedStatus(JTAG_ExecuteScanTemplate(ftHandle, 0, NULL, NULL, &dwNumBytesReturned),
+                                                        "execute scan template"));
+  dwNumFailures = (dwNumFailures + CheckSubmittedStatus(JTAG_GenerateClockPulses(ftHandle, 8), "generate clock pulses"));
+  dwNumFailures = (dwNumFailures + CheckSubmittedStatus(JTAG_GenerateClockPulsesHiSpeedDevice(ftHandle, FALSE, 8, FALSE, FALSE),
+                                                        "generate hi-speed clock pulses"));
+  dwNumFailures = (dwNumFailures + CheckSubmittedStatus(JTAG_GetHiSpeedDeviceGPIOs(ftHandle, TRUE, &LowPinsInputData, TRUE,
+                                                                                   &HighPinsInputData), "get GPIOs"));
+
+  return dwNumFailures;
+}
+
+static DWORD TestCommandSequences(FTC_HANDLE ftHandle, PWriteDataByteBuffer pWriteDataBuffer,
+                                  PReadCmdSequenceDataByteBuffer pReadCmdSequenceDataBuffer)
+{
+  DWORD dwNumFailures = 0;
+  DWORD dwCommandIndex = 0;
+  DWORD dwNumBytesReturned = 0;
+  DWORD dwTicket = 0;
+
+  dwNumFailures = (dwNumFailures + CheckStatus(JTAG_ClearDeviceCmdSequence(ftHandle), "clear sequence"));
+
+  for (dwCommandIndex = 0; (dwCommandIndex < NUM_TEST_SEQUENCE_COMMANDS); dwCommandIndex++)
+    dwNumFailures = (dwNumFailures + CheckStatus(JTAG_AddDeviceWriteReadCmd(ftHandle, FALSE, (TEST_SEQUENCE_COMMAND_NUM_BYTES * 8),
+                                                                            pWriteDataBuffer, TEST_SEQUENCE_COMMAND_NUM_BYTES,
+                                                                            RUN_TEST_IDLE_STATE),
+                                                 "add write read command"));
+
+  dwNumFailures = (dwNumFailures + CheckStatus(JTAG_ExecuteCmdSequence(ftHandle, pReadCmdSequenceDataBuffer, &dwNumBytesReturned),
+                                               "execute sequence"));
+
+  for (dwCommandIndex = 0; (dwCommandIndex < NUM_TEST_SEQUENCE_COMMANDS); dwCommandIndex++)
+    dwNumFailures = (dwNumFailures + CompareBits(*pWriteDataBuffer, &(*pReadCmdSequenceDataBuffer)[(dwCommandIndex * TEST_SEQUENCE_COMMAND_NUM_BYTES)],
+                                                 (TEST_SEQUENCE_COMMAND_NUM_BYTES * 8), "sequence write read"));
+
+  // the next sequence is cleared and built while the submitted one is executing, which must not lose the submitted one
+  for (dwCommandIndex = 0; (dwCommandIndex < NUM_TEST_SEQUENCE_COMMANDS); dwCommandIndex++)
+    dwNumFailures = (dwNumFailures + CheckStatus(JTAG_AddDeviceWriteReadCmd(ftHandle, FALSE, (TEST_SEQUENCE_COMMAND_NUM_BYTES * 8),
+                                                                            pWriteDataBuffer, TEST_SEQUENCE_COMMAND_NUM_BYTES,
+                                                                            RUN_TEST_IDLE_STATE),
+                                                 "add write read command"));
+
+  dwNumFailures = (dwNumFailures + CheckStatus(JTAG_ExecuteCmdSequenceAsync(ftHandle, &dwTicket), "execute sequence async"));
+  dwNumFailures = (dwNumFailures + TestSubmittedCommandSequenceRule(ftHandle, pWriteDataBuffer));
+
+  dwNumFailures = (dwNumFailures + CheckStatus(JTAG_ClearDeviceCmdSequence(ftHandle), "clear sequence"));
+  dwNumFailures = (dwNumFailures + CheckStatus(JTAG_AddDeviceWriteReadCmd(ftHandle, TRUE, 8, pWriteDataBuffer, 1, RUN_TEST_IDLE_STATE),
+                                               "add write read command"));
+
+  memset(pReadCmdSequenceDataBuffer, 0, sizeof(ReadCmdSequenceDataByteBuffer));
+
+  dwNumFailures = (dwNumFailures + CheckStatus(JTAG_WaitCmdSequence(ftHandle, dwTicket, pReadCmdSequenceDataBuffer, &dwNumBytesReturned),
+                                               "wait sequence"));
+
+  for (dwCommandIndex = 0; (dwCommandIndex < NUM_TEST_SEQUENCE_COMMANDS); dwCommandIndex++)
+    dwNumFailures = (dwNumFailures + CompareBits(*pWriteDataBuffer, &(*pReadCmdSequenceDataBuffer)[(dwCommandIndex * TEST_SEQUENCE_COMMAND_NUM_BYTES)],
+                                                 (TEST_SEQUENCE_COMMAND_NUM_BYTES * 8), "async sequence write read"));
+
+  dwNumFailures = (dwNumFailures + CheckStatus(JTAG_ExecuteCmdSequence(ftHandle, pReadCmdSequenceDataBuffer, &dwNumBytesReturned),
+                                               "execute next sequence"));
+
+  if (dwNumBytesReturned != 1)
+  {
+    printf("next sequence returned %u bytes instead of 1\n", dwNumBytesReturned);
+
+    dwNumFailures = (dwNumFailures + 1);
+  }
+  else
+    dwNumFailures = (dwNumFailures + CompareBits(*pWriteDataBuffer, *pReadCmdSequenceDataBuffer, 8, "next sequence write read"));
+
+  return dwNumFailures;
+}
+
+static FTC_STATUS WINAPI StreamingSequenceDataSink(LPVOID pContext, LPBYTE pDataBytes, DWORD dwNumBytes)
+{
+  PSTREAMING_SEQUENCE_TEST_DATA pTestData = (PSTREAMING_SEQUENCE_TEST_DATA)pContext;
+  FTC_STATUS Status = FTC_SUCCESS;
+  DWORD dwByteIndex = 0;
+  DWORD dwStreamByteIndex = 0;
+
+  pTestData->dwNumSinkCalls = (pTestData->dwNumSinkCalls + 1);
+
+  if (pTestData->dwNumSinkCalls == pTestData->dwFailingSinkCall)
+    Status = FTC_INSUFFICIENT_RESOURCES;
+  else
+  {
+    // every write read command reads back the same bytes, the bytes of the read commands in between are not checked
+    for (dwByteIndex = 0; (dwByteIndex < dwNumBytes); dwByteIndex++)
+    {
+      dwStreamByteIndex = (pTestData->dwNumSinkBytes + dwByteIndex);
+
+      if ((!pTestData->bReadCommands) || (((dwStreamByteIndex / TEST_STREAMING_SEQUENCE_COMMAND_NUM_BYTES) % 2) == 0))
+      {
+        if (pDataBytes[dwByteIndex] != (*pTestData->pWriteDataBuffer)[(dwStreamByteIndex % TEST_STREAMING_SEQUENCE_COMMAND_NUM_BYTES)])
+          pTestData->dwNumMismatchedBytes = (pTestData->dwNumMismatchedBytes + 1);
+      }
+    }
+
+    pTestData->dwNumSinkBytes = (pTestData->dwNumSinkBytes + dwNumBytes);
+  }
+
+  return Status;
+}
+
+// Builds streaming sequences several segments long. A write command after every write read command fills each
+// segment with command bytes, a read command after every write read command fills it with read bytes, so segments
+// are flushed by both limits. Every byte read must reach the sink in order, in at least as many calls as the bytes
+// need segments, and a failing sink must stop the sequence being built.
+static DWORD TestStreamingCommandSequences(FTC_HANDLE ftHandle, PWriteDataByteBuffer pWriteDataBuffer)
+{
+  STREAMING_SEQUENCE_TEST_DATA TestData;
+  FTC_STATUS Status = FTC_SUCCESS;
+  DWORD dwNumFailures = 0;
+  DWORD dwRunIndex = 0;
+  DWORD dwCommandIndex = 0;
+  DWORD dwNumExpectedBytes = 0;
+  DWORD dwNumBytesReturned = 0;
+
+  for (dwRunIndex = 0; (dwRunIndex < 3); dwRunIndex++)
+  {
+    memset(&TestData, 0, sizeof(TestData));
+
+    TestData.pWriteDataBuffer = pWriteDataBuffer;
+    TestData.bReadCommands = (dwRunIndex == 1);
+
+    // the last run fails on the second segment, which is sent while the sequence is being built
+    if (dwRunIndex == 2)
+      TestData.dwFailingSinkCall = 2;
+
+    dwNumFailures = (dwNumFailures + CheckStatus(JTAG_SetDeviceCmdSequenceStreaming(ftHandle, TRUE, StreamingSequenceDataSink, &TestData),
+                                                 "enable streaming"));
+
+    Status = FTC_SUCCESS;
+
+    for (dwCommandIndex = 0; ((dwCommandIndex < NUM_TEST_STREAMING_SEQUENCE_COMMANDS) && (Status == FTC_SUCCESS)); dwCommandIndex++)
+    {
+      Status = JTAG_AddDeviceWriteReadCmd(ftHandle, FALSE, (TEST_STREAMING_SEQUENCE_COMMAND_NUM_BYTES * 8), pWriteDataBuffer,
+                                          TEST_STREAMING_SEQUENCE_COMMAND_NUM_BYTES, PAUSE_TEST_DATA_REGISTER_STATE);
+
+      if (Status == FTC_SUCCESS)
+      {
+        if (TestData.bReadCommands)
+          Status = JTAG_AddDeviceReadCmd(ftHandle, FALSE, (TEST_STREAMING_SEQUENCE_COMMAND_NUM_BYTES * 8), RUN_TEST_IDLE_STATE);
+        else
+          Status = JTAG_AddDeviceWriteCmd(ftHandle, FALSE, (TEST_STREAMING_SEQUENCE_COMMAND_NUM_BYTES * 8), pWriteDataBuffer,
+                                          TEST_STREAMING_SEQUENCE_COMMAND_NUM_BYTES, RUN_TEST_IDLE_STATE);
+      }
+    }
+
+    if (dwRunIndex < 2)
+    {
+      dwNumFailures = (dwNumFailures + CheckStatus(Status, "add streaming command"));
+
+      dwNumExpectedBytes = (NUM_TEST_STREAMING_SEQUENCE_COMMANDS * TEST_STREAMING_SEQUENCE_COMMAND_NUM_BYTES);
+
+      if (TestData.bReadCommands)
+        dwNumExpectedBytes = (dwNumExpectedBytes * 2);
+
+      if (JTAG_SubmitCmdSequence(ftHandle) != FTC_COMMAND_SEQUENCE_STREAMING)
+      {
+        printf("streaming sequence was submitted\n");
+
+        dwNumFailures = (dwNumFailures + 1);
+      }
+
+      dwNumFailures = (dwNumFailures + CheckStatus(JTAG_ExecuteCmdSequence(ftHandle, NULL, &dwNumBytesReturned), "execute streaming sequence"));
+
+      if ((dwNumBytesReturned != dwNumExpectedBytes) || (TestData.dwNumSinkBytes != dwNumBytesReturned) ||
+          (TestData.dwNumSinkCalls < ((dwNumExpectedBytes + 65535) / 65536)) || (TestData.dwNumMismatchedBytes > 0))
+      {
+        printf("streaming sequence returned %u bytes, passed %u bytes to %u sink calls, %u of them wrong\n", dwNumBytesReturned,
+               TestData.dwNumSinkBytes, TestData.dwNumSinkCalls, TestData.dwNumMismatchedBytes);
+
+        dwNumFailures = (dwNumFailures + 1);
+      }
+    }
+    else if (Status != FTC_INSUFFICIENT_RESOURCES)
+    {
+      printf("streaming sequence with a failing sink returned status %u\n", Status);
+
+      dwNumFailures = (dwNumFailures + 1);
+    }
+
+    dwNumFailures = (dwNumFailures + CheckStatus(JTAG_SetDeviceCmdSequenceStreaming(ftHandle, FALSE, NULL, NULL), "disable streaming"));
+  }
+
+  return dwNumFailures;
+}
+
+// Builds a sequence of short scans that move the TAP controller between the pause, run test idle and test logic
+// reset states, so most of its commands are TMS commands
+static DWORD AddOptimizerTestCommands(FTC_HANDLE ftHandle, PWriteDataByteBuffer pWriteDataBuffer)
+{
+  DWORD dwRepeatIndex = 0;
+  DWORD dwNumFailures = 0;
+
+  for (dwRepeatIndex = 0; (dwRepeatIndex < 4); dwRepeatIndex++)
+  {
+    dwNumFailures = (dwNumFailures + CheckStatus(JTAG_AddDeviceWriteCmd(ftHandle, TRUE, 10, pWriteDataBuffer, 2, PAUSE_INSTRUCTION_REGISTER_STATE),
+                                                 "add write command"));
+    dwNumFailures = (dwNumFailures + CheckStatus(JTAG_AddDeviceWriteReadCmd(ftHandle, FALSE, 16, pWriteDataBuffer, 2,
+                                                                            PAUSE_TEST_DATA_REGISTER_STATE),
+                                                 "add write read command"));
+    dwNumFailures = (dwNumFailures + CheckStatus(JTAG_AddDeviceWriteReadCmd(ftHandle, FALSE, 24, pWriteDataBuffer, 3,
+                                                                            PAUSE_TEST_DATA_REGISTER_STATE),
+                                                 "add write read command"));
+    dwNumFailures = (dwNumFailures + CheckStatus(JTAG_AddDeviceReadCmd(ftHandle, FALSE, 8, RUN_TEST_IDLE_STATE), "add read command"));
+    dwNumFailures = (dwNumFailures + CheckStatus(JTAG_AddDeviceWriteCmd(ftHandle, FALSE, 8, pWriteDataBuffer, 1, TEST_LOGIC_STATE),
+                                                 "add write command"));
+    dwNumFailures = (dwNumFailures + CheckStatus(JTAG_AddDeviceWriteReadCmd(ftHandle, TRUE, 10, pWriteDataBuffer, 2, RUN_TEST_IDLE_STATE),
+                                                 "add write read command"));
+  }
+
+  return dwNumFailures;
+}
+
+// A sequence must read back the same data and leave the emulator in the same state whether or not it is optimized.
+// Both runs start with the TAP controller state undefined, so the sequence starts with 7 TMS high clocks, of which
+// the optimizer must drop the 2 given after the test logic reset state is reached
+static DWORD TestCommandSequenceOptimizer(FTC_HANDLE ftHandle, PWriteDataByteBuffer pWriteDataBuffer)
+{
+  static ReadCmdSequenceDataByteBuffer ReadCmdSequenceDataBuffers[2];
+  FTC_EMULATOR_STATE StartEmulatorStates[2];
+  FTC_EMULATOR_STATE EndEmulatorStates[2];
+  STREAM_SCAN_TEST_DATA StreamScanData;
+  DWORD NumBytesReturned[2] = {0, 0};
+  DWORD NumBytesSaved[2] = {0, 0};
+  BOOL bOptimizerEnabled = FALSE;
+  DWORD dwRunIndex = 0;
+  DWORD dwNumFailures = 0;
+
+  dwNumFailures = (dwNumFailures + CheckStatus(JTAG_GetDeviceCmdSequenceOptimizer(ftHandle, &bOptimizerEnabled, &NumBytesSaved[0]),
+                                               "get optimizer"));
+
+  if (bOptimizerEnabled != FALSE)
+  {
+    printf("the command sequence optimizer was enabled when the device was opened\n");
+
+    dwNumFailures = (dwNumFailures + 1);
+  }
+
+  for (dwRunIndex = 0; (dwRunIndex < 2); dwRunIndex++)
+  {
+    dwNumFailures = (dwNumFailures + CheckStatus(JTAG_SetDeviceCmdSequenceOptimizer(ftHandle, (dwRunIndex == 1)), "set optimizer"));
+
+    // a stream scan stopped after its first block leaves the TAP controller state undefined
+    memset(&StreamScanData, 0, sizeof(StreamScanData));
+    StreamScanData.dwFailingSourceCall = 2;
+
+    JTAG_StreamScan(ftHandle, FALSE, ((2 * TEST_STREAM_SCAN_BLOCK_NUM_BYTES * 8) + 8), StreamScanDataSource, NULL, &StreamScanData,
+                    RUN_TEST_IDLE_STATE);
+
+    dwNumFailures = (dwNumFailures + CheckStatus(JTAG_ClearDeviceCmdSequence(ftHandle), "clear sequence"));
+    dwNumFailures = (dwNumFailures + AddOptimizerTestCommands(ftHandle, pWriteDataBuffer));
+    dwNumFailures = (dwNumFailures + GetEmulatorState(ftHandle, &StartEmulatorStates[dwRunIndex]));
+    dwNumFailures = (dwNumFailures + CheckStatus(JTAG_ExecuteCmdSequence(ftHandle, &ReadCmdSequenceDataBuffers[dwRunIndex],
+                                                                         &NumBytesReturned[dwRunIndex]),
+                                                 "execute sequence"));
+    dwNumFailures = (dwNumFailures + GetEmulatorState(ftHandle, &EndEmulatorStates[dwRunIndex]));
+    dwNumFailures = (dwNumFailures + CheckStatus(JTAG_GetDeviceCmdSequenceOptimizer(ftHandle, &bOptimizerEnabled, &NumBytesSaved[dwRunIndex]),
+                                                 "get optimizer"));
+  }
+
+  dwNumFailures = (dwNumFailures + CheckStatus(JTAG_SetDeviceCmdSequenceOptimizer(ftHandle, FALSE), "set optimizer"));
+
+  if ((NumBytesReturned[1] != NumBytesReturned[0]) ||
+      (memcmp(ReadCmdSequenceDataBuffers[1], ReadCmdSequenceDataBuffers[0], NumBytesReturned[0]) != 0))
+  {
+    printf("optimized sequence read back different data\n");
+
+    dwNumFailures = (dwNumFailures + 1);
+  }
+
+  if ((EndEmulatorStates[1].dwTapControllerState != EndEmulatorStates[0].dwTapControllerState) ||
+      (EndEmulatorStates[1].dwNumInstructionRegisterBits != EndEmulatorStates[0].dwNumInstructionRegisterBits) ||
+      (memcmp(EndEmulatorStates[1].InstructionRegisterBytes, EndEmulatorStates[0].InstructionRegisterBytes,
+              sizeof(EndEmulatorStates[0].InstructionRegisterBytes)) != 0) ||
+      ((EndEmulatorStates[1].dwNumInstructionRegisterUpdates - StartEmulatorStates[1].dwNumInstructionRegisterUpdates) !=
+       (EndEmulatorStates[0].dwNumInstructionRegisterUpdates - StartEmulatorStates[0].dwNumInstructionRegisterUpdates)))
+  {
+    printf("optimized sequence left the emulator in a different state\n");
+
+    dwNumFailures = (dwNumFailures + 1);
+  }
+
+  if (((EndEmulatorStates[1].dwNumTmsClocks - StartEmulatorStates[1].dwNumTmsClocks) + 2) !=
+      (EndEmulatorStates[0].dwNumTmsClocks - StartEmulatorStates[0].dwNumTmsClocks))
+  {
+    printf("optimized sequence clocked TMS %u times instead of %u\n",
+           (EndEmulatorStates[1].dwNumTmsClocks - StartEmulatorStates[1].dwNumTmsClocks),
+           ((EndEmulatorStates[0].dwNumTmsClocks - StartEmulatorStates[0].dwNumTmsClocks) - 2));
+
+    dwNumFailures = (dwNumFailures + 1);
+  }
+
+  if (((EndEmulatorStates[1].dwNumCommands - StartEmulatorStates[1].dwNumCommands) >=
+       (EndEmulatorStates[0].dwNumCommands - StartEmulatorStates[0].dwNumCommands)) || (NumBytesSaved[1] <= NumBytesSaved[0]))
+  {
+    printf("optimized sequence sent %u commands instead of fewer than %u, saving %u bytes\n",
+           (EndEmulatorStates[1].dwNumCommands - StartEmulatorStates[1].dwNumCommands),
+           (EndEmulatorStates[0].dwNumCommands - StartEmulatorStates[0].dwNumCommands), (NumBytesSaved[1] - NumBytesSaved[0]));
+
+    dwNumFailures = (dwNumFailures + 1);
+  }
+
+  return dwNumFailures;
+}
+
+#ifndef _WIN32
+// The completion fd must become readable once the submitted sequence has returned its bytes, and unreadable again
+// once the sequence has been reaped
+static DWORD TestCompletionFd(FTC_HANDLE ftHandle, PWriteDataByteBuffer pWriteDataBuffer,
+                              PReadCmdSequenceDataByteBuffer pReadCmdSequenceDataBuffer)
+{
+  struct pollfd CompletionPollFd;
+  DWORD dwNumFailures = 0;
+  DWORD dwNumBytesReturned = 0;
+  INT iCompletionFd = -1;
+
+  dwNumFailures = (dwNumFailures + CheckStatus(JTAG_GetDeviceCompletionFd(ftHandle, &iCompletionFd), "get completion fd"));
+  dwNumFailures = (dwNumFailures + CheckStatus(JTAG_ClearDeviceCmdSequence(ftHandle), "clear sequence"));
+  dwNumFailures = (dwNumFailures + CheckStatus(JTAG_AddDeviceWriteReadCmd(ftHandle, FALSE, 64, pWriteDataBuffer, 8, RUN_TEST_IDLE_STATE),
+                                               "add write read command"));
+  dwNumFailures = (dwNumFailures + CheckStatus(JTAG_SubmitCmdSequence(ftHandle), "submit sequence"));
+
+  CompletionPollFd.fd = iCompletionFd;
+  CompletionPollFd.events = POLLIN;
+
+  if (poll(&CompletionPollFd, 1, 2000) != 1)
+  {
+    printf("completion fd not readable after the submitted sequence returned its bytes\n");
+
+    dwNumFailures = (dwNumFailures + 1);
+  }
+
+  dwNumFailures = (dwNumFailures + CheckStatus(JTAG_ReapCmdSequence(ftHandle, pReadCmdSequenceDataBuffer, &dwNumBytesReturned),
+                                               "reap sequence"));
+  dwNumFailures = (dwNumFailures + CompareBits(*pWriteDataBuffer, *pReadCmdSequenceDataBuffer, 64, "reaped sequence write read"));
+
+  if (poll(&CompletionPollFd, 1, 0) != 0)
+  {
+    printf("completion fd still readable after the sequence was reaped\n");
+
+    dwNumFailures = (dwNumFailures + 1);
+  }
+
+  return dwNumFailures;
+}
+#endif
+
+static DWORD TestCompareScans(FTC_HANDLE ftHandle, PWriteDataByteBuffer pWriteDataBuffer, PWriteDataByteBuffer pExpectedDataBuffer)
+{
+  static const DWORD NumScanBits[] = {5, 64, 1001, 40001, 524279};
+  DWORD dwNumFailures = 0;
+  DWORD dwScanIndex = 0;
+  DWORD dwMismatchBitIndex = 0;
+  DWORD dwMismatchBitOffset = 0;
+  FTC_STATUS Status = FTC_SUCCESS;
+
+  for (dwScanIndex = 0; (dwScanIndex < (sizeof(NumScanBits) / sizeof(NumScanBits[0]))); dwScanIndex++)
+  {
+    memcpy(pExpectedDataBuffer, pWriteDataBuffer, sizeof(WriteDataByteBuffer));
+
+    dwNumFailures = (dwNumFailures + CheckStatus(JTAG_WriteReadCompare(ftHandle, FALSE, NumScanBits[dwScanIndex], pWriteDataBuffer,
+                                                                       ((NumScanBits[dwScanIndex] + 7) / 8), pExpectedDataBuffer, NULL,
+                                                                       &dwMismatchBitOffset, RUN_TEST_IDLE_STATE),
+                                                 "write read compare"));
+
+    // a bit near the end, so a long scan has to be stopped part way through to find it
+    dwMismatchBitIndex = ((NumScanBits[dwScanIndex] * 3) / 4);
+
+    (*pExpectedDataBuffer)[(dwMismatchBitIndex / 8)] = BYTE((*pExpectedDataBuffer)[(dwMismatchBitIndex / 8)] ^ (1 << (dwMismatchBitIndex % 8)));
+
+    Status = JTAG_WriteReadCompare(ftHandle, FALSE, NumScanBits[dwScanIndex], pWriteDataBuffer, ((NumScanBits[dwScanIndex] + 7) / 8),
+                                   pExpectedDataBuffer, NULL, &dwMismatchBitOffset, RUN_TEST_IDLE_STATE);
+
+    if ((Status != FTC_TDO_DATA_MISMATCH) || (dwMismatchBitOffset != dwMismatchBitIndex))
+    {
+      printf("compare of %u bits returned status %u offset %u instead of a mismatch at %u\n", NumScanBits[dwScanIndex], Status,
+             dwMismatchBitOffset, dwMismatchBitIndex);
+
+      dwNumFailures = (dwNumFailures + 1);
+    }
+  }
+
+  return dwNumFailures;
+}
+
+// Replays a recorded sequence and checks the bytes it read, the instruction register it wrote and its end state
+static DWORD CheckRecordedCommandSequence(FTC_HANDLE ftHandle, DWORD dwRecordedCmdSequence, PWriteDataByteBuffer pWriteDataBuffer,
+                                          PReadCmdSequenceDataByteBuffer pReadCmdSequenceDataBuffer, LPCSTR lpOperation)
+{
+  FTC_EMULATOR_STATE EmulatorState;
+  DWORD dwNumFailures = 0;
+  DWORD dwNumBytesReturned = 0;
+
+  memset(pReadCmdSequenceDataBuffer, 0, sizeof(ReadCmdSequenceDataByteBuffer));
+
+  dwNumFailures = (dwNumFailures + CheckStatus(JTAG_ExecuteRecordedCmdSequence(ftHandle, dwRecordedCmdSequence, pReadCmdSequenceDataBuffer,
+                                                                               &dwNumBytesReturned), lpOperation));
+
+  if (dwNumBytesReturned != (8 + 2))
+  {
+    printf("%s returned %u bytes instead of %u\n", lpOperation, dwNumBytesReturned, (8 + 2));
+
+    dwNumFailures = (dwNumFailures + 1);
+  }
+
+  dwNumFailures = (dwNumFailures + CompareBits(*pWriteDataBuffer, *pReadCmdSequenceDataBuffer, 64, lpOperation));
+  dwNumFailures = (dwNumFailures + CompareBits(*pWriteDataBuffer, &(*pReadCmdSequenceDataBuffer)[8], 13, lpOperation));
+  dwNumFailures = (dwNumFailures + CheckInstructionRegister(ftHandle, *pWriteDataBuffer, 10, lpOperation));
+  dwNumFailures = (dwNumFailures + GetEmulatorState(ftHandle, &EmulatorState));
+
+  if (EmulatorState.dwTapControllerState != PAUSE_TEST_DATA_REGISTER_STATE)
+  {
+    printf("%s left the emulator in state %u\n", lpOperation, EmulatorState.dwTapControllerState);
+
+    dwNumFailures = (dwNumFailures + 1);
+  }
+
+  return dwNumFailures;
+}
+
+// A recorded sequence is replayed from several TAP controller states, then with a second hi-speed device, which it
+// must work with, and with a FT2232D dual device, which it must be refused for. The TAP controller state is not kept
+// for each device, so this test opens other devices last.
+static DWORD TestRecordedCommandSequences(FTC_HANDLE ftHandle, PWriteDataByteBuffer pWriteDataBuffer,
+                                          PReadCmdSequenceDataByteBuffer pReadCmdSequenceDataBuffer)
+{
+  static const DWORD StartStates[] = {TEST_LOGIC_STATE, PAUSE_INSTRUCTION_REGISTER_STATE, SHIFT_TEST_DATA_REGISTER_STATE};
+  DWORD dwNumFailures = 0;
+  DWORD dwRecordedCmdSequence = 0;
+  DWORD dwRunIndex = 0;
+  DWORD dwNumBytesReturned = 0;
+  FTC_HANDLE ftOtherHandle = 0;
+
+  dwNumFailures = (dwNumFailures + CheckStatus(JTAG_ClearDeviceCmdSequence(ftHandle), "clear sequence"));
+  dwNumFailures = (dwNumFailures + CheckStatus(JTAG_AddDeviceWriteCmd(ftHandle, TRUE, 10, pWriteDataBuffer, 2, RUN_TEST_IDLE_STATE),
+                                               "add write IR command"));
+  dwNumFailures = (dwNumFailures + CheckStatus(JTAG_AddDeviceWriteReadCmd(ftHandle, FALSE, 64, pWriteDataBuffer, 8, RUN_TEST_IDLE_STATE),
+                                               "add write read command"));
+  dwNumFailures = (dwNumFailures + CheckStatus(JTAG_AddDeviceWriteReadCmd(ftHandle, FALSE, 13, pWriteDataBuffer, 2,
+                                                                          PAUSE_TEST_DATA_REGISTER_STATE),
+                                               "add write read command"));
+  dwNumFailures = (dwNumFailures + CheckStatus(JTAG_RecordCmdSequence(ftHandle, &dwRecordedCmdSequence), "record sequence"));
+
+  // recording a sequence takes it away from the device
+  if (JTAG_ExecuteCmdSequence(ftHandle, pReadCmdSequenceDataBuffer, &dwNumBytesReturned) != FTC_NO_COMMAND_SEQUENCE)
+  {
+    printf("recorded sequence was left to be executed\n");
+
+    dwNumFailures = (dwNumFailures + 1);
+  }
+
+  for (dwRunIndex = 0; ((dwRunIndex < (sizeof(StartStates) / sizeof(StartStates[0]))) && (dwNumFailures == 0)); dwRunIndex++)
+  {
+    dwNumFailures = (dwNumFailures + CheckStatus(JTAG_Write(ftHandle, FALSE, 8, pWriteDataBuffer, 1, StartStates[dwRunIndex]), "write DR"));
+    dwNumFailures = (dwNumFailures + CheckRecordedCommandSequence(ftHandle, dwRecordedCmdSequence, pWriteDataBuffer,
+                                                                  pReadCmdSequenceDataBuffer, "replay sequence"));
+  }
+
+  dwNumFailures = (dwNumFailures + CheckStatus(JTAG_OpenTransportDevice(FTC_TRANSPORT_MPSSE_EMULATOR, FTC_EMULATOR_HI_SPEED_DEVICE_INDEX,
+                                                                        &ftOtherHandle), "open"));
+
+  if (ftOtherHandle != 0)
+  {
+    dwNumFailures = (dwNumFailures + CheckStatus(JTAG_InitDevice(ftOtherHandle, 0), "init"));
+    dwNumFailures = (dwNumFailures + CheckRecordedCommandSequence(ftOtherHandle, dwRecordedCmdSequence, pWriteDataBuffer,
+                                                                  pReadCmdSequenceDataBuffer, "replay sequence with another device"));
+    dwNumFailures = (dwNumFailures + CheckStatus(JTAG_Close(ftOtherHandle), "close"));
+
+    ftOtherHandle = 0;
+  }
+
+  dwNumFailures = (dwNumFailures + CheckStatus(JTAG_OpenTransportDevice(FTC_TRANSPORT_MPSSE_EMULATOR, FTC_EMULATOR_DUAL_DEVICE_INDEX,
+                                                                        &ftOtherHandle), "open dual device"));
+
+  if (ftOtherHandle != 0)
+  {
+    dwNumFailures = (dwNumFailures + CheckStatus(JTAG_InitDevice(ftOtherHandle, 0), "init dual device"));
+
+    if (JTAG_ExecuteRecordedCmdSequence(ftOtherHandle, dwRecordedCmdSequence, pReadCmdSequenceDataBuffer,
+                                        &dwNumBytesReturned) != FTC_INCOMPATIBLE_RECORDED_COMMAND_SEQUENCE)
+    {
+      printf("sequence recorded for a hi-speed device was replayed with a dual device\n");
+
+      dwNumFailures = (dwNumFailures + 1);
+    }
+
+    dwNumFailures = (dwNumFailures + CheckStatus(JTAG_Close(ftOtherHandle), "close dual device"));
+  }
+
+  dwNumFailures = (dwNumFailures + CheckStatus(JTAG_DeleteRecordedCmdSequence(dwRecordedCmdSequence), "delete recorded sequence"));
+
+  if (JTAG_ExecuteRecordedCmdSequence(ftHandle, dwRecordedCmdSequence, pReadCmdSequenceDataBuffer,
+                                      &dwNumBytesReturned) != FTC_INVALID_RECORDED_COMMAND_SEQUENCE)
+  {
+    printf("deleted recorded sequence was replayed\n");
+
+    dwNumFailures = (dwNumFailures + 1);
+  }
+
+  return dwNumFailures;
+}
+
+int main(void)
+{
+  static WriteDataByteBuffer WriteDataBuffer;
+  static WriteDataByteBuffer ExpectedDataBuffer;
+  static ReadDataByteBuffer ReadDataBuffer;
+  static ReadCmdSequenceDataByteBuffer ReadCmdSequenceDataBuffer;
+  DWORD dwNumFailures = 0;
+  DWORD dwByteIndex = 0;
+  FTC_HANDLE ftHandle = 0;
+
+  for (dwByteIndex = 0; (dwByteIndex < sizeof(WriteDataBuffer)); dwByteIndex++)
+    WriteDataBuffer[dwByteIndex] = BYTE((dwByteIndex * 37) + (dwByteIndex >> 8));
+
+  dwNumFailures = (dwNumFailures + TestDeviceHandles());
+
+  dwNumFailures = (dwNumFailures + CheckStatus(JTAG_OpenTransportDevice(FTC_TRANSPORT_MPSSE_EMULATOR, 0, &ftHandle), "open"));
+
+  if (dwNumFailures == 0)
+  {
+    dwNumFailures = (dwNumFailures + CheckStatus(JTAG_InitDevice(ftHandle, 0), "init"));
+
+    if (dwNumFailures == 0)
+    {
+      dwNumFailures = (dwNumFailures + TestEmulatorTapController(ftHandle));
+      dwNumFailures = (dwNumFailures + TestTapControllerStates(ftHandle, &WriteDataBuffer));
+      dwNumFailures = (dwNumFailures + TestInstructionRegisterCache(ftHandle));
+      dwNumFailures = (dwNumFailures + TestScans(ftHandle, &WriteDataBuffer, &ReadDataBuffer));
+      dwNumFailures = (dwNumFailures + TestClockPulses(ftHandle, &WriteDataBuffer));
+      dwNumFailures = (dwNumFailures + TestIdleCycles(ftHandle, &WriteDataBuffer, &ReadDataBuffer, &ReadCmdSequenceDataBuffer));
+      dwNumFailures = (dwNumFailures + TestStreamScans(ftHandle));
+      dwNumFailures = (dwNumFailures + TestScanTemplates(ftHandle, &ReadCmdSequenceDataBuffer));
+      dwNumFailures = (dwNumFailures + TestCommandSequences(ftHandle, &WriteDataBuffer, &ReadCmdSequenceDataBuffer));
+      dwNumFailures = (dwNumFailures + TestStreamingCommandSequences(ftHandle, &WriteDataBuffer));
+      dwNumFailures = (dwNumFailures + TestCommandSequenceOptimizer(ftHandle, &WriteDataBuffer));
+#ifndef _WIN32
+      dwNumFailures = (dwNumFailures + TestCompletionFd(ftHandle, &WriteDataBuffer, &ReadCmdSequenceDataBuffer));
+#endif
+      dwNumFailures = (dwNumFailures + TestCompareScans(ftHandle, &WriteDataBuffer, &ExpectedDataBuffer));
+      dwNumFailures = (dwNumFailures + TestRecordedCommandSequences(ftHandle, &WriteDataBuffer, &ReadCmdSequenceDataBuffer));
+    }
+
+    dwNumFailures = (dwNumFailures + CheckStatus(JTAG_Close(ftHandle), "close"));
+  }
+
+  printf("%u loopback failures\n", dwNumFailures);
+
+  return ((dwNumFailures == 0) ? 0 : 1);
+}